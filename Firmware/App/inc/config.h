@@ -37,6 +37,14 @@ along with this program.  If not, see <https://www.gnu.org/licenses/>.
 #define TIMER_16_BIT_COUNT      1
 
 #define TIMEBASE_MAX_MODULES 3U
+/* Upper bound of the build-time solved timebase period error (residual error is compensated by the timebase ISR) */
+#define TIMEBASE_MAX_PERIOD_ERROR_PPM 50U
+/* Timebase timer 2 is clocked from the I/O clock (AS2 cleared, no crystal on TOSC pins) : it stops in sleep modes
+deeper than idle */
+#define TIMEBASE_TIMER_ASYNCHRONOUS 0
+#define TIMEBASE_TIMER_MAX_TIMERS 8U
+#define TIMEBASE_TIMER_WHEEL_SIZE 16U
+#define SCHEDULER_MAX_TASKS 4U
 #define I2C_DEVICES_COUNT 1U
 
 // Only implement master tx driver
@@ -45,4 +53,29 @@ along with this program.  If not, see <https://www.gnu.org/licenses/>.
 
 #define IO_MAX_PINS 6U
 
+/* Smoothed secondary ripple analysis. ADC2 samples are positioned with the ADC conversion count (ADC_CONVERSION_TIME_US
+per conversion), so the frequency estimate follows the actual scan. Running block is restarted when two ADC2 samples
+are more than RIPPLE_ANALYSER_MAX_GAP_CYCLES worst case scan cycles apart (stalled scan) */
+#define RIPPLE_ANALYSER_MAX_GAP_CYCLES  2U
+#define RIPPLE_ANALYSER_BLOCK_ORDER     10U
+#define RIPPLE_ANALYSER_HYSTERESIS      4U
+
+/* ADC scan table, built at compile time and kept in flash (@see adc_load_scan_table()). Entries are listed in scan
+order : channels which need settling come last, so that they follow a low impedance channel as rarely as possible.
+Noise reduced channels are converted while the main loop sleeps, which stops every timer clocked from the I/O clock.
+This includes the timebase timer 2, which is not clocked asynchronously (@see TIMEBASE_TIMER_ASYNCHRONOUS) : noise
+reduction is refused at build time so that the millisecond timebase does not lose time.
+MCU die temperature is not scanned : it needs the internal 1V1 reference, and the 100 nF AREF capacitor of this board
+takes ~26 ms to follow each reference switch (@see ADC_PROTECTION_LATENCY_US), during which every other channel would
+be blind..
+X(channel, reference, divider, discard, average_order, filter, window, listener, noise_reduction) */
+#define ADC_SCAN_TABLE(X)                                                                                                               \
+    X(ADC_MUX_ADC0, ADC_SCAN_REFERENCE_DEFAULT, 1U, 0U, 0U, ADC_SCAN_NO_FILTER, ADC_SCAN_NO_WINDOW, NULL, false)                        \
+    X(ADC_MUX_ADC1, ADC_SCAN_REFERENCE_DEFAULT, 1U, 0U, 0U, ADC_SCAN_NO_FILTER, ADC_SCAN_NO_WINDOW, NULL, false)                        \
+    /* Rectified and smoothed transformer secondary, streamed to the ripple analyser */                                                 \
+    X(ADC_MUX_ADC2, ADC_SCAN_REFERENCE_DEFAULT, 1U, 0U, 0U, ADC_SCAN_NO_FILTER, ADC_SCAN_NO_WINDOW, secondary_smoothed_listener, false) \
+    X(ADC_MUX_ADC4, ADC_SCAN_REFERENCE_DEFAULT, 1U, 0U, 0U, ADC_SCAN_NO_FILTER, ADC_SCAN_NO_WINDOW, NULL, false)                        \
+    /* Thermistor divider is a high impedance source : sample and hold capacitor settles after the mux switched to it */                \
+    X(ADC_MUX_ADC3, ADC_SCAN_REFERENCE_DEFAULT, 1U, 2U, 1U, ADC_SCAN_NO_FILTER, ADC_SCAN_NO_WINDOW, NULL, false)
+
 #endif /* CONFIG_HEADER */
\ No newline at end of file
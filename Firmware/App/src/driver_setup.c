@@ -48,6 +48,8 @@ driver_setup_error_t driver_init_adc(void)
     config.running_mode = ADC_RUNNING_MODE_SINGLE_SHOT;
     config.supply_voltage_mv = 5000;
     config.using_interrupt = true;
+    /* USB-fed AVCC is not accurate, measure it against the internal bandgap every 16 scan cycles */
+    config.supply_monitoring_period = 16U;
 
 
     adc_error_t init_err = adc_base_init(&config);
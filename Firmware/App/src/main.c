@@ -34,7 +34,11 @@ along with this program.  If not, see <https://www.gnu.org/licenses/>.
 #include "timer_16_bit.h"
 #include "HD44780_lcd.h"
 #include "timebase.h"
+#include "timebase_timer.h"
 #include "i2c.h"
+#include "ripple_analyser.h"
+#include "scheduler.h"
+#include "config.h"
 
 #include "driver_setup.h"
 #include "module_setup.h"
@@ -43,23 +47,61 @@ along with this program.  If not, see <https://www.gnu.org/licenses/>.
 #include <string.h>
 
 #include <avr/interrupt.h>
+#include <avr/sleep.h>
 
-#define MAX_MUX 5
-
-static adc_mux_t mux_table[MAX_MUX] =
-{
-    ADC_MUX_ADC0,
-    ADC_MUX_ADC1,
-    ADC_MUX_ADC2,
-    ADC_MUX_ADC3,
-    ADC_MUX_ADC4,
-};
+/* Rectified and smoothed transformer secondary, fed by the ADC ISR */
+static ripple_analyser_t secondary_ripple;
 
 static void error_handler(void);
 static void bootup_sequence(void);
 static driver_setup_error_t adc_register_all_channels(void);
 static void adc_read_values(void);
+static void secondary_smoothed_listener(const adc_mux_t channel, const adc_result_t result);
 static void print_data(void);
+static void i2c_task(void);
+static void timers_task(void);
+static uint32_t scheduler_clock(void);
+static uint32_t scheduler_runtime_clock(void);
+
+/* Expands config.h ADC scan table into scan entries, channel list and channel count */
+#define ADC_SCAN_ENTRY(channel, reference, divider, discard, average_order, filter, window, listener, noise_reduction) \
+    {(channel), (reference), (divider), (discard), (average_order), filter, window, (listener), (noise_reduction)},
+#define ADC_SCAN_CHANNEL(channel, ...) (channel),
+#define ADC_SCAN_COUNT(...) + 1U
+#define ADC_SCAN_CONVERSIONS(channel, reference, divider, discard, average_order, filter, window, listener, noise_reduction) \
+    + (discard) + (1U << (average_order))
+#define ADC_SCAN_NOISE_REDUCED(channel, reference, divider, discard, average_order, filter, window, listener, noise_reduction) \
+    || (noise_reduction)
+
+#define ADC_SCAN_CHANNEL_COUNT (0U ADC_SCAN_TABLE(ADC_SCAN_COUNT))
+/* Worst case scan cycle : every channel is due (dividers ignored), followed by the supply monitoring bandgap */
+#define ADC_SCAN_CYCLE_CONVERSIONS ((0U ADC_SCAN_TABLE(ADC_SCAN_CONVERSIONS)) + ADC_BANDGAP_SETTLING_CONVERSIONS + 1U)
+_Static_assert((RIPPLE_ANALYSER_MAX_GAP_CYCLES * ADC_SCAN_CYCLE_CONVERSIONS) <= UINT16_MAX,
+               "Ripple analyser stall detection gap does not fit its configuration");
+_Static_assert(ADC_SCAN_CHANNEL_COUNT <= ADC_MUX_COUNT, "ADC scan table lists more channels than the ADC can scan");
+_Static_assert(TIMEBASE_TIMER_ASYNCHRONOUS || !(0 ADC_SCAN_TABLE(ADC_SCAN_NOISE_REDUCED)),
+               "ADC noise reduction sleep stops the synchronous timebase timer : timebase would lose time");
+
+static const adc_scan_entry_t adc_scan_table[ADC_SCAN_CHANNEL_COUNT] ADC_SCAN_TABLE_STORAGE =
+{
+    ADC_SCAN_TABLE(ADC_SCAN_ENTRY)
+};
+
+static const adc_mux_t adc_scan_channels[ADC_SCAN_CHANNEL_COUNT] =
+{
+    ADC_SCAN_TABLE(ADC_SCAN_CHANNEL)
+};
+
+/* Control and protection run at the timebase rate, display at a lower one. Offsets spread the load over ticks.
+Periods are in timebase ticks (ms). */
+static const scheduler_task_t tasks[] =
+{
+    /* function,            period, offset, priority, event_triggered */
+    {adc_read_values,       1U,     0U,     0U,       false},
+    {timers_task,           1U,     0U,     1U,       false},
+    {i2c_task,              1U,     0U,     2U,       false},
+    {print_data,            5U,     2U,     3U,       false},
+};
 
 ISR(ADC_vect)
 {
@@ -71,18 +113,53 @@ ISR(TIMER2_COMPA_vect)
     timebase_interrupt_callback(0U);
 }
 
+/* Commits the PWM duty pairs staged with timer_16_bit_set_duty_pair() */
+ISR(TIMER1_OVF_vect)
+{
+    timer_16_bit_overflow_isr_handler(0U);
+}
+
 int main(void)
 {
     bootup_sequence();
 
-    i2c_error_t i2c_err = I2C_ERROR_OK;
-
     while(true)
     {
-        i2c_err = i2c_process(0U);
-        (void) i2c_err;
-        adc_read_values();
-        print_data();
+        bool idle = false;
+        scheduler_error_t err = scheduler_dispatch(&idle);
+        if (SCHEDULER_ERROR_OK != err)
+        {
+            error_handler();
+        }
+
+        /* Nothing left to run until next interrupt (timebase tick at worst) : CPU sleeps.
+        Precision channels are converted with CPU and I/O clocks halted, ADC interrupt wakes the CPU up.
+        Idle state is checked again with interrupts disabled : an event raised in between would otherwise wait for
+        the next interrupt. Instruction following sei() always runs, interrupts pending by then wake the CPU up. */
+        if (idle)
+        {
+            cli();
+            err = scheduler_is_idle(&idle);
+            if ((SCHEDULER_ERROR_OK == err) && idle)
+            {
+                if (adc_noise_reduction_pending())
+                {
+                    set_sleep_mode(SLEEP_MODE_ADC);
+                }
+                else
+                {
+                    set_sleep_mode(SLEEP_MODE_IDLE);
+                }
+                sleep_enable();
+                sei();
+                sleep_cpu();
+                sleep_disable();
+            }
+            else
+            {
+                sei();
+            }
+        }
     }
 
     return 0;
@@ -95,11 +172,49 @@ int main(void)
 void adc_read_values(void)
 {
     static uint8_t idx = 0;
-    adc_result_t results[5];
-    adc_read_raw(mux_table[idx % MAX_MUX], &results[idx]);
+    adc_result_t results[ADC_SCAN_CHANNEL_COUNT];
+    adc_read_raw(adc_scan_channels[idx % ADC_SCAN_CHANNEL_COUNT], &results[idx]);
 
     idx++;
-    idx %= MAX_MUX;
+    idx %= ADC_SCAN_CHANNEL_COUNT;
+}
+
+static void i2c_task(void)
+{
+    i2c_error_t i2c_err = i2c_process(0U);
+    (void) i2c_err;
+}
+
+static void timers_task(void)
+{
+    timebase_error_t err = timebase_timer_process();
+    (void) err;
+}
+
+static uint32_t scheduler_clock(void)
+{
+    uint32_t tick = 0;
+    timebase_error_t err = timebase_get_tick(0U, &tick);
+    (void) err;
+    return tick;
+}
+
+static uint32_t scheduler_runtime_clock(void)
+{
+    uint32_t timestamp = 0;
+    timebase_error_t err = timebase_get_timestamp_us(0U, &timestamp);
+    (void) err;
+    return timestamp;
+}
+
+static void secondary_smoothed_listener(const adc_mux_t channel, const adc_result_t result)
+{
+    /* Called from the ADC ISR, once the conversion count includes this result */
+    uint32_t conversion = 0;
+    adc_error_t err = adc_get_conversion_counters(&conversion, NULL);
+    (void) err;
+    (void) channel;
+    ripple_analyser_push(&secondary_ripple, result, conversion);
 }
 
 void error_handler(void)
@@ -111,15 +226,25 @@ void error_handler(void)
 
 driver_setup_error_t adc_register_all_channels(void)
 {
-    for (uint8_t i = 0; i < MAX_MUX ; i++)
+    driver_setup_error_t ret = DRIVER_SETUP_ERROR_OK;
+
+    /* Smoothed secondary result stream feeds the ripple analyser (full-wave rectified mains) */
+    const ripple_analyser_config_t ripple_config =
     {
-        adc_error_t err = adc_register_channel(mux_table[i]);
-        if (ADC_ERROR_OK != err)
-        {
-            return DRIVER_SETUP_ERROR_INIT_FAILED;
-        }
+        .conversion_rate_hz = 1000000UL / ADC_CONVERSION_TIME_US,
+        .max_gap = RIPPLE_ANALYSER_MAX_GAP_CYCLES * ADC_SCAN_CYCLE_CONVERSIONS,
+        .block_order = RIPPLE_ANALYSER_BLOCK_ORDER,
+        .hysteresis = RIPPLE_ANALYSER_HYSTERESIS,
+        .ripple_per_mains_period = 2U,
+    };
+
+    /* Whole scan is described by config.h ADC scan table and loaded at once */
+    if ((RIPPLE_ANALYSER_ERROR_OK != ripple_analyser_init(&secondary_ripple, &ripple_config))
+    ||  (ADC_ERROR_OK != adc_load_scan_table(adc_scan_table, ADC_SCAN_CHANNEL_COUNT)))
+    {
+        ret = DRIVER_SETUP_ERROR_INIT_FAILED;
     }
-    return DRIVER_SETUP_ERROR_OK;
+    return ret;
 }
 
 static void bootup_sequence(void)
@@ -198,6 +323,13 @@ static void bootup_sequence(void)
     {
         error_handler();
     }
+
+    /* Tasks are released on timebase ticks, their run times are measured in microseconds */
+    scheduler_error_t scheduler_error = scheduler_init(tasks, sizeof(tasks) / sizeof(tasks[0]), scheduler_clock, scheduler_runtime_clock);
+    if (SCHEDULER_ERROR_OK != scheduler_error)
+    {
+        error_handler();
+    }
 }
 
 static void print_data(void)
@@ -29,20 +29,45 @@ along with this program.  If not, see <https://www.gnu.org/licenses/>.
 */
 
 #include "module_setup.h"
+#include "config.h"
 #include "timebase.h"
+#include "timebase_timer.h"
+#include "timer_8_bit_async.h"
+
+/* Millisecond timebase parameters are solved at build time, timer search loops do not run at boot */
+#define TIMEBASE_TICK_FREQUENCY_HZ 1000UL
+_Static_assert(TIMER_8_BIT_ASYNC_STATIC_ERROR_PPM(F_CPU, TIMEBASE_TICK_FREQUENCY_HZ) <= TIMEBASE_MAX_PERIOD_ERROR_PPM,
+               "Timebase tick period is too far from 1 ms with this CPU frequency");
+
+static const timebase_timer_parameters_t timebase_parameters =
+{
+    .prescaler = TIMER_8_BIT_ASYNC_STATIC_PRESCALER(F_CPU, TIMEBASE_TICK_FREQUENCY_HZ),
+    .ocr_value = TIMER_8_BIT_ASYNC_STATIC_OCR(F_CPU, TIMEBASE_TICK_FREQUENCY_HZ),
+    .accumulator = TIMER_8_BIT_ASYNC_STATIC_ACCUMULATOR(F_CPU, TIMEBASE_TICK_FREQUENCY_HZ),
+};
 
 module_setup_error_t module_init_timebase(void)
 {
     timebase_config_t config = {0};
-    config.cpu_freq = 16000000;
+    config.cpu_freq = F_CPU;
     config.timer.index = 0;
     config.timer.type = TIMEBASE_TIMER_8_BIT_ASYNC;
     config.timescale = TIMEBASE_TIMESCALE_MILLISECONDS;
+    // Control tasks run on every millisecond : a tickless timebase would wake the CPU up just as often
+    config.tickless = false;
+    config.parameters = &timebase_parameters;
     timebase_error_t err = timebase_init(0U, &config);
     if (TIMEBASE_ERROR_OK != err)
     {
         return MODULE_SETUP_ERROR_INIT_FAILED;
     }
+
+    // Software timers run on the millisecond timebase
+    err = timebase_timer_init(0U);
+    if (TIMEBASE_ERROR_OK != err)
+    {
+        return MODULE_SETUP_ERROR_INIT_FAILED;
+    }
     return MODULE_SETUP_ERROR_OK;
 }
 
@@ -0,0 +1,225 @@
+/*
+
+------------------
+@<FreeMyCode>
+FreeMyCode version : 1.0 RC alpha
+    Author : bebenlebricolo
+    License : 
+        name : GPLv3
+        url : https://www.gnu.org/licenses/quick-guide-gplv3.html
+    Date : 12/02/2021
+    Project : LabBenchPowerSupply
+    Description : The Lab Bench Power Supply provides a simple design based around an Arduino Nano board to convert AC main voltage into
+ smaller ones, ranging from 0V to 16V, with voltage and current regulations
+<FreeMyCode>@
+------------------
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+
+#include "AdcConversionSimulator.hpp"
+#include "adc_reg.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#define ADC_CONVERSION_CYCLES        13.0
+#define ADC_FIRST_CONVERSION_CYCLES  25.0
+#define ADC_SAMPLE_AND_HOLD_CYCLES   1.5
+#define ADC_INTERNAL_REFERENCE_VOLTAGE 1.1
+
+AdcConversionSimulator::AdcConversionSimulator(adc_register_stub_t& registers, const double cpu_frequency, const double reference_voltage)
+    : registers(registers), cpu_frequency(cpu_frequency), reference_voltage(reference_voltage)
+{
+}
+
+void AdcConversionSimulator::connect(const adc_mux_t channel, std::shared_ptr<SignalSource> source)
+{
+    sources[channel & MUX_MSK] = source;
+}
+
+double AdcConversionSimulator::adc_clock_period() const
+{
+    /* ADPS = 0 and ADPS = 1 both select a division factor of 2 */
+    const uint8_t adps = registers.adcsra_reg & ADPS_MSK;
+    const double division = (0U == adps) ? 2.0 : static_cast<double>(1U << adps);
+    return division / cpu_frequency;
+}
+
+bool AdcConversionSimulator::adc_enabled() const
+{
+    return 0 != (registers.adcsra_reg & ADEN_MSK);
+}
+
+bool AdcConversionSimulator::free_running() const
+{
+    return (0 != (registers.adcsra_reg & ADATE_MSK)) && (ADC_TRIGGER_FREE_RUNNING == (registers.adcsrb_reg & ADTS_MSK));
+}
+
+void AdcConversionSimulator::start_conversion()
+{
+    const double cycles = first_conversion ? ADC_FIRST_CONVERSION_CYCLES : ADC_CONVERSION_CYCLES;
+    const double clock = adc_clock_period();
+    latched_mux = registers.mux_reg & MUX_MSK;
+
+    /* Input is sampled right away, result is only made available at the end of conversion */
+    double voltage = 0.0;
+    if (nullptr != sources[latched_mux])
+    {
+        voltage = sources[latched_mux]->sample(time + ADC_SAMPLE_AND_HOLD_CYCLES * clock);
+    }
+    const double reference = (ADC_VOLTAGE_REF_INTERNAL_1V1 == ((registers.mux_reg & REF_MSK) >> REFS0)) ? ADC_INTERNAL_REFERENCE_VOLTAGE
+                                                                                                      : reference_voltage;
+    const double noise = sleeping ? 0.0 : digital_noise * noise_distribution(noise_generator);
+    const double code = std::floor((voltage * 1024.0 / reference) + noise);
+    latched_result = static_cast<uint16_t>(std::clamp(code, 0.0, 1023.0));
+
+    conversion_end = time + cycles * clock;
+    converting = true;
+    first_conversion = false;
+    registers.adcsra_reg |= ADSC_MSK;
+}
+
+void AdcConversionSimulator::complete_conversion()
+{
+    time = conversion_end;
+    converting = false;
+    conversion_count++;
+    last_channel = static_cast<adc_mux_t>(latched_mux);
+    last_result = latched_result;
+
+    const uint16_t aligned = (0 != (registers.mux_reg & ADLAR_MSK)) ? static_cast<uint16_t>(latched_result << 6U) : latched_result;
+    registers.readings.adclow_reg = static_cast<uint8_t>(aligned & 0xFF);
+    registers.readings.adchigh_reg = static_cast<uint8_t>(aligned >> 8U);
+    registers.adcsra_reg |= ADIF_MSK;
+
+    /* Free-running : next conversion starts right away and latches the mux before the ISR gets a chance to run */
+    if (free_running())
+    {
+        start_conversion();
+    }
+    else
+    {
+        registers.adcsra_reg &= ~ADSC_MSK;
+    }
+
+    if (0 != (registers.adcsra_reg & ADIE_MSK))
+    {
+        adc_isr_handler();
+    }
+    else
+    {
+        adc_process();
+    }
+}
+
+void AdcConversionSimulator::set_digital_noise(const double lsb_rms, const uint32_t seed)
+{
+    digital_noise = lsb_rms;
+    noise_generator.seed(seed);
+}
+
+bool AdcConversionSimulator::sleep()
+{
+    if (!adc_enabled())
+    {
+        return false;
+    }
+
+    /* Conversion is sampled with quiet clocks, CPU is awake again by the time the ISR runs */
+    if (!converting)
+    {
+        sleeping = true;
+        start_conversion();
+        sleeping = false;
+    }
+    sleep_conversion_count++;
+    complete_conversion();
+    return true;
+}
+
+uint64_t AdcConversionSimulator::get_sleep_conversion_count() const
+{
+    return sleep_conversion_count;
+}
+
+bool AdcConversionSimulator::step(const double time_limit)
+{
+    if (!adc_enabled())
+    {
+        converting = false;
+        first_conversion = true;
+        return false;
+    }
+
+    /* Single shot conversions (or the first free-running one) are started by the driver through ADSC */
+    if (!converting)
+    {
+        if (0 == (registers.adcsra_reg & ADSC_MSK))
+        {
+            return false;
+        }
+        start_conversion();
+    }
+
+    if (conversion_end > time_limit)
+    {
+        time = time_limit;
+        return false;
+    }
+    complete_conversion();
+    return true;
+}
+
+uint64_t AdcConversionSimulator::run_conversions(const uint64_t count)
+{
+    const uint64_t start = conversion_count;
+    while ((conversion_count - start < count) && step(std::numeric_limits<double>::infinity()))
+    {
+    }
+    return conversion_count - start;
+}
+
+uint64_t AdcConversionSimulator::run_for(const double duration)
+{
+    const uint64_t start = conversion_count;
+    const double end = time + duration;
+    while (step(end))
+    {
+    }
+    time = std::max(time, end);
+    return conversion_count - start;
+}
+
+double AdcConversionSimulator::get_time() const
+{
+    return time;
+}
+
+adc_mux_t AdcConversionSimulator::get_last_channel() const
+{
+    return last_channel;
+}
+
+uint16_t AdcConversionSimulator::get_last_result() const
+{
+    return last_result;
+}
+
+uint64_t AdcConversionSimulator::get_conversion_count() const
+{
+    return conversion_count;
+}
@@ -0,0 +1,139 @@
+/*
+
+------------------
+@<FreeMyCode>
+FreeMyCode version : 1.0 RC alpha
+    Author : bebenlebricolo
+    License : 
+        name : GPLv3
+        url : https://www.gnu.org/licenses/quick-guide-gplv3.html
+    Date : 12/02/2021
+    Project : LabBenchPowerSupply
+    Description : The Lab Bench Power Supply provides a simple design based around an Arduino Nano board to convert AC main voltage into
+ smaller ones, ranging from 0V to 16V, with voltage and current regulations
+<FreeMyCode>@
+------------------
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+
+#ifndef ADC_CONVERSION_SIMULATOR_HEADER
+#define ADC_CONVERSION_SIMULATOR_HEADER
+
+#include "adc.h"
+#include "adc_register_stub.h"
+#include "SignalSource.hpp"
+
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <random>
+
+/**
+ * @brief drives adc_register_stub as the ADC peripheral would : signal sources are sampled on the channel latched
+ * by each conversion, results are written to ADCL/ADCH and conversion complete events are raised with the actual
+ * peripheral timings, so that adc_isr_handler() (interrupt mode) or adc_process() (polling mode) run as on the MCU.
+ *
+ * Modelled behavior :
+ *  - conversions last 13 ADC clock cycles (25 for the first one after the ADC is enabled), ADC clock being
+ *    cpu_frequency / prescaler (read from ADCSRA)
+ *  - mux register is latched when a conversion starts ; free-running conversions restart as soon as the previous
+ *    one is finished, before the ISR runs, whereas single shot conversions start when the driver sets ADSC
+ *  - input is sampled 1.5 ADC clock cycles after conversion start, and converted against the internal 1.1V reference
+ *    or reference_voltage (AVCC and AREF pin), as selected by REFS bits latched with the mux. Reference settling
+ *    time is not modelled
+ *  - result is left or right aligned depending on ADLAR
+ *  - digital noise coupled by CPU and I/O clocks (@see set_digital_noise()) is added to conversions sampled while the
+ *    CPU runs, but not to the ones started by entering ADC noise reduction sleep (@see sleep())
+ * Interrupt latency and ISR execution time are not modelled.
+*/
+class AdcConversionSimulator
+{
+public:
+    AdcConversionSimulator(adc_register_stub_t& registers, const double cpu_frequency, const double reference_voltage);
+
+    /**
+     * @brief connects a signal source to a mux channel. Unconnected channels read 0V (GND)
+    */
+    void connect(const adc_mux_t channel, std::shared_ptr<SignalSource> source);
+
+    /**
+     * @brief runs the simulation until the given number of conversions are completed (or ADC gets disabled)
+     * @return number of completed conversions
+    */
+    uint64_t run_conversions(const uint64_t count);
+
+    /**
+     * @brief runs the simulation for the given duration (seconds)
+     * @return number of completed conversions
+    */
+    uint64_t run_for(const double duration);
+
+    /**
+     * @brief sets the gaussian noise (LSB rms) added to conversions sampled while the CPU and I/O clocks run
+    */
+    void set_digital_noise(const double lsb_rms, const uint32_t seed = 1U);
+
+    /**
+     * @brief models sleep_mode() with SLEEP_MODE_ADC : entering sleep starts a conversion if the ADC is enabled and idle,
+     * then CPU sleeps until the conversion complete interrupt wakes it up. A conversion which was already running
+     * before entering sleep keeps the noise it was sampled with
+     * @return true if CPU was woken up by a completed conversion (false : ADC is disabled, CPU would sleep forever)
+    */
+    bool sleep();
+
+    /* Number of conversions completed while sleeping */
+    uint64_t get_sleep_conversion_count() const;
+
+    /* Current simulated time, in seconds */
+    double get_time() const;
+
+    /* Mux channel and 10 bits result of the last completed conversion */
+    adc_mux_t get_last_channel() const;
+    uint16_t get_last_result() const;
+
+    /* Total number of completed conversions */
+    uint64_t get_conversion_count() const;
+
+private:
+    adc_register_stub_t& registers;
+    double cpu_frequency;
+    double reference_voltage;
+    std::array<std::shared_ptr<SignalSource>, 16> sources {};
+
+    double time = 0.0;
+    bool converting = false;
+    bool first_conversion = true;
+    double conversion_end = 0.0;
+    uint8_t latched_mux = 0;
+    uint16_t latched_result = 0;
+    adc_mux_t last_channel = ADC_MUX_ADC0;
+    uint16_t last_result = 0;
+    uint64_t conversion_count = 0;
+    uint64_t sleep_conversion_count = 0;
+    bool sleeping = false;
+    double digital_noise = 0.0;
+    std::mt19937 noise_generator {1U};
+    std::normal_distribution<double> noise_distribution {0.0, 1.0};
+
+    double adc_clock_period() const;
+    bool adc_enabled() const;
+    bool free_running() const;
+    void start_conversion();
+    void complete_conversion();
+    bool step(const double time_limit);
+};
+
+#endif /* ADC_CONVERSION_SIMULATOR_HEADER */
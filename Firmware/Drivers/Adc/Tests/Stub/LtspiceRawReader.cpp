@@ -0,0 +1,324 @@
+/*
+
+------------------
+@<FreeMyCode>
+FreeMyCode version : 1.0 RC alpha
+    Author : bebenlebricolo
+    License : 
+        name : GPLv3
+        url : https://www.gnu.org/licenses/quick-guide-gplv3.html
+    Date : 12/02/2021
+    Project : LabBenchPowerSupply
+    Description : The Lab Bench Power Supply provides a simple design based around an Arduino Nano board to convert AC main voltage into
+ smaller ones, ranging from 0V to 16V, with voltage and current regulations
+<FreeMyCode>@
+------------------
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+
+#include "LtspiceRawReader.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <sstream>
+#include <stdexcept>
+
+static std::string to_lower(std::string text)
+{
+    std::transform(text.begin(), text.end(), text.begin(), [](unsigned char c){ return std::tolower(c); });
+    return text;
+}
+
+static bool starts_with(const std::string& text, const std::string& prefix)
+{
+    return 0 == text.compare(0, prefix.size(), prefix);
+}
+
+/* Number conversions throw on malformed text : a broken file is reported through the reader status instead */
+static bool parse_count(const std::string& text, size_t& count)
+{
+    try
+    {
+        count = std::stoul(text);
+    }
+    catch (const std::logic_error&)
+    {
+        return false;
+    }
+    return true;
+}
+
+static bool parse_value(const std::string& text, double& value)
+{
+    try
+    {
+        value = std::stod(text);
+    }
+    catch (const std::logic_error&)
+    {
+        return false;
+    }
+    return true;
+}
+
+LtspiceRawReader::LtspiceRawReader(const std::string& path)
+    : file(path, std::ios::binary)
+{
+    if (!file.is_open())
+    {
+        status = Status::FileNotFound;
+    }
+    else
+    {
+        /* LTspice writes UTF-16LE headers : second byte of "Title:" is a null character */
+        char bom[2] = {0};
+        file.read(bom, 2);
+        wide_header = ('\0' == bom[1]);
+        file.seekg(0);
+        if (parse_header())
+        {
+            data_start = file.tellg();
+            rewind();
+        }
+    }
+}
+
+bool LtspiceRawReader::read_line(std::string& line)
+{
+    line.clear();
+    char c = 0;
+    while (file.get(c))
+    {
+        if (wide_header)
+        {
+            char high = 0;
+            file.get(high);
+        }
+        if ('\n' == c)
+        {
+            return true;
+        }
+        if ('\r' != c)
+        {
+            line.push_back(c);
+        }
+    }
+    return !line.empty();
+}
+
+bool LtspiceRawReader::parse_header()
+{
+    std::string line;
+    size_t variable_count = 0;
+    bool point_count_found = false;
+    while (read_line(line))
+    {
+        const std::string lower = to_lower(line);
+        if (starts_with(lower, "flags:"))
+        {
+            if ((std::string::npos != lower.find("complex")) || (std::string::npos != lower.find("fastaccess")))
+            {
+                status = Status::Unsupported;
+                return false;
+            }
+            double_precision = (std::string::npos != lower.find("double"));
+        }
+        else if (starts_with(lower, "no. variables:"))
+        {
+            if (!parse_count(line.substr(line.find(':') + 1U), variable_count))
+            {
+                return false;
+            }
+        }
+        else if (starts_with(lower, "no. points:"))
+        {
+            if (!parse_count(line.substr(line.find(':') + 1U), point_count))
+            {
+                return false;
+            }
+            point_count_found = true;
+        }
+        else if (starts_with(lower, "variables:"))
+        {
+            for (size_t i = 0; i < variable_count; i++)
+            {
+                std::string index, name;
+                if (!read_line(line) || !(std::istringstream(line) >> index >> name))
+                {
+                    return false;
+                }
+                variables.push_back(name);
+            }
+        }
+        else if (starts_with(lower, "binary:") || starts_with(lower, "values:"))
+        {
+            binary = starts_with(lower, "binary:");
+            if ((0U == variable_count) || (variables.size() != variable_count) || !point_count_found)
+            {
+                return false;
+            }
+            status = Status::Ok;
+            return true;
+        }
+    }
+    return false;
+}
+
+bool LtspiceRawReader::read_point(std::vector<double>& values)
+{
+    if (next_point >= point_count)
+    {
+        return false;
+    }
+    values.resize(variables.size());
+
+    if (binary)
+    {
+        /* Time (first variable) is always stored as a double, other ones are floats unless the "double" flag is set */
+        for (size_t i = 0; i < variables.size(); i++)
+        {
+            if ((0U == i) || double_precision)
+            {
+                double value = 0.0;
+                file.read(reinterpret_cast<char*>(&value), sizeof(value));
+                values[i] = value;
+            }
+            else
+            {
+                float value = 0.0F;
+                file.read(reinterpret_cast<char*>(&value), sizeof(value));
+                values[i] = value;
+            }
+        }
+    }
+    else
+    {
+        /* Point index, followed by one value per variable, separated by white spaces */
+        std::string line;
+        const size_t expected = variables.size() + 1U;
+        size_t count = 0;
+        while ((count < expected) && read_line(line))
+        {
+            std::istringstream stream(line);
+            std::string token;
+            while ((count < expected) && (stream >> token))
+            {
+                if ((0U != count) && !parse_value(token, values[count - 1U]))
+                {
+                    return false;
+                }
+                count++;
+            }
+        }
+        if (count != expected)
+        {
+            return false;
+        }
+    }
+
+    /* Compressed transient traces flag some points with a negative time */
+    values[0] = std::fabs(values[0]);
+    next_point++;
+    return !file.fail();
+}
+
+void LtspiceRawReader::rewind()
+{
+    file.clear();
+    file.seekg(data_start);
+    next_point = 0;
+    previous.clear();
+    next.clear();
+    if (read_point(next))
+    {
+        previous = next;
+    }
+}
+
+LtspiceRawReader::Status LtspiceRawReader::get_status() const
+{
+    return status;
+}
+
+const std::vector<std::string>& LtspiceRawReader::get_variables() const
+{
+    return variables;
+}
+
+size_t LtspiceRawReader::get_point_count() const
+{
+    return point_count;
+}
+
+int LtspiceRawReader::find_variable(const std::string& name) const
+{
+    const std::string lower = to_lower(name);
+    for (size_t i = 0; i < variables.size(); i++)
+    {
+        if (to_lower(variables[i]) == lower)
+        {
+            return static_cast<int>(i);
+        }
+    }
+    return -1;
+}
+
+double LtspiceRawReader::interpolate(const size_t variable, const double time)
+{
+    if ((Status::Ok != status) || (variable >= variables.size()) || next.empty())
+    {
+        return 0.0;
+    }
+
+    if (time < previous[0])
+    {
+        rewind();
+    }
+    std::vector<double> point;
+    while ((next[0] <= time) && read_point(point))
+    {
+        previous.swap(next);
+        next.swap(point);
+    }
+
+    /* Before first point or past the end of the trace */
+    if ((time <= previous[0]) || (next[0] <= time) || (next[0] == previous[0]))
+    {
+        return (time <= previous[0]) ? previous[variable] : next[variable];
+    }
+    return previous[variable] + (next[variable] - previous[variable]) * (time - previous[0]) / (next[0] - previous[0]);
+}
+
+LtspiceSource::LtspiceSource(std::shared_ptr<LtspiceRawReader> reader, const std::string& variable, const double scale,
+                             const double time_offset)
+    : reader(reader), variable(reader->find_variable(variable)), scale(scale), time_offset(time_offset)
+{
+}
+
+bool LtspiceSource::is_valid() const
+{
+    return (LtspiceRawReader::Status::Ok == reader->get_status()) && (0 <= variable);
+}
+
+double LtspiceSource::sample(const double time)
+{
+    if (!is_valid())
+    {
+        return 0.0;
+    }
+    return scale * reader->interpolate(static_cast<size_t>(variable), time + time_offset);
+}
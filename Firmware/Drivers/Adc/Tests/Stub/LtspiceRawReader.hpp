@@ -0,0 +1,115 @@
+/*
+
+------------------
+@<FreeMyCode>
+FreeMyCode version : 1.0 RC alpha
+    Author : bebenlebricolo
+    License : 
+        name : GPLv3
+        url : https://www.gnu.org/licenses/quick-guide-gplv3.html
+    Date : 12/02/2021
+    Project : LabBenchPowerSupply
+    Description : The Lab Bench Power Supply provides a simple design based around an Arduino Nano board to convert AC main voltage into
+ smaller ones, ranging from 0V to 16V, with voltage and current regulations
+<FreeMyCode>@
+------------------
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+
+#ifndef LTSPICE_RAW_READER_HEADER
+#define LTSPICE_RAW_READER_HEADER
+
+#include "SignalSource.hpp"
+
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+
+/**
+ * @brief streams points of a LTspice transient analysis .raw file (binary or ASCII, UTF-16 or 8 bits header)
+ * Only the two points surrounding the last requested time are kept in memory, so traces of any size can be
+ * replayed. Time is expected to be requested in increasing order : going backward rewinds the file.
+*/
+class LtspiceRawReader
+{
+public:
+    enum class Status
+    {
+        Ok,             /**< File is opened and its header is understood                     */
+        FileNotFound,   /**< File could not be opened                                        */
+        BadHeader,      /**< Header is truncated or malformed                                */
+        Unsupported,    /**< Complex data (AC analysis) or fast access layout is not handled */
+    };
+
+    explicit LtspiceRawReader(const std::string& path);
+
+    Status get_status() const;
+    const std::vector<std::string>& get_variables() const;
+    size_t get_point_count() const;
+
+    /**
+     * @brief finds a variable by name (case insensitive, e.g. "V(5v)")
+     * @return variable index or -1 if not found
+    */
+    int find_variable(const std::string& name) const;
+
+    /**
+     * @brief linearly interpolates a variable at given time. Value is held before the first and after the last point
+    */
+    double interpolate(const size_t variable, const double time);
+
+private:
+    std::ifstream file;
+    Status status = Status::BadHeader;
+    bool wide_header = false;
+    bool binary = false;
+    bool double_precision = false;
+    std::vector<std::string> variables;
+    size_t point_count = 0;
+    std::streampos data_start;
+
+    size_t next_point = 0;
+    std::vector<double> previous;
+    std::vector<double> next;
+
+    bool read_line(std::string& line);
+    bool parse_header();
+    bool read_point(std::vector<double>& values);
+    void rewind();
+};
+
+/**
+ * @brief replays a node voltage of a LTspice trace as an ADC input, scaled by the input divider ratio.
+ * Several sources may share the same reader (one per probed node), as long as they are sampled with increasing time
+*/
+class LtspiceSource : public SignalSource
+{
+public:
+    LtspiceSource(std::shared_ptr<LtspiceRawReader> reader, const std::string& variable, const double scale = 1.0,
+                  const double time_offset = 0.0);
+    double sample(const double time) override;
+    bool is_valid() const;
+
+private:
+    std::shared_ptr<LtspiceRawReader> reader;
+    int variable;
+    double scale;
+    double time_offset;
+};
+
+#endif /* LTSPICE_RAW_READER_HEADER */
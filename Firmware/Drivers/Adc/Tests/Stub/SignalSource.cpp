@@ -0,0 +1,156 @@
+/*
+
+------------------
+@<FreeMyCode>
+FreeMyCode version : 1.0 RC alpha
+    Author : bebenlebricolo
+    License : 
+        name : GPLv3
+        url : https://www.gnu.org/licenses/quick-guide-gplv3.html
+    Date : 12/02/2021
+    Project : LabBenchPowerSupply
+    Description : The Lab Bench Power Supply provides a simple design based around an Arduino Nano board to convert AC main voltage into
+ smaller ones, ranging from 0V to 16V, with voltage and current regulations
+<FreeMyCode>@
+------------------
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+
+#include "SignalSource.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <sstream>
+
+DcSource::DcSource(const double value) : value(value)
+{
+}
+
+double DcSource::sample(const double time)
+{
+    (void) time;
+    return value;
+}
+
+RampSource::RampSource(const double start, const double end, const double duration)
+    : start(start), end(end), duration(duration)
+{
+}
+
+double RampSource::sample(const double time)
+{
+    if (time >= duration)
+    {
+        return end;
+    }
+    return start + (end - start) * (time / duration);
+}
+
+SineSource::SineSource(const double offset, const double amplitude, const double frequency,
+                       const double ripple_amplitude, const double ripple_frequency)
+    : offset(offset), amplitude(amplitude), frequency(frequency),
+      ripple_amplitude(ripple_amplitude), ripple_frequency(ripple_frequency)
+{
+}
+
+double SineSource::sample(const double time)
+{
+    return offset
+         + amplitude * std::sin(2.0 * M_PI * frequency * time)
+         + ripple_amplitude * std::sin(2.0 * M_PI * ripple_frequency * time);
+}
+
+StepSource::StepSource(const double before, const double after, const double step_time)
+    : before(before), after(after), step_time(step_time)
+{
+}
+
+double StepSource::sample(const double time)
+{
+    return (time < step_time) ? before : after;
+}
+
+NoiseSource::NoiseSource(std::shared_ptr<SignalSource> base, const double sigma, const uint32_t seed)
+    : base(base), generator(seed), distribution(0.0, sigma)
+{
+}
+
+double NoiseSource::sample(const double time)
+{
+    return base->sample(time) + distribution(generator);
+}
+
+CsvSource::CsvSource(const std::string& path)
+{
+    std::ifstream file(path);
+    load(file);
+}
+
+CsvSource::CsvSource(std::istream& stream)
+{
+    load(stream);
+}
+
+void CsvSource::load(std::istream& stream)
+{
+    std::string line;
+    while (std::getline(stream, line))
+    {
+        if (line.empty() || '#' == line[0])
+        {
+            continue;
+        }
+        std::replace(line.begin(), line.end(), ',', ' ');
+        std::istringstream fields(line);
+        Point point;
+        if (fields >> point.time >> point.value)
+        {
+            points.push_back(point);
+        }
+    }
+}
+
+size_t CsvSource::size() const
+{
+    return points.size();
+}
+
+double CsvSource::sample(const double time)
+{
+    if (points.empty())
+    {
+        return 0.0;
+    }
+
+    /* Samples are requested with an increasing time most of the time : resume search from last position */
+    if (time < points[cursor].time)
+    {
+        cursor = 0;
+    }
+    while ((cursor + 1U < points.size()) && (points[cursor + 1U].time <= time))
+    {
+        cursor++;
+    }
+
+    const Point& previous = points[cursor];
+    if ((cursor + 1U == points.size()) || (time <= previous.time))
+    {
+        return previous.value;
+    }
+    const Point& next = points[cursor + 1U];
+    return previous.value + (next.value - previous.value) * (time - previous.time) / (next.time - previous.time);
+}
@@ -0,0 +1,153 @@
+/*
+
+------------------
+@<FreeMyCode>
+FreeMyCode version : 1.0 RC alpha
+    Author : bebenlebricolo
+    License : 
+        name : GPLv3
+        url : https://www.gnu.org/licenses/quick-guide-gplv3.html
+    Date : 12/02/2021
+    Project : LabBenchPowerSupply
+    Description : The Lab Bench Power Supply provides a simple design based around an Arduino Nano board to convert AC main voltage into
+ smaller ones, ranging from 0V to 16V, with voltage and current regulations
+<FreeMyCode>@
+------------------
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+
+#ifndef SIGNAL_SOURCE_HEADER
+#define SIGNAL_SOURCE_HEADER
+
+#include <cstdint>
+#include <istream>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+/**
+ * @brief analog signal seen by an ADC input, sampled at an arbitrary time (seconds). Values are in volts
+*/
+class SignalSource
+{
+public:
+    virtual ~SignalSource() = default;
+    virtual double sample(const double time) = 0;
+};
+
+/**
+ * @brief constant voltage
+*/
+class DcSource : public SignalSource
+{
+public:
+    explicit DcSource(const double value);
+    double sample(const double time) override;
+
+private:
+    double value;
+};
+
+/**
+ * @brief goes linearly from start to end in duration seconds, then stays at end
+*/
+class RampSource : public SignalSource
+{
+public:
+    RampSource(const double start, const double end, const double duration);
+    double sample(const double time) override;
+
+private:
+    double start;
+    double end;
+    double duration;
+};
+
+/**
+ * @brief sine wave on top of a DC offset, with an optional ripple component (e.g. switching or mains ripple)
+*/
+class SineSource : public SignalSource
+{
+public:
+    SineSource(const double offset, const double amplitude, const double frequency,
+               const double ripple_amplitude = 0.0, const double ripple_frequency = 0.0);
+    double sample(const double time) override;
+
+private:
+    double offset;
+    double amplitude;
+    double frequency;
+    double ripple_amplitude;
+    double ripple_frequency;
+};
+
+/**
+ * @brief jumps from before to after when step_time is reached
+*/
+class StepSource : public SignalSource
+{
+public:
+    StepSource(const double before, const double after, const double step_time);
+    double sample(const double time) override;
+
+private:
+    double before;
+    double after;
+    double step_time;
+};
+
+/**
+ * @brief adds gaussian noise to another source. Seeded, so that tests are reproducible
+*/
+class NoiseSource : public SignalSource
+{
+public:
+    NoiseSource(std::shared_ptr<SignalSource> base, const double sigma, const uint32_t seed = 0U);
+    double sample(const double time) override;
+
+private:
+    std::shared_ptr<SignalSource> base;
+    std::mt19937 generator;
+    std::normal_distribution<double> distribution;
+};
+
+/**
+ * @brief replays a recorded trace made of "time,value" lines (seconds, volts). Lines which cannot be parsed
+ * (header, comments starting with '#') are skipped. Values are linearly interpolated between points and held
+ * before the first and after the last point.
+*/
+class CsvSource : public SignalSource
+{
+public:
+    explicit CsvSource(const std::string& path);
+    explicit CsvSource(std::istream& stream);
+    double sample(const double time) override;
+    size_t size() const;
+
+private:
+    struct Point
+    {
+        double time;
+        double value;
+    };
+    std::vector<Point> points;
+    size_t cursor = 0;
+
+    void load(std::istream& stream);
+};
+
+#endif /* SIGNAL_SOURCE_HEADER */
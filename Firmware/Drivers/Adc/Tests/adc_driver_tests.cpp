@@ -64,6 +64,7 @@ protected:
         config.supply_voltage_mv = 5000;
         config.trigger_sources = ADC_TRIGGER_EXT_INT_REQUEST_0;
         config.using_interrupt = true;
+        config.supply_monitoring_period = 0;
         adc_register_stub_init_adc_handle(&config.handle, &adc_register_stub);
     }
     void TearDown() override
@@ -256,6 +257,1159 @@ TEST_F(AdcTestFixture, adc_isr_test)
     }
 }
 
+TEST_F(AdcTestFixture, adc_free_running_pipeline_test)
+{
+    const uint8_t channels = 3U;
+    const uint8_t max_values = channels * 10U;
+    config.running_mode = ADC_RUNNING_MODE_AUTOTRIGGERED;
+    config.trigger_sources = ADC_TRIGGER_FREE_RUNNING;
+    config.using_interrupt = true;
+    const auto& init_result = adc_base_init(&config);
+    ASSERT_EQ(init_result, ADC_ERROR_OK);
+    ASSERT_NE(0, adc_register_stub.adcsra_reg & ADATE_MSK);
+
+    ASSERT_EQ(adc_register_channel(ADC_MUX_ADC0), ADC_ERROR_OK);
+    ASSERT_EQ(adc_register_channel(ADC_MUX_ADC1), ADC_ERROR_OK);
+    ASSERT_EQ(adc_register_channel(ADC_MUX_ADC2), ADC_ERROR_OK);
+
+    ASSERT_EQ(ADC_STATE_READY, adc_start());
+    ASSERT_EQ(ADC_MUX_ADC0, adc_register_stub.mux_reg & MUX_MSK);
+
+    /* Mimics the hardware : a conversion latches the mux register when it starts, which happens as soon as
+    the previous conversion ends (right before the ISR is executed) */
+    uint8_t latched_channel = adc_register_stub.mux_reg & MUX_MSK;
+    for (uint8_t i = 0; i < max_values ; i++)
+    {
+        const uint16_t value = (uint16_t)(latched_channel * 100U + i);
+        const uint8_t next_latched_channel = adc_register_stub.mux_reg & MUX_MSK;
+        adc_register_stub.readings.adclow_reg = (uint8_t) (value & 0xFF);
+        adc_register_stub.readings.adchigh_reg = (uint8_t) ((value & 0x0300) >> 8U);
+
+        /* ADSC is left untouched by the driver in free-running mode */
+        adc_register_stub.adcsra_reg &= ~(ADSC_MSK);
+        adc_register_stub.adcsra_reg |= (ADIF_MSK);
+        adc_isr_handler();
+        EXPECT_EQ(0, adc_register_stub.adcsra_reg & ADSC_MSK);
+        EXPECT_EQ(0, adc_register_stub.adcsra_reg & ADIF_MSK);
+
+        adc_result_t result;
+        const auto& read_result = adc_read_raw((adc_mux_t) latched_channel, &result);
+        EXPECT_EQ(read_result, ADC_ERROR_OK);
+        EXPECT_EQ(value, result);
+        latched_channel = next_latched_channel;
+    }
+}
+
+TEST_F(AdcTestFixture, adc_free_running_polling_test)
+{
+    config.running_mode = ADC_RUNNING_MODE_AUTOTRIGGERED;
+    config.trigger_sources = ADC_TRIGGER_FREE_RUNNING;
+    config.using_interrupt = false;
+    ASSERT_EQ(adc_base_init(&config), ADC_ERROR_OK);
+    ASSERT_EQ(adc_register_channel(ADC_MUX_ADC3), ADC_ERROR_OK);
+    ASSERT_EQ(ADC_STATE_READY, adc_start());
+
+    /* No conversion is finished yet : nothing shall be fetched */
+    adc_register_stub.readings.adclow_reg = 0x12;
+    adc_register_stub.readings.adchigh_reg = 0x01;
+    ASSERT_EQ(ADC_STATE_READY, adc_process());
+    adc_result_t result = 0;
+    ASSERT_EQ(ADC_ERROR_OK, adc_read_raw(ADC_MUX_ADC3, &result));
+    ASSERT_EQ(0U, result);
+
+    adc_register_stub.adcsra_reg |= (ADIF_MSK);
+    ASSERT_EQ(ADC_STATE_READY, adc_process());
+    ASSERT_EQ(ADC_ERROR_OK, adc_read_raw(ADC_MUX_ADC3, &result));
+    ASSERT_EQ(0x112U, result);
+}
+static void set_stub_reading(const uint16_t value)
+{
+    adc_register_stub.readings.adclow_reg = (uint8_t) (value & 0xFF);
+    adc_register_stub.readings.adchigh_reg = (uint8_t) ((value & 0x0300) >> 8U);
+    adc_register_stub.adcsra_reg &= ~(ADSC_MSK);
+    adc_register_stub.adcsra_reg |= (ADIF_MSK);
+}
+
+TEST_F(AdcTestFixture, adc_millivolt_conversion_matches_division)
+{
+    const adc_voltage_ref_t refs[3] = {ADC_VOLTAGE_REF_INTERNAL_1V1, ADC_VOLTAGE_REF_AVCC, ADC_VOLTAGE_REF_AREF_PIN};
+    const uint16_t supplies[4] = {5000U, 4750U, 3300U, 5250U};
+    for (const auto& ref : refs)
+    {
+        for (const auto& supply : supplies)
+        {
+            config.ref = ref;
+            config.supply_voltage_mv = supply;
+            ASSERT_EQ(ADC_ERROR_OK, adc_base_init(&config));
+            ASSERT_EQ(ADC_ERROR_OK, adc_register_channel(ADC_MUX_ADC0));
+            const uint32_t reference_mv = (ADC_VOLTAGE_REF_INTERNAL_1V1 == ref) ? 1100U : supply;
+
+            for (uint16_t raw = 0 ; raw < 1024U ; raw++)
+            {
+                set_stub_reading(raw);
+                adc_isr_handler();
+                adc_millivolts_t reading = 0;
+                ASSERT_EQ(ADC_ERROR_OK, adc_read_millivolt(ADC_MUX_ADC0, &reading));
+                /* Former implementation, using a 32 bits division */
+                ASSERT_EQ((uint16_t)(((uint32_t) raw * reference_mv) / 1024U), reading);
+            }
+            adc_base_deinit();
+        }
+    }
+}
+
+TEST_F(AdcTestFixture, adc_millivolt_wrong_reference)
+{
+    config.ref = (adc_voltage_ref_t) 0x02;
+    ASSERT_EQ(ADC_ERROR_CONFIG, adc_base_init(&config));
+    ASSERT_EQ(ADC_STATE_NOT_INITIALISED, adc_start());
+}
+
+TEST_F(AdcTestFixture, adc_read_millivolt_all_test)
+{
+    const uint16_t values[3] = {1023U, 512U, 17U};
+    config.ref = ADC_VOLTAGE_REF_AVCC;
+    config.supply_voltage_mv = 5000U;
+    ASSERT_EQ(ADC_ERROR_OK, adc_base_init(&config));
+    ASSERT_EQ(ADC_ERROR_OK, adc_register_channel(ADC_MUX_ADC0));
+    ASSERT_EQ(ADC_ERROR_OK, adc_register_channel(ADC_MUX_ADC4));
+    ASSERT_EQ(ADC_ERROR_OK, adc_register_channel(ADC_MUX_ADC2));
+
+    for (const auto& value : values)
+    {
+        set_stub_reading(value);
+        adc_isr_handler();
+    }
+
+    adc_mux_t channels[ADC_MUX_COUNT] = {};
+    adc_millivolts_t readings[ADC_MUX_COUNT] = {};
+    uint8_t count = ADC_MUX_COUNT;
+    ASSERT_EQ(ADC_ERROR_OK, adc_read_millivolt_all(channels, readings, &count));
+    ASSERT_EQ(3U, count);
+    ASSERT_EQ(ADC_MUX_ADC0, channels[0]);
+    ASSERT_EQ(ADC_MUX_ADC4, channels[1]);
+    ASSERT_EQ(ADC_MUX_ADC2, channels[2]);
+    for (uint8_t i = 0 ; i < count ; i++)
+    {
+        adc_millivolts_t single = 0;
+        ASSERT_EQ(ADC_ERROR_OK, adc_read_millivolt(channels[i], &single));
+        ASSERT_EQ(single, readings[i]);
+        ASSERT_EQ((uint16_t)(((uint32_t) values[i] * 5000U) / 1024U), readings[i]);
+    }
+
+    /* Capacity is honored, channels array is optional */
+    count = 2U;
+    ASSERT_EQ(ADC_ERROR_OK, adc_read_millivolt_all(NULL, readings, &count));
+    ASSERT_EQ(2U, count);
+    ASSERT_EQ(ADC_ERROR_NULL_POINTER, adc_read_millivolt_all(channels, NULL, &count));
+    ASSERT_EQ(ADC_ERROR_NULL_POINTER, adc_read_millivolt_all(channels, readings, NULL));
+}
+TEST_F(AdcTestFixture, adc_supply_monitoring_test)
+{
+    config.ref = ADC_VOLTAGE_REF_AVCC;
+    config.supply_voltage_mv = 5000U;
+    config.supply_monitoring_period = 4U;
+    ASSERT_EQ(ADC_ERROR_OK, adc_base_init(&config));
+    ASSERT_EQ(ADC_ERROR_OK, adc_register_channel(ADC_MUX_ADC0));
+    ASSERT_EQ(ADC_STATE_READY, adc_start());
+
+    /* Nothing measured yet : configured supply is used */
+    adc_millivolts_t supply = 0;
+    ASSERT_EQ(ADC_ERROR_OK, adc_get_supply_voltage(&supply));
+    ASSERT_EQ(5000U, supply);
+
+    /* Actual AVCC is 4.6V : bandgap reads 1100 * 1024 / 4600 = 244, and a 2.3V input reads 512 */
+    const uint16_t bandgap_raw = 244U;
+    const uint16_t adc0_raw = 512U;
+    uint8_t bandgap_conversions = 0;
+    bool was_bandgap = false;
+    for (uint8_t i = 0 ; i < 28U ; i++)
+    {
+        const bool is_bandgap = (ADC_MUX_1v1_REF == (adc_register_stub.mux_reg & MUX_MSK));
+        bandgap_conversions += is_bandgap ? 1U : 0U;
+        /* Sample and hold capacitor still holds ADC0 voltage right after the switch */
+        set_stub_reading((is_bandgap && was_bandgap) ? bandgap_raw : adc0_raw);
+        was_bandgap = is_bandgap;
+        adc_isr_handler();
+    }
+    /* Bandgap is selected once every 4 scan cycles, for its settling conversions plus the kept one :
+    28 conversions = 4 x 3 bandgap + 16 ADC0 */
+    ASSERT_EQ(4U * (ADC_BANDGAP_SETTLING_CONVERSIONS + 1U), bandgap_conversions);
+
+    ASSERT_EQ(ADC_ERROR_OK, adc_get_supply_voltage(&supply));
+    ASSERT_EQ((1100U * 1024U) / bandgap_raw, supply);
+
+    adc_millivolts_t reading = 0;
+    ASSERT_EQ(ADC_ERROR_OK, adc_read_millivolt(ADC_MUX_ADC0, &reading));
+    const uint32_t expected = ((uint32_t) adc0_raw * 1100U) / bandgap_raw;
+    ASSERT_NEAR(expected, reading, 1U);
+    ASSERT_NEAR(2308U, reading, 1U);
+}
+
+TEST_F(AdcTestFixture, adc_supply_monitoring_discards_implausible_readings)
+{
+    config.ref = ADC_VOLTAGE_REF_AVCC;
+    config.supply_voltage_mv = 5000U;
+    config.supply_monitoring_period = 1U;
+    ASSERT_EQ(ADC_ERROR_OK, adc_base_init(&config));
+    ASSERT_EQ(ADC_STATE_READY, adc_start());
+
+    /* Only the bandgap is scanned, reading a grounded value */
+    for (uint8_t i = 0 ; i < (ADC_BANDGAP_SETTLING_CONVERSIONS + 1U) ; i++)
+    {
+        set_stub_reading(3U);
+        adc_isr_handler();
+    }
+    adc_millivolts_t supply = 0;
+    ASSERT_EQ(ADC_ERROR_OK, adc_get_supply_voltage(&supply));
+    ASSERT_EQ(5000U, supply);
+}
+
+TEST_F(AdcTestFixture, adc_channel_filter_test)
+{
+    adc_filter_t median_filter;
+    const adc_filter_config_t median_config = {ADC_FILTER_MEDIAN_3, 0};
+    ASSERT_EQ(ADC_ERROR_OK, adc_base_init(&config));
+    ASSERT_EQ(ADC_ERROR_OK, adc_register_channel(ADC_MUX_ADC0));
+    ASSERT_EQ(ADC_ERROR_OK, adc_register_channel(ADC_MUX_ADC1));
+
+    ASSERT_EQ(ADC_ERROR_CHANNEL_NOT_FOUND, adc_set_channel_filter(ADC_MUX_ADC5, &median_filter, &median_config));
+    ASSERT_EQ(ADC_ERROR_NULL_POINTER, adc_set_channel_filter(ADC_MUX_ADC0, &median_filter, NULL));
+    const adc_filter_config_t wrong_config = {ADC_FILTER_EMA, ADC_FILTER_EMA_MAX_ORDER + 1U};
+    ASSERT_EQ(ADC_ERROR_CONFIG, adc_set_channel_filter(ADC_MUX_ADC0, &median_filter, &wrong_config));
+    ASSERT_EQ(ADC_ERROR_OK, adc_set_channel_filter(ADC_MUX_ADC0, &median_filter, &median_config));
+    /* Interrupt enable bit is restored */
+    ASSERT_NE(0, adc_register_stub.adcsra_reg & ADIE_MSK);
+    ASSERT_EQ(ADC_STATE_READY, adc_start());
+
+    /* Conversions alternate between ADC0 and ADC1, a spike is injected on both channels but only rejected on ADC0 */
+    const uint16_t adc0_values[4] = {300U, 1000U, 302U, 303U};
+    const uint16_t adc0_filtered[4] = {300U, 300U, 302U, 303U};
+    const uint16_t adc1_values[4] = {600U, 0U, 602U, 603U};
+    adc_result_t raw = 0;
+    adc_result_t filtered = 0;
+    for (uint8_t i = 0 ; i < 4U ; i++)
+    {
+        set_stub_reading(adc0_values[i]);
+        adc_isr_handler();
+        set_stub_reading(adc1_values[i]);
+        adc_isr_handler();
+
+        ASSERT_EQ(ADC_ERROR_OK, adc_read_raw(ADC_MUX_ADC0, &raw));
+        ASSERT_EQ(ADC_ERROR_OK, adc_read_filtered(ADC_MUX_ADC0, &filtered));
+        ASSERT_EQ(adc0_values[i], raw);
+        ASSERT_EQ(adc0_filtered[i], filtered);
+
+        ASSERT_EQ(ADC_ERROR_OK, adc_read_raw(ADC_MUX_ADC1, &raw));
+        ASSERT_EQ(ADC_ERROR_OK, adc_read_filtered(ADC_MUX_ADC1, &filtered));
+        ASSERT_EQ(adc1_values[i], raw);
+        ASSERT_EQ(raw, filtered);
+    }
+
+    /* Removing the filter makes filtered output follow raw results again */
+    ASSERT_EQ(ADC_ERROR_OK, adc_set_channel_filter(ADC_MUX_ADC0, NULL, NULL));
+    set_stub_reading(1000U);
+    adc_isr_handler();
+    ASSERT_EQ(ADC_ERROR_OK, adc_read_filtered(ADC_MUX_ADC0, &filtered));
+    ASSERT_EQ(1000U, filtered);
+
+    ASSERT_EQ(ADC_ERROR_NULL_POINTER, adc_read_filtered(ADC_MUX_ADC0, NULL));
+    ASSERT_EQ(ADC_ERROR_CHANNEL_NOT_FOUND, adc_read_filtered(ADC_MUX_ADC5, &filtered));
+}
+
+static struct
+{
+    uint8_t calls;
+    adc_mux_t channel;
+    adc_result_t value;
+    adc_window_crossing_t crossing;
+} window_callback_spy;
+
+static void window_callback(const adc_mux_t channel, const adc_result_t value, const adc_window_crossing_t crossing)
+{
+    window_callback_spy.calls++;
+    window_callback_spy.channel = channel;
+    window_callback_spy.value = value;
+    window_callback_spy.crossing = crossing;
+}
+
+TEST_F(AdcTestFixture, adc_window_comparator_test)
+{
+    window_callback_spy = {};
+    ASSERT_EQ(ADC_ERROR_OK, adc_base_init(&config));
+    ASSERT_EQ(ADC_ERROR_OK, adc_register_channel(ADC_MUX_ADC0));
+    ASSERT_EQ(ADC_ERROR_OK, adc_register_channel(ADC_MUX_ADC3));
+
+    adc_window_t window = {200U, 800U, window_callback};
+    ASSERT_EQ(ADC_ERROR_CHANNEL_NOT_FOUND, adc_set_channel_window(ADC_MUX_ADC5, &window));
+    window.low = 900U;
+    ASSERT_EQ(ADC_ERROR_CONFIG, adc_set_channel_window(ADC_MUX_ADC3, &window));
+    window.low = 200U;
+    ASSERT_EQ(ADC_ERROR_OK, adc_set_channel_window(ADC_MUX_ADC3, &window));
+    ASSERT_EQ(ADC_STATE_READY, adc_start());
+
+    uint16_t faults = 0xFFFF;
+    ASSERT_EQ(ADC_ERROR_NULL_POINTER, adc_get_window_faults(NULL));
+    ASSERT_EQ(ADC_ERROR_OK, adc_get_window_faults(&faults));
+    ASSERT_EQ(0U, faults);
+
+    /* ADC0 has no window, ADC3 stays within bounds (thresholds included) */
+    set_stub_reading(1023U);
+    adc_isr_handler();
+    set_stub_reading(800U);
+    adc_isr_handler();
+    ASSERT_EQ(0U, window_callback_spy.calls);
+
+    /* Trip is reported from within the very ISR call which fetched the faulty result */
+    set_stub_reading(0U);
+    adc_isr_handler();
+    set_stub_reading(801U);
+    adc_isr_handler();
+    ASSERT_EQ(1U, window_callback_spy.calls);
+    ASSERT_EQ(ADC_MUX_ADC3, window_callback_spy.channel);
+    ASSERT_EQ(801U, window_callback_spy.value);
+    ASSERT_EQ(ADC_WINDOW_CROSSING_HIGH, window_callback_spy.crossing);
+    ASSERT_EQ(ADC_ERROR_OK, adc_get_window_faults(&faults));
+    ASSERT_EQ(1U << ADC_MUX_ADC3, faults);
+
+    /* Fault is latched : callback is not called again until cleared */
+    set_stub_reading(0U);
+    adc_isr_handler();
+    set_stub_reading(10U);
+    adc_isr_handler();
+    ASSERT_EQ(1U, window_callback_spy.calls);
+
+    adc_clear_window_faults(1U << ADC_MUX_ADC3);
+    ASSERT_EQ(ADC_ERROR_OK, adc_get_window_faults(&faults));
+    ASSERT_EQ(0U, faults);
+    ASSERT_NE(0, adc_register_stub.adcsra_reg & ADIE_MSK);
+
+    set_stub_reading(0U);
+    adc_isr_handler();
+    set_stub_reading(199U);
+    adc_isr_handler();
+    ASSERT_EQ(2U, window_callback_spy.calls);
+    ASSERT_EQ(199U, window_callback_spy.value);
+    ASSERT_EQ(ADC_WINDOW_CROSSING_LOW, window_callback_spy.crossing);
+
+    /* Disarmed comparator does not trip anymore */
+    adc_clear_window_faults(0xFFFF);
+    ASSERT_EQ(ADC_ERROR_OK, adc_set_channel_window(ADC_MUX_ADC3, NULL));
+    set_stub_reading(0U);
+    adc_isr_handler();
+    set_stub_reading(1023U);
+    adc_isr_handler();
+    ASSERT_EQ(2U, window_callback_spy.calls);
+    ASSERT_EQ(ADC_ERROR_OK, adc_get_window_faults(&faults));
+    ASSERT_EQ(0U, faults);
+}
+
+TEST_F(AdcTestFixture, adc_snapshot_test)
+{
+    const adc_mux_t channels[2] = {ADC_MUX_ADC2, ADC_MUX_ADC0};
+    adc_result_t results[2] = {0xFFFF, 0xFFFF};
+    uint8_t cycle_id = 0xFF;
+
+    ASSERT_EQ(ADC_ERROR_OK, adc_base_init(&config));
+    ASSERT_EQ(ADC_ERROR_OK, adc_register_channel(ADC_MUX_ADC0));
+    ASSERT_EQ(ADC_ERROR_OK, adc_register_channel(ADC_MUX_ADC1));
+    ASSERT_EQ(ADC_ERROR_OK, adc_register_channel(ADC_MUX_ADC2));
+    ASSERT_EQ(ADC_STATE_READY, adc_start());
+
+    ASSERT_EQ(ADC_ERROR_NULL_POINTER, adc_snapshot(NULL, results, 2U, &cycle_id));
+    ASSERT_EQ(ADC_ERROR_NULL_POINTER, adc_snapshot(channels, NULL, 2U, &cycle_id));
+    const adc_mux_t wrong_channels[2] = {ADC_MUX_ADC0, ADC_MUX_ADC5};
+    ASSERT_EQ(ADC_ERROR_CHANNEL_NOT_FOUND, adc_snapshot(wrong_channels, results, 2U, &cycle_id));
+
+    /* Nothing published before the end of the first scan cycle */
+    ASSERT_EQ(ADC_ERROR_OK, adc_snapshot(channels, results, 2U, &cycle_id));
+    ASSERT_EQ(0U, cycle_id);
+    ASSERT_EQ(0U, results[0]);
+    ASSERT_EQ(0U, results[1]);
+
+    for (uint16_t cycle = 1 ; cycle <= 3U ; cycle++)
+    {
+        /* ADC0 is already converted for this cycle, but ADC2 is not yet : published values are still the previous ones */
+        set_stub_reading(cycle * 10U);
+        adc_isr_handler();
+        set_stub_reading(cycle * 10U + 1U);
+        adc_isr_handler();
+        ASSERT_EQ(ADC_ERROR_OK, adc_snapshot(channels, results, 2U, &cycle_id));
+        ASSERT_EQ(cycle - 1U, cycle_id);
+
+        set_stub_reading(cycle * 10U + 2U);
+        adc_isr_handler();
+        ASSERT_EQ(ADC_ERROR_OK, adc_snapshot(channels, results, 2U, NULL));
+        ASSERT_EQ(ADC_ERROR_OK, adc_snapshot(channels, results, 2U, &cycle_id));
+        ASSERT_EQ(cycle, cycle_id);
+        ASSERT_EQ(cycle * 10U + 2U, results[0]);
+        ASSERT_EQ(cycle * 10U, results[1]);
+    }
+}
+
+TEST_F(AdcTestFixture, adc_snapshot_free_running_test)
+{
+    const adc_mux_t channels[2] = {ADC_MUX_ADC0, ADC_MUX_ADC1};
+    adc_result_t results[2] = {0};
+    uint8_t cycle_id = 0xFF;
+
+    config.running_mode = ADC_RUNNING_MODE_AUTOTRIGGERED;
+    config.trigger_sources = ADC_TRIGGER_FREE_RUNNING;
+    ASSERT_EQ(ADC_ERROR_OK, adc_base_init(&config));
+    ASSERT_EQ(ADC_ERROR_OK, adc_register_channel(ADC_MUX_ADC0));
+    ASSERT_EQ(ADC_ERROR_OK, adc_register_channel(ADC_MUX_ADC1));
+    ASSERT_EQ(ADC_STATE_READY, adc_start());
+
+    /* First channel is converted twice when starting, this does not complete a scan cycle */
+    set_stub_reading(100U);
+    adc_isr_handler();
+    set_stub_reading(101U);
+    adc_isr_handler();
+    ASSERT_EQ(ADC_ERROR_OK, adc_snapshot(channels, results, 2U, &cycle_id));
+    ASSERT_EQ(0U, cycle_id);
+
+    set_stub_reading(200U);
+    adc_isr_handler();
+    ASSERT_EQ(ADC_ERROR_OK, adc_snapshot(channels, results, 2U, &cycle_id));
+    ASSERT_EQ(1U, cycle_id);
+    ASSERT_EQ(101U, results[0]);
+    ASSERT_EQ(200U, results[1]);
+}
+
+TEST_F(AdcTestFixture, adc_channel_statistics_test)
+{
+    adc_statistics_t statistics;
+    adc_statistics_summary_t summary;
+    ASSERT_EQ(ADC_ERROR_OK, adc_base_init(&config));
+    ASSERT_EQ(ADC_ERROR_OK, adc_register_channel(ADC_MUX_ADC0));
+    ASSERT_EQ(ADC_ERROR_OK, adc_register_channel(ADC_MUX_ADC1));
+
+    ASSERT_EQ(ADC_ERROR_CONFIG, adc_get_channel_statistics(ADC_MUX_ADC1, &summary));
+    ASSERT_EQ(ADC_ERROR_CHANNEL_NOT_FOUND, adc_set_channel_statistics(ADC_MUX_ADC5, &statistics, 4U));
+    ASSERT_EQ(ADC_ERROR_CONFIG, adc_set_channel_statistics(ADC_MUX_ADC1, &statistics, 0U));
+    ASSERT_EQ(ADC_ERROR_OK, adc_set_channel_statistics(ADC_MUX_ADC1, &statistics, 4U));
+    ASSERT_EQ(ADC_ERROR_NULL_POINTER, adc_get_channel_statistics(ADC_MUX_ADC1, NULL));
+    ASSERT_EQ(ADC_ERROR_CHANNEL_NOT_FOUND, adc_get_channel_statistics(ADC_MUX_ADC5, &summary));
+    ASSERT_EQ(ADC_STATE_READY, adc_start());
+
+    ASSERT_EQ(ADC_ERROR_OK, adc_get_channel_statistics(ADC_MUX_ADC1, &summary));
+    ASSERT_EQ(0U, summary.count);
+
+    /* ADC0 and ADC1 are alternatively converted, only ADC1 results are accumulated */
+    const uint16_t adc1_values[4] = {100U, 104U, 102U, 102U};
+    for (const auto& value : adc1_values)
+    {
+        set_stub_reading(900U);
+        adc_isr_handler();
+        set_stub_reading(value);
+        adc_isr_handler();
+    }
+    ASSERT_EQ(ADC_ERROR_OK, adc_get_channel_statistics(ADC_MUX_ADC1, &summary));
+    ASSERT_EQ(4U, summary.count);
+    ASSERT_EQ(100U, summary.min);
+    ASSERT_EQ(104U, summary.max);
+    ASSERT_EQ(102U * 256U, summary.mean_q8);
+    ASSERT_EQ(2U * 256U, summary.variance_q8);
+
+    uint32_t total = 0;
+    uint16_t overruns = 0xFFFF;
+    ASSERT_EQ(ADC_ERROR_OK, adc_get_conversion_counters(&total, &overruns));
+    ASSERT_EQ(8U, total);
+    ASSERT_EQ(0U, overruns);
+    adc_reset_conversion_counters();
+    ASSERT_EQ(ADC_ERROR_OK, adc_get_conversion_counters(&total, NULL));
+    ASSERT_EQ(0U, total);
+
+    /* Detached statistics are not updated anymore */
+    ASSERT_EQ(ADC_ERROR_OK, adc_set_channel_statistics(ADC_MUX_ADC1, NULL, 0U));
+    ASSERT_EQ(ADC_ERROR_CONFIG, adc_get_channel_statistics(ADC_MUX_ADC1, &summary));
+}
+
+/* Simulates a new conversion ending while the ISR is still running */
+static void raise_interrupt_flag(const adc_mux_t channel, const adc_result_t value, const adc_window_crossing_t crossing)
+{
+    (void) channel;
+    (void) value;
+    (void) crossing;
+    adc_register_stub.adcsra_reg |= ADIF_MSK;
+}
+
+static struct
+{
+    uint8_t calls;
+    adc_mux_t channel;
+    adc_result_t result;
+} listener_spy;
+
+static void sample_listener(const adc_mux_t channel, const adc_result_t result)
+{
+    listener_spy.calls++;
+    listener_spy.channel = channel;
+    listener_spy.result = result;
+}
+
+TEST_F(AdcTestFixture, adc_channel_listener_test)
+{
+    listener_spy = {};
+    ASSERT_EQ(ADC_ERROR_OK, adc_base_init(&config));
+    ASSERT_EQ(ADC_ERROR_OK, adc_register_channel(ADC_MUX_ADC0));
+    ASSERT_EQ(ADC_ERROR_OK, adc_register_channel(ADC_MUX_ADC2));
+    ASSERT_EQ(ADC_ERROR_CHANNEL_NOT_FOUND, adc_set_channel_listener(ADC_MUX_ADC5, sample_listener));
+    ASSERT_EQ(ADC_ERROR_OK, adc_set_channel_listener(ADC_MUX_ADC2, sample_listener));
+    ASSERT_EQ(ADC_ERROR_OK, adc_set_channel_settling(ADC_MUX_ADC2, 0U, 1U));
+    ASSERT_EQ(ADC_STATE_READY, adc_start());
+
+    /* Only ADC2 averaged results are streamed */
+    const uint16_t readings[] = {900U, 700U, 702U, 900U, 710U, 714U};
+    for (const auto& reading : readings)
+    {
+        set_stub_reading(reading);
+        adc_isr_handler();
+    }
+    ASSERT_EQ(2U, listener_spy.calls);
+    ASSERT_EQ(ADC_MUX_ADC2, listener_spy.channel);
+    ASSERT_EQ(712U, listener_spy.result);
+
+    ASSERT_EQ(ADC_ERROR_OK, adc_set_channel_listener(ADC_MUX_ADC2, NULL));
+    ASSERT_EQ(ADC_STATE_READY, adc_start());
+    for (const auto& reading : readings)
+    {
+        set_stub_reading(reading);
+        adc_isr_handler();
+    }
+    ASSERT_EQ(2U, listener_spy.calls);
+}
+
+TEST_F(AdcTestFixture, adc_overrun_counter_test)
+{
+    config.running_mode = ADC_RUNNING_MODE_AUTOTRIGGERED;
+    config.trigger_sources = ADC_TRIGGER_FREE_RUNNING;
+    ASSERT_EQ(ADC_ERROR_OK, adc_base_init(&config));
+    ASSERT_EQ(ADC_ERROR_OK, adc_register_channel(ADC_MUX_ADC0));
+    const adc_window_t window = {0U, 500U, raise_interrupt_flag};
+    ASSERT_EQ(ADC_ERROR_OK, adc_set_channel_window(ADC_MUX_ADC0, &window));
+    ASSERT_EQ(ADC_STATE_READY, adc_start());
+
+    set_stub_reading(100U);
+    adc_isr_handler();
+    set_stub_reading(600U);
+    adc_isr_handler();
+
+    uint32_t total = 0;
+    uint16_t overruns = 0;
+    ASSERT_EQ(ADC_ERROR_OK, adc_get_conversion_counters(&total, &overruns));
+    ASSERT_EQ(2U, total);
+    ASSERT_EQ(1U, overruns);
+}
+
+TEST(adc_driver_tests, adc_compute_conversion_rate_test)
+{
+    ASSERT_EQ(0U, adc_compute_conversion_rate(0U, 1000U, 0U));
+    ASSERT_EQ(9615U, adc_compute_conversion_rate(1000U, 10615U, 1000U));
+    ASSERT_EQ(4000U, adc_compute_conversion_rate(0U, 1000U, 250U));
+    /* Total conversion count wrapped around between both samples */
+    ASSERT_EQ(2000U, adc_compute_conversion_rate(UINT32_MAX - 999U, 1000U, 1000U));
+}
+
+static void set_stub_burst_sample(const uint8_t value)
+{
+    /* Left aligned result : 8 most significant bits are in the high register */
+    adc_register_stub.readings.adchigh_reg = value;
+    adc_register_stub.adcsra_reg |= (ADIF_MSK);
+}
+
+TEST_F(AdcTestFixture, adc_burst_configuration_test)
+{
+    uint8_t buffer[8] = {0};
+    adc_burst_config_t burst_config = {ADC_MUX_ADC1, ADC_PRESCALER_16, buffer, 8U, 2U, ADC_BURST_TRIGGER_SOFTWARE, 0U};
+
+    ASSERT_EQ(ADC_ERROR_NOT_INITIALISED, adc_burst_start(&burst_config));
+    ASSERT_EQ(ADC_ERROR_OK, adc_base_init(&config));
+    ASSERT_EQ(ADC_ERROR_NULL_POINTER, adc_burst_start(NULL));
+    burst_config.buffer = NULL;
+    ASSERT_EQ(ADC_ERROR_NULL_POINTER, adc_burst_start(&burst_config));
+    burst_config.buffer = buffer;
+    burst_config.pre_trigger = 8U;
+    ASSERT_EQ(ADC_ERROR_CONFIG, adc_burst_start(&burst_config));
+    burst_config.pre_trigger = 2U;
+    burst_config.length = 0U;
+    ASSERT_EQ(ADC_ERROR_CONFIG, adc_burst_start(&burst_config));
+    burst_config.length = 8U;
+
+    ASSERT_EQ(ADC_ERROR_OK, adc_register_channel(ADC_MUX_ADC0));
+    ASSERT_EQ(ADC_STATE_READY, adc_start());
+    const adc_register_stub_t saved = adc_register_stub;
+
+    ASSERT_EQ(ADC_BURST_STATE_IDLE, adc_burst_get_state());
+    ASSERT_EQ(ADC_ERROR_OK, adc_burst_start(&burst_config));
+    ASSERT_EQ(ADC_ERROR_BUSY, adc_burst_start(&burst_config));
+    ASSERT_EQ(ADC_BURST_STATE_ARMED, adc_burst_get_state());
+
+    /* Free-running 8 bits conversions on burst channel, with burst prescaler */
+    ASSERT_EQ(ADC_MUX_ADC1, adc_register_stub.mux_reg & MUX_MSK);
+    ASSERT_NE(0, adc_register_stub.mux_reg & ADLAR_MSK);
+    ASSERT_EQ(ADC_PRESCALER_16, adc_register_stub.adcsra_reg & ADPS_MSK);
+    ASSERT_NE(0, adc_register_stub.adcsra_reg & ADATE_MSK);
+    ASSERT_NE(0, adc_register_stub.adcsra_reg & ADEN_MSK);
+    ASSERT_EQ(ADC_TRIGGER_FREE_RUNNING, adc_register_stub.adcsrb_reg & ADTS_MSK);
+
+    uint16_t first_index = 0;
+    ASSERT_EQ(ADC_ERROR_BUSY, adc_burst_get_trace_start(&first_index));
+
+    /* Aborting restores normal scan configuration and restarts it */
+    adc_burst_abort();
+    ASSERT_EQ(ADC_BURST_STATE_IDLE, adc_burst_get_state());
+    ASSERT_EQ(saved.mux_reg, adc_register_stub.mux_reg);
+    ASSERT_EQ(saved.adcsrb_reg, adc_register_stub.adcsrb_reg);
+    ASSERT_EQ(saved.adcsra_reg, adc_register_stub.adcsra_reg);
+}
+
+TEST_F(AdcTestFixture, adc_burst_software_trigger_test)
+{
+    uint8_t buffer[8] = {0};
+    const adc_burst_config_t burst_config = {ADC_MUX_ADC1, ADC_PRESCALER_16, buffer, 8U, 3U, ADC_BURST_TRIGGER_SOFTWARE, 0U};
+    ASSERT_EQ(ADC_ERROR_OK, adc_base_init(&config));
+    ASSERT_EQ(ADC_ERROR_OK, adc_register_channel(ADC_MUX_ADC0));
+    ASSERT_EQ(ADC_STATE_READY, adc_start());
+    const adc_register_stub_t saved = adc_register_stub;
+    ASSERT_EQ(ADC_ERROR_OK, adc_burst_start(&burst_config));
+
+    /* Samples keep wrapping around in buffer while waiting for the trigger */
+    uint8_t sample = 0;
+    for ( ; sample < 10U ; sample++)
+    {
+        set_stub_burst_sample(sample);
+        adc_isr_handler();
+    }
+    ASSERT_EQ(ADC_BURST_STATE_ARMED, adc_burst_get_state());
+
+    /* Sample following the trigger request is the trigger event */
+    adc_burst_trigger();
+    for ( ; sample < 14U ; sample++)
+    {
+        set_stub_burst_sample(sample);
+        adc_isr_handler();
+        ASSERT_EQ(ADC_BURST_STATE_TRIGGERED, adc_burst_get_state());
+    }
+    set_stub_burst_sample(sample);
+    adc_isr_handler();
+    ASSERT_EQ(ADC_BURST_STATE_DONE, adc_burst_get_state());
+
+    uint16_t first_index = 0;
+    ASSERT_EQ(ADC_ERROR_NULL_POINTER, adc_burst_get_trace_start(NULL));
+    ASSERT_EQ(ADC_ERROR_OK, adc_burst_get_trace_start(&first_index));
+    for (uint8_t i = 0 ; i < 8U ; i++)
+    {
+        /* 3 pre-trigger samples (7, 8, 9), then trigger event (10) and 4 post-trigger samples */
+        ASSERT_EQ(7U + i, buffer[(first_index + i) % 8U]);
+    }
+
+    /* Normal scan is restored and restarted */
+    ASSERT_EQ(saved.mux_reg, adc_register_stub.mux_reg);
+    ASSERT_EQ(saved.adcsrb_reg, adc_register_stub.adcsrb_reg);
+    ASSERT_EQ(saved.adcsra_reg, adc_register_stub.adcsra_reg);
+    set_stub_reading(321U);
+    adc_isr_handler();
+    adc_result_t result = 0;
+    ASSERT_EQ(ADC_ERROR_OK, adc_read_raw(ADC_MUX_ADC0, &result));
+    ASSERT_EQ(321U, result);
+}
+
+TEST_F(AdcTestFixture, adc_burst_edge_trigger_test)
+{
+    uint8_t buffer[6] = {0};
+    adc_burst_config_t burst_config = {ADC_MUX_ADC2, ADC_PRESCALER_32, buffer, 6U, 2U, ADC_BURST_TRIGGER_RISING, 128U};
+    ASSERT_EQ(ADC_ERROR_OK, adc_base_init(&config));
+
+    /* Rising edge : crossings which happen before pre-trigger samples are captured are ignored */
+    ASSERT_EQ(ADC_ERROR_OK, adc_burst_start(&burst_config));
+    const uint8_t rising[] = {10U, 200U, 10U, 20U, 127U, 128U, 250U, 5U, 6U};
+    for (const auto& value : rising)
+    {
+        set_stub_burst_sample(value);
+        adc_isr_handler();
+    }
+    ASSERT_EQ(ADC_BURST_STATE_DONE, adc_burst_get_state());
+    uint16_t first_index = 0;
+    ASSERT_EQ(ADC_ERROR_OK, adc_burst_get_trace_start(&first_index));
+    const uint8_t expected_rising[6] = {20U, 127U, 128U, 250U, 5U, 6U};
+    for (uint8_t i = 0 ; i < 6U ; i++)
+    {
+        ASSERT_EQ(expected_rising[i], buffer[(first_index + i) % 6U]);
+    }
+    /* Normal scan was not running before capture : it is not restarted */
+    ASSERT_EQ(0, adc_register_stub.adcsra_reg & ADEN_MSK);
+
+    /* Falling edge, polling mode */
+    config.using_interrupt = false;
+    ASSERT_EQ(ADC_ERROR_OK, adc_base_init(&config));
+    burst_config.trigger = ADC_BURST_TRIGGER_FALLING;
+    burst_config.pre_trigger = 0U;
+    ASSERT_EQ(ADC_ERROR_OK, adc_burst_start(&burst_config));
+    const uint8_t falling[] = {10U, 200U, 130U, 128U, 1U, 2U, 3U, 4U, 5U};
+    for (const auto& value : falling)
+    {
+        set_stub_burst_sample(value);
+        adc_process();
+    }
+    ASSERT_EQ(ADC_BURST_STATE_DONE, adc_burst_get_state());
+    ASSERT_EQ(ADC_ERROR_OK, adc_burst_get_trace_start(&first_index));
+    const uint8_t expected_falling[6] = {128U, 1U, 2U, 3U, 4U, 5U};
+    for (uint8_t i = 0 ; i < 6U ; i++)
+    {
+        ASSERT_EQ(expected_falling[i], buffer[(first_index + i) % 6U]);
+    }
+
+    /* Signal already above the level when capture starts : first sample is not an edge */
+    burst_config.trigger = ADC_BURST_TRIGGER_RISING;
+    ASSERT_EQ(ADC_ERROR_OK, adc_burst_start(&burst_config));
+    const uint8_t already_above[] = {200U, 220U, 10U, 130U, 1U, 2U, 3U, 4U, 5U};
+    for (uint8_t i = 0 ; i < sizeof(already_above) ; i++)
+    {
+        ASSERT_NE(ADC_BURST_STATE_DONE, adc_burst_get_state());
+        set_stub_burst_sample(already_above[i]);
+        adc_process();
+        if (i < 3U)
+        {
+            ASSERT_EQ(ADC_BURST_STATE_ARMED, adc_burst_get_state());
+        }
+    }
+    ASSERT_EQ(ADC_BURST_STATE_DONE, adc_burst_get_state());
+    ASSERT_EQ(ADC_ERROR_OK, adc_burst_get_trace_start(&first_index));
+    const uint8_t expected_above[6] = {130U, 1U, 2U, 3U, 4U, 5U};
+    for (uint8_t i = 0 ; i < 6U ; i++)
+    {
+        ASSERT_EQ(expected_above[i], buffer[(first_index + i) % 6U]);
+    }
+}
+
+/**
+ * @brief models the sample and hold capacitor of the ADC : at each conversion, it only gets a fraction of the way from
+ * the charge left by the previous conversion to the selected channel voltage. The fraction depends on the source
+ * impedance of the channel (1/1 for a low impedance source, less for a high impedance one)
+*/
+class SampleAndHoldModel
+{
+public:
+    struct Source
+    {
+        uint16_t value;         /**< Actual channel value                                   */
+        uint8_t  settling_div;  /**< Capacitor gets 1/settling_div of the way per conversion */
+    };
+
+    void set_source(const adc_mux_t channel, const uint16_t value, const uint8_t settling_div)
+    {
+        sources[channel] = {value, settling_div};
+    }
+
+    /* Converts the channel currently selected by the mux register and feeds the stub with the result */
+    uint16_t convert(void)
+    {
+        const Source& source = sources[adc_register_stub.mux_reg & MUX_MSK];
+        const int32_t error = (int32_t) source.value - (int32_t) held;
+        held = (uint16_t)((int32_t) held + error / source.settling_div);
+        set_stub_reading(held);
+        return held;
+    }
+
+private:
+    Source sources[16] = {};
+    uint16_t held = 0;
+};
+
+TEST_F(AdcTestFixture, adc_settling_discard_and_average_test)
+{
+    SampleAndHoldModel model;
+    model.set_source(ADC_MUX_ADC0, 1000U, 1U);   /* Low impedance                    */
+    model.set_source(ADC_MUX_ADC3, 200U, 2U);    /* High impedance thermistor divider */
+
+    ASSERT_EQ(ADC_ERROR_OK, adc_base_init(&config));
+    ASSERT_EQ(ADC_ERROR_OK, adc_register_channel(ADC_MUX_ADC0));
+    ASSERT_EQ(ADC_ERROR_OK, adc_register_channel(ADC_MUX_ADC3));
+    ASSERT_EQ(ADC_ERROR_CHANNEL_NOT_FOUND, adc_set_channel_settling(ADC_MUX_ADC5, 1U, 0U));
+    ASSERT_EQ(ADC_ERROR_CONFIG, adc_set_channel_settling(ADC_MUX_ADC3, 0U, ADC_AVERAGE_MAX_ORDER + 1U));
+    ASSERT_EQ(ADC_ERROR_CONFIG, adc_set_channel_settling(ADC_MUX_ADC3, 200U, ADC_AVERAGE_MAX_ORDER));
+    ASSERT_EQ(ADC_STATE_READY, adc_start());
+
+    /* Without settling, ADC3 reading is way off because of the charge left by ADC0 */
+    adc_result_t result = 0;
+    for (uint8_t i = 0 ; i < 10U ; i++)
+    {
+        model.convert();
+        adc_isr_handler();
+    }
+    ASSERT_EQ(ADC_ERROR_OK, adc_read_raw(ADC_MUX_ADC3, &result));
+    ASSERT_EQ(600U, result);
+
+    /* 5 discarded conversions leave (1000 - 200) / 2^5 = 25 LSB of error, then 2 averaged ones : 213 and 207 */
+    ASSERT_EQ(ADC_ERROR_OK, adc_set_channel_settling(ADC_MUX_ADC3, 5U, 1U));
+    uint32_t total_before = 0;
+    uint32_t total_after = 0;
+    adc_get_conversion_counters(&total_before, NULL);
+    ASSERT_EQ(ADC_STATE_READY, adc_start());
+    for (uint8_t i = 0 ; i < 3U * 8U ; i++)
+    {
+        model.convert();
+        adc_isr_handler();
+    }
+    adc_get_conversion_counters(&total_after, NULL);
+    ASSERT_EQ(24U, total_after - total_before);
+    ASSERT_EQ(ADC_ERROR_OK, adc_read_raw(ADC_MUX_ADC3, &result));
+    ASSERT_EQ((213U + 207U) / 2U, result);
+    ASSERT_EQ(ADC_ERROR_OK, adc_read_raw(ADC_MUX_ADC0, &result));
+    ASSERT_EQ(1000U, result);
+
+    /* Scan divider does not touch the settling sequence : one scan cycle is still 1 + 5 + 2 conversions */
+    ASSERT_EQ(ADC_ERROR_OK, adc_set_channel_divider(ADC_MUX_ADC3, 1U));
+    adc_get_conversion_counters(&total_before, NULL);
+    ASSERT_EQ(ADC_STATE_READY, adc_start());
+    for (uint8_t i = 0 ; i < 8U ; i++)
+    {
+        model.convert();
+        adc_isr_handler();
+    }
+    adc_get_conversion_counters(&total_after, NULL);
+    ASSERT_EQ(8U, total_after - total_before);
+    ASSERT_EQ(ADC_ERROR_OK, adc_read_raw(ADC_MUX_ADC3, &result));
+    ASSERT_EQ((213U + 207U) / 2U, result);
+}
+
+TEST_F(AdcTestFixture, adc_internal_temperature_test)
+{
+    int16_t temperature = 0;
+    ASSERT_EQ(ADC_ERROR_OK, adc_base_init(&config));
+    ASSERT_EQ(ADC_ERROR_NULL_POINTER, adc_read_die_temperature(NULL));
+    ASSERT_EQ(ADC_ERROR_CHANNEL_NOT_FOUND, adc_read_die_temperature(&temperature));
+    ASSERT_EQ(ADC_ERROR_OK, adc_register_channel(ADC_MUX_ADC0));
+
+    /* Default AREF capacitor settling exceeds the protection latency : reference switches are refused */
+    ASSERT_EQ(ADC_ERROR_CONFIG, adc_register_channel(ADC_MUX_INTERNAL_TEMPERATURE));
+    ASSERT_EQ(ADC_ERROR_CHANNEL_NOT_FOUND, adc_read_die_temperature(&temperature));
+    ASSERT_EQ(ADC_ERROR_CONFIG, adc_set_channel_reference(ADC_MUX_ADC0, ADC_VOLTAGE_REF_INTERNAL_1V1));
+    ASSERT_EQ(ADC_ERROR_OK, adc_set_reference_settling(1U));
+    ASSERT_EQ(ADC_ERROR_OK, adc_register_channel(ADC_MUX_INTERNAL_TEMPERATURE));
+    ASSERT_EQ(ADC_ERROR_CONFIG, adc_set_reference_settling((ADC_PROTECTION_LATENCY_US / ADC_CONVERSION_TIME_US) + 1U));
+
+    ASSERT_EQ(ADC_ERROR_CHANNEL_NOT_FOUND, adc_set_channel_reference(ADC_MUX_ADC5, ADC_VOLTAGE_REF_AVCC));
+    ASSERT_EQ(ADC_ERROR_CONFIG, adc_set_channel_reference(ADC_MUX_INTERNAL_TEMPERATURE, ADC_VOLTAGE_REF_AVCC));
+    ASSERT_EQ(ADC_ERROR_CONFIG, adc_set_channel_reference(ADC_MUX_ADC0, (adc_voltage_ref_t) 0x02));
+    ASSERT_EQ(ADC_ERROR_CHANNEL_NOT_FOUND, adc_set_channel_divider(ADC_MUX_ADC5, 2U));
+    ASSERT_EQ(ADC_STATE_READY, adc_start());
+
+    /* ADC0 uses configured AREF pin reference, temperature sensor is switched to 1V1 and back */
+    const uint8_t aref = ADC_VOLTAGE_REF_AREF_PIN << REFS0;
+    const uint8_t internal = ADC_VOLTAGE_REF_INTERNAL_1V1 << REFS0;
+    const struct
+    {
+        uint8_t mux;        /* Mux register while converting */
+        uint16_t reading;
+    } sequence[] = {
+        {(uint8_t)(aref | ADC_MUX_ADC0), 500U},
+        {(uint8_t)(internal | ADC_MUX_INTERNAL_TEMPERATURE), 1023U},   /* Reference settling */
+        {(uint8_t)(internal | ADC_MUX_INTERNAL_TEMPERATURE), 300U},
+        {(uint8_t)(aref | ADC_MUX_ADC0), 0U},                          /* Reference settling */
+        {(uint8_t)(aref | ADC_MUX_ADC0), 501U},
+    };
+    for (const auto& step : sequence)
+    {
+        ASSERT_EQ(step.mux, adc_register_stub.mux_reg & (REF_MSK | MUX_MSK));
+        set_stub_reading(step.reading);
+        adc_isr_handler();
+    }
+
+    adc_result_t result = 0;
+    ASSERT_EQ(ADC_ERROR_OK, adc_read_raw(ADC_MUX_ADC0, &result));
+    ASSERT_EQ(501U, result);
+    ASSERT_EQ(ADC_ERROR_OK, adc_read_raw(ADC_MUX_INTERNAL_TEMPERATURE, &result));
+    ASSERT_EQ(300U, result);
+
+    /* 300 * 1100 / 1024 = 322 mV, 8 mV above 25 degrees reading */
+    adc_millivolts_t millivolts = 0;
+    ASSERT_EQ(ADC_ERROR_OK, adc_read_millivolt(ADC_MUX_INTERNAL_TEMPERATURE, &millivolts));
+    ASSERT_EQ(322U, millivolts);
+    ASSERT_EQ(ADC_ERROR_OK, adc_read_millivolt(ADC_MUX_ADC0, &millivolts));
+    ASSERT_EQ((uint16_t)((501UL * 5000UL) / 1024UL), millivolts);
+    ASSERT_EQ(ADC_ERROR_OK, adc_read_die_temperature(&temperature));
+    ASSERT_EQ(33, temperature);
+
+    /* Temperature sensor selected once every 4 scan cycles : each 7 conversions cycle is made of
+    ADC0, ADC0, ADC0, settling + ADC0, settling + temperature */
+    ASSERT_EQ(ADC_ERROR_OK, adc_set_channel_divider(ADC_MUX_INTERNAL_TEMPERATURE, 4U));
+    ASSERT_EQ(ADC_STATE_READY, adc_start());
+    uint8_t temperature_selections = 0;
+    uint8_t previous_channel = ADC_MUX_GND;
+    for (uint8_t i = 0 ; i < 3U * 7U ; i++)
+    {
+        const uint8_t channel = adc_register_stub.mux_reg & MUX_MSK;
+        if ((ADC_MUX_INTERNAL_TEMPERATURE == channel) && (previous_channel != channel))
+        {
+            temperature_selections++;
+        }
+        previous_channel = channel;
+        set_stub_reading(300U);
+        adc_isr_handler();
+    }
+    ASSERT_EQ(3U, temperature_selections);
+}
+
+TEST_F(AdcTestFixture, adc_settling_free_running_test)
+{
+    config.running_mode = ADC_RUNNING_MODE_AUTOTRIGGERED;
+    config.trigger_sources = ADC_TRIGGER_FREE_RUNNING;
+    ASSERT_EQ(ADC_ERROR_OK, adc_base_init(&config));
+    ASSERT_EQ(ADC_ERROR_OK, adc_register_channel(ADC_MUX_ADC0));
+    ASSERT_EQ(ADC_ERROR_OK, adc_register_channel(ADC_MUX_ADC3));
+    ASSERT_EQ(ADC_ERROR_OK, adc_set_channel_settling(ADC_MUX_ADC3, 1U, 1U));
+    ASSERT_EQ(ADC_STATE_READY, adc_start());
+
+    /* Channel value encodes the mux latched by the conversion (written one conversion ahead) and the conversion rank
+    within the sequence, so that discarded results are easily spotted */
+    uint8_t latched_channel = adc_register_stub.mux_reg & MUX_MSK;
+    uint8_t rank = 0;
+    for (uint8_t i = 0 ; i < 20U ; i++)
+    {
+        const uint8_t next_latched_channel = adc_register_stub.mux_reg & MUX_MSK;
+        rank = (latched_channel == ADC_MUX_ADC3) ? rank + 1U : 0U;
+        set_stub_reading((ADC_MUX_ADC3 == latched_channel) ? (uint16_t)(300U + (rank == 1U ? 500U : rank)) : 100U);
+        adc_isr_handler();
+        latched_channel = next_latched_channel;
+    }
+
+    /* First ADC3 conversion of each sequence is discarded (800), next two are averaged : (302 + 303) / 2 */
+    adc_result_t result = 0;
+    ASSERT_EQ(ADC_ERROR_OK, adc_read_raw(ADC_MUX_ADC3, &result));
+    ASSERT_EQ(302U, result);
+    ASSERT_EQ(ADC_ERROR_OK, adc_read_raw(ADC_MUX_ADC0, &result));
+    ASSERT_EQ(100U, result);
+}
+
+TEST_F(AdcTestFixture, adc_optimise_scan_order_test)
+{
+    SampleAndHoldModel model;
+    model.set_source(ADC_MUX_ADC0, 1000U, 1U);
+    model.set_source(ADC_MUX_ADC1, 1000U, 1U);
+    model.set_source(ADC_MUX_ADC3, 200U, 2U);
+    model.set_source(ADC_MUX_ADC4, 200U, 2U);
+
+    /* Interleaved registration : both high impedance channels follow a low impedance one */
+    ASSERT_EQ(ADC_ERROR_OK, adc_base_init(&config));
+    ASSERT_EQ(ADC_ERROR_OK, adc_register_channel(ADC_MUX_ADC3));
+    ASSERT_EQ(ADC_ERROR_OK, adc_register_channel(ADC_MUX_ADC0));
+    ASSERT_EQ(ADC_ERROR_OK, adc_register_channel(ADC_MUX_ADC4));
+    ASSERT_EQ(ADC_ERROR_OK, adc_register_channel(ADC_MUX_ADC1));
+    ASSERT_EQ(ADC_ERROR_OK, adc_set_channel_settling(ADC_MUX_ADC3, 1U, 0U));
+    ASSERT_EQ(ADC_ERROR_OK, adc_set_channel_settling(ADC_MUX_ADC4, 1U, 0U));
+
+    const auto settling_error = [&model]() -> uint16_t
+    {
+        EXPECT_EQ(ADC_STATE_READY, adc_start());
+        for (uint8_t i = 0 ; i < 30U ; i++)
+        {
+            model.convert();
+            adc_isr_handler();
+        }
+        adc_result_t adc3 = 0;
+        adc_result_t adc4 = 0;
+        adc_read_raw(ADC_MUX_ADC3, &adc3);
+        adc_read_raw(ADC_MUX_ADC4, &adc4);
+        return (adc3 - 200U) + (adc4 - 200U);
+    };
+
+    /* Both high impedance channels start from 1000 : 600 (discarded) then 400 */
+    ASSERT_EQ(400U, settling_error());
+
+    /* ADC0 -> ADC1 -> ADC3 -> ADC4 : ADC4 now starts from the 400 left by ADC3, 300 (discarded) then 250 */
+    ASSERT_EQ(ADC_ERROR_OK, adc_optimise_scan_order());
+    ASSERT_EQ(250U, settling_error());
+}
+
+static adc_filter_t scan_table_filter;
+static const adc_scan_entry_t scan_table[] ADC_SCAN_TABLE_STORAGE =
+{
+    /* channel, reference, divider, discard, average order, filter, filter config, window armed, window, listener, noise reduction */
+    {ADC_MUX_ADC2, ADC_SCAN_REFERENCE_DEFAULT, 0U, 0U, 1U, &scan_table_filter, {ADC_FILTER_MEDIAN_3, 0U}, false, {0U, 0U, NULL}, sample_listener, false},
+    {ADC_MUX_ADC0, ADC_VOLTAGE_REF_AREF_PIN, 0U, 0U, 0U, NULL, {ADC_FILTER_NONE, 0U}, true, {200U, 800U, window_callback}, NULL, false},
+};
+
+TEST_F(AdcTestFixture, adc_load_scan_table_test)
+{
+    window_callback_spy = {};
+    listener_spy = {};
+    ASSERT_EQ(ADC_ERROR_OK, adc_base_init(&config));
+    ASSERT_EQ(ADC_ERROR_NULL_POINTER, adc_load_scan_table(NULL, 1U));
+    ASSERT_EQ(ADC_ERROR_CONFIG, adc_load_scan_table(scan_table, ADC_MUX_COUNT + 1U));
+    ASSERT_EQ(ADC_ERROR_OK, adc_load_scan_table(scan_table, 2U));
+    ASSERT_EQ(ADC_STATE_READY, adc_start());
+
+    /* Table order is the scan order : ADC2 (two averaged conversions), then ADC0 */
+    const struct
+    {
+        uint8_t mux;        /* Mux register while converting */
+        uint16_t reading;
+    } sequence[] = {
+        {ADC_MUX_ADC2, 300U},
+        {ADC_MUX_ADC2, 302U},
+        {ADC_MUX_ADC0, 500U},
+        {ADC_MUX_ADC2, 1000U},
+        {ADC_MUX_ADC2, 1000U},
+        {ADC_MUX_ADC0, 900U},
+    };
+    for (const auto& step : sequence)
+    {
+        ASSERT_EQ(step.mux, adc_register_stub.mux_reg & (REF_MSK | MUX_MSK));
+        set_stub_reading(step.reading);
+        adc_isr_handler();
+    }
+
+    /* Spike is rejected by ADC2 median filter, ADC0 tripped its window */
+    adc_result_t result = 0;
+    ASSERT_EQ(ADC_ERROR_OK, adc_read_raw(ADC_MUX_ADC2, &result));
+    ASSERT_EQ(1000U, result);
+    ASSERT_EQ(ADC_ERROR_OK, adc_read_filtered(ADC_MUX_ADC2, &result));
+    ASSERT_EQ(301U, result);
+    ASSERT_EQ(2U, listener_spy.calls);
+    ASSERT_EQ(1000U, listener_spy.result);
+    ASSERT_EQ(1U, window_callback_spy.calls);
+    ASSERT_EQ(ADC_MUX_ADC0, window_callback_spy.channel);
+    ASSERT_EQ(ADC_WINDOW_CROSSING_HIGH, window_callback_spy.crossing);
+    adc_clear_window_faults(0xFFFF);
+
+    /* Rejected tables leave the current scan untouched */
+    static const adc_scan_entry_t wrong_tables[][2] ADC_SCAN_TABLE_STORAGE =
+    {
+        /* Same channel listed twice */
+        {
+            {ADC_MUX_ADC5, ADC_SCAN_REFERENCE_DEFAULT, 0U, 0U, 0U, NULL, {ADC_FILTER_NONE, 0U}, false, {0U, 0U, NULL}, NULL, false},
+            {ADC_MUX_ADC5, ADC_SCAN_REFERENCE_DEFAULT, 0U, 0U, 0U, NULL, {ADC_FILTER_NONE, 0U}, false, {0U, 0U, NULL}, NULL, false},
+        },
+        /* Temperature sensor can only be converted against 1V1 reference */
+        {
+            {ADC_MUX_ADC5, ADC_SCAN_REFERENCE_DEFAULT, 0U, 0U, 0U, NULL, {ADC_FILTER_NONE, 0U}, false, {0U, 0U, NULL}, NULL, false},
+            {ADC_MUX_INTERNAL_TEMPERATURE, ADC_SCAN_REFERENCE_DEFAULT, 0U, 0U, 0U, NULL, {ADC_FILTER_NONE, 0U}, false, {0U, 0U, NULL}, NULL, false},
+        },
+        /* Inverted window thresholds */
+        {
+            {ADC_MUX_ADC5, ADC_SCAN_REFERENCE_DEFAULT, 0U, 0U, 0U, NULL, {ADC_FILTER_NONE, 0U}, false, {0U, 0U, NULL}, NULL, false},
+            {ADC_MUX_ADC6, ADC_SCAN_REFERENCE_DEFAULT, 0U, 0U, 0U, NULL, {ADC_FILTER_NONE, 0U}, true, {800U, 200U, NULL}, NULL, false},
+        },
+        /* Average order out of range */
+        {
+            {ADC_MUX_ADC5, ADC_SCAN_REFERENCE_DEFAULT, 0U, 0U, 0U, NULL, {ADC_FILTER_NONE, 0U}, false, {0U, 0U, NULL}, NULL, false},
+            {ADC_MUX_ADC6, ADC_SCAN_REFERENCE_DEFAULT, 0U, 0U, ADC_AVERAGE_MAX_ORDER + 1U, NULL, {ADC_FILTER_NONE, 0U}, false, {0U, 0U, NULL}, NULL, false},
+        },
+        /* Valid entry reusing the filter of the current scan, followed by an unknown filter type */
+        {
+            {ADC_MUX_ADC5, ADC_SCAN_REFERENCE_DEFAULT, 0U, 0U, 0U, &scan_table_filter, {ADC_FILTER_BOXCAR, 2U}, false, {0U, 0U, NULL}, NULL, false},
+            {ADC_MUX_ADC6, ADC_SCAN_REFERENCE_DEFAULT, 0U, 0U, 0U, &scan_table_filter, {(adc_filter_type_t) 42, 0U}, false, {0U, 0U, NULL}, NULL, false},
+        },
+    };
+    for (const auto& table : wrong_tables)
+    {
+        ASSERT_EQ(ADC_ERROR_CONFIG, adc_load_scan_table(table, 2U));
+        ASSERT_EQ(ADC_ERROR_CHANNEL_NOT_FOUND, adc_read_raw(ADC_MUX_ADC5, &result));
+        ASSERT_EQ(ADC_ERROR_OK, adc_read_raw(ADC_MUX_ADC2, &result));
+        ASSERT_EQ(1000U, result);
+        /* Filter still used by the ISR was neither reconfigured nor cleared */
+        ASSERT_EQ(ADC_FILTER_MEDIAN_3, scan_table_filter.config.type);
+        ASSERT_TRUE(scan_table_filter.primed);
+    }
+
+    /* Loading another table replaces registered channels, temperature sensor is switched to 1V1 */
+    static const adc_scan_entry_t temperature_table[] ADC_SCAN_TABLE_STORAGE =
+    {
+        {ADC_MUX_INTERNAL_TEMPERATURE, ADC_VOLTAGE_REF_INTERNAL_1V1, 0U, 0U, 0U, NULL, {ADC_FILTER_NONE, 0U}, false, {0U, 0U, NULL}, NULL, false},
+    };
+    /* Default AREF capacitor settling would block the scan far longer than the protection latency */
+    ASSERT_EQ(ADC_ERROR_CONFIG, adc_load_scan_table(temperature_table, 1U));
+    ASSERT_EQ(ADC_ERROR_OK, adc_read_raw(ADC_MUX_ADC2, &result));
+    ASSERT_EQ(ADC_ERROR_OK, adc_set_reference_settling(ADC_PROTECTION_LATENCY_US / ADC_CONVERSION_TIME_US));
+    ASSERT_EQ(ADC_ERROR_OK, adc_load_scan_table(temperature_table, 1U));
+    ASSERT_EQ(ADC_ERROR_CHANNEL_NOT_FOUND, adc_read_raw(ADC_MUX_ADC2, &result));
+    ASSERT_EQ(ADC_STATE_READY, adc_start());
+    ASSERT_EQ((ADC_VOLTAGE_REF_INTERNAL_1V1 << REFS0) | ADC_MUX_INTERNAL_TEMPERATURE, adc_register_stub.mux_reg & (REF_MSK | MUX_MSK));
+}
+
+TEST_F(AdcTestFixture, adc_load_scan_table_keeps_supply_monitoring_test)
+{
+    config.ref = ADC_VOLTAGE_REF_AVCC;
+    config.supply_voltage_mv = 5000U;
+    config.supply_monitoring_period = 1U;
+    ASSERT_EQ(ADC_ERROR_OK, adc_base_init(&config));
+
+    static const adc_scan_entry_t supply_table[] ADC_SCAN_TABLE_STORAGE =
+    {
+        {ADC_MUX_ADC0, ADC_SCAN_REFERENCE_DEFAULT, 0U, 0U, 0U, NULL, {ADC_FILTER_NONE, 0U}, false, {0U, 0U, NULL}, NULL, false},
+    };
+    ASSERT_EQ(ADC_ERROR_OK, adc_load_scan_table(supply_table, 1U));
+    ASSERT_EQ(ADC_STATE_READY, adc_start());
+
+    /* Bandgap is still scanned after table's channels : ADC0, then bandgap settling conversions and kept one */
+    const uint16_t bandgap_raw = 244U;
+    uint8_t bandgap_conversions = 0;
+    for (uint8_t i = 0 ; i < (ADC_BANDGAP_SETTLING_CONVERSIONS + 2U) ; i++)
+    {
+        const bool is_bandgap = (ADC_MUX_1v1_REF == (adc_register_stub.mux_reg & MUX_MSK));
+        bandgap_conversions += is_bandgap ? 1U : 0U;
+        set_stub_reading(is_bandgap ? bandgap_raw : 512U);
+        adc_isr_handler();
+    }
+    ASSERT_EQ(ADC_BANDGAP_SETTLING_CONVERSIONS + 1U, bandgap_conversions);
+
+    adc_millivolts_t supply = 0;
+    ASSERT_EQ(ADC_ERROR_OK, adc_get_supply_voltage(&supply));
+    ASSERT_EQ((1100U * 1024U) / bandgap_raw, supply);
+}
+
+TEST_F(AdcTestFixture, adc_noise_reduction_test)
+{
+    ASSERT_EQ(ADC_ERROR_OK, adc_base_init(&config));
+    ASSERT_EQ(ADC_ERROR_OK, adc_register_channel(ADC_MUX_ADC0));
+    ASSERT_EQ(ADC_ERROR_OK, adc_register_channel(ADC_MUX_ADC1));
+    ASSERT_EQ(ADC_ERROR_CHANNEL_NOT_FOUND, adc_set_channel_noise_reduction(ADC_MUX_ADC5, true));
+    ASSERT_EQ(ADC_ERROR_OK, adc_set_channel_noise_reduction(ADC_MUX_ADC1, true));
+    ASSERT_EQ(ADC_STATE_READY, adc_start());
+    ASSERT_FALSE(adc_noise_reduction_pending());
+    ASSERT_NE(0, adc_register_stub.adcsra_reg & ADSC_MSK);
+
+    /* ADC1 conversion is not started by the driver : scan waits for the main loop to enter sleep */
+    set_stub_reading(100U);
+    adc_isr_handler();
+    ASSERT_TRUE(adc_noise_reduction_pending());
+    ASSERT_EQ(0, adc_register_stub.adcsra_reg & ADSC_MSK);
+    ASSERT_EQ(ADC_MUX_ADC1, adc_register_stub.mux_reg & MUX_MSK);
+    ASSERT_EQ(ADC_STATE_READY, adc_process());
+    ASSERT_TRUE(adc_noise_reduction_pending());
+    adc_result_t result = 0;
+    ASSERT_EQ(ADC_ERROR_OK, adc_read_raw(ADC_MUX_ADC1, &result));
+    ASSERT_EQ(0U, result);
+
+    /* Entering sleep starts the conversion, CPU wakes up on its interrupt and scan goes on */
+    adc_register_stub.adcsra_reg |= ADSC_MSK;
+    set_stub_reading(200U);
+    adc_isr_handler();
+    ASSERT_FALSE(adc_noise_reduction_pending());
+    ASSERT_NE(0, adc_register_stub.adcsra_reg & ADSC_MSK);
+    ASSERT_EQ(ADC_MUX_ADC0, adc_register_stub.mux_reg & MUX_MSK);
+    ASSERT_EQ(ADC_ERROR_OK, adc_read_raw(ADC_MUX_ADC1, &result));
+    ASSERT_EQ(200U, result);
+
+    /* Stopping the ADC drops the pending conversion */
+    set_stub_reading(100U);
+    adc_isr_handler();
+    ASSERT_TRUE(adc_noise_reduction_pending());
+    adc_stop();
+    ASSERT_FALSE(adc_noise_reduction_pending());
+    adc_base_deinit();
+
+    /* Sleeping CPU can only be woken up by the conversion complete interrupt : polled scans ignore noise reduction */
+    config.using_interrupt = false;
+    ASSERT_EQ(ADC_ERROR_OK, adc_base_init(&config));
+    ASSERT_EQ(ADC_ERROR_OK, adc_register_channel(ADC_MUX_ADC1));
+    ASSERT_EQ(ADC_ERROR_OK, adc_set_channel_noise_reduction(ADC_MUX_ADC1, true));
+    ASSERT_EQ(ADC_STATE_READY, adc_start());
+    ASSERT_FALSE(adc_noise_reduction_pending());
+    ASSERT_NE(0, adc_register_stub.adcsra_reg & ADSC_MSK);
+}
 
 int main(int argc, char **argv)
 {
@@ -0,0 +1,230 @@
+/*
+
+------------------
+@<FreeMyCode>
+FreeMyCode version : 1.0 RC alpha
+    Author : bebenlebricolo
+    License : 
+        name : GPLv3
+        url : https://www.gnu.org/licenses/quick-guide-gplv3.html
+    Date : 12/02/2021
+    Project : LabBenchPowerSupply
+    Description : The Lab Bench Power Supply provides a simple design based around an Arduino Nano board to convert AC main voltage into
+ smaller ones, ranging from 0V to 16V, with voltage and current regulations
+<FreeMyCode>@
+------------------
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+
+#include "gtest/gtest.h"
+#include "adc_filter.h"
+
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <vector>
+
+TEST(adc_filter_tests, init_checks_configuration)
+{
+    adc_filter_t filter;
+    adc_filter_config_t config = {ADC_FILTER_EMA, ADC_FILTER_EMA_MAX_ORDER};
+    ASSERT_EQ(ADC_FILTER_ERROR_NULL_POINTER, adc_filter_init(NULL, &config));
+    ASSERT_EQ(ADC_FILTER_ERROR_NULL_POINTER, adc_filter_init(&filter, NULL));
+    ASSERT_EQ(ADC_FILTER_ERROR_OK, adc_filter_init(&filter, &config));
+
+    config.order = ADC_FILTER_EMA_MAX_ORDER + 1U;
+    ASSERT_EQ(ADC_FILTER_ERROR_CONFIG, adc_filter_init(&filter, &config));
+
+    config = {ADC_FILTER_BOXCAR, ADC_FILTER_BOXCAR_MAX_ORDER};
+    ASSERT_EQ(ADC_FILTER_ERROR_OK, adc_filter_init(&filter, &config));
+    config.order = ADC_FILTER_BOXCAR_MAX_ORDER + 1U;
+    ASSERT_EQ(ADC_FILTER_ERROR_CONFIG, adc_filter_init(&filter, &config));
+
+    config = {(adc_filter_type_t) 42, 0};
+    ASSERT_EQ(ADC_FILTER_ERROR_CONFIG, adc_filter_init(&filter, &config));
+    ASSERT_EQ(ADC_FILTER_ERROR_CONFIG, adc_filter_check_config(&config));
+    ASSERT_EQ(ADC_FILTER_ERROR_NULL_POINTER, adc_filter_check_config(NULL));
+
+    config = {ADC_FILTER_MEDIAN_3, 0};
+    ASSERT_EQ(ADC_FILTER_ERROR_OK, adc_filter_check_config(&config));
+}
+
+TEST(adc_filter_tests, no_filter_is_transparent)
+{
+    adc_filter_t filter;
+    adc_filter_config_t config = {ADC_FILTER_NONE, 0};
+    ASSERT_EQ(ADC_FILTER_ERROR_OK, adc_filter_init(&filter, &config));
+    for (uint16_t sample = 0 ; sample < 1024U ; sample++)
+    {
+        ASSERT_EQ(sample, adc_filter_apply(&filter, sample));
+    }
+}
+
+TEST(adc_filter_tests, ema_step_response)
+{
+    adc_filter_t filter;
+    adc_filter_config_t config = {ADC_FILTER_EMA, 2U};
+    ASSERT_EQ(ADC_FILTER_ERROR_OK, adc_filter_init(&filter, &config));
+
+    /* First sample seeds the filter : no startup transient */
+    ASSERT_EQ(100U, adc_filter_apply(&filter, 100U));
+    ASSERT_EQ(100U, adc_filter_apply(&filter, 100U));
+
+    /* alpha = 1/4 : output moves by a quarter of the remaining error at each sample */
+    ASSERT_EQ(325U, adc_filter_apply(&filter, 1000U));
+    ASSERT_EQ(493U, adc_filter_apply(&filter, 1000U));
+    uint16_t output = 0;
+    for (uint8_t i = 0 ; i < 50U ; i++)
+    {
+        output = adc_filter_apply(&filter, 1000U);
+    }
+    ASSERT_EQ(1000U, output);
+
+    /* Full scale input at maximum order does not overflow the accumulator */
+    config.order = ADC_FILTER_EMA_MAX_ORDER;
+    ASSERT_EQ(ADC_FILTER_ERROR_OK, adc_filter_init(&filter, &config));
+    adc_filter_apply(&filter, 0U);
+    for (uint16_t i = 0 ; i < 2000U ; i++)
+    {
+        output = adc_filter_apply(&filter, 1023U);
+    }
+    ASSERT_EQ(1023U, output);
+}
+
+TEST(adc_filter_tests, boxcar_average)
+{
+    adc_filter_t filter;
+    adc_filter_config_t config = {ADC_FILTER_BOXCAR, 2U};
+    ASSERT_EQ(ADC_FILTER_ERROR_OK, adc_filter_init(&filter, &config));
+
+    ASSERT_EQ(8U, adc_filter_apply(&filter, 8U));
+    ASSERT_EQ(10U, adc_filter_apply(&filter, 16U));  /* 8 8 8 16  */
+    ASSERT_EQ(12U, adc_filter_apply(&filter, 16U));  /* 8 8 16 16 */
+    ASSERT_EQ(14U, adc_filter_apply(&filter, 16U));  /* 8 16 16 16 */
+    ASSERT_EQ(16U, adc_filter_apply(&filter, 16U));
+    ASSERT_EQ(16U, adc_filter_apply(&filter, 16U));
+    ASSERT_EQ(12U, adc_filter_apply(&filter, 0U));   /* 16 16 16 0 */
+
+    /* Reset discards the window content */
+    ASSERT_EQ(ADC_FILTER_ERROR_OK, adc_filter_reset(&filter));
+    ASSERT_EQ(500U, adc_filter_apply(&filter, 500U));
+    ASSERT_EQ(ADC_FILTER_ERROR_NULL_POINTER, adc_filter_reset(NULL));
+}
+
+TEST(adc_filter_tests, median_rejects_spikes)
+{
+    adc_filter_t filter;
+    adc_filter_config_t config = {ADC_FILTER_MEDIAN_3, 0};
+    ASSERT_EQ(ADC_FILTER_ERROR_OK, adc_filter_init(&filter, &config));
+
+    ASSERT_EQ(200U, adc_filter_apply(&filter, 200U));
+    ASSERT_EQ(200U, adc_filter_apply(&filter, 1023U));
+    ASSERT_EQ(201U, adc_filter_apply(&filter, 201U));
+    ASSERT_EQ(201U, adc_filter_apply(&filter, 0U));
+    ASSERT_EQ(201U, adc_filter_apply(&filter, 202U));
+
+    /* Every ordering of 3 distinct values */
+    const uint16_t orders[6][3] = {{1,2,3}, {1,3,2}, {2,1,3}, {2,3,1}, {3,1,2}, {3,2,1}};
+    for (const auto& order : orders)
+    {
+        adc_filter_init(&filter, &config);
+        adc_filter_apply(&filter, order[0]);
+        adc_filter_apply(&filter, order[0]);
+        adc_filter_apply(&filter, order[1]);
+        ASSERT_EQ(2U, adc_filter_apply(&filter, order[2]));
+    }
+}
+
+/* Filters are run from the conversion ISR, their cost per sample shall stay low and bounded.
+Host timings only give an order of magnitude, they are printed for reference but never asserted */
+TEST(adc_filter_tests, benchmark_cost_per_sample)
+{
+    const size_t sample_count = 1000000U;
+    std::vector<uint16_t> samples(sample_count);
+    std::mt19937 generator(1234U);
+    std::uniform_int_distribution<uint16_t> distribution(0U, 1023U);
+    for (auto& sample : samples)
+    {
+        sample = distribution(generator);
+    }
+
+    const adc_filter_config_t configs[] =
+    {
+        {ADC_FILTER_NONE, 0},
+        {ADC_FILTER_EMA, ADC_FILTER_EMA_MAX_ORDER},
+        {ADC_FILTER_BOXCAR, ADC_FILTER_BOXCAR_MAX_ORDER},
+        {ADC_FILTER_MEDIAN_3, 0},
+    };
+    const char * names[] = {"none", "ema", "boxcar", "median_3"};
+
+    for (uint8_t i = 0 ; i < sizeof(configs) / sizeof(configs[0]) ; i++)
+    {
+        adc_filter_t filter;
+        ASSERT_EQ(ADC_FILTER_ERROR_OK, adc_filter_init(&filter, &configs[i]));
+        volatile uint16_t output = 0;
+        const auto start = std::chrono::steady_clock::now();
+        for (const auto& sample : samples)
+        {
+            output = adc_filter_apply(&filter, sample);
+        }
+        const auto stop = std::chrono::steady_clock::now();
+        (void) output;
+
+        const double ns_per_sample = std::chrono::duration<double, std::nano>(stop - start).count() / sample_count;
+        std::cout << "[ BENCH    ] " << names[i] << " : " << ns_per_sample << " ns/sample" << std::endl;
+    }
+}
+
+/* The boxcar is the only filter holding a sample history : its cost stays constant as long as each sample only
+touches the running sum and the slot it replaces. Every other slot of the window is poisoned before each sample,
+so any loop over the history would show up in the output */
+TEST(adc_filter_tests, boxcar_cost_does_not_depend_on_window_length)
+{
+    adc_filter_t filter;
+    const adc_filter_config_t config = {ADC_FILTER_BOXCAR, ADC_FILTER_BOXCAR_MAX_ORDER};
+    const uint8_t length = (uint8_t)(1U << ADC_FILTER_BOXCAR_MAX_ORDER);
+    ASSERT_EQ(ADC_FILTER_ERROR_OK, adc_filter_init(&filter, &config));
+    adc_filter_apply(&filter, 0U);
+
+    std::mt19937 generator(1234U);
+    std::uniform_int_distribution<uint16_t> distribution(0U, 1023U);
+    for (uint16_t i = 0 ; i < 1000U ; i++)
+    {
+        const uint8_t index = filter.state.boxcar.index;
+        const uint16_t replaced = filter.state.boxcar.samples[index];
+        const uint16_t sum = filter.state.boxcar.sum;
+        for (uint8_t slot = 0 ; slot < length ; slot++)
+        {
+            if (slot != index)
+            {
+                filter.state.boxcar.samples[slot] = 0xFFFFU;
+            }
+        }
+
+        const uint16_t sample = distribution(generator);
+        const uint16_t expected_sum = (uint16_t)(sum - replaced + sample);
+        ASSERT_EQ(expected_sum >> ADC_FILTER_BOXCAR_MAX_ORDER, adc_filter_apply(&filter, sample));
+        ASSERT_EQ(expected_sum, filter.state.boxcar.sum);
+        ASSERT_EQ(sample, filter.state.boxcar.samples[index]);
+        ASSERT_EQ((index + 1U) % length, filter.state.boxcar.index);
+    }
+}
+
+int main(int argc, char **argv)
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
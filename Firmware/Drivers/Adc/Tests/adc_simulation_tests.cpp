@@ -0,0 +1,517 @@
+/*
+
+------------------
+@<FreeMyCode>
+FreeMyCode version : 1.0 RC alpha
+    Author : bebenlebricolo
+    License : 
+        name : GPLv3
+        url : https://www.gnu.org/licenses/quick-guide-gplv3.html
+    Date : 12/02/2021
+    Project : LabBenchPowerSupply
+    Description : The Lab Bench Power Supply provides a simple design based around an Arduino Nano board to convert AC main voltage into
+ smaller ones, ranging from 0V to 16V, with voltage and current regulations
+<FreeMyCode>@
+------------------
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+
+#include "gtest/gtest.h"
+#include "adc.h"
+#include "adc_reg.h"
+#include "adc_register_stub.h"
+#include "AdcConversionSimulator.hpp"
+#include "SignalSource.hpp"
+#include "LtspiceRawReader.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+#define SIMULATED_CPU_FREQUENCY     16000000.0
+#define SIMULATED_REFERENCE_VOLTAGE 5.0
+
+/* 13 ADC clock cycles with ADC_PRESCALER_128 @ 16 MHz */
+#define CONVERSION_TIME             (13.0 * 128.0 / SIMULATED_CPU_FREQUENCY)
+
+static uint16_t to_code(const double voltage)
+{
+    return static_cast<uint16_t>(std::floor(voltage * 1024.0 / SIMULATED_REFERENCE_VOLTAGE));
+}
+
+class AdcSimulationFixture : public ::testing::Test
+{
+public:
+    adc_config_hal_t config;
+    AdcConversionSimulator simulator{adc_register_stub, SIMULATED_CPU_FREQUENCY, SIMULATED_REFERENCE_VOLTAGE};
+protected:
+    void SetUp() override
+    {
+        adc_register_stub_erase(&adc_register_stub);
+        config.alignment = ADC_RIGT_ALIGNED_RESULT;
+        config.prescaler = ADC_PRESCALER_128;
+        config.ref = ADC_VOLTAGE_REF_AREF_PIN;
+        config.running_mode = ADC_RUNNING_MODE_SINGLE_SHOT;
+        config.supply_voltage_mv = 5000;
+        config.trigger_sources = ADC_TRIGGER_FREE_RUNNING;
+        config.using_interrupt = true;
+        config.supply_monitoring_period = 0;
+        adc_register_stub_init_adc_handle(&config.handle, &adc_register_stub);
+    }
+    void TearDown() override
+    {
+        adc_base_deinit();
+    }
+};
+
+TEST_F(AdcSimulationFixture, dc_sources_single_shot)
+{
+    ASSERT_EQ(ADC_ERROR_OK, adc_base_init(&config));
+    ASSERT_EQ(ADC_ERROR_OK, adc_register_channel(ADC_MUX_ADC0));
+    ASSERT_EQ(ADC_ERROR_OK, adc_register_channel(ADC_MUX_ADC1));
+    simulator.connect(ADC_MUX_ADC0, std::make_shared<DcSource>(1.25));
+    simulator.connect(ADC_MUX_ADC1, std::make_shared<DcSource>(3.3));
+    ASSERT_EQ(ADC_STATE_READY, adc_start());
+
+    ASSERT_EQ(100U, simulator.run_conversions(100U));
+
+    adc_result_t result = 0;
+    ASSERT_EQ(ADC_ERROR_OK, adc_read_raw(ADC_MUX_ADC0, &result));
+    ASSERT_EQ(to_code(1.25), result);
+    ASSERT_EQ(ADC_ERROR_OK, adc_read_raw(ADC_MUX_ADC1, &result));
+    ASSERT_EQ(to_code(3.3), result);
+
+    /* First conversion after enabling the ADC takes 25 ADC clock cycles instead of 13 */
+    ASSERT_NEAR((25.0 + 99.0 * 13.0) * 128.0 / SIMULATED_CPU_FREQUENCY, simulator.get_time(), 1e-9);
+
+    /* Conversions stop with the ADC */
+    adc_stop();
+    ASSERT_EQ(0U, simulator.run_conversions(10U));
+}
+
+TEST_F(AdcSimulationFixture, dc_sources_free_running)
+{
+    config.running_mode = ADC_RUNNING_MODE_AUTOTRIGGERED;
+    ASSERT_EQ(ADC_ERROR_OK, adc_base_init(&config));
+    ASSERT_EQ(ADC_ERROR_OK, adc_register_channel(ADC_MUX_ADC0));
+    ASSERT_EQ(ADC_ERROR_OK, adc_register_channel(ADC_MUX_ADC1));
+    ASSERT_EQ(ADC_ERROR_OK, adc_register_channel(ADC_MUX_ADC2));
+    simulator.connect(ADC_MUX_ADC0, std::make_shared<DcSource>(0.5));
+    simulator.connect(ADC_MUX_ADC1, std::make_shared<DcSource>(2.0));
+    simulator.connect(ADC_MUX_ADC2, std::make_shared<DcSource>(4.5));
+    ASSERT_EQ(ADC_STATE_READY, adc_start());
+
+    /* Mux is latched one conversion ahead : results shall still land in the right channel */
+    ASSERT_EQ(300U, simulator.run_conversions(300U));
+
+    adc_result_t result = 0;
+    ASSERT_EQ(ADC_ERROR_OK, adc_read_raw(ADC_MUX_ADC0, &result));
+    ASSERT_EQ(to_code(0.5), result);
+    ASSERT_EQ(ADC_ERROR_OK, adc_read_raw(ADC_MUX_ADC1, &result));
+    ASSERT_EQ(to_code(2.0), result);
+    ASSERT_EQ(ADC_ERROR_OK, adc_read_raw(ADC_MUX_ADC2, &result));
+    ASSERT_EQ(to_code(4.5), result);
+
+    uint32_t total = 0;
+    uint16_t overruns = 0;
+    ASSERT_EQ(ADC_ERROR_OK, adc_get_conversion_counters(&total, &overruns));
+    ASSERT_EQ(300U, total);
+    ASSERT_EQ(0U, overruns);
+}
+
+TEST_F(AdcSimulationFixture, ripple_attenuation_through_ema_filter)
+{
+    config.running_mode = ADC_RUNNING_MODE_AUTOTRIGGERED;
+    ASSERT_EQ(ADC_ERROR_OK, adc_base_init(&config));
+    ASSERT_EQ(ADC_ERROR_OK, adc_register_channel(ADC_MUX_ADC0));
+    adc_filter_t filter;
+    const adc_filter_config_t filter_config = {ADC_FILTER_EMA, 4U};
+    ASSERT_EQ(ADC_ERROR_OK, adc_set_channel_filter(ADC_MUX_ADC0, &filter, &filter_config));
+
+    /* 2.5V output with 200 mV of 1 kHz ripple, sampled at ~9.6 kS/s */
+    simulator.connect(ADC_MUX_ADC0, std::make_shared<SineSource>(2.5, 0.0, 0.0, 0.2, 1000.0));
+    ASSERT_EQ(ADC_STATE_READY, adc_start());
+    simulator.run_for(50e-3);
+
+    uint16_t raw_min = 0xFFFF, raw_max = 0, filtered_min = 0xFFFF, filtered_max = 0;
+    while (simulator.get_time() < 70e-3)
+    {
+        ASSERT_EQ(1U, simulator.run_conversions(1U));
+        adc_result_t raw = 0, filtered = 0;
+        ASSERT_EQ(ADC_ERROR_OK, adc_read_raw(ADC_MUX_ADC0, &raw));
+        ASSERT_EQ(ADC_ERROR_OK, adc_read_filtered(ADC_MUX_ADC0, &filtered));
+        raw_min = std::min(raw_min, raw);
+        raw_max = std::max(raw_max, raw);
+        filtered_min = std::min(filtered_min, filtered);
+        filtered_max = std::max(filtered_max, filtered);
+    }
+
+    /* Raw readings see the whole ripple, EMA (order 4) attenuates it by roughly a factor 10 at this frequency */
+    ASSERT_GE(raw_max - raw_min, to_code(0.38));
+    ASSERT_LT(filtered_max - filtered_min, (raw_max - raw_min) / 4);
+    ASSERT_NEAR(to_code(2.5), (filtered_max + filtered_min) / 2, 4);
+}
+
+static struct
+{
+    AdcConversionSimulator * simulator;
+    uint8_t calls;
+    double time;
+} step_trip_spy;
+
+static void step_trip_callback(const adc_mux_t channel, const adc_result_t value, const adc_window_crossing_t crossing)
+{
+    (void) channel;
+    (void) value;
+    (void) crossing;
+    step_trip_spy.calls++;
+    step_trip_spy.time = step_trip_spy.simulator->get_time();
+}
+
+TEST_F(AdcSimulationFixture, window_comparator_trip_latency)
+{
+    ASSERT_EQ(ADC_ERROR_OK, adc_base_init(&config));
+    ASSERT_EQ(ADC_ERROR_OK, adc_register_channel(ADC_MUX_ADC0));
+    ASSERT_EQ(ADC_ERROR_OK, adc_register_channel(ADC_MUX_ADC1));
+    const adc_window_t window = {0U, to_code(4.0), step_trip_callback};
+    ASSERT_EQ(ADC_ERROR_OK, adc_set_channel_window(ADC_MUX_ADC1, &window));
+
+    /* Over-current : current sense output steps from 1V to 4.5V after 5 ms */
+    const double step_time = 5e-3;
+    simulator.connect(ADC_MUX_ADC0, std::make_shared<DcSource>(2.0));
+    simulator.connect(ADC_MUX_ADC1, std::make_shared<StepSource>(1.0, 4.5, step_time));
+    step_trip_spy = {&simulator, 0U, 0.0};
+    ASSERT_EQ(ADC_STATE_READY, adc_start());
+
+    simulator.run_for(10e-3);
+    ASSERT_EQ(1U, step_trip_spy.calls);
+    ASSERT_GT(step_trip_spy.time, step_time);
+
+    /* Worst case : ADC1 was just sampled before the step, then ADC0 and ADC1 have to be converted again */
+    ASSERT_LE(step_trip_spy.time - step_time, 3.0 * CONVERSION_TIME);
+
+    uint16_t faults = 0;
+    ASSERT_EQ(ADC_ERROR_OK, adc_get_window_faults(&faults));
+    ASSERT_EQ(1U << ADC_MUX_ADC1, faults);
+}
+
+TEST_F(AdcSimulationFixture, averaging_reduces_noise)
+{
+    ASSERT_EQ(ADC_ERROR_OK, adc_base_init(&config));
+    ASSERT_EQ(ADC_ERROR_OK, adc_register_channel(ADC_MUX_ADC0));
+    ASSERT_EQ(ADC_ERROR_OK, adc_register_channel(ADC_MUX_ADC1));
+    ASSERT_EQ(ADC_ERROR_OK, adc_set_channel_settling(ADC_MUX_ADC1, 0U, 2U));
+
+    adc_statistics_t statistics[2];
+    ASSERT_EQ(ADC_ERROR_OK, adc_set_channel_statistics(ADC_MUX_ADC0, &statistics[0], 256U));
+    ASSERT_EQ(ADC_ERROR_OK, adc_set_channel_statistics(ADC_MUX_ADC1, &statistics[1], 256U));
+
+    /* Same 2.5V signal with ~4 LSB rms of noise on both channels, ADC1 averages 4 conversions per result */
+    simulator.connect(ADC_MUX_ADC0, std::make_shared<NoiseSource>(std::make_shared<DcSource>(2.5), 0.02, 1U));
+    simulator.connect(ADC_MUX_ADC1, std::make_shared<NoiseSource>(std::make_shared<DcSource>(2.5), 0.02, 2U));
+    ASSERT_EQ(ADC_STATE_READY, adc_start());
+    simulator.run_conversions(5U * 256U + 10U);
+
+    adc_statistics_summary_t raw_summary;
+    adc_statistics_summary_t averaged_summary;
+    ASSERT_EQ(ADC_ERROR_OK, adc_get_channel_statistics(ADC_MUX_ADC0, &raw_summary));
+    ASSERT_EQ(ADC_ERROR_OK, adc_get_channel_statistics(ADC_MUX_ADC1, &averaged_summary));
+    ASSERT_EQ(256U, raw_summary.count);
+    ASSERT_EQ(256U, averaged_summary.count);
+
+    ASSERT_NEAR(to_code(2.5) * 256.0, raw_summary.mean_q8, 256.0);
+    ASSERT_NEAR(to_code(2.5) * 256.0, averaged_summary.mean_q8, 256.0);
+
+    /* Averaging 4 samples divides variance by 4 (quantisation aside) */
+    ASSERT_GT(raw_summary.variance_q8, 256U * 4U);
+    ASSERT_LT(averaged_summary.variance_q8, raw_summary.variance_q8 / 2U);
+}
+
+TEST_F(AdcSimulationFixture, noise_reduction_sleep_benchmark)
+{
+    ASSERT_EQ(ADC_ERROR_OK, adc_base_init(&config));
+    ASSERT_EQ(ADC_ERROR_OK, adc_register_channel(ADC_MUX_ADC0));
+    ASSERT_EQ(ADC_ERROR_OK, adc_register_channel(ADC_MUX_ADC1));
+    ASSERT_EQ(ADC_ERROR_OK, adc_set_channel_noise_reduction(ADC_MUX_ADC1, true));
+
+    adc_statistics_t statistics[2];
+    ASSERT_EQ(ADC_ERROR_OK, adc_set_channel_statistics(ADC_MUX_ADC0, &statistics[0], 256U));
+    ASSERT_EQ(ADC_ERROR_OK, adc_set_channel_statistics(ADC_MUX_ADC1, &statistics[1], 256U));
+
+    /* Same clean signal on both channels (centered on code 512), CPU activity couples 1.5 LSB rms of noise into
+    active mode conversions */
+    const double voltage = 512.5 * SIMULATED_REFERENCE_VOLTAGE / 1024.0;
+    simulator.set_digital_noise(1.5);
+    simulator.connect(ADC_MUX_ADC0, std::make_shared<DcSource>(voltage));
+    simulator.connect(ADC_MUX_ADC1, std::make_shared<DcSource>(voltage));
+    ASSERT_EQ(ADC_STATE_READY, adc_start());
+
+    /* Main loop : ADC1 conversions are started by entering sleep */
+    const uint64_t conversions = 2U * (3U * 256U);
+    while (simulator.get_conversion_count() < conversions)
+    {
+        if (adc_noise_reduction_pending())
+        {
+            ASSERT_TRUE(simulator.sleep());
+        }
+        else
+        {
+            ASSERT_EQ(1U, simulator.run_conversions(1U));
+        }
+    }
+    ASSERT_EQ(conversions / 2U, simulator.get_sleep_conversion_count());
+
+    /* Sleeping does not slow the scan down : ADC timings are the same in both modes */
+    ASSERT_NEAR((25.0 + (conversions - 1U) * 13.0) * 128.0 / SIMULATED_CPU_FREQUENCY, simulator.get_time(), 1e-9);
+
+    adc_statistics_summary_t normal_summary;
+    adc_statistics_summary_t quiet_summary;
+    ASSERT_EQ(ADC_ERROR_OK, adc_get_channel_statistics(ADC_MUX_ADC0, &normal_summary));
+    ASSERT_EQ(ADC_ERROR_OK, adc_get_channel_statistics(ADC_MUX_ADC1, &quiet_summary));
+    ASSERT_EQ(256U, normal_summary.count);
+    ASSERT_EQ(256U, quiet_summary.count);
+    ASSERT_NEAR(512.0 * 256.0, normal_summary.mean_q8, 64.0);
+    ASSERT_EQ(512U * 256U, quiet_summary.mean_q8);
+
+    /* Active mode variance is the coupled noise one (1.5 LSB rms) plus quantisation (1/12 LSB^2), sleeping conversions all land on the same code */
+    ASSERT_NEAR((1.5 * 1.5) + (1.0 / 12.0), normal_summary.variance_q8 / 256.0, 0.6);
+    ASSERT_EQ(512U, quiet_summary.min);
+    ASSERT_EQ(512U, quiet_summary.max);
+    ASSERT_EQ(0U, quiet_summary.variance_q8);
+}
+
+TEST_F(AdcSimulationFixture, die_temperature_alongside_aref_channels)
+{
+    ASSERT_EQ(ADC_ERROR_OK, adc_base_init(&config));
+    ASSERT_EQ(ADC_ERROR_OK, adc_register_channel(ADC_MUX_ADC0));
+    ASSERT_EQ(ADC_ERROR_OK, adc_register_channel(ADC_MUX_ADC1));
+    /* Board with a 1 nF AREF capacitor : 8 time constants last 256 us, within the protection latency */
+    ASSERT_EQ(ADC_ERROR_OK, adc_set_reference_settling(3U));
+    ASSERT_EQ(ADC_ERROR_OK, adc_register_channel(ADC_MUX_INTERNAL_TEMPERATURE));
+    ASSERT_EQ(ADC_ERROR_OK, adc_set_channel_divider(ADC_MUX_INTERNAL_TEMPERATURE, 8U));
+
+    /* Sensor outputs 354 mV at 65 degrees, converted against 1V1 while other channels use 5V */
+    simulator.connect(ADC_MUX_ADC0, std::make_shared<DcSource>(1.0));
+    simulator.connect(ADC_MUX_ADC1, std::make_shared<DcSource>(4.0));
+    simulator.connect(ADC_MUX_INTERNAL_TEMPERATURE, std::make_shared<DcSource>(0.354));
+    ASSERT_EQ(ADC_STATE_READY, adc_start());
+    simulator.run_for(20e-3);
+
+    adc_result_t result = 0;
+    ASSERT_EQ(ADC_ERROR_OK, adc_read_raw(ADC_MUX_ADC0, &result));
+    ASSERT_EQ(to_code(1.0), result);
+    ASSERT_EQ(ADC_ERROR_OK, adc_read_raw(ADC_MUX_ADC1, &result));
+    ASSERT_EQ(to_code(4.0), result);
+    int16_t temperature = 0;
+    ASSERT_EQ(ADC_ERROR_OK, adc_read_die_temperature(&temperature));
+    ASSERT_NEAR(65, temperature, 1);
+}
+
+TEST_F(AdcSimulationFixture, recorded_trace_replay)
+{
+    /* Linear interpolation between points : 0V -> 5V over 10 ms */
+    std::istringstream trace("# time (s), voltage (V)\n"
+                             "0.0, 0.0\n"
+                             "0.01, 5.0\n");
+    auto source = std::make_shared<CsvSource>(trace);
+    ASSERT_EQ(2U, source->size());
+
+    ASSERT_EQ(ADC_ERROR_OK, adc_base_init(&config));
+    ASSERT_EQ(ADC_ERROR_OK, adc_register_channel(ADC_MUX_ADC0));
+    simulator.connect(ADC_MUX_ADC0, source);
+    ASSERT_EQ(ADC_STATE_READY, adc_start());
+
+    simulator.run_for(5e-3);
+    adc_result_t result = 0;
+    ASSERT_EQ(ADC_ERROR_OK, adc_read_raw(ADC_MUX_ADC0, &result));
+    ASSERT_EQ(simulator.get_last_result(), result);
+    ASSERT_NEAR(512, result, 15);
+
+    /* Trace holds its last value past its end */
+    simulator.run_for(10e-3);
+    ASSERT_EQ(ADC_ERROR_OK, adc_read_raw(ADC_MUX_ADC0, &result));
+    ASSERT_EQ(1023U, result);
+}
+
+TEST_F(AdcSimulationFixture, throughput_benchmark)
+{
+    config.running_mode = ADC_RUNNING_MODE_AUTOTRIGGERED;
+    ASSERT_EQ(ADC_ERROR_OK, adc_base_init(&config));
+    ASSERT_EQ(ADC_ERROR_OK, adc_register_channel(ADC_MUX_ADC0));
+    ASSERT_EQ(ADC_ERROR_OK, adc_register_channel(ADC_MUX_ADC1));
+    ASSERT_EQ(ADC_ERROR_OK, adc_register_channel(ADC_MUX_ADC2));
+    adc_filter_t filter;
+    const adc_filter_config_t filter_config = {ADC_FILTER_EMA, 3U};
+    ASSERT_EQ(ADC_ERROR_OK, adc_set_channel_filter(ADC_MUX_ADC0, &filter, &filter_config));
+    simulator.connect(ADC_MUX_ADC0, std::make_shared<SineSource>(2.5, 1.0, 50.0, 0.1, 1000.0));
+    simulator.connect(ADC_MUX_ADC1, std::make_shared<RampSource>(0.0, 5.0, 1.0));
+    simulator.connect(ADC_MUX_ADC2, std::make_shared<NoiseSource>(std::make_shared<DcSource>(1.0), 0.01));
+    ASSERT_EQ(ADC_STATE_READY, adc_start());
+
+    const uint64_t conversions = 1000000U;
+    const auto start = std::chrono::steady_clock::now();
+    ASSERT_EQ(conversions, simulator.run_conversions(conversions));
+    const auto end = std::chrono::steady_clock::now();
+
+    const double elapsed = std::chrono::duration<double>(end - start).count();
+    const double rate = static_cast<double>(conversions) / elapsed;
+    std::cout << "Simulated " << conversions << " conversions (" << simulator.get_time() << " s of ADC time) in "
+              << elapsed << " s : " << rate / 1e6 << " MS/s" << std::endl;
+
+    /* Generous bound, only meant to catch pathological slowdowns in the driver's ISR path */
+    ASSERT_GT(rate, 1e5);
+}
+
+TEST(ltspice_raw_reader, binary_transient_trace)
+{
+    LtspiceRawReader reader(SIMULATIONS_DIR "/MosfetDriverAntiLatchup.raw");
+    ASSERT_EQ(LtspiceRawReader::Status::Ok, reader.get_status());
+    ASSERT_EQ(37U, reader.get_variables().size());
+    ASSERT_EQ(2470U, reader.get_point_count());
+    ASSERT_EQ(0, reader.find_variable("time"));
+    ASSERT_EQ(4, reader.find_variable("v(10v)"));
+    ASSERT_EQ(-1, reader.find_variable("V(does_not_exist)"));
+
+    /* First points : t = 0 and t = 10 us */
+    const size_t gate = static_cast<size_t>(reader.find_variable("V(n005)"));
+    ASSERT_NEAR(9.957107, reader.interpolate(gate, 0.0), 1e-5);
+    ASSERT_NEAR((9.957107 + 9.956840) / 2.0, reader.interpolate(gate, 5e-6), 1e-5);
+    ASSERT_NEAR(10.0, reader.interpolate(4U, 50e-3), 1e-5);
+
+    /* Value is held past the end of the trace, and going backward rewinds it */
+    ASSERT_NEAR(0.009411, reader.interpolate(gate, 1.0), 1e-5);
+    ASSERT_NEAR(9.957107, reader.interpolate(gate, 0.0), 1e-5);
+}
+
+TEST(ltspice_raw_reader, ascii_trace_and_errors)
+{
+    const std::string path = ::testing::TempDir() + "ltspice_ascii_trace.raw";
+    {
+        std::ofstream file(path);
+        file << "Title: * ascii test\n"
+                "Plotname: Transient Analysis\n"
+                "Flags: real forward\n"
+                "No. Variables: 2\n"
+                "No. Points: 3\n"
+                "Variables:\n"
+                "\t0\ttime\ttime\n"
+                "\t1\tV(out)\tvoltage\n"
+                "Values:\n"
+                "0\t0.0\n\t1.0\n"
+                "1\t1e-3\n\t3.0\n"
+                "2\t-2e-3\n\t2.0\n";
+    }
+    auto reader = std::make_shared<LtspiceRawReader>(path);
+    ASSERT_EQ(LtspiceRawReader::Status::Ok, reader->get_status());
+    LtspiceSource source(reader, "V(out)", 0.5);
+    ASSERT_TRUE(source.is_valid());
+    ASSERT_NEAR(0.5, source.sample(0.0), 1e-9);
+    ASSERT_NEAR(1.0, source.sample(0.5e-3), 1e-9);
+    /* Negative time flags a compressed point : its absolute value is used */
+    ASSERT_NEAR(1.25, source.sample(1.5e-3), 1e-9);
+    ASSERT_NEAR(1.0, source.sample(5e-3), 1e-9);
+    std::remove(path.c_str());
+
+    LtspiceRawReader missing(SIMULATIONS_DIR "/does_not_exist.raw");
+    ASSERT_EQ(LtspiceRawReader::Status::FileNotFound, missing.get_status());
+
+    /* Malformed counts and values are reported, not thrown */
+    {
+        std::ofstream file(path);
+        file << "Title: * ascii test\n"
+                "Flags: real forward\n"
+                "No. Variables: two\n";
+    }
+    LtspiceRawReader bad_count(path);
+    ASSERT_EQ(LtspiceRawReader::Status::BadHeader, bad_count.get_status());
+    {
+        std::ofstream file(path);
+        file << "Title: * ascii test\n"
+                "Flags: real forward\n"
+                "No. Variables: 2\n"
+                "No. Points: 99999999999999999999999\n";
+    }
+    LtspiceRawReader huge_count(path);
+    ASSERT_EQ(LtspiceRawReader::Status::BadHeader, huge_count.get_status());
+    {
+        std::ofstream file(path);
+        file << "Title: * ascii test\n"
+                "Flags: real forward\n"
+                "No. Variables: 2\n"
+                "No. Points: 2\n"
+                "Variables:\n"
+                "\t0\ttime\ttime\n"
+                "\t1\tV(out)\tvoltage\n"
+                "Values:\n"
+                "0\t0.0\n\t1.0\n"
+                "1\t1e-3\n\tnope\n";
+    }
+    auto bad_value = std::make_shared<LtspiceRawReader>(path);
+    ASSERT_EQ(LtspiceRawReader::Status::Ok, bad_value->get_status());
+    LtspiceSource truncated(bad_value, "V(out)");
+    ASSERT_NEAR(1.0, truncated.sample(2e-3), 1e-9);
+    std::remove(path.c_str());
+
+    /* Operating point files share the same layout, with a single point */
+    LtspiceRawReader op(SIMULATIONS_DIR "/MosfetDriverAntiLatchup.op.raw");
+    ASSERT_EQ(LtspiceRawReader::Status::Ok, op.get_status());
+    ASSERT_EQ(1U, op.get_point_count());
+}
+
+TEST_F(AdcSimulationFixture, ltspice_trace_injection)
+{
+    ASSERT_EQ(ADC_ERROR_OK, adc_base_init(&config));
+    ASSERT_EQ(ADC_ERROR_OK, adc_register_channel(ADC_MUX_ADC0));
+    ASSERT_EQ(ADC_ERROR_OK, adc_register_channel(ADC_MUX_ADC1));
+
+    /* 10V rail and MOSFET driver node, both seen through a 1/4 divider. Driver node drops from ~10V to ~0V
+    at 9 ms, and every 20 ms afterwards */
+    auto reader = std::make_shared<LtspiceRawReader>(SIMULATIONS_DIR "/MosfetDriverAntiLatchup.raw");
+    auto rail = std::make_shared<LtspiceSource>(reader, "V(10v)", 0.25);
+    auto gate = std::make_shared<LtspiceSource>(reader, "V(n005)", 0.25);
+    ASSERT_TRUE(rail->is_valid());
+    ASSERT_TRUE(gate->is_valid());
+    simulator.connect(ADC_MUX_ADC0, rail);
+    simulator.connect(ADC_MUX_ADC1, gate);
+
+    const adc_window_t window = {to_code(1.25), 1023U, step_trip_callback};
+    ASSERT_EQ(ADC_ERROR_OK, adc_set_channel_window(ADC_MUX_ADC1, &window));
+    step_trip_spy = {&simulator, 0U, 0.0};
+    ASSERT_EQ(ADC_STATE_READY, adc_start());
+
+    simulator.run_for(8e-3);
+    adc_result_t result = 0;
+    ASSERT_EQ(ADC_ERROR_OK, adc_read_raw(ADC_MUX_ADC0, &result));
+    ASSERT_NEAR(to_code(2.5), result, 1);
+    ASSERT_EQ(ADC_ERROR_OK, adc_read_raw(ADC_MUX_ADC1, &result));
+    ASSERT_GT(result, to_code(2.4));
+    ASSERT_EQ(0U, step_trip_spy.calls);
+
+    simulator.run_for(4e-3);
+    ASSERT_EQ(1U, step_trip_spy.calls);
+    ASSERT_GT(step_trip_spy.time, 9e-3);
+    ASSERT_LT(step_trip_spy.time, 9e-3 + 3.0 * CONVERSION_TIME);
+}
+
+int main(int argc, char **argv)
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
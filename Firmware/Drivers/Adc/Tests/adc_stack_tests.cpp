@@ -29,6 +29,7 @@ along with this program.  If not, see <https://www.gnu.org/licenses/>.
 */
 
 #include "gtest/gtest.h"
+#include "adc.h"
 #include "adc_stack.h"
 
 static adc_mux_t mux_lookup_table[ADC_MUX_COUNT] = 
@@ -191,6 +192,166 @@ TEST(adc_stack_tests, get_current)
     }
 }
 
+TEST(adc_stack_tests, get_next_with_divider)
+{
+    volatile adc_stack_t registered_channels;
+    adc_stack_reset(&registered_channels);
+    adc_stack_register_channel(&registered_channels, ADC_MUX_ADC0);
+    adc_stack_register_channel(&registered_channels, ADC_MUX_1v1_REF);
+    adc_stack_register_channel(&registered_channels, ADC_MUX_ADC1);
+
+    ASSERT_EQ(ADC_STACK_ERROR_ELEMENT_NOT_FOUND, adc_stack_set_divider(&registered_channels, ADC_MUX_ADC5, 4U));
+    ASSERT_EQ(ADC_STACK_ERROR_OK, adc_stack_set_divider(&registered_channels, ADC_MUX_1v1_REF, 4U));
+
+    /* Index starts at ADC0 : 1v1 reference is converted on first pass, then once every 4 scan cycles */
+    uint8_t bandgap_conversions = 0;
+    uint8_t adc1_conversions = 0;
+    volatile adc_channel_pair_t * pair = NULL;
+    for (uint8_t i = 0 ; i < 40U ; i++)
+    {
+        ASSERT_EQ(ADC_STACK_ERROR_OK, adc_stack_get_next(&registered_channels, &pair));
+        bandgap_conversions += (ADC_MUX_1v1_REF == pair->channel) ? 1U : 0U;
+        adc1_conversions += (ADC_MUX_ADC1 == pair->channel) ? 1U : 0U;
+    }
+    /* Pattern is (1v1, ADC1, ADC0) x 1 followed by (ADC1, ADC0) x 3 : 9 conversions every 4 scan cycles */
+    ASSERT_EQ(5U, bandgap_conversions);
+    ASSERT_EQ(18U, adc1_conversions);
+
+    /* A lonely divided channel is still returned, even if not due yet */
+    adc_stack_reset(&registered_channels);
+    adc_stack_register_channel(&registered_channels, ADC_MUX_1v1_REF);
+    ASSERT_EQ(ADC_STACK_ERROR_OK, adc_stack_set_divider(&registered_channels, ADC_MUX_1v1_REF, 4U));
+    for (uint8_t i = 0 ; i < 10U ; i++)
+    {
+        ASSERT_EQ(ADC_STACK_ERROR_OK, adc_stack_get_next(&registered_channels, &pair));
+        ASSERT_EQ(ADC_MUX_1v1_REF, pair->channel);
+    }
+}
+
+TEST(adc_stack_tests, publish_scan_cycle)
+{
+    volatile adc_stack_t registered_channels;
+    adc_stack_reset(&registered_channels);
+    ASSERT_EQ(ADC_STACK_ERROR_NULL_POINTER, adc_stack_publish(NULL));
+    ASSERT_EQ(0U, registered_channels.scan_cycle);
+
+    adc_stack_register_channel(&registered_channels, ADC_MUX_ADC0);
+    adc_stack_register_channel(&registered_channels, ADC_MUX_ADC1);
+    registered_channels.channels_pair[0].result = 12U;
+    registered_channels.channels_pair[1].result = 34U;
+    ASSERT_EQ(0U, registered_channels.channels_pair[0].published);
+
+    ASSERT_EQ(ADC_STACK_ERROR_OK, adc_stack_publish(&registered_channels));
+    ASSERT_EQ(1U, registered_channels.scan_cycle);
+    ASSERT_EQ(12U, registered_channels.channels_pair[0].published);
+    ASSERT_EQ(34U, registered_channels.channels_pair[1].published);
+
+    /* Published values survive removal of previous channels */
+    adc_stack_unregister_channel(&registered_channels, ADC_MUX_ADC0);
+    ASSERT_EQ(34U, registered_channels.channels_pair[0].published);
+}
+
+TEST(adc_stack_tests, get_next_with_settling_sequence)
+{
+    volatile adc_stack_t registered_channels;
+    adc_stack_reset(&registered_channels);
+    adc_stack_register_channel(&registered_channels, ADC_MUX_ADC0);
+    adc_stack_register_channel(&registered_channels, ADC_MUX_ADC3);
+    ASSERT_EQ(ADC_STACK_ERROR_ELEMENT_NOT_FOUND, adc_stack_set_settling(&registered_channels, ADC_MUX_ADC5, 1U, 1U));
+    ASSERT_EQ(ADC_STACK_ERROR_OK, adc_stack_set_settling(&registered_channels, ADC_MUX_ADC3, 2U, 1U));
+    ASSERT_EQ(1U, adc_channel_pair_sequence_length(&registered_channels.channels_pair[0]));
+    ASSERT_EQ(4U, adc_channel_pair_sequence_length(&registered_channels.channels_pair[1]));
+
+    /* Settling configuration survives a scan divider change */
+    ASSERT_EQ(ADC_STACK_ERROR_OK, adc_stack_set_divider(&registered_channels, ADC_MUX_ADC3, 0U));
+    ASSERT_EQ(4U, adc_channel_pair_sequence_length(&registered_channels.channels_pair[1]));
+
+    /* ADC3 is converted 2 + 2^1 times in a row each time it is selected */
+    const adc_mux_t expected[] = {ADC_MUX_ADC0, ADC_MUX_ADC3, ADC_MUX_ADC3, ADC_MUX_ADC3, ADC_MUX_ADC3,
+                                  ADC_MUX_ADC0, ADC_MUX_ADC3, ADC_MUX_ADC3, ADC_MUX_ADC3, ADC_MUX_ADC3, ADC_MUX_ADC0};
+    volatile adc_channel_pair_t * pair = NULL;
+    ASSERT_EQ(ADC_STACK_ERROR_OK, adc_stack_rewind(&registered_channels, &pair));
+    ASSERT_EQ(expected[0], pair->channel);
+    for (uint8_t i = 1 ; i < sizeof(expected) / sizeof(expected[0]) ; i++)
+    {
+        ASSERT_EQ(ADC_STACK_ERROR_OK, adc_stack_get_next(&registered_channels, &pair));
+        ASSERT_EQ(expected[i], pair->channel);
+    }
+
+    /* Rewinding in the middle of a sequence restarts from the first channel */
+    ASSERT_EQ(ADC_STACK_ERROR_OK, adc_stack_get_next(&registered_channels, &pair));
+    ASSERT_EQ(ADC_MUX_ADC3, pair->channel);
+    ASSERT_EQ(ADC_STACK_ERROR_OK, adc_stack_rewind(&registered_channels, &pair));
+    ASSERT_EQ(ADC_MUX_ADC0, pair->channel);
+}
+
+TEST(adc_stack_tests, get_next_with_reference_switching)
+{
+    volatile adc_stack_t registered_channels;
+    adc_stack_reset(&registered_channels);
+    adc_stack_register_channel(&registered_channels, ADC_MUX_ADC0);
+    adc_stack_register_channel(&registered_channels, ADC_MUX_ADC1);
+    adc_stack_register_channel(&registered_channels, ADC_MUX_INTERNAL_TEMPERATURE);
+    registered_channels.reference_settling = 2U;
+    ASSERT_EQ(ADC_STACK_ERROR_ELEMENT_NOT_FOUND, adc_stack_set_reference(&registered_channels, ADC_MUX_ADC5, ADC_VOLTAGE_REF_INTERNAL_1V1));
+    ASSERT_EQ(ADC_STACK_ERROR_OK, adc_stack_set_reference(&registered_channels, ADC_MUX_INTERNAL_TEMPERATURE, ADC_VOLTAGE_REF_INTERNAL_1V1));
+
+    /* Switching to and from the temperature sensor reference adds 2 conversions, ADC0 -> ADC1 does not */
+    const adc_mux_t expected[] = {ADC_MUX_ADC0, ADC_MUX_ADC1,
+                                  ADC_MUX_INTERNAL_TEMPERATURE, ADC_MUX_INTERNAL_TEMPERATURE, ADC_MUX_INTERNAL_TEMPERATURE,
+                                  ADC_MUX_ADC0, ADC_MUX_ADC0, ADC_MUX_ADC0, ADC_MUX_ADC1};
+    const uint8_t expected_reference_discard[] = {0U, 0U, 2U, 2U, 2U, 2U, 2U, 2U, 0U};
+    volatile adc_channel_pair_t * pair = NULL;
+    ASSERT_EQ(ADC_STACK_ERROR_OK, adc_stack_rewind(&registered_channels, &pair));
+    ASSERT_EQ(expected[0], pair->channel);
+    for (uint8_t i = 1 ; i < sizeof(expected) / sizeof(expected[0]) ; i++)
+    {
+        ASSERT_EQ(ADC_STACK_ERROR_OK, adc_stack_get_next(&registered_channels, &pair));
+        ASSERT_EQ(expected[i], pair->channel);
+        ASSERT_EQ(expected_reference_discard[i], pair->reference_discard);
+    }
+
+    /* AREF capacitor settling lasts longer than the longest averaged sequence */
+    registered_channels.reference_settling = ADC_REFERENCE_SETTLING_CONVERSIONS;
+    ASSERT_EQ(493U, ADC_REFERENCE_SETTLING_CONVERSIONS);
+    ASSERT_EQ(ADC_STACK_ERROR_OK, adc_stack_get_next(&registered_channels, &pair));
+    ASSERT_EQ(ADC_MUX_INTERNAL_TEMPERATURE, pair->channel);
+    ASSERT_EQ(ADC_REFERENCE_SETTLING_CONVERSIONS, pair->reference_discard);
+    ASSERT_EQ(ADC_REFERENCE_SETTLING_CONVERSIONS, pair->repeat);
+
+    /* Scan divider and settling configuration are independent */
+    adc_stack_set_settling(&registered_channels, ADC_MUX_INTERNAL_TEMPERATURE, 1U, 0U);
+    adc_stack_set_divider(&registered_channels, ADC_MUX_INTERNAL_TEMPERATURE, 4U);
+    ASSERT_EQ(2U, adc_channel_pair_sequence_length(&registered_channels.channels_pair[2]));
+}
+
+TEST(adc_stack_tests, group_settling_channels)
+{
+    volatile adc_stack_t registered_channels;
+    adc_stack_reset(&registered_channels);
+    ASSERT_EQ(ADC_STACK_ERROR_NULL_POINTER, adc_stack_group_settling_channels(NULL));
+    const adc_mux_t registered[] = {ADC_MUX_ADC3, ADC_MUX_ADC0, ADC_MUX_ADC4, ADC_MUX_ADC1, ADC_MUX_ADC2};
+    for (const auto& channel : registered)
+    {
+        adc_stack_register_channel(&registered_channels, channel);
+    }
+    adc_stack_set_settling(&registered_channels, ADC_MUX_ADC3, 2U, 0U);
+    adc_stack_set_settling(&registered_channels, ADC_MUX_ADC4, 1U, 2U);
+    adc_stack_set_settling(&registered_channels, ADC_MUX_ADC1, 0U, 2U);
+
+    ASSERT_EQ(ADC_STACK_ERROR_OK, adc_stack_group_settling_channels(&registered_channels));
+    const adc_mux_t expected[] = {ADC_MUX_ADC0, ADC_MUX_ADC1, ADC_MUX_ADC2, ADC_MUX_ADC3, ADC_MUX_ADC4};
+    for (uint8_t i = 0 ; i < 5U ; i++)
+    {
+        ASSERT_EQ(expected[i], registered_channels.channels_pair[i].channel);
+    }
+    /* Settings follow their channel */
+    ASSERT_EQ(2U, registered_channels.channels_pair[1].average_order);
+    ASSERT_EQ(2U, registered_channels.channels_pair[3].discard);
+    ASSERT_EQ(1U, registered_channels.channels_pair[4].discard);
+    ASSERT_EQ(0U, registered_channels.index);
+}
+
 int main(int argc, char **argv)
 {
     ::testing::InitGoogleTest(&argc, argv);
@@ -0,0 +1,177 @@
+/*
+
+------------------
+@<FreeMyCode>
+FreeMyCode version : 1.0 RC alpha
+    Author : bebenlebricolo
+    License : 
+        name : GPLv3
+        url : https://www.gnu.org/licenses/quick-guide-gplv3.html
+    Date : 12/02/2021
+    Project : LabBenchPowerSupply
+    Description : The Lab Bench Power Supply provides a simple design based around an Arduino Nano board to convert AC main voltage into
+ smaller ones, ranging from 0V to 16V, with voltage and current regulations
+<FreeMyCode>@
+------------------
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+
+#include "gtest/gtest.h"
+#include "adc_statistics.h"
+
+#include <random>
+#include <vector>
+
+TEST(adc_statistics_tests, init_checks_window_length)
+{
+    adc_statistics_t stats;
+    ASSERT_EQ(ADC_STATISTICS_ERROR_NULL_POINTER, adc_statistics_init(NULL, 16U));
+    ASSERT_EQ(ADC_STATISTICS_ERROR_CONFIG, adc_statistics_init(&stats, 0U));
+    ASSERT_EQ(ADC_STATISTICS_ERROR_CONFIG, adc_statistics_init(&stats, ADC_STATISTICS_MAX_WINDOW + 1U));
+    ASSERT_EQ(ADC_STATISTICS_ERROR_OK, adc_statistics_init(&stats, ADC_STATISTICS_MAX_WINDOW));
+    ASSERT_EQ(0U, stats.window_id);
+    ASSERT_EQ(0U, stats.latched.count);
+
+    adc_statistics_summary_t summary;
+    ASSERT_EQ(ADC_STATISTICS_ERROR_NULL_POINTER, adc_statistics_summarize(NULL, &summary));
+    ASSERT_EQ(ADC_STATISTICS_ERROR_NULL_POINTER, adc_statistics_summarize(&stats.latched, NULL));
+    ASSERT_EQ(ADC_STATISTICS_ERROR_OK, adc_statistics_summarize(&stats.latched, &summary));
+    ASSERT_EQ(0U, summary.count);
+    ASSERT_EQ(0U, summary.mean_q8);
+    ASSERT_EQ(0U, summary.variance_q8);
+}
+
+TEST(adc_statistics_tests, window_is_latched_when_full)
+{
+    adc_statistics_t stats;
+    ASSERT_EQ(ADC_STATISTICS_ERROR_OK, adc_statistics_init(&stats, 4U));
+
+    const uint16_t samples[4] = {10U, 14U, 10U, 14U};
+    for (uint8_t i = 0 ; i < 3U ; i++)
+    {
+        adc_statistics_push(&stats, samples[i]);
+    }
+    ASSERT_EQ(0U, stats.window_id);
+    adc_statistics_push(&stats, samples[3]);
+    ASSERT_EQ(1U, stats.window_id);
+    ASSERT_EQ(0U, stats.running.count);
+
+    adc_statistics_summary_t summary;
+    ASSERT_EQ(ADC_STATISTICS_ERROR_OK, adc_statistics_summarize(&stats.latched, &summary));
+    ASSERT_EQ(4U, summary.count);
+    ASSERT_EQ(10U, summary.min);
+    ASSERT_EQ(14U, summary.max);
+    ASSERT_EQ(12U * 256U, summary.mean_q8);
+    ASSERT_EQ(4U * 256U, summary.variance_q8);
+
+    /* Next window starts from scratch */
+    for (uint8_t i = 0 ; i < 4U ; i++)
+    {
+        adc_statistics_push(&stats, 500U);
+    }
+    ASSERT_EQ(2U, stats.window_id);
+    ASSERT_EQ(ADC_STATISTICS_ERROR_OK, adc_statistics_summarize(&stats.latched, &summary));
+    ASSERT_EQ(500U, summary.min);
+    ASSERT_EQ(500U, summary.max);
+    ASSERT_EQ(500U * 256U, summary.mean_q8);
+    ASSERT_EQ(0U, summary.variance_q8);
+}
+
+TEST(adc_statistics_tests, restart_discards_running_window_only)
+{
+    adc_statistics_t stats;
+    ASSERT_EQ(ADC_STATISTICS_ERROR_OK, adc_statistics_init(&stats, 4U));
+    for (uint8_t i = 0 ; i < 4U ; i++)
+    {
+        adc_statistics_push(&stats, 100U);
+    }
+
+    /* Samples pushed before the restart do not end up in next window */
+    adc_statistics_push(&stats, 1000U);
+    adc_statistics_push(&stats, 1000U);
+    adc_statistics_restart(&stats);
+    ASSERT_EQ(0U, stats.running.count);
+    ASSERT_EQ(1U, stats.window_id);
+    ASSERT_EQ(4U, stats.latched.count);
+    ASSERT_EQ(400U, stats.latched.sum);
+
+    for (uint8_t i = 0 ; i < 4U ; i++)
+    {
+        adc_statistics_push(&stats, 200U);
+    }
+    ASSERT_EQ(2U, stats.window_id);
+    ASSERT_EQ(200U, stats.latched.min);
+    ASSERT_EQ(200U, stats.latched.max);
+    ASSERT_EQ(800U, stats.latched.sum);
+}
+
+TEST(adc_statistics_tests, matches_floating_point_computation)
+{
+    std::mt19937 generator(42U);
+    std::normal_distribution<double> noise(512.0, 3.0);
+    adc_statistics_t stats;
+    ASSERT_EQ(ADC_STATISTICS_ERROR_OK, adc_statistics_init(&stats, 1000U));
+
+    std::vector<uint16_t> samples;
+    for (uint16_t i = 0 ; i < 1000U ; i++)
+    {
+        samples.push_back((uint16_t) std::lround(noise(generator)));
+        adc_statistics_push(&stats, samples.back());
+    }
+
+    double mean = 0.0;
+    for (const auto& sample : samples)
+    {
+        mean += sample;
+    }
+    mean /= samples.size();
+    double variance = 0.0;
+    for (const auto& sample : samples)
+    {
+        variance += (sample - mean) * (sample - mean);
+    }
+    variance /= samples.size();
+
+    adc_statistics_summary_t summary;
+    ASSERT_EQ(ADC_STATISTICS_ERROR_OK, adc_statistics_summarize(&stats.latched, &summary));
+    ASSERT_NEAR(mean, summary.mean_q8 / 256.0, 1.0 / 256.0);
+    ASSERT_NEAR(variance, summary.variance_q8 / 256.0, 1.0 / 256.0);
+}
+
+TEST(adc_statistics_tests, full_scale_maximum_window_does_not_overflow)
+{
+    adc_statistics_t stats;
+    ASSERT_EQ(ADC_STATISTICS_ERROR_OK, adc_statistics_init(&stats, ADC_STATISTICS_MAX_WINDOW));
+    for (uint16_t i = 0 ; i < ADC_STATISTICS_MAX_WINDOW ; i++)
+    {
+        /* Square wave between 0 and full scale : worst case for both sums and variance */
+        adc_statistics_push(&stats, (i & 1U) ? 1023U : 0U);
+    }
+
+    adc_statistics_summary_t summary;
+    ASSERT_EQ(ADC_STATISTICS_ERROR_OK, adc_statistics_summarize(&stats.latched, &summary));
+    ASSERT_EQ(ADC_STATISTICS_MAX_WINDOW, summary.count);
+    ASSERT_EQ(0U, summary.min);
+    ASSERT_EQ(1023U, summary.max);
+    ASSERT_EQ(1023U * 128U, summary.mean_q8);
+    ASSERT_EQ((uint32_t)(511.5 * 511.5 * 256.0), summary.variance_q8);
+}
+
+int main(int argc, char **argv)
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
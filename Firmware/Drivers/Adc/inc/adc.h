@@ -47,6 +47,8 @@ extern "C"
 
 /* Application drivers */
 #include "adc_reg.h"
+#include "adc_filter.h"
+#include "adc_statistics.h"
 
 /* ############################################################################################
    ################################## Data types declaration ##################################
@@ -55,6 +57,55 @@ extern "C"
 typedef uint16_t adc_result_t;
 typedef uint16_t adc_millivolts_t;
 
+/* Up to 2^6 averaged 10 bits conversions fit in a 16 bits accumulator */
+#define ADC_AVERAGE_MAX_ORDER 6U
+
+/* AREF pin is decoupled by an external capacitor, which charges or discharges to a newly selected reference through
+the reference source resistance (32 kOhm typical for the internal references). Settling within half a 10 bits LSB
+takes ln(2^11), about 8 time constants : 26 ms with the usual 100 nF capacitor. Override the capacitor value to match
+the board, and the conversion time to match the ADC clock (13 ADC clocks : 52 us with ADC_PRESCALER_64 @ 16 MHz). */
+#ifndef ADC_AREF_CAPACITOR_NF
+    #define ADC_AREF_CAPACITOR_NF 100UL
+#endif
+
+#ifndef ADC_REFERENCE_SOURCE_RESISTANCE_OHMS
+    #define ADC_REFERENCE_SOURCE_RESISTANCE_OHMS 32000UL
+#endif
+
+#ifndef ADC_CONVERSION_TIME_US
+    #define ADC_CONVERSION_TIME_US 52UL
+#endif
+
+#define ADC_REFERENCE_SETTLING_TIME_CONSTANTS 8UL
+#define ADC_REFERENCE_SETTLING_US \
+    ((ADC_REFERENCE_SOURCE_RESISTANCE_OHMS * ADC_AREF_CAPACITOR_NF * ADC_REFERENCE_SETTLING_TIME_CONSTANTS) / 1000UL)
+
+/* Conversions thrown away after the scan switched to a channel which uses another voltage reference, long enough for
+the AREF capacitor to settle (rounded up) */
+#ifndef ADC_REFERENCE_SETTLING_CONVERSIONS
+    #define ADC_REFERENCE_SETTLING_CONVERSIONS \
+        ((uint16_t) ((ADC_REFERENCE_SETTLING_US + ADC_CONVERSION_TIME_US - 1UL) / ADC_CONVERSION_TIME_US))
+#endif
+
+/* Longest time the scan may be held on a single channel by a reference switch. Window comparators, results and
+listeners of every other channel are frozen meanwhile, so reference switches are refused when their settling time
+exceeds this budget (the default settling time does : boards which mix references need a small AREF capacitor) */
+#ifndef ADC_PROTECTION_LATENCY_US
+    #define ADC_PROTECTION_LATENCY_US 1000UL
+#endif
+
+/* Conversions thrown away each time the scan switches to the internal bandgap : sample and hold capacitor still holds
+previous channel's voltage, and the bandgap output is weak enough to need a few conversions to drive it */
+#ifndef ADC_BANDGAP_SETTLING_CONVERSIONS
+    #define ADC_BANDGAP_SETTLING_CONVERSIONS 2U
+#endif
+
+/* Internal temperature sensor output (against 1V1 reference) at 25 degrees Celsius, slope is ~1 mV / degree.
+Sensor is not factory calibrated and its offset may differ by +/- 10 degrees : override for a calibrated part */
+#ifndef ADC_TEMPERATURE_SENSOR_MV_AT_25C
+    #define ADC_TEMPERATURE_SENSOR_MV_AT_25C 314
+#endif
+
 
 /**
  * @brief generic structure which holds timer error types
@@ -68,8 +119,114 @@ typedef enum
     ADC_ERROR_NULL_HANDLE,      /**< Timer handle still points to NULL                            */
     ADC_ERROR_UNKNOWN_TIMER,    /**< Given timer id exceeds the range of registered timers        */
     ADC_ERROR_NOT_INITIALISED,  /**< Given configuration is not well-formed                       */
+    ADC_ERROR_BUSY,             /**< Data kept changing while being read, try again later         */
 } adc_error_t;
 
+/**
+ * @brief tells which threshold of a channel window was crossed
+*/
+typedef enum
+{
+    ADC_WINDOW_CROSSING_LOW,    /**< Result went below the low threshold    */
+    ADC_WINDOW_CROSSING_HIGH,   /**< Result went above the high threshold   */
+} adc_window_crossing_t;
+
+/**
+ * @brief window comparator callback, called from within the conversion ISR : keep it short
+*/
+typedef void (*adc_window_callback_t)(const adc_mux_t channel, const adc_result_t value, const adc_window_crossing_t crossing);
+
+/**
+ * @brief sample listener, called from within the conversion ISR with each new result of a channel (after settling
+ * and averaging, before filtering) : keep it short
+*/
+typedef void (*adc_sample_listener_t)(const adc_mux_t channel, const adc_result_t result);
+
+/**
+ * @brief window comparator configuration of a channel. Results strictly below low or strictly above high
+ * thresholds are considered as faults
+*/
+typedef struct
+{
+    adc_result_t low;                   /**< Low threshold (raw value)                                 */
+    adc_result_t high;                  /**< High threshold (raw value)                                */
+    adc_window_callback_t callback;     /**< Called on fault (may be NULL : fault is only latched)     */
+} adc_window_t;
+
+/* Scan table entry uses the voltage reference selected in adc configuration */
+#define ADC_SCAN_REFERENCE_DEFAULT 0xFFU
+
+/* Scan tables are built at compile time and kept in program memory, they are only read once by adc_load_scan_table() */
+#ifdef UNIT_TESTING
+    #define ADC_SCAN_TABLE_STORAGE
+#else
+    #include <avr/pgmspace.h>
+    #define ADC_SCAN_TABLE_STORAGE PROGMEM
+#endif
+
+/**
+ * @brief static configuration of a scanned channel, @see adc_load_scan_table()
+*/
+typedef struct
+{
+    adc_mux_t channel;                  /**< Scanned channel, each channel appears once per table                        */
+    uint8_t reference;                  /**< adc_voltage_ref_t used by this channel, or ADC_SCAN_REFERENCE_DEFAULT      */
+    uint8_t divider;                    /**< Channel is converted once every 'divider' scan cycles (0 or 1 : each cycle) */
+    uint8_t discard;                    /**< Conversions thrown away after the mux switched to this channel             */
+    uint8_t average_order;              /**< log2 of the number of averaged conversions (up to ADC_AVERAGE_MAX_ORDER)   */
+    adc_filter_t * filter;              /**< Optional filter object storage (NULL : no filtering)                       */
+    adc_filter_config_t filter_config;  /**< Filter configuration (ignored when filter is NULL)                          */
+    bool window_armed;                  /**< Window comparator is armed with thresholds below                           */
+    adc_window_t window;                /**< Window comparator thresholds and callback                                  */
+    adc_sample_listener_t listener;     /**< Optional sample listener (NULL : no listener)                              */
+    bool noise_reduction;               /**< Converted during ADC noise reduction sleep, @see adc_set_channel_noise_reduction() */
+} adc_scan_entry_t;
+
+/* Helpers filling filter and window fields of an adc_scan_entry_t initializer, so that scan tables can be written as
+one line per channel (e.g. in an X-macro) */
+#define ADC_SCAN_NO_FILTER                          NULL, {ADC_FILTER_NONE, 0U}
+#define ADC_SCAN_FILTER(storage, type, order)       &(storage), {(type), (order)}
+#define ADC_SCAN_NO_WINDOW                          false, {0U, 0U, NULL}
+#define ADC_SCAN_WINDOW(low, high, callback)        true, {(low), (high), (callback)}
+
+/**
+ * @brief burst capture trigger condition
+*/
+typedef enum
+{
+    ADC_BURST_TRIGGER_SOFTWARE,     /**< Capture is triggered by adc_burst_trigger() (or right away without pre-trigger) */
+    ADC_BURST_TRIGGER_RISING,       /**< Capture is triggered when samples go from below to at least trigger_level       */
+    ADC_BURST_TRIGGER_FALLING,      /**< Capture is triggered when samples go from above to at most trigger_level        */
+} adc_burst_trigger_t;
+
+/**
+ * @brief burst capture configuration. Samples are 8 bits wide (left aligned result, high byte only) and are captured
+ * in free-running mode, so sampling rate is F_CPU / (prescaler * 13) : ~77 kS/s with ADC_PRESCALER_16 @ 16 MHz.
+ * Note : each sample is fetched by the ISR, which then has 13 * prescaler CPU cycles to complete. Prescalers below 16
+ * do not leave enough time and samples get lost. Accuracy also degrades above 200 kHz ADC clock, which is fine for 8 bits
+*/
+typedef struct
+{
+    adc_mux_t channel;              /**< Captured channel                                                      */
+    adc_prescaler_t prescaler;      /**< ADC prescaler used during capture, sets the sampling rate             */
+    uint8_t * buffer;               /**< Caller provided trace buffer                                          */
+    uint16_t length;                /**< Trace buffer length, in samples                                       */
+    uint16_t pre_trigger;           /**< Number of samples kept before the trigger event (< length)            */
+    adc_burst_trigger_t trigger;    /**< Trigger condition                                                     */
+    uint8_t trigger_level;          /**< Trigger level for edge triggers (8 bits sample)                       */
+} adc_burst_config_t;
+
+/**
+ * @brief burst capture state
+*/
+typedef enum
+{
+    ADC_BURST_STATE_IDLE,       /**< No capture was requested                                                       */
+    ADC_BURST_STATE_ARMED,      /**< Capture is running and waits for the trigger event (pre-trigger samples)      */
+    ADC_BURST_STATE_TRIGGERED,  /**< Trigger happened, post-trigger samples are being captured                     */
+    ADC_BURST_STATE_DONE,       /**< Trace buffer is complete, normal scan is restored                             */
+} adc_burst_state_t;
+
 /**
  * @brief basic adc peripheral state
 */
@@ -87,7 +244,10 @@ typedef enum
 {
     ADC_RUNNING_MODE_SINGLE_SHOT,   /**< If set, adc will require start() to be called repeateadly between each calls       */
     ADC_RUNNING_MODE_AUTOTRIGGERED  /**< ADC is controlled by a trigger event, which my be set to free-running (software)
-                                         in this particular case, ADC will be continuously triggered when a conversion ends  */
+                                         in this particular case, ADC will be continuously triggered when a conversion ends.
+                                         Free-running conversions are pipelined : mux register is written one conversion ahead
+                                         so that no ISR latency is lost between two samples (13 ADC clock cycles per sample,
+                                         ~9.6 kS/s shared among registered channels with ADC_PRESCALER_128 @ 16 MHz)          */
 }adc_running_mode_t;
 
 /**
@@ -116,6 +276,9 @@ typedef struct {
     adc_handle_t                handle;             /**< Packs pointers to base ADC registers. Particularly
                                                          useful when performing Dependency Injection & testing  */
     bool using_interrupt;                           /**< uses interrupts for data fetch process or not          */
+    uint8_t supply_monitoring_period;               /**< When using AVCC reference, internal 1V1 bandgap is added to the
+                                                         scan once every 'n' scan cycles to measure actual AVCC and
+                                                         correct millivolt conversions. 0 disables this feature      */
 } adc_config_hal_t;
 
 
@@ -176,6 +339,11 @@ adc_error_t adc_handle_reset(adc_handle_t * const handle);
 
 /**
  * @brief adc module initialisation function
+ * Note : millivolts conversion factor is computed once here, using the selected reference voltage
+ * @return
+ *      ADC_ERROR_OK             : operation succeeded
+ *      ADC_ERROR_NULL_POINTER   : null pointer guarded
+ *      ADC_ERROR_CONFIG         : selected reference voltage is not supported
 */
 adc_error_t adc_base_init(adc_config_hal_t * const config);
 
@@ -219,6 +387,8 @@ adc_state_t adc_process(void);
 
 /**
  * @brief isr handler that might be called from within an ISR function
+ * Note : in single shot mode, next conversion is restarted from within this handler. In auto triggered mode, it is restarted
+ * by hardware ; when free-running, the fetched result belongs to the channel which was queued one conversion earlier
 */
 void adc_isr_handler(void);
 
@@ -232,6 +402,129 @@ adc_error_t adc_register_channel(const adc_mux_t channel);
  * @param[in]   channel : channel to be removed */
 adc_error_t adc_unregister_channel(const adc_mux_t channel);
 
+/**
+ * @brief configures the settling sequence of a registered channel. When the mux switches to this channel, it is
+ * converted discard + 2^average_order times in a row : first 'discard' results are thrown away while the sample and
+ * hold capacitor loses the charge left by the previous channel (high impedance sources such as thermistor dividers
+ * need it the most), remaining ones are averaged and published as a single result.
+ * Note : a channel sequence is seen by window comparators, statistics and filters as a single result
+ * @param[in]   channel       : registered channel
+ * @param[in]   discard       : conversions thrown away after switching to this channel
+ * @param[in]   average_order : log2 of the number of averaged conversions (up to ADC_AVERAGE_MAX_ORDER)
+ * @return
+ *      ADC_ERROR_OK                : everything's fine
+ *      ADC_ERROR_CONFIG            : average order is out of range, or sequence is longer than 255 conversions
+ *      ADC_ERROR_CHANNEL_NOT_FOUND : channel is not registered
+*/
+adc_error_t adc_set_channel_settling(const adc_mux_t channel, const uint8_t discard, const uint8_t average_order);
+
+/**
+ * @brief selects the voltage reference used to convert a registered channel, so that channels needing different
+ * references can be scanned together. Each time the scan switches from a channel to another one which uses another
+ * reference, the new channel sequence starts with extra conversions which are thrown away while the reference
+ * settles (@see adc_set_reference_settling()).
+ * Note : ADC_MUX_INTERNAL_TEMPERATURE is automatically converted against the internal 1V1 reference when registered
+ * Note : the scan is blocked on the channel while the reference settles, which shall not take longer than
+ * ADC_PROTECTION_LATENCY_US (@see adc_set_reference_settling())
+ * @param[in]   channel   : registered channel
+ * @param[in]   reference : voltage reference for this channel
+ * @return
+ *      ADC_ERROR_OK                : everything's fine
+ *      ADC_ERROR_CONFIG            : unknown reference, temperature sensor used with another reference than 1V1, or
+ *                                    reference settling exceeds ADC_PROTECTION_LATENCY_US
+ *      ADC_ERROR_CHANNEL_NOT_FOUND : channel is not registered
+*/
+adc_error_t adc_set_channel_reference(const adc_mux_t channel, const adc_voltage_ref_t reference);
+
+/**
+ * @brief sets the number of conversions thrown away after each reference switch (defaults to
+ * ADC_REFERENCE_SETTLING_CONVERSIONS). Channels using a non-default reference are best scanned at a low rate
+ * (@see adc_set_channel_divider()) as each of their conversion costs two reference switches, that is twice the
+ * AREF capacitor settling time.
+ * Settling conversions shall not last longer than ADC_PROTECTION_LATENCY_US (at ADC_CONVERSION_TIME_US each) for
+ * channels to use a non-default reference : set it before registering them.
+ * @param[in]   conversions : conversions thrown away
+ * @return
+ *      ADC_ERROR_OK                : everything's fine
+ *      ADC_ERROR_CONFIG            : settling exceeds ADC_PROTECTION_LATENCY_US while a channel uses another reference
+*/
+adc_error_t adc_set_reference_settling(const uint16_t conversions);
+
+/**
+ * @brief lowers the scan rate of a registered channel, which is then converted once every 'divider' scan cycles
+ * @param[in]   channel : registered channel
+ * @param[in]   divider : scan cycles between two conversions of this channel (0 or 1 : converted at each cycle)
+ * @return
+ *      ADC_ERROR_OK                : everything's fine
+ *      ADC_ERROR_CHANNEL_NOT_FOUND : channel is not registered
+*/
+adc_error_t adc_set_channel_divider(const adc_mux_t channel, const uint8_t divider);
+
+/**
+ * @brief converts the last ADC_MUX_INTERNAL_TEMPERATURE reading to MCU die temperature
+ * (@see ADC_TEMPERATURE_SENSOR_MV_AT_25C)
+ * @param[out]  celsius : die temperature, in degrees Celsius
+ * @return
+ *      ADC_ERROR_OK                : everything's fine
+ *      ADC_ERROR_NULL_POINTER      : null pointer guarded
+ *      ADC_ERROR_CHANNEL_NOT_FOUND : temperature sensor channel is not registered
+*/
+adc_error_t adc_read_die_temperature(int16_t * const celsius);
+
+/**
+ * @brief selects ADC noise reduction conversions for a registered precision channel (setpoint read-back, calibration).
+ * Each time the scan reaches this channel, its conversions are not started by the driver : adc_noise_reduction_pending()
+ * tells the main loop to enter SLEEP_MODE_ADC, which halts the CPU and I/O clocks and starts the conversion (~1 to 2 LSB
+ * less noise). CPU wakes up on ADC_vect and the scan goes on.
+ * Notes :
+ *  - only applies to single shot, interrupt driven scans : otherwise channel is converted like any other one
+ *  - scan stalls on this channel until the main loop sleeps, use a scan divider to keep this cost low
+ *  - every timer clocked from the I/O clock stops while sleeping (PWM outputs hold their level) : timer 0, timer 1, and
+ *    timer 2 unless it runs in asynchronous mode (AS2 set, clocked from TOSC). A timebase on a stopped timer loses
+ *    13 ADC clock cycles per conversion : do not use noise reduction with a synchronous timebase
+ *  - conversion still completes, with regular noise, if another interrupt wakes the CPU up before it is finished
+ * @param[in]   channel : registered channel
+ * @param[in]   enabled : channel is converted during noise reduction sleep
+ * @return
+ *      ADC_ERROR_OK                : everything's fine
+ *      ADC_ERROR_CHANNEL_NOT_FOUND : channel is not registered
+*/
+adc_error_t adc_set_channel_noise_reduction(const adc_mux_t channel, const bool enabled);
+
+/**
+ * @brief tells whether the scan waits for the main loop to enter ADC noise reduction sleep. Peripheral is left idle
+ * meanwhile (so nothing else clears this state but the conversion started by the sleep instruction), typical use being :
+ *      if (adc_noise_reduction_pending()) { set_sleep_mode(SLEEP_MODE_ADC); sleep_mode(); }
+ * @return true when next conversion shall be started by entering sleep
+*/
+bool adc_noise_reduction_pending(void);
+
+/**
+ * @brief reorders scanned channels so that all channels which need settling (discard != 0) are converted after
+ * all low impedance ones. Registration order is kept within both groups, and scan restarts from the first channel.
+ * This limits the number of high impedance channels which directly follow a low impedance one in the scan.
+ * @return
+ *      ADC_ERROR_OK : everything's fine
+*/
+adc_error_t adc_optimise_scan_order(void);
+
+/**
+ * @brief replaces all registered channels by the ones of a scan table, in a single pass. Table order is the scan order
+ * (no reordering takes place : channels which need settling are best listed last, @see adc_optimise_scan_order()).
+ * Whole table is checked before anything is changed, so a rejected table leaves the current scan untouched.
+ * Note : ADC_MUX_INTERNAL_TEMPERATURE entries shall use ADC_VOLTAGE_REF_INTERNAL_1V1
+ * Note : entries using a non-default reference are refused when reference settling exceeds ADC_PROTECTION_LATENCY_US
+ * Note : when supply monitoring is enabled, the bandgap keeps being scanned after table's channels, unless the table
+ * lists ADC_MUX_1v1_REF itself
+ * @param[in]   table : scan table, located in program memory (@see ADC_SCAN_TABLE_STORAGE)
+ * @param[in]   count : number of entries in table (up to ADC_MUX_COUNT)
+ * @return
+ *      ADC_ERROR_OK                : everything's fine
+ *      ADC_ERROR_NULL_POINTER      : table is NULL
+ *      ADC_ERROR_CONFIG            : table is too long, a channel is listed twice or one of the entries is not valid
+*/
+adc_error_t adc_load_scan_table(const adc_scan_entry_t * const table, const uint8_t count);
+
 /**
  * @brief adc result getter function
  * @param[in]   channel  : targeted device index
@@ -242,6 +535,142 @@ adc_error_t adc_unregister_channel(const adc_mux_t channel);
 */
 adc_error_t adc_read_raw(const adc_mux_t channel, adc_result_t * const result);
 
+/**
+ * @brief attaches a digital filter to a registered channel. Filter is run from the conversion ISR on each new result
+ * and its output is published next to the raw value (@see adc_read_filtered())
+ * Note : filter object storage is owned by the caller and shall outlive the channel registration, so that only
+ * filtered channels consume RAM. Changing a channel filter resets it : next result will seed it again.
+ * @param[in]   channel : registered channel
+ * @param[in]   filter  : filter object storage, NULL removes the current filter
+ * @param[in]   config  : filter configuration (ignored when filter is NULL)
+ * @return
+ *      ADC_ERROR_OK                : everything's fine
+ *      ADC_ERROR_NULL_POINTER      : filter object is given without a configuration
+ *      ADC_ERROR_CONFIG            : filter configuration is not valid
+ *      ADC_ERROR_CHANNEL_NOT_FOUND : channel is not registered
+*/
+adc_error_t adc_set_channel_filter(const adc_mux_t channel, adc_filter_t * const filter, const adc_filter_config_t * const config);
+
+/**
+ * @brief arms a window comparator on a registered channel. Each raw result is compared against thresholds
+ * inside the conversion ISR, before anything else is done, so that a trip is reported at most one conversion
+ * time after it happened. On fault, the channel bit (1 << channel) is latched in the fault bitmask and the callback
+ * is called once ; it won't be called again for this channel until its fault bit is cleared.
+ * @param[in]   channel : registered channel
+ * @param[in]   window  : window configuration, NULL disarms the comparator
+ * @return
+ *      ADC_ERROR_OK                : everything's fine
+ *      ADC_ERROR_CONFIG            : low threshold is greater than the high one
+ *      ADC_ERROR_CHANNEL_NOT_FOUND : channel is not registered
+*/
+adc_error_t adc_set_channel_window(const adc_mux_t channel, const adc_window_t * const window);
+
+/**
+ * @brief returns latched window comparator faults
+ * @param[out]  faults : fault bitmask, bit n is set when channel n tripped its window
+ * @return
+ *      ADC_ERROR_OK             : everything's fine
+ *      ADC_ERROR_NULL_POINTER   : null pointer guarded
+*/
+adc_error_t adc_get_window_faults(uint16_t * const faults);
+
+/**
+ * @brief clears latched window comparator faults, which re-arms callbacks of related channels
+ * @param[in]   mask : faults to be cleared (bit n clears channel n)
+*/
+void adc_clear_window_faults(const uint16_t mask);
+
+/**
+ * @brief filtered adc result getter
+ * @param[in]   channel  : targeted device index
+ * @param[out]  result   : last filtered result from this device (raw result when no filter is attached to it)
+ * @return
+ *      ADC_ERROR_OK                : everything's fine
+ *      ADC_ERROR_NULL_POINTER      : null pointer guarded
+ *      ADC_ERROR_CHANNEL_NOT_FOUND : channel is not registered
+*/
+adc_error_t adc_read_filtered(const adc_mux_t channel, adc_result_t * const result);
+
+/**
+ * @brief copies raw results of several channels, all coming from the same scan cycle.
+ * Results are published by the ISR once per complete scan cycle and are copied without disabling interrupts ;
+ * copy is retried when a new cycle was published meanwhile (up to ADC_SNAPSHOT_MAX_RETRIES times).
+ * Note : results are all 0 until the first scan cycle is complete (cycle id is 0 as well)
+ * @param[in]   channels : channels to be read
+ * @param[out]  results  : raw results, same order as channels
+ * @param[in]   count    : number of channels to be read
+ * @param[out]  cycle_id : optional (may be NULL), id of the scan cycle results belong to. Wraps around at 256
+ * @return
+ *      ADC_ERROR_OK                : everything's fine
+ *      ADC_ERROR_NULL_POINTER      : channels or results are NULL
+ *      ADC_ERROR_CHANNEL_NOT_FOUND : one of the channels is not registered
+ *      ADC_ERROR_BUSY              : scan cycles are published faster than results can be copied
+*/
+adc_error_t adc_snapshot(const adc_mux_t * const channels, adc_result_t * const results, const uint8_t count, uint8_t * const cycle_id);
+
+/**
+ * @brief attaches a statistics object to a registered channel. Each raw result is accumulated from the conversion ISR
+ * (count, min, max, sum and sum of squares), at constant cost. Once window_length results are accumulated, the window
+ * is latched and a new one is started. Statistics storage is owned by the caller, like filters.
+ * @param[in]   channel       : registered channel
+ * @param[in]   statistics    : statistics object storage, NULL stops gathering statistics on this channel
+ * @param[in]   window_length : number of results per window (1 to ADC_STATISTICS_MAX_WINDOW)
+ * @return
+ *      ADC_ERROR_OK                : everything's fine
+ *      ADC_ERROR_CONFIG            : window length is out of range
+ *      ADC_ERROR_CHANNEL_NOT_FOUND : channel is not registered
+*/
+adc_error_t adc_set_channel_statistics(const adc_mux_t channel, adc_statistics_t * const statistics, const uint16_t window_length);
+
+/**
+ * @brief attaches a sample listener to a channel, so that its whole result stream can be processed (e.g. by a
+ * streaming analyser) instead of polling the last result
+ * @param[in]   channel  : registered channel
+ * @param[in]   listener : listener called from ISR with each result, NULL to detach it
+ * @return
+ *      ADC_ERROR_OK                : everything's fine
+ *      ADC_ERROR_CHANNEL_NOT_FOUND : channel is not registered
+*/
+adc_error_t adc_set_channel_listener(const adc_mux_t channel, const adc_sample_listener_t listener);
+
+/**
+ * @brief computes min, max, mean and variance of the last complete statistics window of a channel
+ * @param[in]   channel : registered channel, with statistics attached
+ * @param[out]  summary : window summary (count is 0 when no window was completed yet)
+ * @return
+ *      ADC_ERROR_OK                : everything's fine
+ *      ADC_ERROR_NULL_POINTER      : null pointer guarded
+ *      ADC_ERROR_CHANNEL_NOT_FOUND : channel is not registered
+ *      ADC_ERROR_CONFIG            : no statistics are gathered on this channel
+ *      ADC_ERROR_BUSY              : windows are latched faster than they can be read
+*/
+adc_error_t adc_get_channel_statistics(const adc_mux_t channel, adc_statistics_summary_t * const summary);
+
+/**
+ * @brief returns conversion counters. Total conversion count can be sampled periodically to measure the actual
+ * conversion rate (@see adc_compute_conversion_rate())
+ * @param[out]  total    : number of conversions fetched since init (wraps around), may be NULL
+ * @param[out]  overruns : number of results which came late : next conversion was already finished when the previous
+ *                         one was processed, in free-running mode (may be NULL)
+ * @return
+ *      ADC_ERROR_OK             : everything's fine
+*/
+adc_error_t adc_get_conversion_counters(uint32_t * const total, uint16_t * const overruns);
+
+/**
+ * @brief resets conversion counters
+*/
+void adc_reset_conversion_counters(void);
+
+/**
+ * @brief computes a conversion rate out of two samples of the total conversion count
+ * @param[in]   previous_total : total conversion count sampled first
+ * @param[in]   total          : total conversion count sampled elapsed_ms later
+ * @param[in]   elapsed_ms     : time elapsed between both samples, in milliseconds
+ * @return conversions per second (0 if elapsed_ms is 0)
+*/
+uint32_t adc_compute_conversion_rate(const uint32_t previous_total, const uint32_t total, const uint16_t elapsed_ms);
+
 /**
  * @brief adc raw reading getter
  * @param[in]   channel   : targeted device index
@@ -252,6 +681,69 @@ adc_error_t adc_read_raw(const adc_mux_t channel, adc_result_t * const result);
 */
 adc_error_t adc_read_millivolt(const adc_mux_t channel, adc_millivolts_t * const reading);
 
+/**
+ * @brief returns the supply voltage used for millivolt conversions. When supply monitoring is enabled,
+ * this is the last AVCC value measured through the internal 1V1 bandgap, otherwise this is the configured one
+ * @param[out]  supply : supply voltage in millivolts
+ * @return
+ *      ADC_ERROR_OK             : everything's fine
+ *      ADC_ERROR_NULL_POINTER   : null pointer guarded
+*/
+adc_error_t adc_get_supply_voltage(adc_millivolts_t * const supply);
+
+/**
+ * @brief converts every registered channel to millivolts in a single pass (registration order)
+ * @param[out]    channels : optional array receiving the channel of each reading (may be NULL)
+ * @param[out]    readings : array receiving millivolt readings
+ * @param[in,out] count    : in : capacity of given arrays, out : number of converted channels
+ * @return
+ *      ADC_ERROR_OK             : everything's fine
+ *      ADC_ERROR_NULL_POINTER   : readings or count pointers are NULL
+*/
+adc_error_t adc_read_millivolt_all(adc_mux_t * const channels, adc_millivolts_t * const readings, uint8_t * const count);
+
+/**
+ * @brief starts a single channel burst capture. Normal scan is suspended : peripheral is switched to free-running,
+ * 8 bits left aligned conversions using the given prescaler, and each sample is written to the trace buffer (circularly
+ * while waiting for the trigger). Once length - pre_trigger samples are captured after the trigger event, previous
+ * peripheral configuration is restored and normal scan restarts if it was running.
+ * Samples are fetched by adc_isr_handler() or adc_process(), like regular conversions.
+ * @param[in]   config : burst configuration (copied, buffer shall outlive the capture)
+ * @return
+ *      ADC_ERROR_OK                : capture started
+ *      ADC_ERROR_NULL_POINTER      : configuration or buffer is NULL
+ *      ADC_ERROR_CONFIG            : buffer length is 0 or pre-trigger does not fit in buffer
+ *      ADC_ERROR_NOT_INITIALISED   : driver is not initialised
+ *      ADC_ERROR_BUSY              : a capture is already running
+*/
+adc_error_t adc_burst_start(const adc_burst_config_t * const config);
+
+/**
+ * @brief requests a software trigger. If pre-trigger samples are not all captured yet, capture is triggered as soon
+ * as they are
+*/
+void adc_burst_trigger(void);
+
+/**
+ * @brief aborts a running capture and restores normal scan
+*/
+void adc_burst_abort(void);
+
+/**
+ * @brief returns the current burst capture state
+*/
+adc_burst_state_t adc_burst_get_state(void);
+
+/**
+ * @brief returns where the trace starts in the buffer, once the capture is done : trace is
+ * buffer[(first_index + i) % length] for i in [0, length[, trigger event being at i = pre_trigger
+ * @param[out]  first_index : index of the oldest sample in buffer
+ * @return
+ *      ADC_ERROR_OK             : everything's fine
+ *      ADC_ERROR_NULL_POINTER   : null pointer guarded
+ *      ADC_ERROR_BUSY           : capture is not done
+*/
+adc_error_t adc_burst_get_trace_start(uint16_t * const first_index);
 
 #ifdef __cplusplus
 }
@@ -0,0 +1,167 @@
+/*
+
+------------------
+@<FreeMyCode>
+FreeMyCode version : 1.0 RC alpha
+    Author : bebenlebricolo
+    License : 
+        name : GPLv3
+        url : https://www.gnu.org/licenses/quick-guide-gplv3.html
+    Date : 12/02/2021
+    Project : LabBenchPowerSupply
+    Description : The Lab Bench Power Supply provides a simple design based around an Arduino Nano board to convert AC main voltage into
+ smaller ones, ranging from 0V to 16V, with voltage and current regulations
+<FreeMyCode>@
+------------------
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+
+#ifndef ADC_FILTER_HEADER
+#define ADC_FILTER_HEADER
+
+/* Expose this API to C++ code without name mangling */
+#ifdef __cplusplus
+extern "C"
+{
+#endif /* __cplusplus */
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/*  ####################################################################################
+    ############################ Data types declaration ################################
+    #################################################################################### */
+
+/* Boxcar filter stores its whole window, which costs 2 bytes per sample and per filtered channel */
+#ifndef ADC_FILTER_BOXCAR_MAX_ORDER
+    #define ADC_FILTER_BOXCAR_MAX_ORDER 3U
+#endif
+#define ADC_FILTER_BOXCAR_MAX_LENGTH (1U << ADC_FILTER_BOXCAR_MAX_ORDER)
+
+/* EMA accumulator is 16 bits wide : 10 bits samples leave 6 bits of fractional part */
+#define ADC_FILTER_EMA_MAX_ORDER 6U
+
+#if ADC_FILTER_BOXCAR_MAX_ORDER > 6U
+    #error "ADC_FILTER_BOXCAR_MAX_ORDER cannot exceed 6, boxcar sum would overflow its 16 bits accumulator"
+#endif
+
+/**
+ * @brief lists available error types for adc filters
+*/
+typedef enum
+{
+    ADC_FILTER_ERROR_OK,            /**< Action was successful                          */
+    ADC_FILTER_ERROR_NULL_POINTER,  /**< Given pointer not initialised                  */
+    ADC_FILTER_ERROR_CONFIG,        /**< Filter order is out of range for this filter   */
+} adc_filter_error_t;
+
+/**
+ * @brief available digital filters. All of them work with integer math only and have a constant cost per sample.
+ * Note : filters work on right aligned 10 bits results
+*/
+typedef enum
+{
+    ADC_FILTER_NONE,        /**< No filtering, output follows input                                                       */
+    ADC_FILTER_EMA,         /**< Exponential moving average : y += (x - y) / 2^order                                      */
+    ADC_FILTER_BOXCAR,      /**< Moving average over the last 2^order samples                                             */
+    ADC_FILTER_MEDIAN_3,    /**< Median of the last 3 samples, rejects isolated spikes                                    */
+} adc_filter_type_t;
+
+/**
+ * @brief filter configuration
+*/
+typedef struct
+{
+    adc_filter_type_t type; /**< Selected filter                                                                          */
+    uint8_t order;          /**< EMA : smoothing shift (up to ADC_FILTER_EMA_MAX_ORDER), BOXCAR : log2 of window length
+                                 (up to ADC_FILTER_BOXCAR_MAX_ORDER), ignored by other filters                            */
+} adc_filter_config_t;
+
+/**
+ * @brief filter object : packs configuration and running state of a filter
+*/
+typedef struct
+{
+    adc_filter_config_t config; /**< Filter configuration                                                  */
+    bool primed;                /**< State is seeded with the first sample to avoid a startup transient    */
+    union
+    {
+        struct
+        {
+            uint16_t accumulator;                               /**< Filtered value, scaled by 2^order     */
+        } ema;
+        struct
+        {
+            uint16_t samples[ADC_FILTER_BOXCAR_MAX_LENGTH];     /**< Circular buffer of last samples       */
+            uint16_t sum;                                       /**< Running sum of samples in window      */
+            uint8_t index;                                      /**< Oldest sample index                   */
+        } boxcar;
+        struct
+        {
+            uint16_t history[2];                                /**< Two previous samples                  */
+        } median;
+    } state;
+} adc_filter_t;
+
+/*  ####################################################################################
+    ############################ Functions declarations ################################
+    #################################################################################### */
+
+/**
+ * @brief checks a filter configuration without touching any filter object
+ * @param[in]  config : filter configuration
+ * @return
+ *      ADC_FILTER_ERROR_OK             : configuration is valid
+ *      ADC_FILTER_ERROR_NULL_POINTER   : given pointer is NULL
+ *      ADC_FILTER_ERROR_CONFIG         : filter type is unknown or filter order is out of range
+*/
+adc_filter_error_t adc_filter_check_config(const adc_filter_config_t * const config);
+
+/**
+ * @brief initialises a filter object with the given configuration and clears its state
+ * @param[out] filter : filter object
+ * @param[in]  config : filter configuration
+ * @return
+ *      ADC_FILTER_ERROR_OK             : operation succeeded
+ *      ADC_FILTER_ERROR_NULL_POINTER   : given pointer is NULL
+ *      ADC_FILTER_ERROR_CONFIG         : filter order is out of range
+*/
+adc_filter_error_t adc_filter_init(adc_filter_t * const filter, const adc_filter_config_t * const config);
+
+/**
+ * @brief clears filter state, next sample will seed it again
+ * @param[in] filter : filter object
+ * @return
+ *      ADC_FILTER_ERROR_OK             : operation succeeded
+ *      ADC_FILTER_ERROR_NULL_POINTER   : given pointer is NULL
+*/
+adc_filter_error_t adc_filter_reset(adc_filter_t * const filter);
+
+/**
+ * @brief pushes a new sample through the filter and returns the filtered value.
+ * Meant to be called from the ADC ISR : no checks are performed on the filter object
+ * @param[in] filter : initialised filter object
+ * @param[in] sample : new raw sample
+ * @return filtered value
+*/
+uint16_t adc_filter_apply(adc_filter_t * const filter, const uint16_t sample);
+
+/* Expose this API to C++ code without name mangling */
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* ADC_FILTER_HEADER */
@@ -68,7 +68,7 @@ extern "C"
 
 
 /* ADCSRA register masks */
-#define ADPS_MSK    0x03
+#define ADPS_MSK    0x07
 #define ADIE_MSK    (1 << ADIE)
 #define ADIF_MSK    (1 << ADIF)
 #define ADATE_MSK   (1 << ADATE)
@@ -76,7 +76,7 @@ extern "C"
 #define ADEN_MSK    (1 << ADEN)
 
 /* ADCSRB register masks */
-#define ADTS_MSK 0x03
+#define ADTS_MSK 0x07
 #define ACME_MSK (1 << ACME)
 
 /* ADMUX regsister masks */
@@ -86,9 +86,9 @@ extern "C"
 
 
 typedef enum {
-    ADC_VOLTAGE_REF_INTERNAL_1V1 = 0x00,
+    ADC_VOLTAGE_REF_AREF_PIN     = 0x00,
     ADC_VOLTAGE_REF_AVCC         = 0x01,
-    ADC_VOLTAGE_REF_AREF_PIN     = 0x03
+    ADC_VOLTAGE_REF_INTERNAL_1V1 = 0x03
 } adc_voltage_ref_t;
 
 typedef enum {
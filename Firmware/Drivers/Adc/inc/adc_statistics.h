@@ -0,0 +1,140 @@
+/*
+
+------------------
+@<FreeMyCode>
+FreeMyCode version : 1.0 RC alpha
+    Author : bebenlebricolo
+    License : 
+        name : GPLv3
+        url : https://www.gnu.org/licenses/quick-guide-gplv3.html
+    Date : 12/02/2021
+    Project : LabBenchPowerSupply
+    Description : The Lab Bench Power Supply provides a simple design based around an Arduino Nano board to convert AC main voltage into
+ smaller ones, ranging from 0V to 16V, with voltage and current regulations
+<FreeMyCode>@
+------------------
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+
+#ifndef ADC_STATISTICS_HEADER
+#define ADC_STATISTICS_HEADER
+
+/* Expose this API to C++ code without name mangling */
+#ifdef __cplusplus
+extern "C"
+{
+#endif /* __cplusplus */
+
+#include <stdint.h>
+
+/*  ####################################################################################
+    ############################ Data types declaration ################################
+    #################################################################################### */
+
+/* Sum of squares of 10 bits samples is held on 32 bits : 4096 * 1023^2 < 2^32 */
+#define ADC_STATISTICS_MAX_WINDOW 4096U
+
+/**
+ * @brief lists available error types for adc statistics
+*/
+typedef enum
+{
+    ADC_STATISTICS_ERROR_OK,            /**< Action was successful                          */
+    ADC_STATISTICS_ERROR_NULL_POINTER,  /**< Given pointer not initialised                  */
+    ADC_STATISTICS_ERROR_CONFIG,        /**< Window length is 0 or exceeds the maximum one  */
+} adc_statistics_error_t;
+
+/**
+ * @brief raw accumulators of a window of samples
+*/
+typedef struct
+{
+    uint16_t count;             /**< Number of accumulated samples              */
+    uint16_t min;               /**< Smallest sample                            */
+    uint16_t max;               /**< Biggest sample                             */
+    uint32_t sum;               /**< Sum of samples                             */
+    uint32_t sum_of_squares;    /**< Sum of squared samples                     */
+} adc_statistics_window_t;
+
+/**
+ * @brief statistics object of a channel. Samples are accumulated in the running window ; when it is full,
+ * it is latched and window_id is incremented so that readers can detect a concurrent update
+*/
+typedef struct
+{
+    uint16_t window_length;             /**< Number of samples per window                       */
+    uint8_t window_id;                  /**< Incremented each time a window is latched          */
+    adc_statistics_window_t running;    /**< Window being accumulated                           */
+    adc_statistics_window_t latched;    /**< Last complete window                               */
+} adc_statistics_t;
+
+/**
+ * @brief summary computed out of a complete window, in raw adc units
+*/
+typedef struct
+{
+    uint16_t count;         /**< Number of samples in window (0 : no complete window yet)   */
+    uint16_t min;           /**< Smallest sample                                            */
+    uint16_t max;           /**< Biggest sample                                             */
+    uint32_t mean_q8;       /**< Mean value, in 1/256 LSB                                   */
+    uint32_t variance_q8;   /**< Variance, in 1/256 LSB^2                                   */
+} adc_statistics_summary_t;
+
+/*  ####################################################################################
+    ############################ Functions declarations ################################
+    #################################################################################### */
+
+/**
+ * @brief initialises a statistics object and clears its windows
+ * @param[out] stats         : statistics object
+ * @param[in]  window_length : number of samples per window (1 to ADC_STATISTICS_MAX_WINDOW)
+ * @return
+ *      ADC_STATISTICS_ERROR_OK             : operation succeeded
+ *      ADC_STATISTICS_ERROR_NULL_POINTER   : given pointer is NULL
+ *      ADC_STATISTICS_ERROR_CONFIG         : window length is out of range
+*/
+adc_statistics_error_t adc_statistics_init(adc_statistics_t * const stats, const uint16_t window_length);
+
+/**
+ * @brief accumulates a new sample, at constant cost. Meant to be called from the ADC ISR : no checks are performed
+ * @param[in] stats  : initialised statistics object
+ * @param[in] sample : new raw sample
+*/
+void adc_statistics_push(adc_statistics_t * const stats, const uint16_t sample);
+
+/**
+ * @brief discards the running window, when the samples it holds are not contiguous anymore (stalled acquisition).
+ * Last latched window is kept. Meant to be called from the ADC ISR : no checks are performed
+ * @param[in] stats : initialised statistics object
+*/
+void adc_statistics_restart(adc_statistics_t * const stats);
+
+/**
+ * @brief computes mean and variance out of a window. Uses 64 bits arithmetic : call it from main context only
+ * @param[in]  window  : window accumulators
+ * @param[out] summary : computed summary
+ * @return
+ *      ADC_STATISTICS_ERROR_OK             : operation succeeded
+ *      ADC_STATISTICS_ERROR_NULL_POINTER   : given pointer is NULL
+*/
+adc_statistics_error_t adc_statistics_summarize(const adc_statistics_window_t * const window, adc_statistics_summary_t * const summary);
+
+/* Expose this API to C++ code without name mangling */
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* ADC_STATISTICS_HEADER */
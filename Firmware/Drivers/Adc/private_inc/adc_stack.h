@@ -38,13 +38,19 @@ extern "C"
 #endif /* __cplusplus */
 
 #include <stdint.h>
+#include <stdbool.h>
 #include "adc.h"
 #include "adc_reg.h"
+#include "adc_filter.h"
+#include "adc_statistics.h"
 
 /*  ####################################################################################
     ############################ Data types declaration ################################
     #################################################################################### */
 
+/* Channel pair uses the voltage reference selected in adc configuration */
+#define ADC_STACK_REFERENCE_DEFAULT 0xFFU
+
 /**
  * @brief lists available error types for this ADC stack object
 */
@@ -64,6 +70,22 @@ typedef struct
 {
     adc_mux_t    channel;   /**< Adc configured channel (uses a ADC_MUX type)                     */
     adc_result_t result;    /**< Adc result type, last value read by ADC                          */
+    adc_result_t published; /**< Result of the last complete scan cycle, updated for all channels at once  */
+    adc_result_t filtered;  /**< Last result passed through the channel filter (equals result when no filter is set) */
+    adc_filter_t * filter;  /**< Optional filter object, owned by the caller (NULL : no filtering)  */
+    adc_statistics_t * statistics; /**< Optional statistics object, owned by the caller (NULL : no statistics)  */
+    adc_sample_listener_t listener; /**< Optional listener called with each result (NULL : no listener)   */
+    adc_window_t window;    /**< Window comparator thresholds and callback                        */
+    bool window_armed;      /**< Window comparator is checked only when armed                     */
+    uint8_t      divider;   /**< Channel is converted once every 'divider' scan cycles (0 or 1 : converted at each cycle) */
+    uint8_t      countdown; /**< Remaining scan cycles before this channel is converted again      */
+    uint8_t      discard;   /**< Conversions thrown away each time the mux switches to this channel (settling)         */
+    uint8_t      average_order; /**< 2^average_order conversions are averaged after discarded ones                    */
+    uint16_t     repeat;    /**< Remaining back-to-back conversions of this channel in current sequence                */
+    uint16_t     accumulator;   /**< Sum of averaged conversions of current sequence                                   */
+    uint8_t      reference; /**< Voltage reference (adc_voltage_ref_t) used by this channel, or ADC_STACK_REFERENCE_DEFAULT */
+    uint16_t     reference_discard; /**< Extra conversions thrown away in current sequence after a reference switch    */
+    bool         noise_reduction;   /**< Conversions are started by entering ADC noise reduction sleep                  */
 } adc_channel_pair_t;
 
 /**
@@ -75,6 +97,9 @@ typedef struct
 {
     uint8_t   count;
     uint8_t   index;
+    uint8_t   scan_cycle;   /**< Incremented each time a scan cycle is published, used as a sequence counter by readers */
+    uint16_t  reference_settling;   /**< Conversions thrown away when selected pair uses another reference than the previous one */
+    uint8_t   active_reference;     /**< Reference of the last selected pair                                    */
     adc_channel_pair_t channels_pair[ADC_MUX_COUNT];
 } adc_stack_t;
 
@@ -142,6 +167,9 @@ adc_stack_error_t adc_stack_find_channel(volatile adc_stack_t * const stack, vol
 
 /**
  * @brief returns next channel to be scanned (mainly called either by ISR or asynchronous code)
+ * Channels with a scan divider are skipped until their countdown elapses. A channel with a settling sequence is
+ * returned several times in a row (@see adc_stack_set_settling()), plus reference_settling times when it does not use
+ * the same reference as the previously selected one (@see adc_stack_set_reference())
  * @param[in] stack :   adc stack object
  * @param[out] pair :   pointer to next pair
  * @return
@@ -150,6 +178,87 @@ adc_stack_error_t adc_stack_find_channel(volatile adc_stack_t * const stack, vol
 */
 adc_stack_error_t adc_stack_get_next(volatile adc_stack_t * const stack, volatile adc_channel_pair_t ** pair);
 
+/**
+ * @brief sets the scan divider of the first matching channel in stack
+ * @param[in] stack     :   adc stack object
+ * @param[in] channel   :   adc channel value
+ * @param[in] divider   :   channel will be converted once every 'divider' scan cycles
+ * @return
+ *      ADC_STACK_ERROR_OK                  :   action performed ok
+ *      ADC_STACK_ERROR_EMPTY               :   stack is empty
+ *      ADC_STACK_ERROR_ELEMENT_NOT_FOUND   :   channel is not registered
+*/
+adc_stack_error_t adc_stack_set_divider(volatile adc_stack_t * const stack, volatile const adc_mux_t channel, const uint8_t divider);
+
+/**
+ * @brief sets the settling sequence of the first matching channel in stack : each time this channel is selected,
+ * it is returned by adc_stack_get_next() discard + 2^average_order times in a row
+ * @param[in] stack         :   adc stack object
+ * @param[in] channel       :   adc channel value
+ * @param[in] discard       :   conversions to be thrown away after mux switch
+ * @param[in] average_order :   log2 of the number of conversions to be averaged
+ * @return
+ *      ADC_STACK_ERROR_OK                  :   action performed ok
+ *      ADC_STACK_ERROR_EMPTY               :   stack is empty
+ *      ADC_STACK_ERROR_ELEMENT_NOT_FOUND   :   channel is not registered
+*/
+adc_stack_error_t adc_stack_set_settling(volatile adc_stack_t * const stack, volatile const adc_mux_t channel, const uint8_t discard, const uint8_t average_order);
+
+/**
+ * @brief sets the voltage reference of the first matching channel in stack. When the scan switches between pairs
+ * using different references, the newly selected pair's sequence starts with stack's reference_settling extra
+ * conversions, thrown away while the reference voltage settles (@see adc_stack_get_next())
+ * @param[in] stack     :   adc stack object
+ * @param[in] channel   :   adc channel value
+ * @param[in] reference :   adc_voltage_ref_t value, or ADC_STACK_REFERENCE_DEFAULT
+ * @return
+ *      ADC_STACK_ERROR_OK                  :   action performed ok
+ *      ADC_STACK_ERROR_EMPTY               :   stack is empty
+ *      ADC_STACK_ERROR_ELEMENT_NOT_FOUND   :   channel is not registered
+*/
+adc_stack_error_t adc_stack_set_reference(volatile adc_stack_t * const stack, volatile const adc_mux_t channel, const uint8_t reference);
+
+/**
+ * @brief returns the number of back-to-back conversions performed each time a pair is selected, reference
+ * switching aside
+ * @param[in] pair :   channel pair
+ * @return discard + 2^average_order
+*/
+uint16_t adc_channel_pair_sequence_length(volatile const adc_channel_pair_t * const pair);
+
+/**
+ * @brief reorders the stack so that channels which need settling (discard != 0, typically high impedance sources)
+ * are grouped at the end of the scan, after all other ones. Relative order is kept within both groups.
+ * Scan restarts from the first channel.
+ * @param[in] stack :   adc stack object
+ * @return
+ *      ADC_STACK_ERROR_OK              :   action performed ok
+ *      ADC_STACK_ERROR_NULL_POINTER    :   given pointer is NULL
+*/
+adc_stack_error_t adc_stack_group_settling_channels(volatile adc_stack_t * const stack);
+
+/**
+ * @brief restarts the scan from the first registered channel and returns it. Its scan divider countdown is reloaded
+ * as if it was returned by adc_stack_get_next()
+ * @param[in] stack :   adc stack object
+ * @param[out] pair :   pointer to first pair
+ * @return
+ *      ADC_STACK_ERROR_OK      :   action performed ok
+ *      ADC_STACK_ERROR_EMPTY   :   stack is empty, no pair. Returned pair is unchanged
+*/
+adc_stack_error_t adc_stack_rewind(volatile adc_stack_t * const stack, volatile adc_channel_pair_t ** pair);
+
+/**
+ * @brief publishes results of a complete scan cycle : each pair's result is copied to its published value and
+ * scan cycle counter is incremented. Meant to be called from the ISR once the last channel of a cycle is converted,
+ * readers compare scan_cycle before and after copying published values to detect a concurrent update.
+ * @param[in] stack :   adc stack object
+ * @return
+ *      ADC_STACK_ERROR_OK              :   action performed ok
+ *      ADC_STACK_ERROR_NULL_POINTER    :   given pointer is NULL
+*/
+adc_stack_error_t adc_stack_publish(volatile adc_stack_t * const stack);
+
 /**
  * @brief returns currently scanned pair object
  * @param[in] stack :   adc stack object
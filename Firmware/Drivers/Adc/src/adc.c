@@ -39,19 +39,97 @@ along with this program.  If not, see <https://www.gnu.org/licenses/>.
 #define ADC_MAX_VALUE       1024U
 #define ADC_1V1_MILLIVOLT   1100U
 
+/* Millivolts conversion factor is stored as a Q16 fixed point number, so that a conversion is a multiplication
+followed by a shift instead of a 32 bits division */
+#define ADC_MILLIVOLT_SCALE_SHIFT   16U
+
+/* Plausible bandgap readings against AVCC, for a supply ranging from 5.5V (lower bound) to 1.8V (upper bound).
+Anything else is considered as a non-settled reading and is discarded */
+#define ADC_BANDGAP_MIN_RAW ((ADC_1V1_MILLIVOLT * ADC_MAX_VALUE) / 5500U)
+#define ADC_BANDGAP_MAX_RAW ((ADC_1V1_MILLIVOLT * ADC_MAX_VALUE) / 1800U)
+
+/* Snapshots are retried this many times when a scan cycle gets published while results are being copied */
+#ifndef ADC_SNAPSHOT_MAX_RETRIES
+    #define ADC_SNAPSHOT_MAX_RETRIES 4U
+#endif
 
 /* Holds the current configuration of the ADC module */
 static struct
 {
     adc_config_hal_t base_config;
+    uint32_t millivolt_scale;       /**< Q16 factor : millivolts = (raw * millivolt_scale) >> 16 */
+    volatile bool supply_sample_pending; /**< Set by ISR when a new bandgap reading is available     */
     bool is_initialised;
 } internal_configuration = {.base_config = {0},
+                            .millivolt_scale = 0,
+                            .supply_sample_pending = false,
                             .is_initialised = false};
 
 static volatile adc_stack_t registered_channels;
 
+/* Latched window comparator faults, bit n is set when channel n tripped */
+static volatile uint16_t window_faults = 0;
+
+/* Set when the next conversion belongs to a noise reduced channel : it is left to the main loop, which starts it by
+entering ADC noise reduction sleep */
+static volatile bool noise_reduction_pending = false;
+
+/* Conversion counters, updated by ISR */
+static volatile struct
+{
+    uint32_t total;     /**< Number of fetched conversions                                          */
+    uint16_t overruns;  /**< Number of times a conversion was already finished when exiting the ISR */
+} conversion_counters = {.total = 0, .overruns = 0};
+
+/**
+ * @brief keeps track of the channels which are being processed by the ADC peripheral.
+ * In single shot mode, only the converting pair is relevant : the mux register is written right before
+ * a new conversion is started.
+ * In free-running mode, the ADC latches the mux register when a conversion starts, which happens as soon as
+ * the previous one is finished (so before the ISR fires). Mux register is then written one conversion ahead and
+ * the result which is read in the ISR belongs to the channel which was queued one conversion earlier.
+*/
+typedef enum
+{
+    SAMPLE_ROLE_DISCARD,        /**< Conversion is performed while sample and hold capacitor settles, result is dropped    */
+    SAMPLE_ROLE_ACCUMULATE,     /**< Result is accumulated, more conversions of the same channel follow                    */
+    SAMPLE_ROLE_LAST,           /**< Last conversion of the channel sequence, averaged result is published                  */
+} sample_role_t;
+
+static struct
+{
+    volatile adc_channel_pair_t * converting;   /**< Channel pair which owns the conversion currently running in the peripheral */
+    volatile adc_channel_pair_t * queued;       /**< Channel pair written to the mux register, latched by the next conversion   */
+    sample_role_t converting_role;              /**< What to do with the result of the running conversion                       */
+    sample_role_t queued_role;                  /**< What to do with the result of the queued conversion                        */
+    bool first_channel_duplicated;              /**< Free-running start converts the first channel twice in a row               */
+} pipeline = {.converting = NULL, .queued = NULL, .converting_role = SAMPLE_ROLE_LAST, .queued_role = SAMPLE_ROLE_LAST,
+              .first_channel_duplicated = false};
+
+/* Single channel burst capture */
+static struct
+{
+    volatile adc_burst_state_t state;
+    adc_burst_config_t config;
+    volatile uint16_t index;                /**< Next write index in trace buffer                               */
+    volatile uint16_t captured;             /**< Number of samples written, saturates at pre_trigger            */
+    volatile uint16_t remaining;            /**< Post-trigger samples still to be captured                      */
+    volatile uint16_t first_index;          /**< Oldest sample of the trace                                     */
+    volatile bool trigger_requested;        /**< Software trigger pending                                       */
+    uint8_t previous_sample;                /**< Used by edge triggers                                          */
+    bool previous_sample_valid;             /**< No edge can be seen before a first sample was converted        */
+    struct
+    {
+        uint8_t mux;
+        uint8_t adcsra;
+        uint8_t adcsrb;
+    } saved_registers;                      /**< Normal scan configuration, restored after capture              */
+} burst = {.state = ADC_BURST_STATE_IDLE};
+
 static inline uint16_t retrieve_result_from_registers(void);
 static inline void isr_helper_extract_data_from_adc_regs(void);
+static inline void pipeline_reset(void);
+static inline bool conversion_result_available(void);
 
 static inline uint16_t retrieve_result_from_registers(void)
 {
@@ -69,11 +147,215 @@ static inline adc_error_t set_mux_register(volatile adc_channel_pair_t * const p
     }
     else
     {
-        *internal_configuration.base_config.handle.mux_reg =  (*internal_configuration.base_config.handle.mux_reg & ~MUX_MSK) | pair->channel;
+        /* Reference and channel are written at once, both are latched when next conversion starts */
+        const uint8_t reference = (ADC_STACK_REFERENCE_DEFAULT == pair->reference) ? (uint8_t) internal_configuration.base_config.ref
+                                                                                   : pair->reference;
+        *internal_configuration.base_config.handle.mux_reg = (*internal_configuration.base_config.handle.mux_reg & ~(MUX_MSK | REF_MSK))
+                                                           | (uint8_t)(reference << REFS0) | pair->channel;
+    }
+    return ret;
+}
+
+static inline adc_error_t compute_millivolt_scale(const adc_voltage_ref_t ref, const uint16_t supply_voltage_mv, uint32_t * const scale)
+{
+    adc_error_t ret = ADC_ERROR_OK;
+    uint32_t reference_mv = 0;
+    switch (ref)
+    {
+        case ADC_VOLTAGE_REF_INTERNAL_1V1:
+            reference_mv = ADC_1V1_MILLIVOLT;
+            break;
+        case ADC_VOLTAGE_REF_AREF_PIN:
+        case ADC_VOLTAGE_REF_AVCC:
+            reference_mv = supply_voltage_mv;
+            break;
+        default:
+            ret = ADC_ERROR_CONFIG;
+            break;
     }
+    /* ADC_MAX_VALUE is a power of two, this factor is exact */
+    *scale = (reference_mv << ADC_MILLIVOLT_SCALE_SHIFT) / ADC_MAX_VALUE;
     return ret;
 }
 
+static inline bool supply_monitoring_enabled(void)
+{
+    return (ADC_VOLTAGE_REF_AVCC == internal_configuration.base_config.ref)
+        && (0 != internal_configuration.base_config.supply_monitoring_period);
+}
+
+/**
+ * @brief adds the bandgap to the scan, once every supply_monitoring_period scan cycles. Its first conversions are
+ * dropped while the sample and hold capacitor settles to the bandgap voltage
+*/
+static inline void register_supply_channel(void)
+{
+    if (supply_monitoring_enabled())
+    {
+        adc_stack_register_channel(&registered_channels, ADC_MUX_1v1_REF);
+        adc_stack_set_divider(&registered_channels, ADC_MUX_1v1_REF, internal_configuration.base_config.supply_monitoring_period);
+        adc_stack_set_settling(&registered_channels, ADC_MUX_1v1_REF, ADC_BANDGAP_SETTLING_CONVERSIONS, 0U);
+    }
+}
+
+static inline bool interrupt_lock(void);
+static inline void interrupt_unlock(const bool enabled);
+
+/**
+ * @brief recomputes conversion factor out of the last bandgap reading.
+ * AVCC = 1100 * 1024 / raw, so the Q16 factor (AVCC * 2^16 / 1024) simplifies to (1100 * 2^16) / raw.
+ * This division is only performed (in main context) when a new bandgap sample was fetched by the ISR.
+*/
+static inline void refresh_supply_scale(void)
+{
+    if (supply_monitoring_enabled() && internal_configuration.supply_sample_pending)
+    {
+        volatile adc_channel_pair_t * pair = NULL;
+        if (ADC_STACK_ERROR_OK == adc_stack_find_channel(&registered_channels, ADC_MUX_1v1_REF, &pair))
+        {
+            /* 16 bits result is written by the ISR : flag and result are taken together, out of its reach */
+            const bool interrupt_state = interrupt_lock();
+            const uint32_t raw = pair->result;
+            internal_configuration.supply_sample_pending = false;
+            interrupt_unlock(interrupt_state);
+            if ((raw >= ADC_BANDGAP_MIN_RAW) && (raw <= ADC_BANDGAP_MAX_RAW))
+            {
+                internal_configuration.millivolt_scale = ((uint32_t) ADC_1V1_MILLIVOLT << ADC_MILLIVOLT_SCALE_SHIFT) / raw;
+                internal_configuration.base_config.supply_voltage_mv = (uint16_t)(((uint32_t) ADC_1V1_MILLIVOLT * ADC_MAX_VALUE) / raw);
+            }
+        }
+    }
+}
+
+static inline adc_millivolts_t convert_to_millivolts(const adc_result_t result)
+{
+    return (adc_millivolts_t)(((uint32_t) result * internal_configuration.millivolt_scale) >> ADC_MILLIVOLT_SCALE_SHIFT);
+}
+
+/**
+ * @brief same as convert_to_millivolts(), using the reference selected for this channel pair
+*/
+static inline adc_millivolts_t convert_pair_to_millivolts(volatile const adc_channel_pair_t * const pair, const adc_result_t result)
+{
+    adc_millivolts_t millivolts = 0;
+    uint32_t scale = 0;
+    if (ADC_STACK_REFERENCE_DEFAULT == pair->reference)
+    {
+        millivolts = convert_to_millivolts(result);
+    }
+    else if (ADC_ERROR_OK == compute_millivolt_scale((adc_voltage_ref_t) pair->reference, internal_configuration.base_config.supply_voltage_mv, &scale))
+    {
+        millivolts = (adc_millivolts_t)(((uint32_t) result * scale) >> ADC_MILLIVOLT_SCALE_SHIFT);
+    }
+    return millivolts;
+}
+
+/**
+ * @brief masks ADC conversion complete interrupt while main context modifies data shared with the ISR.
+ * A conversion ending meanwhile leaves ADIF set, so that the ISR fires as soon as interrupt is unmasked again
+ * @return previous interrupt enable state, to be given back to interrupt_unlock()
+*/
+static inline bool interrupt_lock(void)
+{
+    volatile uint8_t * reg = internal_configuration.base_config.handle.adcsra_reg;
+    bool enabled = false;
+    if (NULL != reg)
+    {
+        enabled = (0 != (*reg & ADIE_MSK));
+        *reg &= ~ADIE_MSK;
+    }
+    return enabled;
+}
+
+static inline void interrupt_unlock(const bool enabled)
+{
+    if (enabled)
+    {
+        *internal_configuration.base_config.handle.adcsra_reg |= ADIE_MSK;
+    }
+}
+
+/**
+ * @brief compares a fresh result against channel window, latches the fault and calls the callback on first trip
+*/
+static inline void check_window(volatile adc_channel_pair_t * const pair, const adc_result_t result)
+{
+    if (pair->window_armed)
+    {
+        const uint16_t channel_mask = (uint16_t)(1U << pair->channel);
+        bool tripped = false;
+        adc_window_crossing_t crossing = ADC_WINDOW_CROSSING_LOW;
+        if (result < pair->window.low)
+        {
+            tripped = true;
+        }
+        else if (result > pair->window.high)
+        {
+            tripped = true;
+            crossing = ADC_WINDOW_CROSSING_HIGH;
+        }
+
+        if (tripped && (0 == (window_faults & channel_mask)))
+        {
+            window_faults |= channel_mask;
+            if (NULL != pair->window.callback)
+            {
+                pair->window.callback(pair->channel, result, crossing);
+            }
+        }
+    }
+}
+
+static inline void pipeline_reset(void)
+{
+    pipeline.converting = NULL;
+    pipeline.queued = NULL;
+    pipeline.converting_role = SAMPLE_ROLE_LAST;
+    pipeline.queued_role = SAMPLE_ROLE_LAST;
+    pipeline.first_channel_duplicated = false;
+}
+
+/**
+ * @brief number of back-to-back conversions of a pair selected by the stack, reference settling included
+*/
+static inline uint16_t sequence_length(volatile const adc_channel_pair_t * const pair)
+{
+    return adc_channel_pair_sequence_length(pair) + pair->reference_discard;
+}
+
+/**
+ * @brief tells the role of a conversion, right after its pair was selected by the stack : pair's repeat field
+ * then holds how many conversions of this channel remain after this one
+*/
+static inline sample_role_t sample_role(volatile const adc_channel_pair_t * const pair)
+{
+    sample_role_t role = SAMPLE_ROLE_LAST;
+    if (0 != pair->repeat)
+    {
+        /* Reference settling conversions come first, then channel's own discarded ones */
+        const uint16_t position = sequence_length(pair) - 1U - pair->repeat;
+        role = (position < ((uint16_t) pair->reference_discard + pair->discard)) ? SAMPLE_ROLE_DISCARD : SAMPLE_ROLE_ACCUMULATE;
+    }
+    return role;
+}
+
+static inline bool is_free_running(void)
+{
+    return (ADC_RUNNING_MODE_AUTOTRIGGERED == internal_configuration.base_config.running_mode)
+        && (ADC_TRIGGER_FREE_RUNNING == internal_configuration.base_config.trigger_sources);
+}
+
+/**
+ * @brief tells whether the conversion of a pair is started by entering ADC noise reduction sleep. Sleeping CPU is woken
+ * up by the conversion complete interrupt, so this needs an interrupt driven single shot scan
+*/
+static inline bool noise_reduction_enabled(volatile const adc_channel_pair_t * const pair)
+{
+    return (NULL != pair) && pair->noise_reduction
+        && (ADC_RUNNING_MODE_SINGLE_SHOT == internal_configuration.base_config.running_mode)
+        && internal_configuration.base_config.using_interrupt;
+}
+
 adc_error_t adc_config_hal_copy(adc_config_hal_t * dest, adc_config_hal_t * const src)
 {
     adc_error_t ret = ADC_ERROR_OK;
@@ -119,6 +401,7 @@ adc_error_t adc_config_hal_get_default(adc_config_hal_t * config)
         config->trigger_sources = ADC_TRIGGER_FREE_RUNNING;
         config->running_mode = ADC_RUNNING_MODE_SINGLE_SHOT;
         config->using_interrupt = false;
+        config->supply_monitoring_period = 0;
     }
     return ret;
 }
@@ -164,15 +447,21 @@ adc_error_t adc_base_init(adc_config_hal_t * const config)
         ret = ADC_ERROR_NULL_POINTER;
     }
     else
+    {
+        ret = compute_millivolt_scale(config->ref, config->supply_voltage_mv, &internal_configuration.millivolt_scale);
+    }
+
+    if (ADC_ERROR_OK == ret)
     {
         adc_stack_reset(&registered_channels);
+        pipeline_reset();
         /* First, copy configuration data to the internal cache */
         adc_config_hal_copy(&(internal_configuration.base_config), config);
         adc_handle_t * handle = &internal_configuration.base_config.handle;
         *handle->mux_reg = (*handle->mux_reg & ~REF_MSK) | (config->ref << REFS0);            /* set reference voltage */
         *handle->mux_reg = (*handle->mux_reg & ~ADLAR_MSK) | (config->alignment << ADLAR);    /* set result adjustment */
         *handle->adcsra_reg = (*handle->adcsra_reg & ~ADPS_MSK) | (config->prescaler);        /* set precaler */
-        *handle->adcsrb_reg |= config->trigger_sources;
+        *handle->adcsrb_reg = (*handle->adcsrb_reg & ~ADTS_MSK) | (config->trigger_sources);  /* set trigger source */
         if (internal_configuration.base_config.using_interrupt)
         {
             *handle->adcsra_reg |= (1 << ADIE);
@@ -186,6 +475,16 @@ adc_error_t adc_base_init(adc_config_hal_t * const config)
             *handle->adcsra_reg |= 1 << ADATE;
         }
 
+        window_faults = 0;
+        registered_channels.reference_settling = ADC_REFERENCE_SETTLING_CONVERSIONS;
+        burst.state = ADC_BURST_STATE_IDLE;
+        conversion_counters.total = 0;
+        conversion_counters.overruns = 0;
+
+        /* Bandgap is scanned like any other channel, but only once every supply_monitoring_period scan cycles */
+        internal_configuration.supply_sample_pending = false;
+        register_supply_channel();
+
         internal_configuration.is_initialised = true;
     }
     return ret;
@@ -194,7 +493,10 @@ adc_error_t adc_base_init(adc_config_hal_t * const config)
 void adc_base_deinit(void)
 {
     internal_configuration.is_initialised = false;
+    burst.state = ADC_BURST_STATE_IDLE;
+    noise_reduction_pending = false;
     adc_stack_reset(&registered_channels);
+    pipeline_reset();
     {
         adc_handle_t * handle = &internal_configuration.base_config.handle;
         if (handle->mux_reg != NULL)
@@ -208,6 +510,8 @@ void adc_base_deinit(void)
         }
     }
     adc_config_hal_reset(&internal_configuration.base_config);
+    internal_configuration.millivolt_scale = 0;
+    window_faults = 0;
 }
 
 
@@ -222,8 +526,31 @@ adc_state_t adc_start(void)
     if (ADC_STATE_READY == init_state)
     {
         volatile uint8_t * reg = internal_configuration.base_config.handle.adcsra_reg;
-        /* Enable and start the ADC peripheral */
-        *reg |= (1 << ADEN) | (1 << ADSC);
+
+        /* Select the first channel before starting the first conversion. In free-running mode, this channel
+        will be latched twice (first conversion and the one which automatically follows it) */
+        pipeline_reset();
+        if (ADC_STACK_ERROR_OK == adc_stack_rewind(&registered_channels, &pipeline.converting))
+        {
+            set_mux_register(pipeline.converting);
+            pipeline.converting_role = sample_role(pipeline.converting);
+            pipeline.queued = pipeline.converting;
+            pipeline.queued_role = pipeline.converting_role;
+            pipeline.first_channel_duplicated = is_free_running();
+            /* The extra conversion is part of the settling sequence, if any */
+            if (pipeline.first_channel_duplicated && (1U != sequence_length(pipeline.converting)))
+            {
+                pipeline.queued_role = SAMPLE_ROLE_DISCARD;
+            }
+        }
+
+        /* Enable and start the ADC peripheral, unless first conversion is started by the main loop going to sleep */
+        noise_reduction_pending = noise_reduction_enabled(pipeline.converting);
+        *reg |= (1 << ADEN);
+        if (!noise_reduction_pending)
+        {
+            *reg |= (1 << ADSC);
+        }
     }
 
     return init_state;
@@ -239,6 +566,7 @@ adc_state_t adc_stop(void)
         *reg &= ~((1 << ADEN) | (1 << ADSC));
         /* Disable ADC interrupt mode */
         *reg &= ~(1 << ADIE);
+        noise_reduction_pending = false;
     }
 
     return init_state;
@@ -248,10 +576,21 @@ adc_error_t adc_register_channel(const adc_mux_t channel)
 {
     adc_error_t ret = ADC_ERROR_OK;
     adc_stack_error_t err = adc_stack_register_channel(&registered_channels, channel);
+    pipeline_reset();
     if (ADC_STACK_ERROR_OK != err)
     {
         ret = ADC_ERROR_CONFIG;
     }
+    else if (ADC_MUX_INTERNAL_TEMPERATURE == channel)
+    {
+        /* Temperature sensor can only be measured against internal 1V1 reference : not scanned at all otherwise */
+        ret = adc_set_channel_reference(channel, ADC_VOLTAGE_REF_INTERNAL_1V1);
+        if (ADC_ERROR_OK != ret)
+        {
+            adc_stack_unregister_channel(&registered_channels, channel);
+            pipeline_reset();
+        }
+    }
     return ret;
 }
 
@@ -259,6 +598,7 @@ adc_error_t adc_unregister_channel(const adc_mux_t channel)
 {
     adc_error_t ret = ADC_ERROR_OK;
     adc_stack_error_t err = adc_stack_unregister_channel(&registered_channels, channel);
+    pipeline_reset();
     if (ADC_STACK_ERROR_OK != err)
     {
         ret = ADC_ERROR_CONFIG;
@@ -289,114 +629,994 @@ adc_error_t adc_read_raw(const adc_mux_t channel, adc_result_t * const result)
     return ret;
 }
 
-static inline bool conversion_is_finished(void)
-{
-    return ((*internal_configuration.base_config.handle.adcsra_reg) & 1 << ADSC) == 0;
-}
-
-static inline void isr_helper_extract_data_from_adc_regs(void)
+adc_error_t adc_set_channel_filter(const adc_mux_t channel, adc_filter_t * const filter, const adc_filter_config_t * const config)
 {
-    static volatile adc_channel_pair_t * pair = NULL;
-    adc_stack_error_t stack_error = ADC_STACK_ERROR_OK;
-    if (NULL == pair)
+    adc_error_t ret = ADC_ERROR_OK;
+    volatile adc_channel_pair_t * pair = NULL;
+    if (NULL != filter && NULL == config)
     {
-        stack_error = adc_stack_get_current(&registered_channels, &pair);
+        ret = ADC_ERROR_NULL_POINTER;
     }
-    if (ADC_STACK_ERROR_OK == stack_error && conversion_is_finished())
+    else if (ADC_STACK_ERROR_OK != adc_stack_find_channel(&registered_channels, channel, &pair))
     {
-        uint16_t result = retrieve_result_from_registers();
-        pair->result = result;
-
-        #ifdef UNIT_TESTING
-            /* Reset interrupt flag manually */
-            *internal_configuration.base_config.handle.adcsra_reg &= ~ADIF_MSK;
-        #else
-            /* Reset interrupt flag manually */
-            //*internal_configuration.base_config.handle.adcsra_reg |= (1U << ADIF);
-        #endif
-        stack_error = adc_stack_get_next(&registered_channels, &pair);
-        if (ADC_STACK_ERROR_OK == stack_error)
+        ret = ADC_ERROR_CHANNEL_NOT_FOUND;
+    }
+    else
+    {
+        /* Filter object might already be used by the ISR, and its pointer is not written atomically on 8 bits targets */
+        const bool interrupt_state = interrupt_lock();
+        if ((NULL != filter) && (ADC_FILTER_ERROR_OK != adc_filter_init(filter, config)))
+        {
+            ret = ADC_ERROR_CONFIG;
+        }
+        else
         {
-            set_mux_register(pair);
+            pair->filter = filter;
         }
+        interrupt_unlock(interrupt_state);
     }
+    return ret;
 }
 
-adc_state_t adc_process(void)
+adc_error_t adc_set_channel_settling(const adc_mux_t channel, const uint8_t discard, const uint8_t average_order)
 {
-    adc_state_t ret = check_initialisation();
-    if (ADC_STATE_READY == ret)
+    adc_error_t ret = ADC_ERROR_OK;
+    volatile adc_channel_pair_t * pair = NULL;
+    if (ADC_STACK_ERROR_OK != adc_stack_find_channel(&registered_channels, channel, &pair))
     {
-       isr_helper_extract_data_from_adc_regs();
-        /* Start next conversion */
-        *internal_configuration.base_config.handle.adcsra_reg |= 1U << ADSC ;
+        ret = ADC_ERROR_CHANNEL_NOT_FOUND;
+    }
+    else if ((average_order > ADC_AVERAGE_MAX_ORDER) || ((discard + (1U << average_order)) > UINT8_MAX))
+    {
+        ret = ADC_ERROR_CONFIG;
+    }
+    else
+    {
+        /* Sequence currently being converted is restarted from scratch */
+        const bool interrupt_state = interrupt_lock();
+        adc_stack_set_settling(&registered_channels, channel, discard, average_order);
+        pipeline_reset();
+        interrupt_unlock(interrupt_state);
     }
     return ret;
 }
 
-adc_error_t adc_read_millivolt(const adc_mux_t channel, adc_millivolts_t * const reading)
+/**
+ * @brief tells whether the scan may be held for reference settling conversions without exceeding the protection latency
+*/
+static inline bool reference_settling_fits(const uint16_t conversions)
+{
+    return ((uint32_t) conversions * ADC_CONVERSION_TIME_US) <= ADC_PROTECTION_LATENCY_US;
+}
+
+adc_error_t adc_set_channel_reference(const adc_mux_t channel, const adc_voltage_ref_t reference)
 {
     adc_error_t ret = ADC_ERROR_OK;
-    if (NULL == reading )
+    uint32_t scale = 0;
+    volatile adc_channel_pair_t * pair = NULL;
+    if (ADC_STACK_ERROR_OK != adc_stack_find_channel(&registered_channels, channel, &pair))
     {
-        ret = ADC_ERROR_NULL_POINTER;
+        ret = ADC_ERROR_CHANNEL_NOT_FOUND;
+    }
+    else if ((ADC_ERROR_OK != compute_millivolt_scale(reference, internal_configuration.base_config.supply_voltage_mv, &scale))
+          || ((ADC_MUX_INTERNAL_TEMPERATURE == channel) && (ADC_VOLTAGE_REF_INTERNAL_1V1 != reference))
+          || ((reference != internal_configuration.base_config.ref) && !reference_settling_fits(registered_channels.reference_settling)))
+    {
+        ret = ADC_ERROR_CONFIG;
     }
     else
     {
-        adc_result_t result = 0;
-        ret = adc_read_raw(channel, &result);
-        if (ADC_ERROR_OK == ret)
+        /* Configured reference needs no switching at all */
+        const uint8_t pair_reference = (reference == internal_configuration.base_config.ref) ? ADC_STACK_REFERENCE_DEFAULT
+                                                                                              : (uint8_t) reference;
+        const bool interrupt_state = interrupt_lock();
+        adc_stack_set_reference(&registered_channels, channel, pair_reference);
+        pipeline_reset();
+        interrupt_unlock(interrupt_state);
+    }
+    return ret;
+}
+
+adc_error_t adc_set_reference_settling(const uint16_t conversions)
+{
+    adc_error_t ret = ADC_ERROR_OK;
+    const bool interrupt_state = interrupt_lock();
+    if (!reference_settling_fits(conversions))
+    {
+        for (uint8_t i = 0 ; i < registered_channels.count ; i++)
         {
-            switch (internal_configuration.base_config.ref)
+            if (ADC_STACK_REFERENCE_DEFAULT != registered_channels.channels_pair[i].reference)
             {
-                case ADC_VOLTAGE_REF_INTERNAL_1V1:
-                    *reading =  (uint16_t)(((uint32_t)result * (uint32_t)ADC_1V1_MILLIVOLT) / ADC_MAX_VALUE);
-                    break;
-                case ADC_VOLTAGE_REF_AREF_PIN:
-                case ADC_VOLTAGE_REF_AVCC:
-                    *reading = (uint16_t)(((uint32_t)result * (uint32_t)internal_configuration.base_config.supply_voltage_mv) / ADC_MAX_VALUE);
-                    break;
-                default:
-                    *reading = 0;
-                    ret = ADC_ERROR_CONFIG;
-                    break;
+                ret = ADC_ERROR_CONFIG;
             }
         }
+    }
+    if (ADC_ERROR_OK == ret)
+    {
+        registered_channels.reference_settling = conversions;
+    }
+    interrupt_unlock(interrupt_state);
+    return ret;
+}
+
+adc_error_t adc_set_channel_divider(const adc_mux_t channel, const uint8_t divider)
+{
+    adc_error_t ret = ADC_ERROR_OK;
+    const bool interrupt_state = interrupt_lock();
+    if (ADC_STACK_ERROR_OK != adc_stack_set_divider(&registered_channels, channel, divider))
+    {
+        ret = ADC_ERROR_CHANNEL_NOT_FOUND;
+    }
+    pipeline_reset();
+    interrupt_unlock(interrupt_state);
+    return ret;
+}
 
+adc_error_t adc_read_die_temperature(int16_t * const celsius)
+{
+    adc_error_t ret = ADC_ERROR_OK;
+    volatile adc_channel_pair_t * pair = NULL;
+    if (NULL == celsius)
+    {
+        ret = ADC_ERROR_NULL_POINTER;
+    }
+    else if (ADC_STACK_ERROR_OK != adc_stack_find_channel(&registered_channels, ADC_MUX_INTERNAL_TEMPERATURE, &pair))
+    {
+        ret = ADC_ERROR_CHANNEL_NOT_FOUND;
     }
+    else
+    {
+        /* Sensor slope is ~1 mV per degree */
+        const int16_t millivolts = (int16_t) convert_pair_to_millivolts(pair, pair->result);
+        *celsius = millivolts - ADC_TEMPERATURE_SENSOR_MV_AT_25C + 25;
+    }
+    return ret;
+}
 
+adc_error_t adc_set_channel_noise_reduction(const adc_mux_t channel, const bool enabled)
+{
+    adc_error_t ret = ADC_ERROR_OK;
+    volatile adc_channel_pair_t * pair = NULL;
+    if (ADC_STACK_ERROR_OK != adc_stack_find_channel(&registered_channels, channel, &pair))
+    {
+        ret = ADC_ERROR_CHANNEL_NOT_FOUND;
+    }
+    else
+    {
+        /* Takes effect the next time this channel is selected */
+        pair->noise_reduction = enabled;
+    }
     return ret;
 }
 
+bool adc_noise_reduction_pending(void)
+{
+    return noise_reduction_pending;
+}
+
+adc_error_t adc_optimise_scan_order(void)
+{
+    const bool interrupt_state = interrupt_lock();
+    adc_stack_group_settling_channels(&registered_channels);
+    pipeline_reset();
+    interrupt_unlock(interrupt_state);
+    return ADC_ERROR_OK;
+}
 
+/**
+ * @brief fetches a scan table entry from program memory
+*/
+static inline void read_scan_entry(adc_scan_entry_t * const entry, const adc_scan_entry_t * const src)
+{
 #ifdef UNIT_TESTING
-void adc_isr_handler(void)
+    memcpy(entry, src, sizeof(adc_scan_entry_t));
+#else
+    memcpy_P(entry, src, sizeof(adc_scan_entry_t));
+#endif
+}
+
+/**
+ * @brief resolves the stack reference of a scan table entry (configured reference needs no switching at all)
+*/
+static inline uint8_t scan_entry_reference(const adc_scan_entry_t * const entry)
 {
-    if (internal_configuration.is_initialised)
+    uint8_t reference = ADC_STACK_REFERENCE_DEFAULT;
+    if ((ADC_SCAN_REFERENCE_DEFAULT != entry->reference) && ((uint8_t) internal_configuration.base_config.ref != entry->reference))
     {
-        /* if using interrupt AND interrupt enable bit is ON
-         AND Start Conversion bit is SET
-         AND Interrupt Flag is SET
-         -> read values from ADC registers and store them in local buffer
-         */
-        if((internal_configuration.base_config.using_interrupt == true)
-        && (0 != (*internal_configuration.base_config.handle.adcsra_reg & ADIE_MSK))
-        && (0 == (*internal_configuration.base_config.handle.adcsra_reg & ADSC_MSK))
-        && (0 != (*internal_configuration.base_config.handle.adcsra_reg & ADIF_MSK))
-        )
+        reference = entry->reference;
+    }
+    return reference;
+}
+
+/**
+ * @brief checks a scan table entry against the same rules as per-channel setters. Nothing is written but
+ * listed_channels, so that a rejected table leaves filters of the current scan untouched
+*/
+static adc_error_t check_scan_entry(const adc_scan_entry_t * const entry, uint16_t * const listed_channels)
+{
+    adc_error_t ret = ADC_ERROR_OK;
+    uint32_t scale = 0;
+    const uint8_t reference = scan_entry_reference(entry);
+    const adc_voltage_ref_t actual_reference = (ADC_STACK_REFERENCE_DEFAULT == reference) ? internal_configuration.base_config.ref
+                                                                                          : (adc_voltage_ref_t) reference;
+    const uint16_t channel_bit = (uint16_t)(1U << entry->channel);
+    if ((0 != (*listed_channels & channel_bit))
+    ||  (entry->average_order > ADC_AVERAGE_MAX_ORDER)
+    ||  ((entry->discard + (1U << entry->average_order)) > UINT8_MAX)
+    ||  (ADC_ERROR_OK != compute_millivolt_scale(actual_reference, internal_configuration.base_config.supply_voltage_mv, &scale))
+    ||  ((ADC_MUX_INTERNAL_TEMPERATURE == entry->channel) && (ADC_VOLTAGE_REF_INTERNAL_1V1 != actual_reference))
+    ||  ((ADC_STACK_REFERENCE_DEFAULT != reference) && !reference_settling_fits(registered_channels.reference_settling))
+    ||  (entry->window_armed && (entry->window.low > entry->window.high))
+    ||  ((NULL != entry->filter) && (ADC_FILTER_ERROR_OK != adc_filter_check_config(&entry->filter_config))))
+    {
+        ret = ADC_ERROR_CONFIG;
+    }
+    *listed_channels |= channel_bit;
+    return ret;
+}
+
+adc_error_t adc_load_scan_table(const adc_scan_entry_t * const table, const uint8_t count)
+{
+    adc_error_t ret = ADC_ERROR_OK;
+    adc_scan_entry_t entry;
+    uint16_t listed_channels = 0;
+    if (NULL == table)
+    {
+        ret = ADC_ERROR_NULL_POINTER;
+    }
+    else if (count > ADC_MUX_COUNT)
+    {
+        ret = ADC_ERROR_CONFIG;
+    }
+    else
+    {
+        for (uint8_t i = 0 ; (i < count) && (ADC_ERROR_OK == ret) ; i++)
         {
-            isr_helper_extract_data_from_adc_regs();
+            read_scan_entry(&entry, &table[i]);
+            ret = check_scan_entry(&entry, &listed_channels);
+        }
+    }
 
-            /* Start next conversion */
-            (*internal_configuration.base_config.handle.adcsra_reg) |= 1U << ADSC ;
+    if (ADC_ERROR_OK == ret)
+    {
+        /* Channels are all distinct, so each pair is found right where it was registered */
+        const bool interrupt_state = interrupt_lock();
+        const uint16_t reference_settling = registered_channels.reference_settling;
+        adc_stack_reset(&registered_channels);
+        registered_channels.reference_settling = reference_settling;
+        for (uint8_t i = 0 ; i < count ; i++)
+        {
+            read_scan_entry(&entry, &table[i]);
+            adc_stack_register_channel(&registered_channels, entry.channel);
+            adc_stack_set_divider(&registered_channels, entry.channel, entry.divider);
+            adc_stack_set_settling(&registered_channels, entry.channel, entry.discard, entry.average_order);
+            adc_stack_set_reference(&registered_channels, entry.channel, scan_entry_reference(&entry));
+
+            /* Whole table was checked beforehand, filter initialisation cannot fail anymore */
+            if (NULL != entry.filter)
+            {
+                adc_filter_init(entry.filter, &entry.filter_config);
+            }
+            volatile adc_channel_pair_t * const pair = &registered_channels.channels_pair[i];
+            pair->filter = entry.filter;
+            pair->listener = entry.listener;
+            pair->window.low = entry.window.low;
+            pair->window.high = entry.window.high;
+            pair->window.callback = entry.window.callback;
+            pair->window_armed = entry.window_armed;
+            pair->noise_reduction = entry.noise_reduction;
+        }
+        /* Supply monitoring bandgap goes after table's channels, unless the table already schedules it itself */
+        if (0 == (listed_channels & (uint16_t)(1U << ADC_MUX_1v1_REF)))
+        {
+            register_supply_channel();
         }
+        pipeline_reset();
+        interrupt_unlock(interrupt_state);
     }
+    return ret;
 }
-#else
-void adc_isr_handler(void)
+
+adc_error_t adc_set_channel_window(const adc_mux_t channel, const adc_window_t * const window)
 {
-    isr_helper_extract_data_from_adc_regs();
-    /* Start next conversion */
-    *(internal_configuration.base_config.handle.adcsra_reg) |= (1 << ADSC) ;
+    adc_error_t ret = ADC_ERROR_OK;
+    volatile adc_channel_pair_t * pair = NULL;
+    if (ADC_STACK_ERROR_OK != adc_stack_find_channel(&registered_channels, channel, &pair))
+    {
+        ret = ADC_ERROR_CHANNEL_NOT_FOUND;
+    }
+    else if ((NULL != window) && (window->low > window->high))
+    {
+        ret = ADC_ERROR_CONFIG;
+    }
+    else
+    {
+        /* Thresholds and callback are read by the ISR and cannot be written atomically */
+        const bool interrupt_state = interrupt_lock();
+        if (NULL == window)
+        {
+            pair->window_armed = false;
+        }
+        else
+        {
+            pair->window.low = window->low;
+            pair->window.high = window->high;
+            pair->window.callback = window->callback;
+            pair->window_armed = true;
+        }
+        interrupt_unlock(interrupt_state);
+    }
+    return ret;
+}
+
+adc_error_t adc_get_window_faults(uint16_t * const faults)
+{
+    adc_error_t ret = ADC_ERROR_OK;
+    if (NULL == faults)
+    {
+        ret = ADC_ERROR_NULL_POINTER;
+    }
+    else
+    {
+        const bool interrupt_state = interrupt_lock();
+        *faults = window_faults;
+        interrupt_unlock(interrupt_state);
+    }
+    return ret;
+}
+
+void adc_clear_window_faults(const uint16_t mask)
+{
+    const bool interrupt_state = interrupt_lock();
+    window_faults &= ~mask;
+    interrupt_unlock(interrupt_state);
+}
+
+adc_error_t adc_snapshot(const adc_mux_t * const channels, adc_result_t * const results, const uint8_t count, uint8_t * const cycle_id)
+{
+    adc_error_t ret = ADC_ERROR_OK;
+    if (NULL == channels || NULL == results)
+    {
+        ret = ADC_ERROR_NULL_POINTER;
+    }
+    else
+    {
+        bool consistent = false;
+        for (uint8_t attempt = 0 ; (attempt <= ADC_SNAPSHOT_MAX_RETRIES) && !consistent && (ADC_ERROR_OK == ret) ; attempt++)
+        {
+            /* scan_cycle is 8 bits wide, so it is read atomically */
+            const uint8_t cycle_before = registered_channels.scan_cycle;
+            for (uint8_t i = 0 ; (i < count) && (ADC_ERROR_OK == ret) ; i++)
+            {
+                volatile adc_channel_pair_t * pair = NULL;
+                if (ADC_STACK_ERROR_OK == adc_stack_find_channel(&registered_channels, channels[i], &pair))
+                {
+                    results[i] = pair->published;
+                }
+                else
+                {
+                    ret = ADC_ERROR_CHANNEL_NOT_FOUND;
+                }
+            }
+            consistent = (cycle_before == registered_channels.scan_cycle);
+            if (consistent && (NULL != cycle_id))
+            {
+                *cycle_id = cycle_before;
+            }
+        }
+
+        if ((ADC_ERROR_OK == ret) && !consistent)
+        {
+            ret = ADC_ERROR_BUSY;
+        }
+    }
+    return ret;
+}
+
+adc_error_t adc_set_channel_statistics(const adc_mux_t channel, adc_statistics_t * const statistics, const uint16_t window_length)
+{
+    adc_error_t ret = ADC_ERROR_OK;
+    volatile adc_channel_pair_t * pair = NULL;
+    if (ADC_STACK_ERROR_OK != adc_stack_find_channel(&registered_channels, channel, &pair))
+    {
+        ret = ADC_ERROR_CHANNEL_NOT_FOUND;
+    }
+    else
+    {
+        const bool interrupt_state = interrupt_lock();
+        if ((NULL != statistics) && (ADC_STATISTICS_ERROR_OK != adc_statistics_init(statistics, window_length)))
+        {
+            ret = ADC_ERROR_CONFIG;
+        }
+        else
+        {
+            pair->statistics = statistics;
+        }
+        interrupt_unlock(interrupt_state);
+    }
+    return ret;
+}
+
+adc_error_t adc_set_channel_listener(const adc_mux_t channel, const adc_sample_listener_t listener)
+{
+    adc_error_t ret = ADC_ERROR_OK;
+    volatile adc_channel_pair_t * pair = NULL;
+    if (ADC_STACK_ERROR_OK != adc_stack_find_channel(&registered_channels, channel, &pair))
+    {
+        ret = ADC_ERROR_CHANNEL_NOT_FOUND;
+    }
+    else
+    {
+        /* Function pointer is not written atomically on 8 bits targets */
+        const bool interrupt_state = interrupt_lock();
+        pair->listener = listener;
+        interrupt_unlock(interrupt_state);
+    }
+    return ret;
+}
+
+adc_error_t adc_get_channel_statistics(const adc_mux_t channel, adc_statistics_summary_t * const summary)
+{
+    adc_error_t ret = ADC_ERROR_OK;
+    volatile adc_channel_pair_t * pair = NULL;
+    if (NULL == summary)
+    {
+        ret = ADC_ERROR_NULL_POINTER;
+    }
+    else if (ADC_STACK_ERROR_OK != adc_stack_find_channel(&registered_channels, channel, &pair))
+    {
+        ret = ADC_ERROR_CHANNEL_NOT_FOUND;
+    }
+    else if (NULL == pair->statistics)
+    {
+        ret = ADC_ERROR_CONFIG;
+    }
+    else
+    {
+        /* Latched window is only rewritten by the ISR when window_id changes, same retry policy as snapshots */
+        volatile adc_statistics_t * const statistics = pair->statistics;
+        adc_statistics_window_t window;
+        bool consistent = false;
+        for (uint8_t attempt = 0 ; (attempt <= ADC_SNAPSHOT_MAX_RETRIES) && !consistent ; attempt++)
+        {
+            const uint8_t window_id = statistics->window_id;
+            window.count = statistics->latched.count;
+            window.min = statistics->latched.min;
+            window.max = statistics->latched.max;
+            window.sum = statistics->latched.sum;
+            window.sum_of_squares = statistics->latched.sum_of_squares;
+            consistent = (window_id == statistics->window_id);
+        }
+
+        if (consistent)
+        {
+            adc_statistics_summarize(&window, summary);
+        }
+        else
+        {
+            ret = ADC_ERROR_BUSY;
+        }
+    }
+    return ret;
+}
+
+adc_error_t adc_get_conversion_counters(uint32_t * const total, uint16_t * const overruns)
+{
+    /* 32 bits and 16 bits counters are not read atomically */
+    const bool interrupt_state = interrupt_lock();
+    if (NULL != total)
+    {
+        *total = conversion_counters.total;
+    }
+    if (NULL != overruns)
+    {
+        *overruns = conversion_counters.overruns;
+    }
+    interrupt_unlock(interrupt_state);
+    return ADC_ERROR_OK;
+}
+
+void adc_reset_conversion_counters(void)
+{
+    const bool interrupt_state = interrupt_lock();
+    conversion_counters.total = 0;
+    conversion_counters.overruns = 0;
+    interrupt_unlock(interrupt_state);
+}
+
+uint32_t adc_compute_conversion_rate(const uint32_t previous_total, const uint32_t total, const uint16_t elapsed_ms)
+{
+    uint32_t rate = 0;
+    if (0 != elapsed_ms)
+    {
+        /* Unsigned subtraction handles counter wrap around */
+        rate = (uint32_t)(((uint64_t)(total - previous_total) * 1000U) / elapsed_ms);
+    }
+    return rate;
+}
+
+adc_error_t adc_read_filtered(const adc_mux_t channel, adc_result_t * const result)
+{
+    adc_error_t ret = ADC_ERROR_OK;
+    if (NULL == result)
+    {
+        ret = ADC_ERROR_NULL_POINTER;
+    }
+    else
+    {
+        volatile adc_channel_pair_t * pair = NULL;
+        adc_stack_error_t find_error = adc_stack_find_channel(&registered_channels, channel, &pair);
+        if (ADC_STACK_ERROR_OK == find_error)
+        {
+            *result = pair->filtered;
+        }
+        else
+        {
+            ret = ADC_ERROR_CHANNEL_NOT_FOUND;
+        }
+    }
+    return ret;
+}
+
+static inline bool conversion_is_finished(void)
+{
+    return ((*internal_configuration.base_config.handle.adcsra_reg) & 1 << ADSC) == 0;
+}
+
+static inline void clear_interrupt_flag(void)
+{
+    #ifdef UNIT_TESTING
+        /* Reset interrupt flag manually */
+        *internal_configuration.base_config.handle.adcsra_reg &= ~ADIF_MSK;
+    #else
+        /* Interrupt flag is cleared by hardware when the ISR is executed, but needs to be cleared
+        manually (by writing a logical one to it) when polling the peripheral in auto triggered mode */
+        if (!internal_configuration.base_config.using_interrupt)
+        {
+            *internal_configuration.base_config.handle.adcsra_reg |= ADIF_MSK;
+        }
+    #endif
+}
+
+/**
+ * @brief processes the final (averaged) result of a channel sequence
+*/
+static inline void publish_channel_result(volatile adc_channel_pair_t * const pair, uint16_t result)
+{
+    pair->result = result;
+    check_window(pair, result);
+    if (NULL != pair->statistics)
+    {
+        adc_statistics_push(pair->statistics, result);
+    }
+    if (NULL != pair->listener)
+    {
+        pair->listener(pair->channel, result);
+    }
+    if (NULL != pair->filter)
+    {
+        result = adc_filter_apply(pair->filter, result);
+    }
+    pair->filtered = result;
+    if (ADC_MUX_1v1_REF == pair->channel)
+    {
+        internal_configuration.supply_sample_pending = true;
+    }
+}
+
+static inline void isr_helper_extract_data_from_adc_regs(void)
+{
+    adc_stack_error_t stack_error = ADC_STACK_ERROR_OK;
+    if (NULL == pipeline.converting)
+    {
+        /* Pipeline was reset while converting : this result is taken alone, whatever the settling sequence */
+        stack_error = adc_stack_get_current(&registered_channels, &pipeline.converting);
+        if (ADC_STACK_ERROR_OK == stack_error)
+        {
+            pipeline.converting->repeat = 0;
+            pipeline.converting->accumulator = 0;
+        }
+        pipeline.queued = pipeline.converting;
+        pipeline.converting_role = SAMPLE_ROLE_LAST;
+        pipeline.queued_role = SAMPLE_ROLE_LAST;
+    }
+    if (ADC_STACK_ERROR_OK == stack_error)
+    {
+        volatile adc_channel_pair_t * const stored = pipeline.converting;
+        const sample_role_t stored_role = pipeline.converting_role;
+        const uint16_t raw = retrieve_result_from_registers();
+        clear_interrupt_flag();
+        conversion_counters.total++;
+        if (SAMPLE_ROLE_ACCUMULATE == stored_role)
+        {
+            stored->accumulator += raw;
+        }
+        else if (SAMPLE_ROLE_LAST == stored_role)
+        {
+            const uint16_t result = (uint16_t)(stored->accumulator + raw) >> stored->average_order;
+            stored->accumulator = 0;
+            publish_channel_result(stored, result);
+        }
+
+        if (is_free_running())
+        {
+            /* Next conversion already started with the queued channel : queue the one after it */
+            pipeline.converting = pipeline.queued;
+            pipeline.converting_role = pipeline.queued_role;
+            stack_error = adc_stack_get_next(&registered_channels, &pipeline.queued);
+            if (ADC_STACK_ERROR_OK == stack_error)
+            {
+                set_mux_register(pipeline.queued);
+                pipeline.queued_role = sample_role(pipeline.queued);
+            }
+        }
+        else
+        {
+            stack_error = adc_stack_get_next(&registered_channels, &pipeline.converting);
+            if (ADC_STACK_ERROR_OK == stack_error)
+            {
+                set_mux_register(pipeline.converting);
+                pipeline.converting_role = sample_role(pipeline.converting);
+            }
+            pipeline.queued = pipeline.converting;
+            pipeline.queued_role = pipeline.converting_role;
+        }
+
+        /* Next stored result goes back to the beginning of the scan : this cycle is complete
+        (unless the first channel is converted twice when starting free-running conversions) */
+        if (pipeline.first_channel_duplicated)
+        {
+            pipeline.first_channel_duplicated = false;
+        }
+        else if ((SAMPLE_ROLE_LAST == stored_role) && (ADC_STACK_ERROR_OK == stack_error) && (pipeline.converting <= stored))
+        {
+            adc_stack_publish(&registered_channels);
+        }
+
+        /* In free-running mode, a new result already waiting means we are lagging behind the peripheral : one more
+        late result and the data register gets overwritten */
+        if (is_free_running() && conversion_result_available())
+        {
+            conversion_counters.overruns++;
+        }
+    }
+}
+
+static inline bool conversion_result_available(void)
+{
+    /* ADSC bit stays set when using auto triggered conversions, so interrupt flag is used instead */
+    if (ADC_RUNNING_MODE_AUTOTRIGGERED == internal_configuration.base_config.running_mode)
+    {
+        return ((*internal_configuration.base_config.handle.adcsra_reg) & ADIF_MSK) != 0;
+    }
+    return conversion_is_finished();
+}
+
+static inline void restart_conversion(void)
+{
+    /* Auto triggered conversions are restarted by hardware, no need to loose time here.
+    Noise reduced conversions are started by the main loop, when entering sleep */
+    if (ADC_RUNNING_MODE_SINGLE_SHOT == internal_configuration.base_config.running_mode)
+    {
+        noise_reduction_pending = noise_reduction_enabled(pipeline.converting);
+        if (!noise_reduction_pending)
+        {
+            *internal_configuration.base_config.handle.adcsra_reg |= ADSC_MSK;
+        }
+    }
+}
+
+static inline bool burst_is_running(void)
+{
+    return (ADC_BURST_STATE_ARMED == burst.state) || (ADC_BURST_STATE_TRIGGERED == burst.state);
+}
+
+/**
+ * @brief puts peripheral back in the configuration it had before the capture started
+*/
+static void burst_restore_scan(void)
+{
+    adc_handle_t * handle = &internal_configuration.base_config.handle;
+    const bool was_running = (0 != (burst.saved_registers.adcsra & ADEN_MSK));
+
+    /* Disabling the ADC aborts the ongoing free-running conversion */
+    *handle->adcsra_reg &= ~(ADEN_MSK | ADSC_MSK | ADATE_MSK);
+    *handle->adcsrb_reg = burst.saved_registers.adcsrb;
+    *handle->mux_reg = burst.saved_registers.mux;
+    *handle->adcsra_reg = burst.saved_registers.adcsra & ~(ADEN_MSK | ADSC_MSK | ADIF_MSK);
+    if (was_running)
+    {
+        adc_start();
+    }
+}
+
+static inline bool burst_trigger_event(const uint8_t sample)
+{
+    bool triggered = burst.trigger_requested;
+    switch (burst.config.trigger)
+    {
+        case ADC_BURST_TRIGGER_RISING:
+            triggered |= burst.previous_sample_valid
+                      && (burst.previous_sample < burst.config.trigger_level) && (sample >= burst.config.trigger_level);
+            break;
+        case ADC_BURST_TRIGGER_FALLING:
+            triggered |= burst.previous_sample_valid
+                      && (burst.previous_sample > burst.config.trigger_level) && (sample <= burst.config.trigger_level);
+            break;
+        case ADC_BURST_TRIGGER_SOFTWARE:
+        default:
+            triggered |= (0 == burst.config.pre_trigger);
+            break;
+    }
+    return triggered;
+}
+
+/**
+ * @brief stores one burst sample. Kept as short as possible : only the high byte of the left aligned result is read
+*/
+static void burst_isr_helper(void)
+{
+    const uint8_t sample = *internal_configuration.base_config.handle.readings.adchigh_reg;
+    const uint16_t index = burst.index;
+    clear_interrupt_flag();
+
+    burst.config.buffer[index] = sample;
+    burst.index = (index + 1U == burst.config.length) ? 0U : index + 1U;
+
+    if (ADC_BURST_STATE_ARMED == burst.state)
+    {
+        /* Trigger event is only looked for once pre-trigger samples are all captured */
+        if (burst.captured < burst.config.pre_trigger)
+        {
+            burst.captured++;
+        }
+        else if (burst_trigger_event(sample))
+        {
+            burst.first_index = (index >= burst.config.pre_trigger) ? (index - burst.config.pre_trigger)
+                                                                     : (index + burst.config.length - burst.config.pre_trigger);
+            burst.remaining = burst.config.length - burst.config.pre_trigger - 1U;
+            burst.state = ADC_BURST_STATE_TRIGGERED;
+        }
+        burst.previous_sample = sample;
+        burst.previous_sample_valid = true;
+    }
+    else
+    {
+        burst.remaining--;
+    }
+
+    if ((ADC_BURST_STATE_TRIGGERED == burst.state) && (0 == burst.remaining))
+    {
+        burst.state = ADC_BURST_STATE_DONE;
+        burst_restore_scan();
+    }
+}
+
+adc_error_t adc_burst_start(const adc_burst_config_t * const config)
+{
+    adc_error_t ret = ADC_ERROR_OK;
+    if (NULL == config || NULL == config->buffer)
+    {
+        ret = ADC_ERROR_NULL_POINTER;
+    }
+    else if ((0 == config->length) || (config->pre_trigger >= config->length))
+    {
+        ret = ADC_ERROR_CONFIG;
+    }
+    else if (ADC_STATE_READY != check_initialisation())
+    {
+        ret = ADC_ERROR_NOT_INITIALISED;
+    }
+    else if (burst_is_running())
+    {
+        ret = ADC_ERROR_BUSY;
+    }
+    else
+    {
+        adc_handle_t * handle = &internal_configuration.base_config.handle;
+        burst.saved_registers.mux = *handle->mux_reg;
+        burst.saved_registers.adcsra = *handle->adcsra_reg;
+        burst.saved_registers.adcsrb = *handle->adcsrb_reg;
+
+        /* Stop normal scan first : ISR won't fire until burst is fully configured */
+        *handle->adcsra_reg &= ~(ADEN_MSK | ADSC_MSK | ADATE_MSK);
+        pipeline_reset();
+        noise_reduction_pending = false;
+
+        memcpy(&burst.config, config, sizeof(adc_burst_config_t));
+        burst.index = 0;
+        burst.captured = 0;
+        burst.remaining = 0;
+        burst.first_index = 0;
+        burst.trigger_requested = false;
+        burst.previous_sample = 0;
+        burst.previous_sample_valid = false;
+        burst.state = ADC_BURST_STATE_ARMED;
+
+        *handle->mux_reg = (*handle->mux_reg & ~(MUX_MSK | ADLAR_MSK)) | ADLAR_MSK | config->channel;
+        *handle->adcsrb_reg = (*handle->adcsrb_reg & ~ADTS_MSK) | ADC_TRIGGER_FREE_RUNNING;
+        *handle->adcsra_reg = (*handle->adcsra_reg & ~(ADPS_MSK | ADIF_MSK)) | config->prescaler | ADATE_MSK;
+        *handle->adcsra_reg |= ADEN_MSK | ADSC_MSK;
+    }
+    return ret;
+}
+
+void adc_burst_trigger(void)
+{
+    burst.trigger_requested = true;
+}
+
+void adc_burst_abort(void)
+{
+    if (burst_is_running())
+    {
+        /* Restored registers give the interrupt enable bit back, as it was before the capture */
+        (void) interrupt_lock();
+        burst.state = ADC_BURST_STATE_IDLE;
+        burst_restore_scan();
+    }
+}
+
+adc_burst_state_t adc_burst_get_state(void)
+{
+    return burst.state;
+}
+
+adc_error_t adc_burst_get_trace_start(uint16_t * const first_index)
+{
+    adc_error_t ret = ADC_ERROR_OK;
+    if (NULL == first_index)
+    {
+        ret = ADC_ERROR_NULL_POINTER;
+    }
+    else if (ADC_BURST_STATE_DONE != burst.state)
+    {
+        ret = ADC_ERROR_BUSY;
+    }
+    else
+    {
+        *first_index = burst.first_index;
+    }
+    return ret;
+}
+
+adc_state_t adc_process(void)
+{
+    adc_state_t ret = check_initialisation();
+    if (ADC_STATE_READY == ret)
+    {
+        if (burst_is_running())
+        {
+            /* Burst conversions are always free-running */
+            if (0 != (*internal_configuration.base_config.handle.adcsra_reg & ADIF_MSK))
+            {
+                burst_isr_helper();
+            }
+        }
+        else if (!noise_reduction_pending)
+        {
+            if (conversion_result_available())
+            {
+                isr_helper_extract_data_from_adc_regs();
+            }
+            /* Start next conversion */
+            restart_conversion();
+        }
+    }
+    return ret;
+}
+
+adc_error_t adc_read_millivolt(const adc_mux_t channel, adc_millivolts_t * const reading)
+{
+    adc_error_t ret = ADC_ERROR_OK;
+    if (NULL == reading )
+    {
+        ret = ADC_ERROR_NULL_POINTER;
+    }
+    else
+    {
+        volatile adc_channel_pair_t * pair = NULL;
+        if (ADC_STACK_ERROR_OK == adc_stack_find_channel(&registered_channels, channel, &pair))
+        {
+            refresh_supply_scale();
+            *reading = convert_pair_to_millivolts(pair, pair->result);
+        }
+        else
+        {
+            ret = ADC_ERROR_CHANNEL_NOT_FOUND;
+        }
+    }
+
+    return ret;
+}
+
+adc_error_t adc_get_supply_voltage(adc_millivolts_t * const supply)
+{
+    adc_error_t ret = ADC_ERROR_OK;
+    if (NULL == supply)
+    {
+        ret = ADC_ERROR_NULL_POINTER;
+    }
+    else
+    {
+        refresh_supply_scale();
+        *supply = internal_configuration.base_config.supply_voltage_mv;
+    }
+    return ret;
+}
+
+adc_error_t adc_read_millivolt_all(adc_mux_t * const channels, adc_millivolts_t * const readings, uint8_t * const count)
+{
+    adc_error_t ret = ADC_ERROR_OK;
+    if (NULL == readings || NULL == count)
+    {
+        ret = ADC_ERROR_NULL_POINTER;
+    }
+    else
+    {
+        refresh_supply_scale();
+        uint8_t converted = 0;
+        for (uint8_t i = 0 ; (i < registered_channels.count) && (converted < *count) ; i++)
+        {
+            volatile adc_channel_pair_t * pair = &registered_channels.channels_pair[i];
+            if (NULL != channels)
+            {
+                channels[converted] = pair->channel;
+            }
+            readings[converted] = convert_pair_to_millivolts(pair, pair->result);
+            converted++;
+        }
+        *count = converted;
+    }
+    return ret;
+}
+
+
+#ifdef UNIT_TESTING
+void adc_isr_handler(void)
+{
+    if (internal_configuration.is_initialised)
+    {
+        /* if using interrupt AND interrupt enable bit is ON
+         AND Start Conversion bit is SET (single shot mode only, as it stays set in auto triggered modes)
+         AND Interrupt Flag is SET
+         -> read values from ADC registers and store them in local buffer
+         */
+        const bool conversion_stopped = (ADC_RUNNING_MODE_AUTOTRIGGERED == internal_configuration.base_config.running_mode)
+                                     || burst_is_running()
+                                     || (0 == (*internal_configuration.base_config.handle.adcsra_reg & ADSC_MSK));
+        if((internal_configuration.base_config.using_interrupt == true)
+        && (0 != (*internal_configuration.base_config.handle.adcsra_reg & ADIE_MSK))
+        && conversion_stopped
+        && (0 != (*internal_configuration.base_config.handle.adcsra_reg & ADIF_MSK))
+        )
+        {
+            if (burst_is_running())
+            {
+                burst_isr_helper();
+            }
+            else
+            {
+                isr_helper_extract_data_from_adc_regs();
+
+                /* Start next conversion */
+                restart_conversion();
+            }
+        }
+    }
+}
+#else
+void adc_isr_handler(void)
+{
+    if (burst_is_running())
+    {
+        burst_isr_helper();
+    }
+    else
+    {
+        isr_helper_extract_data_from_adc_regs();
+        /* Start next conversion */
+        restart_conversion();
+    }
 }
 #endif
@@ -0,0 +1,197 @@
+/*
+
+------------------
+@<FreeMyCode>
+FreeMyCode version : 1.0 RC alpha
+    Author : bebenlebricolo
+    License : 
+        name : GPLv3
+        url : https://www.gnu.org/licenses/quick-guide-gplv3.html
+    Date : 12/02/2021
+    Project : LabBenchPowerSupply
+    Description : The Lab Bench Power Supply provides a simple design based around an Arduino Nano board to convert AC main voltage into
+ smaller ones, ranging from 0V to 16V, with voltage and current regulations
+<FreeMyCode>@
+------------------
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+
+#include <stddef.h>
+#include "adc_filter.h"
+
+static inline uint16_t median_of_3(const uint16_t a, const uint16_t b, const uint16_t c)
+{
+    uint16_t ret = b;
+    if (a > b)
+    {
+        if (b < c)
+        {
+            ret = (a < c) ? a : c;
+        }
+    }
+    else
+    {
+        if (b > c)
+        {
+            ret = (a > c) ? a : c;
+        }
+    }
+    return ret;
+}
+
+/**
+ * @brief seeds filter state with the first sample, so that filter output starts at the input value instead
+ * of slowly rising from 0
+*/
+static inline void prime_filter(adc_filter_t * const filter, const uint16_t sample)
+{
+    switch (filter->config.type)
+    {
+        case ADC_FILTER_EMA:
+            filter->state.ema.accumulator = (uint16_t)(sample << filter->config.order);
+            break;
+
+        case ADC_FILTER_BOXCAR:
+            for (uint8_t i = 0 ; i < (1U << filter->config.order) ; i++)
+            {
+                filter->state.boxcar.samples[i] = sample;
+            }
+            filter->state.boxcar.sum = (uint16_t)(sample << filter->config.order);
+            filter->state.boxcar.index = 0;
+            break;
+
+        case ADC_FILTER_MEDIAN_3:
+            filter->state.median.history[0] = sample;
+            filter->state.median.history[1] = sample;
+            break;
+
+        case ADC_FILTER_NONE:
+        default:
+            break;
+    }
+    filter->primed = true;
+}
+
+adc_filter_error_t adc_filter_check_config(const adc_filter_config_t * const config)
+{
+    adc_filter_error_t ret = ADC_FILTER_ERROR_OK;
+    if (NULL == config)
+    {
+        ret = ADC_FILTER_ERROR_NULL_POINTER;
+    }
+    else
+    {
+        switch (config->type)
+        {
+            case ADC_FILTER_EMA:
+                if (config->order > ADC_FILTER_EMA_MAX_ORDER)
+                {
+                    ret = ADC_FILTER_ERROR_CONFIG;
+                }
+                break;
+
+            case ADC_FILTER_BOXCAR:
+                if (config->order > ADC_FILTER_BOXCAR_MAX_ORDER)
+                {
+                    ret = ADC_FILTER_ERROR_CONFIG;
+                }
+                break;
+
+            case ADC_FILTER_NONE:
+            case ADC_FILTER_MEDIAN_3:
+                break;
+
+            default:
+                ret = ADC_FILTER_ERROR_CONFIG;
+                break;
+        }
+    }
+    return ret;
+}
+
+adc_filter_error_t adc_filter_init(adc_filter_t * const filter, const adc_filter_config_t * const config)
+{
+    adc_filter_error_t ret = ADC_FILTER_ERROR_OK;
+    if (NULL == filter)
+    {
+        ret = ADC_FILTER_ERROR_NULL_POINTER;
+    }
+    else
+    {
+        ret = adc_filter_check_config(config);
+    }
+
+    if (ADC_FILTER_ERROR_OK == ret)
+    {
+        filter->config.type = config->type;
+        filter->config.order = config->order;
+        adc_filter_reset(filter);
+    }
+    return ret;
+}
+
+adc_filter_error_t adc_filter_reset(adc_filter_t * const filter)
+{
+    adc_filter_error_t ret = ADC_FILTER_ERROR_OK;
+    if (NULL == filter)
+    {
+        ret = ADC_FILTER_ERROR_NULL_POINTER;
+    }
+    else
+    {
+        filter->primed = false;
+    }
+    return ret;
+}
+
+uint16_t adc_filter_apply(adc_filter_t * const filter, const uint16_t sample)
+{
+    uint16_t ret = sample;
+    if (!filter->primed)
+    {
+        prime_filter(filter, sample);
+    }
+
+    switch (filter->config.type)
+    {
+        case ADC_FILTER_EMA:
+            /* acc = y * 2^order ; acc - y + x cannot overflow as long as 10 bits samples are used with order <= 6 */
+            filter->state.ema.accumulator = (uint16_t)(filter->state.ema.accumulator - (filter->state.ema.accumulator >> filter->config.order) + sample);
+            ret = filter->state.ema.accumulator >> filter->config.order;
+            break;
+
+        case ADC_FILTER_BOXCAR:
+        {
+            const uint8_t index = filter->state.boxcar.index;
+            filter->state.boxcar.sum = (uint16_t)(filter->state.boxcar.sum - filter->state.boxcar.samples[index] + sample);
+            filter->state.boxcar.samples[index] = sample;
+            filter->state.boxcar.index = (uint8_t)((index + 1U) & ((1U << filter->config.order) - 1U));
+            ret = filter->state.boxcar.sum >> filter->config.order;
+            break;
+        }
+
+        case ADC_FILTER_MEDIAN_3:
+            ret = median_of_3(filter->state.median.history[0], filter->state.median.history[1], sample);
+            filter->state.median.history[0] = filter->state.median.history[1];
+            filter->state.median.history[1] = sample;
+            break;
+
+        case ADC_FILTER_NONE:
+        default:
+            break;
+    }
+    return ret;
+}
@@ -43,6 +43,9 @@ adc_stack_error_t adc_stack_reset(volatile adc_stack_t * const stack)
     {
         stack->count = 0;
         stack->index = 0;
+        stack->scan_cycle = 0;
+        stack->reference_settling = 0;
+        stack->active_reference = ADC_STACK_REFERENCE_DEFAULT;
         for (uint8_t i = 0 ; i < ADC_MUX_COUNT ; i++)
         {
             /* resets targeted pair to defaults */
@@ -64,6 +67,24 @@ adc_stack_error_t adc_channel_pair_copy(volatile adc_channel_pair_t * dest, vola
     {
         dest->channel = src->channel;
         dest->result = src->result;
+        dest->published = src->published;
+        dest->filtered = src->filtered;
+        dest->filter = src->filter;
+        dest->statistics = src->statistics;
+        dest->listener = src->listener;
+        dest->window.low = src->window.low;
+        dest->window.high = src->window.high;
+        dest->window.callback = src->window.callback;
+        dest->window_armed = src->window_armed;
+        dest->divider = src->divider;
+        dest->countdown = src->countdown;
+        dest->discard = src->discard;
+        dest->average_order = src->average_order;
+        dest->repeat = src->repeat;
+        dest->accumulator = src->accumulator;
+        dest->reference = src->reference;
+        dest->reference_discard = src->reference_discard;
+        dest->noise_reduction = src->noise_reduction;
     }
     return ret;
 }
@@ -79,6 +100,24 @@ adc_stack_error_t adc_channel_pair_reset(volatile adc_channel_pair_t * const pai
     {
         pair->channel = ADC_MUX_GND;
         pair->result = 0;
+        pair->published = 0;
+        pair->filtered = 0;
+        pair->filter = NULL;
+        pair->statistics = NULL;
+        pair->listener = NULL;
+        pair->window.low = 0;
+        pair->window.high = 0;
+        pair->window.callback = NULL;
+        pair->window_armed = false;
+        pair->divider = 0;
+        pair->countdown = 0;
+        pair->discard = 0;
+        pair->average_order = 0;
+        pair->repeat = 0;
+        pair->accumulator = 0;
+        pair->reference = ADC_STACK_REFERENCE_DEFAULT;
+        pair->reference_discard = 0;
+        pair->noise_reduction = false;
     }
     return ret;
 }
@@ -221,14 +260,167 @@ adc_stack_error_t adc_stack_get_next(volatile adc_stack_t * const stack, volatil
         }
     }
 
-    /* Move to next element and return its address */
-    if (ADC_STACK_ERROR_OK == ret)
+    /* Current element still has conversions to perform in its settling sequence */
+    if ((ADC_STACK_ERROR_OK == ret) && (0 != stack->channels_pair[stack->index].repeat))
     {
-        stack->index++;
-        stack->index %= stack->count;
+        stack->channels_pair[stack->index].repeat--;
         *pair = &(stack->channels_pair[stack->index]);
     }
+    /* Move to next element and return its address. Elements which are not due for this cycle are skipped,
+    at most one full revolution is performed */
+    else if (ADC_STACK_ERROR_OK == ret)
+    {
+        for (uint8_t i = 0 ; i < stack->count ; i++)
+        {
+            stack->index++;
+            stack->index %= stack->count;
+            volatile adc_channel_pair_t * candidate = &(stack->channels_pair[stack->index]);
+            if (0 == candidate->countdown)
+            {
+                candidate->countdown = (candidate->divider > 1U) ? (candidate->divider - 1U) : 0U;
+                break;
+            }
+            candidate->countdown--;
+        }
+        *pair = &(stack->channels_pair[stack->index]);
+
+        /* Reference voltage needs some time to settle after being switched */
+        const uint16_t length = adc_channel_pair_sequence_length(*pair);
+        uint32_t extra = 0;
+        if ((*pair)->reference != stack->active_reference)
+        {
+            extra = stack->reference_settling;
+            if ((length + extra) > (UINT16_MAX + 1UL))
+            {
+                extra = (UINT16_MAX + 1UL) - length;
+            }
+        }
+        stack->active_reference = (*pair)->reference;
+        (*pair)->reference_discard = (uint16_t) extra;
+        (*pair)->repeat = (uint16_t)(length + extra - 1U);
+    }
+
+    return ret;
+}
+
+adc_stack_error_t adc_stack_rewind(volatile adc_stack_t * const stack, volatile adc_channel_pair_t ** pair)
+{
+    adc_stack_error_t ret = ADC_STACK_ERROR_OK;
+    if (NULL == stack)
+    {
+        ret = ADC_STACK_ERROR_NULL_POINTER;
+    }
+    else if (0 == stack->count)
+    {
+        ret = ADC_STACK_ERROR_EMPTY;
+    }
+    else
+    {
+        /* Place index right before the first element so that the regular lookup reloads countdowns */
+        stack->index = stack->count - 1U;
+        stack->channels_pair[stack->index].repeat = 0;
+        ret = adc_stack_get_next(stack, pair);
+    }
+    return ret;
+}
+
+adc_stack_error_t adc_stack_set_divider(volatile adc_stack_t * const stack, volatile const adc_mux_t channel, const uint8_t divider)
+{
+    volatile adc_channel_pair_t * pair = NULL;
+    adc_stack_error_t ret = adc_stack_find_channel(stack, channel, &pair);
+    if (ADC_STACK_ERROR_OK == ret)
+    {
+        pair->divider = divider;
+        pair->countdown = 0;
+        pair->repeat = 0;
+        pair->accumulator = 0;
+    }
+    return ret;
+}
 
+adc_stack_error_t adc_stack_publish(volatile adc_stack_t * const stack)
+{
+    adc_stack_error_t ret = ADC_STACK_ERROR_OK;
+    if (NULL == stack)
+    {
+        ret = ADC_STACK_ERROR_NULL_POINTER;
+    }
+    else
+    {
+        for (uint8_t i = 0 ; i < stack->count ; i++)
+        {
+            stack->channels_pair[i].published = stack->channels_pair[i].result;
+        }
+        stack->scan_cycle++;
+    }
+    return ret;
+}
+
+adc_stack_error_t adc_stack_set_settling(volatile adc_stack_t * const stack, volatile const adc_mux_t channel, const uint8_t discard, const uint8_t average_order)
+{
+    volatile adc_channel_pair_t * pair = NULL;
+    adc_stack_error_t ret = adc_stack_find_channel(stack, channel, &pair);
+    if (ADC_STACK_ERROR_OK == ret)
+    {
+        pair->discard = discard;
+        pair->average_order = average_order;
+        pair->repeat = 0;
+        pair->accumulator = 0;
+    }
+    return ret;
+}
+
+adc_stack_error_t adc_stack_set_reference(volatile adc_stack_t * const stack, volatile const adc_mux_t channel, const uint8_t reference)
+{
+    volatile adc_channel_pair_t * pair = NULL;
+    adc_stack_error_t ret = adc_stack_find_channel(stack, channel, &pair);
+    if (ADC_STACK_ERROR_OK == ret)
+    {
+        pair->reference = reference;
+        pair->repeat = 0;
+        pair->accumulator = 0;
+    }
+    return ret;
+}
+
+uint16_t adc_channel_pair_sequence_length(volatile const adc_channel_pair_t * const pair)
+{
+    return (uint16_t)(pair->discard + (1U << pair->average_order));
+}
+
+adc_stack_error_t adc_stack_group_settling_channels(volatile adc_stack_t * const stack)
+{
+    adc_stack_error_t ret = ADC_STACK_ERROR_OK;
+    if (NULL == stack)
+    {
+        ret = ADC_STACK_ERROR_NULL_POINTER;
+    }
+    else
+    {
+        /* Stable partition : each channel without settling is moved right after the previous one */
+        uint8_t insert = 0;
+        adc_channel_pair_t moved;
+        for (uint8_t i = 0 ; i < stack->count ; i++)
+        {
+            if (0 == stack->channels_pair[i].discard)
+            {
+                adc_channel_pair_copy(&moved, &stack->channels_pair[i]);
+                for (uint8_t j = i ; j > insert ; j--)
+                {
+                    adc_channel_pair_copy(&stack->channels_pair[j], &stack->channels_pair[j - 1U]);
+                }
+                adc_channel_pair_copy(&stack->channels_pair[insert], &moved);
+                insert++;
+            }
+        }
+
+        for (uint8_t i = 0 ; i < stack->count ; i++)
+        {
+            stack->channels_pair[i].repeat = 0;
+            stack->channels_pair[i].accumulator = 0;
+        }
+        stack->index = 0;
+    }
     return ret;
 }
 
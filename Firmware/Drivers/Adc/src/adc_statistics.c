@@ -0,0 +1,118 @@
+/*
+
+------------------
+@<FreeMyCode>
+FreeMyCode version : 1.0 RC alpha
+    Author : bebenlebricolo
+    License : 
+        name : GPLv3
+        url : https://www.gnu.org/licenses/quick-guide-gplv3.html
+    Date : 12/02/2021
+    Project : LabBenchPowerSupply
+    Description : The Lab Bench Power Supply provides a simple design based around an Arduino Nano board to convert AC main voltage into
+ smaller ones, ranging from 0V to 16V, with voltage and current regulations
+<FreeMyCode>@
+------------------
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+
+#include <stddef.h>
+#include "adc_statistics.h"
+
+static inline void window_reset(adc_statistics_window_t * const window)
+{
+    window->count = 0;
+    window->min = UINT16_MAX;
+    window->max = 0;
+    window->sum = 0;
+    window->sum_of_squares = 0;
+}
+
+adc_statistics_error_t adc_statistics_init(adc_statistics_t * const stats, const uint16_t window_length)
+{
+    adc_statistics_error_t ret = ADC_STATISTICS_ERROR_OK;
+    if (NULL == stats)
+    {
+        ret = ADC_STATISTICS_ERROR_NULL_POINTER;
+    }
+    else if ((0 == window_length) || (window_length > ADC_STATISTICS_MAX_WINDOW))
+    {
+        ret = ADC_STATISTICS_ERROR_CONFIG;
+    }
+    else
+    {
+        stats->window_length = window_length;
+        stats->window_id = 0;
+        window_reset(&stats->running);
+        window_reset(&stats->latched);
+        stats->latched.min = 0;
+    }
+    return ret;
+}
+
+void adc_statistics_push(adc_statistics_t * const stats, const uint16_t sample)
+{
+    adc_statistics_window_t * const running = &stats->running;
+    if (sample < running->min)
+    {
+        running->min = sample;
+    }
+    if (sample > running->max)
+    {
+        running->max = sample;
+    }
+    running->sum += sample;
+    running->sum_of_squares += (uint32_t) sample * sample;
+    running->count++;
+
+    if (running->count >= stats->window_length)
+    {
+        stats->latched = *running;
+        stats->window_id++;
+        window_reset(running);
+    }
+}
+
+void adc_statistics_restart(adc_statistics_t * const stats)
+{
+    window_reset(&stats->running);
+}
+
+adc_statistics_error_t adc_statistics_summarize(const adc_statistics_window_t * const window, adc_statistics_summary_t * const summary)
+{
+    adc_statistics_error_t ret = ADC_STATISTICS_ERROR_OK;
+    if (NULL == window || NULL == summary)
+    {
+        ret = ADC_STATISTICS_ERROR_NULL_POINTER;
+    }
+    else
+    {
+        summary->count = window->count;
+        summary->min = window->min;
+        summary->max = window->max;
+        summary->mean_q8 = 0;
+        summary->variance_q8 = 0;
+        if (0 != window->count)
+        {
+            /* var = (n * sum(x^2) - sum(x)^2) / n^2 : exact as long as the division is performed last */
+            const uint64_t count = window->count;
+            const uint64_t spread = (count * window->sum_of_squares) - ((uint64_t) window->sum * window->sum);
+            summary->mean_q8 = (uint32_t)(((uint64_t) window->sum << 8U) / count);
+            summary->variance_q8 = (uint32_t)((spread << 8U) / (count * count));
+        }
+    }
+    return ret;
+}
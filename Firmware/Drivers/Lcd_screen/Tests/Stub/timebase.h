@@ -45,9 +45,9 @@ typedef enum
     TIMEBASE_ERROR_OK
 } timebase_error_t;
 
-timebase_error_t timebase_get_tick(uint8_t id, uint16_t * const tick);
-timebase_error_t timebase_get_duration(uint16_t const * const reference, uint16_t * const new_tick, uint16_t * const duration);
-timebase_error_t timebase_get_duration_now(uint8_t id, uint16_t const * const reference, uint16_t * const duration);
+timebase_error_t timebase_get_tick(uint8_t id, uint32_t * const tick);
+timebase_error_t timebase_get_duration(uint32_t const * const reference, uint32_t const * const new_tick, uint32_t * const duration);
+timebase_error_t timebase_get_duration_now(uint8_t id, uint32_t const * const reference, uint32_t * const duration);
 
 /* Unit testing specificities */
 void timebase_stub_set_times(uint16_t const * const ticks, const uint8_t len);
@@ -54,14 +54,14 @@ static inline uint16_t get_stubbed_value(stubbed_data_fifo_t * const source)
     return returned_value;
 }
 
-timebase_error_t timebase_get_tick(uint8_t id, uint16_t * const tick)
+timebase_error_t timebase_get_tick(uint8_t id, uint32_t * const tick)
 {
     (void) id;
     *tick = get_stubbed_value(&ticks_data);
     return TIMEBASE_ERROR_OK;
 }
 
-timebase_error_t timebase_get_duration(uint16_t const * const reference, uint16_t * const new_tick, uint16_t * const duration)
+timebase_error_t timebase_get_duration(uint32_t const * const reference, uint32_t const * const new_tick, uint32_t * const duration)
 {
     (void) reference;
     (void) new_tick;
@@ -69,7 +69,7 @@ timebase_error_t timebase_get_duration(uint16_t const * const reference, uint16_
     return TIMEBASE_ERROR_OK;
 }
 
-timebase_error_t timebase_get_duration_now(uint8_t id, uint16_t const * const reference, uint16_t * const duration)
+timebase_error_t timebase_get_duration_now(uint8_t id, uint32_t const * const reference, uint32_t * const duration)
 {
     (void) id;
     (void) reference;
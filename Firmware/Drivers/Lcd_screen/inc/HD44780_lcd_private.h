@@ -200,7 +200,7 @@ typedef struct
 {
     process_command_t process_command;          /**< Pointer to the private function to be called                                               */
     process_commands_parameters_t parameters;   /**< Stores all necessary parameters to perform requested commands                              */
-    uint16_t start_time;                        /**< Used to record starting time of a wait operation, for instance                             */
+    uint32_t start_time;                        /**< Used to record starting time of a wait operation, for instance                             */
 
     struct
     {
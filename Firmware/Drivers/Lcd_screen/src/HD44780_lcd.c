@@ -615,7 +615,7 @@ void bootup_sequence_handler(uint8_t time_to_wait, bool end_with_wait)
     // Check if we are waiting waiting for device to bootup ...
     if (true == command_sequencer.sequence.waiting)
     {
-        uint16_t duration = 0;
+        uint32_t duration = 0;
         if (I2C_STATE_READY == i2c_state)
         {
             bool time_has_passed = false;
@@ -693,7 +693,7 @@ void set_backlight_flag_in_i2c_buffer(void)
 bool write_buffer(void)
 {
     bool write_completed = false;
-    uint16_t duration = 0;
+    uint32_t duration = 0;
     i2c_state_t i2c_state = I2C_STATE_NOT_INITIALISED;
     i2c_error_t i2c_err = I2C_ERROR_OK;
     timebase_error_t tim_err = TIMEBASE_ERROR_OK;
@@ -643,7 +643,8 @@ TEST(timer_16_bit_driver_tests, test_parameters_computation_prescaler)
     target_freq = 3'000;
     timer_16_bit_compute_matching_parameters(&cpu_freq, &target_freq, &prescaler, &ocra, &accumulator);
     ASSERT_EQ(prescaler, TIMER16BIT_CLK_PRESCALER_1);
-    ASSERT_EQ(ocra, 2665U);
+    // 2666.67 counts : rounded to the closest value
+    ASSERT_EQ(ocra, 2666U);
     ASSERT_EQ(accumulator, 0U);
 
     cpu_freq = 16'000'000;
@@ -654,6 +655,132 @@ TEST(timer_16_bit_driver_tests, test_parameters_computation_prescaler)
     ASSERT_EQ(accumulator, 0U);
 }
 
+TEST_F(Timer16BitFixture, test_compare_match_a_flag)
+{
+    bool raised = true;
+    ASSERT_EQ(TIMER_ERROR_NULL_POINTER, timer_16_bit_get_compare_match_a_flag(DT_ID, nullptr));
+
+    timer_16_bit_registers_stub.TIFR = OCFB_MSK;
+    ASSERT_EQ(TIMER_ERROR_OK, timer_16_bit_get_compare_match_a_flag(DT_ID, &raised));
+    ASSERT_FALSE(raised);
+
+    timer_16_bit_registers_stub.TIFR |= OCFA_MSK;
+    ASSERT_EQ(TIMER_ERROR_OK, timer_16_bit_get_compare_match_a_flag(DT_ID, &raised));
+    ASSERT_TRUE(raised);
+}
+
+TEST_F(Timer16BitFixture, test_duty_pair_update)
+{
+    uint16_t ocra = 100U;
+    uint16_t ocrb = 900U;
+    uint16_t value = 0U;
+    ASSERT_EQ(TIMER_ERROR_UNKNOWN_TIMER, timer_16_bit_set_duty_pair(TIMER_16_BIT_COUNT, &ocra, &ocrb));
+    ASSERT_EQ(TIMER_ERROR_NULL_POINTER, timer_16_bit_set_duty_pair(DT_ID, nullptr, &ocrb));
+    ASSERT_EQ(TIMER_ERROR_NULL_POINTER, timer_16_bit_set_duty_pair(DT_ID, &ocra, nullptr));
+
+    config.timing_config.waveform_mode = TIMER16BIT_WG_PWM_FAST_10_bit_FULL_RANGE;
+    config.timing_config.ocra_val = 512U;
+    config.timing_config.ocrb_val = 512U;
+    ASSERT_EQ(TIMER_ERROR_OK, timer_16_bit_init(DT_ID, &config));
+
+    // Nothing staged yet
+    timer_16_bit_overflow_isr_handler(DT_ID);
+    ASSERT_EQ(TIMER_ERROR_OK, timer_16_bit_get_ocra_register_value(DT_ID, &value));
+    ASSERT_EQ(512U, value);
+
+    // Registers are left untouched until next overflow, stale overflow flag is cleared by writing a one to it
+    timer_16_bit_registers_stub.TIFR = 0U;
+    ASSERT_EQ(TIMER_ERROR_OK, timer_16_bit_set_duty_pair(DT_ID, &ocra, &ocrb));
+    ASSERT_EQ(TIMER_ERROR_OK, timer_16_bit_get_ocra_register_value(DT_ID, &value));
+    ASSERT_EQ(512U, value);
+    ASSERT_EQ(TIMER_ERROR_OK, timer_16_bit_get_ocrb_register_value(DT_ID, &value));
+    ASSERT_EQ(512U, value);
+    ASSERT_EQ(TOIE_MSK, timer_16_bit_registers_stub.TIMSK & TOIE_MSK);
+    ASSERT_EQ(TOV_MSK, timer_16_bit_registers_stub.TIFR);
+
+    // Last staged pair wins
+    ocra = 300U;
+    ocrb = 700U;
+    ASSERT_EQ(TIMER_ERROR_OK, timer_16_bit_set_duty_pair(DT_ID, &ocra, &ocrb));
+    timer_16_bit_overflow_isr_handler(DT_ID);
+    ASSERT_EQ(TIMER_ERROR_OK, timer_16_bit_get_ocra_register_value(DT_ID, &value));
+    ASSERT_EQ(300U, value);
+    ASSERT_EQ(TIMER_ERROR_OK, timer_16_bit_get_ocrb_register_value(DT_ID, &value));
+    ASSERT_EQ(700U, value);
+    ASSERT_EQ(0U, timer_16_bit_registers_stub.TIMSK & TOIE_MSK);
+
+    // Pair is only written once
+    value = 42U;
+    ASSERT_EQ(TIMER_ERROR_OK, timer_16_bit_set_ocra_register_value(DT_ID, &value));
+    timer_16_bit_overflow_isr_handler(DT_ID);
+    ASSERT_EQ(TIMER_ERROR_OK, timer_16_bit_get_ocra_register_value(DT_ID, &value));
+    ASSERT_EQ(42U, value);
+
+    // Overflow interrupt requested by the application : its flag and mask bit are left alone
+    timer_16_bit_interrupt_config_t it_config;
+    ASSERT_EQ(TIMER_ERROR_OK, timer_16_bit_get_interrupt_config(DT_ID, &it_config));
+    it_config.it_timer_overflow = true;
+    ASSERT_EQ(TIMER_ERROR_OK, timer_16_bit_set_interrupt_config(DT_ID, &it_config));
+    timer_16_bit_registers_stub.TIFR = 0U;
+    ocra = 1023U;
+    ocrb = 0U;
+    ASSERT_EQ(TIMER_ERROR_OK, timer_16_bit_set_duty_pair(DT_ID, &ocra, &ocrb));
+    ASSERT_EQ(0U, timer_16_bit_registers_stub.TIFR);
+    timer_16_bit_overflow_isr_handler(DT_ID);
+    ASSERT_EQ(TIMER_ERROR_OK, timer_16_bit_get_ocra_register_value(DT_ID, &value));
+    ASSERT_EQ(1023U, value);
+    ASSERT_EQ(TIMER_ERROR_OK, timer_16_bit_get_ocrb_register_value(DT_ID, &value));
+    ASSERT_EQ(0U, value);
+    ASSERT_EQ(TOIE_MSK, timer_16_bit_registers_stub.TIMSK & TOIE_MSK);
+
+    ASSERT_EQ(TIMER_ERROR_OK, timer_16_bit_deinit(DT_ID));
+}
+
+TEST_F(Timer16BitFixture, test_direct_writes_survive_overflow_isr)
+{
+    uint16_t ocra = 100U;
+    uint16_t ocrb = 900U;
+    uint16_t value = 0U;
+    config.timing_config.waveform_mode = TIMER16BIT_WG_PWM_FAST_10_bit_FULL_RANGE;
+    config.interrupt_config.it_timer_overflow = true;
+    ASSERT_EQ(TIMER_ERROR_OK, timer_16_bit_init(DT_ID, &config));
+
+    // Application's own overflow interrupts do not replay anything while no pair is pending
+    value = 0x1234U;
+    ASSERT_EQ(TIMER_ERROR_OK, timer_16_bit_set_ocra_register_value(DT_ID, &value));
+    value = 0x0356U;
+    ASSERT_EQ(TIMER_ERROR_OK, timer_16_bit_set_ocrb_register_value(DT_ID, &value));
+    timer_16_bit_overflow_isr_handler(DT_ID);
+    timer_16_bit_overflow_isr_handler(DT_ID);
+    ASSERT_EQ(0x12U, timer_16_bit_registers_stub.OCRA_H);
+    ASSERT_EQ(0x34U, timer_16_bit_registers_stub.OCRA_L);
+    ASSERT_EQ(TIMER_ERROR_OK, timer_16_bit_get_ocrb_register_value(DT_ID, &value));
+    ASSERT_EQ(0x0356U, value);
+
+    // Direct writes made after a committed pair are kept as well
+    ASSERT_EQ(TIMER_ERROR_OK, timer_16_bit_set_duty_pair(DT_ID, &ocra, &ocrb));
+    timer_16_bit_overflow_isr_handler(DT_ID);
+    value = 600U;
+    ASSERT_EQ(TIMER_ERROR_OK, timer_16_bit_set_ocrb_register_value(DT_ID, &value));
+    timer_16_bit_overflow_isr_handler(DT_ID);
+    ASSERT_EQ(TIMER_ERROR_OK, timer_16_bit_get_ocra_register_value(DT_ID, &value));
+    ASSERT_EQ(100U, value);
+    ASSERT_EQ(TIMER_ERROR_OK, timer_16_bit_get_ocrb_register_value(DT_ID, &value));
+    ASSERT_EQ(600U, value);
+
+    // Counter and input capture registers are split the same way
+    value = 0xABCDU;
+    ASSERT_EQ(TIMER_ERROR_OK, timer_16_bit_set_counter_value(DT_ID, &value));
+    ASSERT_EQ(0xABU, timer_16_bit_registers_stub.TCNT_H);
+    ASSERT_EQ(0xCDU, timer_16_bit_registers_stub.TCNT_L);
+    timer_16_bit_registers_stub.ICR_H = 0x42U;
+    timer_16_bit_registers_stub.ICR_L = 0x24U;
+    ASSERT_EQ(TIMER_ERROR_OK, timer_16_bit_get_input_capture_value(DT_ID, &value));
+    ASSERT_EQ(0x4224U, value);
+
+    ASSERT_EQ(TIMER_ERROR_OK, timer_16_bit_deinit(DT_ID));
+}
+
 int main(int argc, char **argv)
 {
     ::testing::InitGoogleTest(&argc, argv);
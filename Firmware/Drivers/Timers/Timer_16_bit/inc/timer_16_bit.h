@@ -365,6 +365,29 @@ timer_error_t timer_16_bit_set_ocrb_register_value(uint8_t id, const uint16_t *
 */
 timer_error_t timer_16_bit_get_ocrb_register_value(uint8_t id, uint16_t * const ocrb);
 
+/**
+ * @brief stages a new pair of Output Compare A and B values, written together by the next overflow interrupt
+ * (@see timer_16_bit_overflow_isr_handler()). Both PWM outputs switch to their new duty cycle on the same period, which
+ * two consecutive timer_16_bit_set_ocrx_register_value() calls do not guarantee. Overflow interrupt is enabled until
+ * the pair is written ; a pair staged meanwhile replaces the previous one.
+ * @param[in]   id    : targeted timer id (used to fetch internal configuration based on ids)
+ * @param[in]   ocra  : OCRA value to be written on next overflow
+ * @param[in]   ocrb  : OCRB value to be written on next overflow
+ * @return
+ *      TIMER_ERROR_OK             :   operation succeeded
+ *      TIMER_ERROR_UNKNOWN_TIMER  :   given id is out of range
+ *      TIMER_ERROR_NULL_POINTER   :   given pointer points to null
+ *      TIMER_ERROR_NULL_HANDLE    :   targeted timer's handle is still NULL (unitialised). Operation failed
+*/
+timer_error_t timer_16_bit_set_duty_pair(uint8_t id, const uint16_t * const ocra, const uint16_t * const ocrb);
+
+/**
+ * @brief writes the staged Output Compare pair, if any. To be called from the timer overflow ISR (TIMERn_OVF_vect).
+ * Overflow interrupt is masked again afterwards, unless timer configuration enabled it.
+ * @param[in]   id    : targeted timer id (used to fetch internal configuration based on ids)
+*/
+void timer_16_bit_overflow_isr_handler(uint8_t id);
+
 
 
 
@@ -392,6 +415,18 @@ timer_error_t timer_16_bit_set_counter_value(uint8_t id, const uint16_t * const
 */
 timer_error_t timer_16_bit_get_counter_value(uint8_t id, uint16_t * const ticks);
 
+/**
+ * @brief reads the compare match A interrupt flag. Flag stays raised until the interrupt is serviced : this tells
+ * whether the counter already wrapped around (CTC mode) and the matching interrupt is still pending
+ * @param[in]   id     : targeted timer id (used to fetch internal configuration based on ids)
+ * @param[out]  raised : compare match A interrupt flag state
+ * @return
+ *      TIMER_ERROR_OK             :   operation succeeded
+ *      TIMER_ERROR_UNKNOWN_TIMER  :   given id is out of range
+ *      TIMER_ERROR_NULL_POINTER   :   given pointer points to null
+*/
+timer_error_t timer_16_bit_get_compare_match_a_flag(uint8_t id, bool * const raised);
+
 /**
  * @brief gets the targeted timer internal input capture register value
  * @param[in]   id    : targeted timer id (used to fetch internal configuration based on ids)
@@ -476,6 +511,25 @@ timer_error_t timer_16_bit_stop(uint8_t id);
 #define TIMER_16_BIT_MAX_PRESCALER_COUNT (5U)
 
 
+/**
+ * @brief Compile-time counterparts of timer_16_bit_compute_matching_parameters() (@see TIMER_GENERIC_STATIC_COUNTS()).
+ * Smallest prescaler which fits a whole target period in 65536 counts, or the biggest one (then used with an accumulator).
+*/
+#define TIMER_16_BIT_STATIC_PRESCALER(cpu_freq, target_freq)                                                           \
+    (                                                                                                                  \
+     TIMER_GENERIC_STATIC_FITS(cpu_freq, target_freq, 1U, TIMER_GENERIC_16_BIT_LIMIT_VALUE) ? 1U :                     \
+     TIMER_GENERIC_STATIC_FITS(cpu_freq, target_freq, 8U, TIMER_GENERIC_16_BIT_LIMIT_VALUE) ? 8U :                     \
+     TIMER_GENERIC_STATIC_FITS(cpu_freq, target_freq, 64U, TIMER_GENERIC_16_BIT_LIMIT_VALUE) ? 64U :                   \
+     TIMER_GENERIC_STATIC_FITS(cpu_freq, target_freq, 256U, TIMER_GENERIC_16_BIT_LIMIT_VALUE) ? 256U :                 \
+     1024U)
+#define TIMER_16_BIT_STATIC_ACCUMULATOR(cpu_freq, target_freq)                                                         \
+    TIMER_GENERIC_STATIC_ACCUMULATOR(cpu_freq, target_freq, TIMER_16_BIT_STATIC_PRESCALER(cpu_freq, target_freq), TIMER_GENERIC_16_BIT_LIMIT_VALUE)
+#define TIMER_16_BIT_STATIC_OCR(cpu_freq, target_freq)                                                                 \
+    TIMER_GENERIC_STATIC_OCR(cpu_freq, target_freq, TIMER_16_BIT_STATIC_PRESCALER(cpu_freq, target_freq), TIMER_GENERIC_16_BIT_LIMIT_VALUE)
+#define TIMER_16_BIT_STATIC_ERROR_PPM(cpu_freq, target_freq)                                                           \
+    TIMER_GENERIC_STATIC_ERROR_PPM(cpu_freq, target_freq, TIMER_16_BIT_STATIC_PRESCALER(cpu_freq, target_freq),        \
+                                   TIMER_16_BIT_STATIC_OCR(cpu_freq, target_freq), TIMER_16_BIT_STATIC_ACCUMULATOR(cpu_freq, target_freq))
+
 void timer_16_bit_compute_matching_parameters(const uint32_t * const cpu_freq,
                                               const uint32_t * const target_freq,
                                               timer_16_bit_prescaler_selection_t * const prescaler,
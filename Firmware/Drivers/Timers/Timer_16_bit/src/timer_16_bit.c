@@ -31,6 +31,13 @@ along with this program.  If not, see <https://www.gnu.org/licenses/>.
 #include "config.h"
 #include "timer_16_bit.h"
 
+#ifdef UNIT_TESTING
+    /* No interrupts to mask on host : the block runs once, as is */
+    #define ATOMIC_BLOCK(type) for (uint8_t atomic_once = 1U ; 0U != atomic_once ; atomic_once = 0U)
+#else
+    #include <util/atomic.h>
+#endif
+
 #include <stddef.h>
 #include <string.h>
 
@@ -44,9 +51,45 @@ static struct
 {
     timer_16_bit_handle_t handle;
     timer_16_bit_prescaler_selection_t prescaler;
+    bool overflow_interrupt;        /**< Overflow interrupt is requested by the timer configuration itself  */
+    struct
+    {
+        volatile uint16_t ocra;     /**< Staged OCRA value, written by next overflow interrupt              */
+        volatile uint16_t ocrb;     /**< Staged OCRB value, written by next overflow interrupt              */
+        volatile bool pending;      /**< A duty pair is waiting for next overflow interrupt                 */
+    } duty;
     bool is_initialised;
 } internal_config[TIMER_16_BIT_COUNT] = {0};
 
+/**
+ * @brief writes a 16 bit register through the TEMP register shared by all 16 bit registers of the timer : high byte
+ * is buffered first, and writing the low byte commits both. An interrupt doing its own 16 bit access in between
+ * would overwrite TEMP, so both writes happen with interrupts disabled
+*/
+static inline void write_16_bit_register(volatile uint8_t * const high, volatile uint8_t * const low, const uint16_t value)
+{
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+    {
+        *high = (value & 0xFF00) >> 8U;
+        *low = (value & 0xFF);
+    }
+}
+
+/**
+ * @brief reads a 16 bit register : reading the low byte latches the high one into TEMP, so both reads happen with
+ * interrupts disabled as well
+*/
+static inline uint16_t read_16_bit_register(volatile uint8_t * const high, volatile uint8_t * const low)
+{
+    uint16_t value = 0U;
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+    {
+        value = *low;
+        value |= (uint16_t)(*high) << 8U;
+    }
+    return value;
+}
+
 const timer_generic_prescaler_pair_t timer_16_bit_prescaler_table[TIMER_16_BIT_MAX_PRESCALER_COUNT] =
 {
     {.value = 1,        .type = (uint8_t) TIMER16BIT_CLK_PRESCALER_1    },
@@ -362,6 +405,7 @@ timer_error_t timer_16_bit_set_interrupt_config(uint8_t id, timer_16_bit_interru
     }
 
     /* TOIE interrupt flag is the first bit, no need to bitshift it */
+    internal_config[id].overflow_interrupt = it_config->it_timer_overflow;
     if (true == it_config->it_timer_overflow)
     {
         *(internal_config[id].handle.TIMSK) |= TOIE_MSK;
@@ -763,8 +807,7 @@ timer_error_t timer_16_bit_get_input_capture_value(uint8_t id, uint16_t * ticks)
         return ret;
     }
 
-    *ticks  = *(internal_config[id].handle.TCNT_L);
-    *ticks |= *(internal_config[id].handle.TCNT_H) << 8U;
+    *ticks = read_16_bit_register(internal_config[id].handle.ICR_H, internal_config[id].handle.ICR_L);
     return ret;
 }
 
@@ -809,8 +852,7 @@ timer_error_t timer_16_bit_set_counter_value(uint8_t id, const uint16_t * const
     }
 
     /* Write new value to internal timer/counter register */
-    *(internal_config[id].handle.TCNT_L) = *ticks & 0xFF;
-    *(internal_config[id].handle.TCNT_H) = (*ticks & 0xFF00) >> 8U;
+    write_16_bit_register(internal_config[id].handle.TCNT_H, internal_config[id].handle.TCNT_L, *ticks);
 
     return ret;
 }
@@ -835,8 +877,30 @@ timer_error_t timer_16_bit_get_counter_value(uint8_t id, uint16_t * const ticks)
     }
 
     /* Transfer data from internal device's timer/count main register */
-    *ticks  = (*internal_config[id].handle.TCNT_L);
-    *ticks |= (*internal_config[id].handle.TCNT_H) << 8U;
+    *ticks = read_16_bit_register(internal_config[id].handle.TCNT_H, internal_config[id].handle.TCNT_L);
+    return ret;
+}
+
+timer_error_t timer_16_bit_get_compare_match_a_flag(uint8_t id, bool * const raised)
+{
+    timer_error_t ret = check_id(id);
+    if (TIMER_ERROR_OK != ret)
+    {
+        return ret;
+    }
+
+    if (NULL == raised)
+    {
+        return TIMER_ERROR_NULL_POINTER;
+    }
+
+    ret = check_handle(&internal_config[id].handle);
+    if (TIMER_ERROR_OK != ret)
+    {
+        return ret;
+    }
+
+    *raised = (0U != (*(internal_config[id].handle.TIFR) & OCFA_MSK));
     return ret;
 }
 
@@ -854,8 +918,7 @@ timer_error_t timer_16_bit_set_ocra_register_value(uint8_t id, const uint16_t *
         return ret;
     }
 
-    *(internal_config[id].handle.OCRA_H) = (*ocra & 0xFF00) >> 8U;
-    *(internal_config[id].handle.OCRA_L) = (*ocra & 0xFF);
+    write_16_bit_register(internal_config[id].handle.OCRA_H, internal_config[id].handle.OCRA_L, *ocra);
     return ret;
 }
 
@@ -878,8 +941,7 @@ timer_error_t timer_16_bit_get_ocra_register_value(uint8_t id, uint16_t * const
         return ret;
     }
 
-    *ocra  = (*internal_config[id].handle.OCRA_L);
-    *ocra |= (*internal_config[id].handle.OCRA_H << 8U);
+    *ocra = read_16_bit_register(internal_config[id].handle.OCRA_H, internal_config[id].handle.OCRA_L);
     return ret;
 }
 
@@ -897,8 +959,7 @@ timer_error_t timer_16_bit_set_ocrb_register_value(uint8_t id, const uint16_t *
         return ret;
     }
 
-    *internal_config[id].handle.OCRB_H = (*ocrb & 0xFF00) >> 8U;
-    *internal_config[id].handle.OCRB_L = (*ocrb & 0xFF);;
+    write_16_bit_register(internal_config[id].handle.OCRB_H, internal_config[id].handle.OCRB_L, *ocrb);
     return ret;
 }
 
@@ -921,11 +982,70 @@ timer_error_t timer_16_bit_get_ocrb_register_value(uint8_t id, uint16_t * const
         return ret;
     }
 
-    *ocrb =  (*internal_config[id].handle.OCRB_L);
-    *ocrb |= (*internal_config[id].handle.OCRB_H << 8U);
+    *ocrb = read_16_bit_register(internal_config[id].handle.OCRB_H, internal_config[id].handle.OCRB_L);
+    return ret;
+}
+
+timer_error_t timer_16_bit_set_duty_pair(uint8_t id, const uint16_t * const ocra, const uint16_t * const ocrb)
+{
+    timer_error_t ret = check_id(id);
+    if (TIMER_ERROR_OK != ret)
+    {
+        return ret;
+    }
+
+    if (NULL == ocra || NULL == ocrb)
+    {
+        return TIMER_ERROR_NULL_POINTER;
+    }
+
+    ret = check_handle(&internal_config[id].handle);
+    if (TIMER_ERROR_OK != ret)
+    {
+        return ret;
+    }
+
+    /* Overflow ISR is the only other user of the staged pair : masking it is enough to update both values at once */
+    *(internal_config[id].handle.TIMSK) &= ~TOIE_MSK;
+    internal_config[id].duty.ocra = *ocra;
+    internal_config[id].duty.ocrb = *ocrb;
+    internal_config[id].duty.pending = true;
+
+    /* A stale overflow flag would commit the pair right away, anywhere within the current period. Flag is cleared by
+    writing a logical one to it, unless the application uses overflow interrupts itself (flag is then its own) */
+    if (false == internal_config[id].overflow_interrupt)
+    {
+        *(internal_config[id].handle.TIFR) = TOV_MSK;
+    }
+    *(internal_config[id].handle.TIMSK) |= TOIE_MSK;
     return ret;
 }
 
+void timer_16_bit_overflow_isr_handler(uint8_t id)
+{
+    /* Handle was checked when the pair was staged */
+    if ((TIMER_ERROR_OK != check_id(id)) || (false == internal_config[id].duty.pending))
+    {
+        return;
+    }
+
+    /* Both registers are written right after the counter wrapped around : PWM modes latch them together on next
+    update (TOP or BOTTOM). 16 bit registers share a TEMP register, high byte first : interrupts are disabled within
+    the ISR, and main context accesses are atomic (@see write_16_bit_register()), so no other access gets in between */
+    const uint16_t ocra = internal_config[id].duty.ocra;
+    const uint16_t ocrb = internal_config[id].duty.ocrb;
+    *(internal_config[id].handle.OCRA_H) = (ocra & 0xFF00) >> 8U;
+    *(internal_config[id].handle.OCRA_L) = (ocra & 0xFF);
+    *(internal_config[id].handle.OCRB_H) = (ocrb & 0xFF00) >> 8U;
+    *(internal_config[id].handle.OCRB_L) = (ocrb & 0xFF);
+    internal_config[id].duty.pending = false;
+
+    if (false == internal_config[id].overflow_interrupt)
+    {
+        *(internal_config[id].handle.TIMSK) &= ~TOIE_MSK;
+    }
+}
+
 static timer_error_t timer_16_bit_write_config(uint8_t id, timer_16_bit_config_t * const config)
 {
     timer_error_t ret = TIMER_ERROR_OK;
@@ -1008,6 +1128,8 @@ static timer_error_t timer_16_bit_write_config(uint8_t id, timer_16_bit_config_t
     }
 
     /* TOIE interrupt flag is the first bit, no need to bitshift it */
+    internal_config[id].overflow_interrupt = config->interrupt_config.it_timer_overflow;
+    internal_config[id].duty.pending = false;
     if (true == config->interrupt_config.it_timer_overflow)
     {
         *(handle->TIMSK) |= TOV_MSK;
@@ -518,11 +518,12 @@ TEST(timer_8_bit_driver_tests, test_parameters_computation_prescaler)
     ASSERT_EQ(ocra, 249U);
     ASSERT_EQ(accumulator, 0U);
 
+    // 3003 Hz out of 3 compare periods is closer than 3012 Hz out of a single one
     target_freq = 3'000;
     timer_8_bit_compute_matching_parameters(&cpu_freq, &target_freq, &prescaler, &ocra, &accumulator);
-    ASSERT_EQ(prescaler, TIMER8BIT_CLK_PRESCALER_64);
-    ASSERT_EQ(ocra, 82U);
-    ASSERT_EQ(accumulator, 0U);
+    ASSERT_EQ(prescaler, TIMER8BIT_CLK_PRESCALER_8);
+    ASSERT_EQ(ocra, 221U);
+    ASSERT_EQ(accumulator, 2U);
 
     target_freq = 5'000;
     timer_8_bit_compute_matching_parameters(&cpu_freq, &target_freq, &prescaler, &ocra, &accumulator);
@@ -552,6 +553,20 @@ TEST(timer_8_bit_driver_tests, test_parameters_computation_prescaler)
 }
 
 
+TEST_F(Timer8BitFixture, test_compare_match_a_flag)
+{
+    bool raised = true;
+    ASSERT_EQ(TIMER_ERROR_NULL_POINTER, timer_8_bit_get_compare_match_a_flag(DT_ID, nullptr));
+
+    timer_8_bit_registers_stub.TIFR = OCFB_MSK;
+    ASSERT_EQ(TIMER_ERROR_OK, timer_8_bit_get_compare_match_a_flag(DT_ID, &raised));
+    ASSERT_FALSE(raised);
+
+    timer_8_bit_registers_stub.TIFR |= OCFA_MSK;
+    ASSERT_EQ(TIMER_ERROR_OK, timer_8_bit_get_compare_match_a_flag(DT_ID, &raised));
+    ASSERT_TRUE(raised);
+}
+
 int main(int argc, char **argv)
 {
     ::testing::InitGoogleTest(&argc, argv);
@@ -601,9 +601,10 @@ TEST(timer_8_bit_async_driver_tests, test_parameters_computation_prescaler)
 
     target_freq = 3'000;
     timer_8_bit_async_compute_matching_parameters(&cpu_freq, &target_freq, &prescaler, &ocra, &accumulator);
-    ASSERT_EQ(prescaler, TIMER8BIT_ASYNC_CLK_PRESCALER_32);
-    ASSERT_EQ(ocra, 165U);
-    ASSERT_EQ(accumulator, 0U);
+    // 3003 Hz out of 3 compare periods is closer than 3012 Hz out of a single one
+    ASSERT_EQ(prescaler, TIMER8BIT_ASYNC_CLK_PRESCALER_8);
+    ASSERT_EQ(ocra, 221U);
+    ASSERT_EQ(accumulator, 2U);
 
     target_freq = 5'000;
     timer_8_bit_async_compute_matching_parameters(&cpu_freq, &target_freq, &prescaler, &ocra, &accumulator);
@@ -632,6 +633,20 @@ TEST(timer_8_bit_async_driver_tests, test_parameters_computation_prescaler)
     ASSERT_EQ(accumulator, 124U);
 }
 
+TEST_F(Timer8BitAsyncFixture, test_compare_match_a_flag)
+{
+    bool raised = true;
+    ASSERT_EQ(TIMER_ERROR_NULL_POINTER, timer_8_bit_async_get_compare_match_a_flag(DT_ID, nullptr));
+
+    timer_8_bit_async_registers_stub.TIFR = OCFB_MSK;
+    ASSERT_EQ(TIMER_ERROR_OK, timer_8_bit_async_get_compare_match_a_flag(DT_ID, &raised));
+    ASSERT_FALSE(raised);
+
+    timer_8_bit_async_registers_stub.TIFR |= OCFA_MSK;
+    ASSERT_EQ(TIMER_ERROR_OK, timer_8_bit_async_get_compare_match_a_flag(DT_ID, &raised));
+    ASSERT_TRUE(raised);
+}
+
 int main(int argc, char **argv)
 {
     ::testing::InitGoogleTest(&argc, argv);
@@ -356,6 +356,18 @@ timer_error_t timer_8_bit_async_set_counter_value(uint8_t id, const uint8_t tick
 */
 timer_error_t timer_8_bit_async_get_counter_value(uint8_t id, uint8_t * ticks);
 
+/**
+ * @brief reads the compare match A interrupt flag. Flag stays raised until the interrupt is serviced : this tells
+ * whether the counter already wrapped around (CTC mode) and the matching interrupt is still pending
+ * @param[in]   id     : targeted timer id (used to fetch internal configuration based on ids)
+ * @param[out]  raised : compare match A interrupt flag state
+ * @return
+ *      TIMER_ERROR_OK             :   operation succeeded
+ *      TIMER_ERROR_UNKNOWN_TIMER  :   given id is out of range
+ *      TIMER_ERROR_NULL_POINTER   :   given pointer points to null
+*/
+timer_error_t timer_8_bit_async_get_compare_match_a_flag(uint8_t id, bool * const raised);
+
 
 
 
@@ -436,6 +448,27 @@ timer_error_t timer_8_bit_async_stop(uint8_t id);
 */
 extern const timer_generic_prescaler_pair_t timer_8_bit_async_prescaler_table[TIMER_8_BIT_ASYNC_MAX_PRESCALER_COUNT];
 
+/**
+ * @brief Compile-time counterparts of timer_8_bit_async_compute_matching_parameters() (@see TIMER_GENERIC_STATIC_COUNTS()).
+ * Smallest prescaler which fits a whole target period in 256 counts, or the biggest one (then used with an accumulator).
+*/
+#define TIMER_8_BIT_ASYNC_STATIC_PRESCALER(cpu_freq, target_freq)                                                      \
+    (                                                                                                                  \
+     TIMER_GENERIC_STATIC_FITS(cpu_freq, target_freq, 1U, TIMER_GENERIC_8_BIT_LIMIT_VALUE) ? 1U :                      \
+     TIMER_GENERIC_STATIC_FITS(cpu_freq, target_freq, 8U, TIMER_GENERIC_8_BIT_LIMIT_VALUE) ? 8U :                      \
+     TIMER_GENERIC_STATIC_FITS(cpu_freq, target_freq, 32U, TIMER_GENERIC_8_BIT_LIMIT_VALUE) ? 32U :                    \
+     TIMER_GENERIC_STATIC_FITS(cpu_freq, target_freq, 64U, TIMER_GENERIC_8_BIT_LIMIT_VALUE) ? 64U :                    \
+     TIMER_GENERIC_STATIC_FITS(cpu_freq, target_freq, 128U, TIMER_GENERIC_8_BIT_LIMIT_VALUE) ? 128U :                  \
+     TIMER_GENERIC_STATIC_FITS(cpu_freq, target_freq, 256U, TIMER_GENERIC_8_BIT_LIMIT_VALUE) ? 256U :                  \
+     1024U)
+#define TIMER_8_BIT_ASYNC_STATIC_ACCUMULATOR(cpu_freq, target_freq)                                                    \
+    TIMER_GENERIC_STATIC_ACCUMULATOR(cpu_freq, target_freq, TIMER_8_BIT_ASYNC_STATIC_PRESCALER(cpu_freq, target_freq), TIMER_GENERIC_8_BIT_LIMIT_VALUE)
+#define TIMER_8_BIT_ASYNC_STATIC_OCR(cpu_freq, target_freq)                                                            \
+    TIMER_GENERIC_STATIC_OCR(cpu_freq, target_freq, TIMER_8_BIT_ASYNC_STATIC_PRESCALER(cpu_freq, target_freq), TIMER_GENERIC_8_BIT_LIMIT_VALUE)
+#define TIMER_8_BIT_ASYNC_STATIC_ERROR_PPM(cpu_freq, target_freq)                                                      \
+    TIMER_GENERIC_STATIC_ERROR_PPM(cpu_freq, target_freq, TIMER_8_BIT_ASYNC_STATIC_PRESCALER(cpu_freq, target_freq),   \
+                                   TIMER_8_BIT_ASYNC_STATIC_OCR(cpu_freq, target_freq), TIMER_8_BIT_ASYNC_STATIC_ACCUMULATOR(cpu_freq, target_freq))
+
 void timer_8_bit_async_compute_matching_parameters(const uint32_t * const cpu_freq,
                                                    const uint32_t * const target_freq,
                                                    timer_8_bit_async_prescaler_selection_t * const prescaler,
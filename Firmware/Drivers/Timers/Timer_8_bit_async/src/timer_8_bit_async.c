@@ -768,6 +768,29 @@ timer_error_t timer_8_bit_async_get_counter_value(uint8_t id, uint8_t * ticks)
     return ret;
 }
 
+timer_error_t timer_8_bit_async_get_compare_match_a_flag(uint8_t id, bool * const raised)
+{
+    timer_error_t ret = check_id(id);
+    if (TIMER_ERROR_OK != ret)
+    {
+        return ret;
+    }
+
+    if (NULL == raised)
+    {
+        return TIMER_ERROR_NULL_POINTER;
+    }
+
+    ret = check_handle(&internal_config[id].handle);
+    if (TIMER_ERROR_OK != ret)
+    {
+        return ret;
+    }
+
+    *raised = (0U != (*(internal_config[id].handle.TIFR) & OCFA_MSK));
+    return ret;
+}
+
 timer_error_t timer_8_bit_async_set_ocra_register_value(uint8_t id, uint8_t ocra)
 {
     timer_error_t ret = check_id(id);
@@ -30,6 +30,12 @@ along with this program.  If not, see <https://www.gnu.org/licenses/>.
 
 #include "gtest/gtest.h"
 
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+
 #include "timer_8_bit.h"
 #include "timer_16_bit.h"
 #include "timer_8_bit_async.h"
@@ -77,10 +83,254 @@ TEST(timer_generic_driver_tests, test_compute_parameters)
     parameters.input.cpu_frequency = 24'000'000U;
     parameters.input.target_frequency = 1U;
     timer_generic_compute_parameters(&parameters);
-    ASSERT_EQ(parameters.output.prescaler, 1024U);
-    ASSERT_EQ(parameters.output.ocra, 22U);
-    ASSERT_EQ(parameters.output.accumulator, 1018U);
+    ASSERT_EQ(parameters.output.prescaler, 256U);
+    ASSERT_EQ(parameters.output.ocra, 249U);
+    ASSERT_EQ(parameters.output.accumulator, 374U);
+    ASSERT_EQ(parameters.output.achieved_frequency, 1U);
+    ASSERT_EQ(parameters.output.error_ppm, 0U);
+
+    // No exact combination : closest frequency wins, 16 MHz / (8 * 222 * 3) = 3003 Hz is closer than 16 MHz / (64 * 83)
+    parameters.input.cpu_frequency = 16'000'000U;
+    parameters.input.target_frequency = 3'000U;
+    timer_generic_compute_parameters(&parameters);
+    ASSERT_EQ(parameters.output.prescaler, 8U);
+    ASSERT_EQ(parameters.output.ocra, 221U);
+    ASSERT_EQ(parameters.output.accumulator, 2U);
+    ASSERT_EQ(parameters.output.achieved_frequency, 3003U);
+    ASSERT_EQ(parameters.output.error_ppm, 1001U);
+
+    parameters.input.target_frequency = 0U;
+    timer_generic_compute_parameters(&parameters);
+    ASSERT_EQ(parameters.output.prescaler, 0U);
+}
+
+TEST(timer_generic_driver_tests, test_static_parameters)
+{
+    // Solved by the compiler : usable in constant expressions
+    static_assert(TIMER_8_BIT_STATIC_OCR(16'000'000ULL, 1'000ULL) == 249U, "Compile-time solver shall yield constant expressions");
+
+    ASSERT_EQ(1U, TIMER_8_BIT_STATIC_PRESCALER(16'000'000UL, 1'000'000UL));
+    ASSERT_EQ(15U, TIMER_8_BIT_STATIC_OCR(16'000'000UL, 1'000'000UL));
+    ASSERT_EQ(0U, TIMER_8_BIT_STATIC_ACCUMULATOR(16'000'000UL, 1'000'000UL));
+    ASSERT_EQ(0U, TIMER_8_BIT_STATIC_ERROR_PPM(16'000'000UL, 1'000'000UL));
+
+    ASSERT_EQ(64U, TIMER_8_BIT_STATIC_PRESCALER(16'000'000UL, 1'000UL));
+    ASSERT_EQ(249U, TIMER_8_BIT_STATIC_OCR(16'000'000UL, 1'000UL));
+    ASSERT_EQ(0U, TIMER_8_BIT_STATIC_ACCUMULATOR(16'000'000UL, 1'000UL));
+    ASSERT_EQ(0U, TIMER_8_BIT_STATIC_ERROR_PPM(16'000'000UL, 1'000UL));
+
+    // Accumulator is not searched for an exact divisor : error bound tells whether the outcome is acceptable
+    ASSERT_EQ(1024U, TIMER_8_BIT_STATIC_PRESCALER(16'000'000UL, 1UL));
+    ASSERT_EQ(251U, TIMER_8_BIT_STATIC_OCR(16'000'000UL, 1UL));
+    ASSERT_EQ(61U, TIMER_8_BIT_STATIC_ACCUMULATOR(16'000'000UL, 1UL));
+    ASSERT_EQ(64U, TIMER_8_BIT_STATIC_ERROR_PPM(16'000'000UL, 1UL));
+
+    // Async timer has more prescalers, counts are rounded to the closest value
+    ASSERT_EQ(64U, TIMER_8_BIT_ASYNC_STATIC_PRESCALER(16'000'000UL, 1'000UL));
+    ASSERT_EQ(249U, TIMER_8_BIT_ASYNC_STATIC_OCR(16'000'000UL, 1'000UL));
+    ASSERT_EQ(0U, TIMER_8_BIT_ASYNC_STATIC_ACCUMULATOR(16'000'000UL, 1'000UL));
+    ASSERT_EQ(32U, TIMER_8_BIT_ASYNC_STATIC_PRESCALER(16'000'000UL, 3'000UL));
+    ASSERT_EQ(166U, TIMER_8_BIT_ASYNC_STATIC_OCR(16'000'000UL, 3'000UL));
+    ASSERT_EQ(2000U, TIMER_8_BIT_ASYNC_STATIC_ERROR_PPM(16'000'000UL, 3'000UL));
+
+    // Static path is first fit, not minimum error : runtime solver finds a closer accumulated split
+    const timer_generic_prescaler_pair_t async_prescalers[7U] = {{1U, 1U}, {8U, 2U}, {32U, 3U}, {64U, 4U}, {128U, 5U}, {256U, 6U}, {1024U, 7U}};
+    timer_generic_parameters_t parameters = {};
+    parameters.input.cpu_frequency = 16'000'000U;
+    parameters.input.target_frequency = 3'000U;
+    parameters.input.resolution = TIMER_GENERIC_RESOLUTION_8_BIT;
+    parameters.input.prescaler_lookup_array.array = async_prescalers;
+    parameters.input.prescaler_lookup_array.size = 7U;
+    timer_generic_compute_parameters(&parameters);
+    ASSERT_EQ(8U, parameters.output.prescaler);
+    ASSERT_EQ(221U, parameters.output.ocra);
+    ASSERT_EQ(2U, parameters.output.accumulator);
+    ASSERT_EQ(1001U, parameters.output.error_ppm);
+    ASSERT_EQ(0U, TIMER_8_BIT_ASYNC_STATIC_ACCUMULATOR(16'000'000UL, 3'000UL));
+
+    ASSERT_EQ(1U, TIMER_16_BIT_STATIC_PRESCALER(16'000'000UL, 1'000UL));
+    ASSERT_EQ(15999U, TIMER_16_BIT_STATIC_OCR(16'000'000UL, 1'000UL));
+    ASSERT_EQ(256U, TIMER_16_BIT_STATIC_PRESCALER(16'000'000UL, 1UL));
+    ASSERT_EQ(62499U, TIMER_16_BIT_STATIC_OCR(16'000'000UL, 1UL));
+    ASSERT_EQ(0U, TIMER_16_BIT_STATIC_ACCUMULATOR(16'000'000UL, 1UL));
+    ASSERT_EQ(0U, TIMER_16_BIT_STATIC_ERROR_PPM(16'000'000UL, 1UL));
+}
+
+TEST(timer_generic_driver_tests, test_static_parameters_against_runtime_solver)
+{
+    const timer_generic_prescaler_pair_t async_prescalers[7U] = {{1U, 1U}, {8U, 2U}, {32U, 3U}, {64U, 4U}, {128U, 5U}, {256U, 6U}, {1024U, 7U}};
+    timer_generic_parameters_t parameters = {};
+    parameters.input.cpu_frequency = 16'000'000U;
+    parameters.input.resolution = TIMER_GENERIC_RESOLUTION_8_BIT;
+    parameters.input.prescaler_lookup_array.array = async_prescalers;
+    parameters.input.prescaler_lookup_array.size = 7U;
+
+    // Macros are plain arithmetic : they can be evaluated on runtime values too
+    for (unsigned long target = 62UL ; target <= 1'000'000UL ; target = (target * 9UL / 8UL) + 1UL)
+    {
+        parameters.input.target_frequency = target;
+        timer_generic_compute_parameters(&parameters);
+
+        // Static parameters are never closer than runtime ones, and whole periods fit in a single compare period
+        // from 62 Hz on : rounding error stays below half a count
+        const unsigned long long counts = TIMER_8_BIT_ASYNC_STATIC_OCR(16'000'000UL, target) + 1ULL;
+        ASSERT_EQ(0U, TIMER_8_BIT_ASYNC_STATIC_ACCUMULATOR(16'000'000UL, target)) << "target frequency : " << target;
+        ASSERT_LE(TIMER_8_BIT_ASYNC_STATIC_ERROR_PPM(16'000'000UL, target), (500'000ULL / counts) + 1ULL) << "target frequency : " << target;
+
+        // Frequency errors compared as error / cycles fractions, ppm values do not share the same reference
+        const uint64_t static_cycles = TIMER_8_BIT_ASYNC_STATIC_PRESCALER(16'000'000UL, target) * counts;
+        const uint64_t runtime_cycles = (uint64_t) parameters.output.prescaler * (parameters.output.ocra + 1U) * (parameters.output.accumulator + 1U);
+        const int64_t static_error = (int64_t) (static_cycles * target) - 16'000'000;
+        const int64_t runtime_error = (int64_t) (runtime_cycles * target) - 16'000'000;
+        ASSERT_LE((unsigned __int128) std::llabs(runtime_error) * static_cycles, (unsigned __int128) std::llabs(static_error) * runtime_cycles)
+            << "target frequency : " << target;
+    }
+}
+
+/* Reference solver : every prescaler and every compare value, with the best accumulator values for it */
+static void brute_force_parameters(timer_generic_parameters_t const * const parameters, uint64_t * const error, uint64_t * const cycles, uint32_t * const interrupts)
+{
+    const uint64_t limit_value = (TIMER_GENERIC_RESOLUTION_8_BIT == parameters->input.resolution) ? TIMER_GENERIC_8_BIT_LIMIT_VALUE : TIMER_GENERIC_16_BIT_LIMIT_VALUE;
+    const uint64_t cpu_frequency = parameters->input.cpu_frequency;
+    const uint64_t target_frequency = parameters->input.target_frequency;
+    bool found = false;
+
+    for (uint8_t i = 0 ; i < parameters->input.prescaler_lookup_array.size ; i++)
+    {
+        const uint64_t prescaler = parameters->input.prescaler_lookup_array.array[i].value;
+        for (uint64_t counts = 1 ; counts <= limit_value ; counts++)
+        {
+            const uint64_t ideal = cpu_frequency / (prescaler * counts * target_frequency);
+            for (uint64_t candidate = (ideal > 1U ? ideal - 1U : 1U) ; candidate <= ideal + 1U ; candidate++)
+            {
+                if ((candidate > TIMER_GENERIC_ACCUMULATOR_LIMIT_VALUE)
+                ||  ((candidate > 1U) && ((prescaler * counts) < TIMER_GENERIC_MIN_ACCUMULATED_PERIOD_CYCLES)))
+                {
+                    continue;
+                }
+
+                const uint64_t candidate_cycles = prescaler * counts * candidate;
+                const uint64_t produced = candidate_cycles * target_frequency;
+                const uint64_t candidate_error = (produced > cpu_frequency) ? (produced - cpu_frequency) : (cpu_frequency - produced);
+
+                // Frequency errors compared as error / cycles fractions
+                const unsigned __int128 lhs = (unsigned __int128) candidate_error * (*cycles);
+                const unsigned __int128 rhs = (unsigned __int128) (*error) * candidate_cycles;
+                if (!found || (lhs < rhs) || ((lhs == rhs) && (candidate < *interrupts)))
+                {
+                    *error = candidate_error;
+                    *cycles = candidate_cycles;
+                    *interrupts = (uint32_t) candidate;
+                    found = true;
+                }
+            }
+        }
+    }
+}
+
+static void check_against_brute_force(timer_generic_parameters_t * const parameters)
+{
+    timer_generic_compute_parameters(parameters);
+
+    uint64_t error = 0;
+    uint64_t cycles = 0;
+    uint32_t interrupts = 0;
+    brute_force_parameters(parameters, &error, &cycles, &interrupts);
+
+    const uint64_t solver_cycles = (uint64_t) parameters->output.prescaler * (parameters->output.ocra + 1U) * (parameters->output.accumulator + 1U);
+    const uint64_t produced = solver_cycles * parameters->input.target_frequency;
+    const uint64_t solver_error = (produced > parameters->input.cpu_frequency) ? (produced - parameters->input.cpu_frequency) : (parameters->input.cpu_frequency - produced);
+
+    ASSERT_EQ((unsigned __int128) solver_error * cycles, (unsigned __int128) error * solver_cycles)
+        << "target frequency : " << parameters->input.target_frequency;
+    ASSERT_EQ(interrupts, parameters->output.accumulator + 1U) << "target frequency : " << parameters->input.target_frequency;
+}
+
+TEST(timer_generic_driver_tests, test_compute_parameters_sweep)
+{
+    const timer_generic_prescaler_pair_t prescalers[5U] = {{1U, 1U}, {8U, 2U}, {64U, 3U}, {256U, 4U}, {1024U, 5U}};
+    const timer_generic_prescaler_pair_t async_prescalers[7U] = {{1U, 1U}, {8U, 2U}, {32U, 3U}, {64U, 4U}, {128U, 5U}, {256U, 6U}, {1024U, 7U}};
+    timer_generic_parameters_t parameters = {};
+
+    parameters.input.cpu_frequency = 16'000'000U;
+    parameters.input.resolution = TIMER_GENERIC_RESOLUTION_8_BIT;
+    parameters.input.prescaler_lookup_array.array = prescalers;
+    parameters.input.prescaler_lookup_array.size = 5U;
+    for (uint32_t target = 1U ; target <= 3000U ; target++)
+    {
+        parameters.input.target_frequency = target;
+        check_against_brute_force(&parameters);
+    }
+
+    parameters.input.cpu_frequency = 20'000'000U;
+    parameters.input.prescaler_lookup_array.array = async_prescalers;
+    parameters.input.prescaler_lookup_array.size = 7U;
+    for (uint32_t target = 1U ; target <= 1'000'000U ; target = (target * 9U / 8U) + 1U)
+    {
+        parameters.input.target_frequency = target;
+        check_against_brute_force(&parameters);
+    }
+
+    // 16 bit reference is 256 times slower : fewer targets
+    parameters.input.cpu_frequency = 16'000'000U;
+    parameters.input.resolution = TIMER_GENERIC_RESOLUTION_16_BIT;
+    parameters.input.prescaler_lookup_array.array = prescalers;
+    parameters.input.prescaler_lookup_array.size = 5U;
+    for (uint32_t target = 1U ; target <= 1'000'000U ; target = (target * 3U / 2U) + 7U)
+    {
+        parameters.input.target_frequency = target;
+        check_against_brute_force(&parameters);
+    }
+}
+
+TEST(timer_generic_driver_tests, test_compute_parameters_worst_case_cost)
+{
+    const timer_generic_prescaler_pair_t prescalers[5U] = {{1U, 1U}, {8U, 2U}, {64U, 3U}, {256U, 4U}, {1024U, 5U}};
+    const timer_generic_prescaler_pair_t async_prescalers[7U] = {{1U, 1U}, {8U, 2U}, {32U, 3U}, {64U, 4U}, {128U, 5U}, {256U, 6U}, {1024U, 7U}};
+
+    // Slowest inputs : ideal counts far above the timer limit, with no close divisor pair
+    const struct
+    {
+        uint32_t cpu_frequency;
+        uint32_t target_frequency;
+        timer_generic_resolution_t resolution;
+        bool async;
+    } inputs[] =
+    {
+        {16'000'000U, 13U, TIMER_GENERIC_RESOLUTION_16_BIT, false},
+        {16'000'000U, 38U, TIMER_GENERIC_RESOLUTION_16_BIT, false},
+        {20'000'000U, 19U, TIMER_GENERIC_RESOLUTION_16_BIT, false},
+        {16'000'000U, 35U, TIMER_GENERIC_RESOLUTION_8_BIT, false},
+        {20'000'000U, 116U, TIMER_GENERIC_RESOLUTION_8_BIT, true},
+    };
+
+    for (const auto& input : inputs)
+    {
+        timer_generic_parameters_t parameters = {};
+        parameters.input.cpu_frequency = input.cpu_frequency;
+        parameters.input.target_frequency = input.target_frequency;
+        parameters.input.resolution = input.resolution;
+        parameters.input.prescaler_lookup_array.array = input.async ? async_prescalers : prescalers;
+        parameters.input.prescaler_lookup_array.size = input.async ? 7U : 5U;
+
+        const auto start = std::chrono::steady_clock::now();
+        timer_generic_compute_parameters(&parameters);
+        const auto elapsed = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start);
+        ASSERT_NE(0U, parameters.output.prescaler);
 
+        // Bounded by construction : each search step splits at most cpu / target + TIMER_GENERIC_MAX_SEARCH_STEPS counts,
+        // trying up to 2 * sqrt() divisor pairs
+        uint32_t search_steps = 0;
+        uint32_t divisions = 0;
+        timer_generic_get_search_cost(&search_steps, &divisions);
+        const uint32_t max_steps = parameters.input.prescaler_lookup_array.size * 2U * TIMER_GENERIC_MAX_SEARCH_STEPS;
+        const uint32_t max_total_counts = (input.cpu_frequency / input.target_frequency) + TIMER_GENERIC_MAX_SEARCH_STEPS;
+        const uint32_t max_divisions_per_step = 2U * (static_cast<uint32_t>(std::sqrt(static_cast<double>(max_total_counts))) + 1U);
+        std::cout << input.cpu_frequency << " Hz / " << input.target_frequency << " Hz : " << search_steps << " steps, "
+                  << divisions << " divisions, " << elapsed.count() << " us" << std::endl;
+        ASSERT_LE(search_steps, max_steps);
+        ASSERT_LE(divisions, search_steps * max_divisions_per_step);
+    }
 }
 
 int main(int argc, char **argv)
@@ -61,6 +61,20 @@ typedef enum
 
 #define TIMER_GENERIC_8_BIT_LIMIT_VALUE (256U)
 #define TIMER_GENERIC_16_BIT_LIMIT_VALUE (65536U)
+/* Accumulators are 16 bits wide in timer drivers APIs */
+#define TIMER_GENERIC_ACCUMULATOR_LIMIT_VALUE (65536UL)
+
+/* When several compare periods make a target period (accumulator), each of them lasts at least this many CPU cycles :
+interrupts would otherwise eat most of the CPU time up */
+#ifndef TIMER_GENERIC_MIN_ACCUMULATED_PERIOD_CYCLES
+    #define TIMER_GENERIC_MIN_ACCUMULATED_PERIOD_CYCLES (512UL)
+#endif
+
+/* Total counts tried by the solver on each side of the ideal one, for each prescaler. Each try costs up to
+2 * sqrt(total counts) divisions (@see timer_generic_compute_parameters()) */
+#ifndef TIMER_GENERIC_MAX_SEARCH_STEPS
+    #define TIMER_GENERIC_MAX_SEARCH_STEPS (64U)
+#endif
 
 typedef enum
 {
@@ -93,11 +107,74 @@ typedef struct
         uint16_t prescaler;
         uint16_t ocra;
         uint32_t accumulator;
+        uint32_t achieved_frequency;    /**< Produced frequency, rounded to the closest Hz                      */
+        uint32_t error_ppm;             /**< Absolute error of the produced frequency, in parts per million     */
     } output;
 } timer_generic_parameters_t;
 
+/**
+ * @brief Selects the prescaler, output compare value and accumulator which produce the closest frequency to the target
+ * one. Every prescaler of the lookup array is evaluated : the combination which minimises the absolute frequency error
+ * wins, then the one with the lowest interrupt rate (fewest compare periods per target period). Accumulated compare
+ * periods shorter than TIMER_GENERIC_MIN_ACCUMULATED_PERIOD_CYCLES are not considered.
+ * Search is bounded : at most 2 * TIMER_GENERIC_MAX_SEARCH_STEPS tries per prescaler, each of them costing up to
+ * 2 * sqrt(cpu_frequency / (prescaler * target_frequency)) divisions.
+ * Outputs are left to 0 when no combination can be produced (e.g. null target frequency).
+ * @param[in,out] parameters : solver inputs and outputs
+*/
 void timer_generic_compute_parameters(timer_generic_parameters_t * const parameters);
 
+#ifdef UNIT_TESTING
+/**
+ * @brief cost of the last timer_generic_compute_parameters() call, so that tests bound it without timing the host
+ * @param[out] search_steps : total counts tried, all prescalers and directions included
+ * @param[out] divisions    : divisor pairs tried while splitting total counts
+*/
+void timer_generic_get_search_cost(uint32_t * const search_steps, uint32_t * const divisions);
+#endif
+
+/* #########################################################################################
+   ########################## Compile-time parameters computation ##########################
+   ######################################################################################### */
+
+/* Constant expressions counterpart of timer_generic_compute_parameters(), for timers whose frequency is known at build
+time (e.g. from F_CPU) : no search loop runs at boot. Timer counts per interrupt are rounded to the closest value, and
+an accumulator is used when they exceed the timer limit (limit_value, @see TIMER_GENERIC_8_BIT_LIMIT_VALUE).
+Each timer driver selects its prescaler with these (@see TIMER_8_BIT_STATIC_PRESCALER()) : the smallest one which fits
+a whole period in a single compare period. This keeps the most counts per period, so that the error stays below
+0.5 / counts, but it is NOT the minimum error rule of the runtime solver, which cannot be expressed as a constant
+expression (it searches exact OCR * accumulator splits over every prescaler). Both may disagree : 16 MHz / 3 kHz on the
+asynchronous timer yields prescaler 32, OCR 166 (2000 ppm) here, and prescaler 8, OCR 221, accumulator 2 (1001 ppm)
+at runtime. Static parameters are never better than runtime ones : check their outcome with
+TIMER_GENERIC_STATIC_ERROR_PPM() in a _Static_assert, and use the runtime solver when it does not meet the need. */
+
+/** @brief Timer counts per target period with given prescaler, rounded to the closest integer */
+#define TIMER_GENERIC_STATIC_COUNTS(cpu_freq, target_freq, prescaler)                                                     \
+    ((((unsigned long long) (cpu_freq)) + (((unsigned long long) (prescaler) * (target_freq)) / 2ULL))                    \
+     / ((unsigned long long) (prescaler) * (target_freq)))
+
+/** @brief Whether a whole target period fits in one timer compare period, with given prescaler */
+#define TIMER_GENERIC_STATIC_FITS(cpu_freq, target_freq, prescaler, limit_value)                                          \
+    (TIMER_GENERIC_STATIC_COUNTS(cpu_freq, target_freq, prescaler) <= (unsigned long long) (limit_value))
+
+/** @brief Compare match interrupts per target period, minus one */
+#define TIMER_GENERIC_STATIC_ACCUMULATOR(cpu_freq, target_freq, prescaler, limit_value)                                   \
+    (TIMER_GENERIC_STATIC_FITS(cpu_freq, target_freq, prescaler, limit_value) ? 0ULL :                                    \
+     (((TIMER_GENERIC_STATIC_COUNTS(cpu_freq, target_freq, prescaler) + (limit_value) - 1ULL) / (limit_value)) - 1ULL))
+
+/** @brief Output compare value, timer counts per compare period minus one */
+#define TIMER_GENERIC_STATIC_OCR(cpu_freq, target_freq, prescaler, limit_value)                                           \
+    (TIMER_GENERIC_STATIC_COUNTS(cpu_freq, (unsigned long long) (target_freq)                                             \
+                                 * (TIMER_GENERIC_STATIC_ACCUMULATOR(cpu_freq, target_freq, prescaler, limit_value) + 1ULL), \
+                                 prescaler) - 1ULL)
+
+/** @brief Absolute error of the period produced by given parameters against the target one, in parts per million */
+#define TIMER_GENERIC_STATIC_ERROR_PPM(cpu_freq, target_freq, prescaler, ocr, accumulator)                                \
+    (((((unsigned long long) (target_freq) * (prescaler) * ((ocr) + 1ULL) * ((accumulator) + 1ULL)) > (cpu_freq))         \
+      ? (((unsigned long long) (target_freq) * (prescaler) * ((ocr) + 1ULL) * ((accumulator) + 1ULL)) - (cpu_freq))      \
+      : ((cpu_freq) - ((unsigned long long) (target_freq) * (prescaler) * ((ocr) + 1ULL) * ((accumulator) + 1ULL))))      \
+     * 1000000ULL / (cpu_freq))
+
 #ifdef __cplusplus
 }
 #endif
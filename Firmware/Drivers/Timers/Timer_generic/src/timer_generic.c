@@ -30,81 +30,269 @@ along with this program.  If not, see <https://www.gnu.org/licenses/>.
 
 #include "timer_generic.h"
 
-void timer_generic_compute_parameters(timer_generic_parameters_t * const parameters)
+#ifdef UNIT_TESTING
+static struct
+{
+    uint32_t search_steps;
+    uint32_t divisions;
+} search_cost = {0};
+    #define COUNT_SEARCH_STEP() (search_cost.search_steps++)
+    #define COUNT_DIVISION() (search_cost.divisions++)
+#else
+    #define COUNT_SEARCH_STEP()
+    #define COUNT_DIVISION()
+#endif
+
+/* Candidate (prescaler, ocra, accumulator) set : frequency error is error / cycles, where cycles is the amount of CPU
+cycles per produced period */
+typedef struct
 {
-    const uint32_t freq_ratio = parameters->input.cpu_frequency / parameters->input.target_frequency;
-    const uint16_t limit_value = (parameters->input.resolution == TIMER_GENERIC_RESOLUTION_8_BIT) ? (TIMER_GENERIC_8_BIT_LIMIT_VALUE - 1) : (TIMER_GENERIC_16_BIT_LIMIT_VALUE - 1);
+    uint64_t error;         /**< |cpu_frequency - target_frequency * cycles|                            */
+    uint64_t cycles;        /**< prescaler * counts per compare period * compare periods per period     */
+    uint16_t prescaler;
+    uint32_t counts;        /**< Counts per compare period (OCRA + 1)                                   */
+    uint32_t interrupts;    /**< Compare periods per produced period (accumulator + 1)                  */
+    bool valid;
+} candidate_t;
 
-    // It is possible that this operation produces aliasing because we do not check if
-    // the remainder of this division is exactly 0 (no remainder, clean euclidean division)
-    const uint32_t min_prescaler = freq_ratio / (uint32_t) limit_value;
+/* Exactly compares a/b against c/d (b and d not null) by comparing their continued fraction expansions : no product is
+involved, so that nothing overflows */
+static bool fraction_is_lower(uint64_t a, uint64_t b, uint64_t c, uint64_t d)
+{
+    while (true)
+    {
+        const uint64_t integer_a = a / b;
+        const uint64_t integer_c = c / d;
+        if (integer_a != integer_c)
+        {
+            return integer_a < integer_c;
+        }
 
-    parameters->output.prescaler = 1U;
-    uint16_t target_prescaler = 1U;
+        a %= b;
+        c %= d;
+        if ((0U == a) || (0U == c))
+        {
+            return (0U == a) && (0U != c);
+        }
 
-    for (uint8_t i = 0 ; i < parameters->input.prescaler_lookup_array.size ; i++)
+        // a/b < c/d  <=>  d/c < b/a
+        const uint64_t old_a = a;
+        const uint64_t old_b = b;
+        a = d;
+        b = c;
+        c = old_b;
+        d = old_a;
+    }
+}
+
+static inline bool candidate_is_better(candidate_t const * const candidate, candidate_t const * const best)
+{
+    if (false == best->valid)
+    {
+        return true;
+    }
+
+    if (fraction_is_lower(candidate->error, candidate->cycles, best->error, best->cycles))
+    {
+        return true;
+    }
+
+    // Same frequency error : the lowest interrupt rate wins
+    return (false == fraction_is_lower(best->error, best->cycles, candidate->error, candidate->cycles))
+        && (candidate->interrupts < best->interrupts);
+}
+
+static inline void compute_error(uint32_t const cpu_frequency, uint32_t const target_frequency, candidate_t * const candidate)
+{
+    const uint64_t produced = candidate->cycles * target_frequency;
+    candidate->error = (produced > cpu_frequency) ? (produced - cpu_frequency) : (cpu_frequency - produced);
+}
+
+/* Integer square root (floor), bit by bit : no floating point nor division involved */
+static uint32_t square_root(uint32_t value)
+{
+    uint32_t root = 0U;
+    uint32_t bit = 1UL << 30U;
+    while (bit > value)
     {
-        parameters->output.prescaler = parameters->input.prescaler_lookup_array.array[i].value;
-        target_prescaler = parameters->input.prescaler_lookup_array.array[i].value;
-        if (parameters->input.prescaler_lookup_array.array[i].value >= min_prescaler)
+        bit >>= 2U;
+    }
+
+    while (0U != bit)
+    {
+        if (value >= (root + bit))
         {
-            break;
+            value -= root + bit;
+            root = (root >> 1U) + bit;
         }
+        else
+        {
+            root >>= 1U;
+        }
+        bit >>= 2U;
     }
+    return root;
+}
 
-    uint32_t computed_ocra = 0;
-    parameters->output.accumulator = 0;
-    if (0 != target_prescaler)
+/* Splits total counts into counts per compare period (as many as possible, so that interrupts are as rare as possible)
+times compare periods. Every divisor pair has one of its members below the square root of total counts : interrupts
+are walked upwards up to it, then counts downwards from it, so that no more than 2 * sqrt(total_counts) candidates
+are tried (about 9000 at 20 MHz, prescaler 1 and 1 Hz) */
+static bool split_counts(const uint32_t total_counts, const uint32_t limit_value, uint32_t * const counts, uint32_t * const interrupts)
+{
+    const uint32_t max_counts = (total_counts < limit_value) ? total_counts : limit_value;
+    const uint32_t min_counts = (uint32_t) ((total_counts + (TIMER_GENERIC_ACCUMULATOR_LIMIT_VALUE - 1U)) / TIMER_GENERIC_ACCUMULATOR_LIMIT_VALUE);
+    if (min_counts > max_counts)
     {
-        // It is possible that this operation produces aliasing because we do not check if
-        // the remainder of this division is exactly 0 (no remainder, clean euclidean division)
-        computed_ocra = freq_ratio / (uint32_t) target_prescaler;
+        return false;
     }
 
-    // Happens when timescale is really large compared to CPU frequency
-    // We have to create an accumulator which will act as a second-stage prescaler
-    if (computed_ocra >= limit_value)
+    const uint32_t root = square_root(total_counts);
+    const uint32_t min_interrupts = (total_counts + max_counts - 1U) / max_counts;
+    const uint32_t max_interrupts = total_counts / min_counts;
+    const uint32_t last_interrupts = (max_interrupts < root) ? max_interrupts : root;
+    for (uint32_t i = min_interrupts ; i <= last_interrupts ; i++)
     {
-        // Select a remainder arbitrarily high to start the algorithm
-        uint16_t min_remainder = 50U;
-        parameters->output.prescaler = target_prescaler;
-
-        // linear search, starting from the end of the resolution range
-        // This will select the greatest value of OCRA while trying to minize the remainder.
-        // Note that 1 is the only candidate for which the remainder will always be 0.
-        // If this takes too long / too much computing power, fallback using 1 and use the accumulator value to
-        // account for the remaining values.
-        for (uint16_t i = limit_value ; i >= 1 ; i--)
+        COUNT_DIVISION();
+        if (0U == (total_counts % i))
         {
-            uint16_t remainder = (computed_ocra % i);
-            if ((0 != remainder) && (remainder < min_remainder))
-            {
-                min_remainder = remainder;
-            }
+            *counts = total_counts / i;
+            *interrupts = i;
+            return true;
+        }
+    }
+
+    // Remaining divisor pairs have less counts than the square root
+    const uint32_t first_counts = (max_counts < root) ? max_counts : root;
+    for (uint32_t i = first_counts ; i >= min_counts ; i--)
+    {
+        COUNT_DIVISION();
+        if (0U == (total_counts % i))
+        {
+            *counts = i;
+            *interrupts = total_counts / i;
+            return true;
+        }
+    }
+    return false;
+}
 
-            if (0 == remainder)
+/* Error only grows when moving away from the ideal amount of counts : walks from it in given direction, and stops on
+the first total counts which can be produced by the timer, or as soon as the error cannot beat the best one anymore.
+Producible totals are dense (less than 30 steps with AVR prescalers and clocks) : TIMER_GENERIC_MAX_SEARCH_STEPS only bounds
+pathological inputs */
+static void search_direction(timer_generic_parameters_t const * const parameters, const uint16_t prescaler, const uint32_t limit_value,
+                             uint64_t total_counts, const bool upwards, candidate_t * const best)
+{
+    const uint64_t max_total_counts = (uint64_t) limit_value * TIMER_GENERIC_ACCUMULATOR_LIMIT_VALUE;
+    const bool can_accumulate = (((uint64_t) limit_value * prescaler) >= TIMER_GENERIC_MIN_ACCUMULATED_PERIOD_CYCLES);
+    for (uint8_t step = 0 ; (step < TIMER_GENERIC_MAX_SEARCH_STEPS) && (0U != total_counts) && (total_counts <= max_total_counts) ; step++)
+    {
+        COUNT_SEARCH_STEP();
+        // Accumulated compare periods would all be too short with this prescaler : skip to single compare periods
+        if ((false == can_accumulate) && (total_counts > limit_value))
+        {
+            if (upwards)
             {
-                parameters->output.accumulator = (computed_ocra / i) - 1;
-                computed_ocra = i;
                 break;
             }
+            total_counts = limit_value;
+        }
+
+        candidate_t candidate = {0};
+        candidate.cycles = total_counts * prescaler;
+        candidate.prescaler = prescaler;
+        candidate.valid = true;
+        compute_error(parameters->input.cpu_frequency, parameters->input.target_frequency, &candidate);
+
+        if (best->valid && fraction_is_lower(best->error, best->cycles, candidate.error, candidate.cycles))
+        {
+            break;
         }
 
-        // If no suitable number was found, fallback on 1 and set the accumulator to computed_ocra old value.
-        if (0 == parameters->output.accumulator)
+        // Counts per compare period are as high as possible : a too short compare period cannot be fixed by
+        // splitting the same total counts differently
+        if (split_counts((uint32_t) total_counts, limit_value, &candidate.counts, &candidate.interrupts)
+        && ((1U == candidate.interrupts) || (((uint64_t) candidate.counts * prescaler) >= TIMER_GENERIC_MIN_ACCUMULATED_PERIOD_CYCLES)))
         {
-            parameters->output.accumulator = computed_ocra - 1;
-            computed_ocra = 1U;
+            if (candidate_is_better(&candidate, best))
+            {
+                *best = candidate;
+            }
+            break;
         }
+        total_counts = upwards ? (total_counts + 1U) : (total_counts - 1U);
+    }
+}
+
+void timer_generic_compute_parameters(timer_generic_parameters_t * const parameters)
+{
+    const uint32_t limit_value = (parameters->input.resolution == TIMER_GENERIC_RESOLUTION_8_BIT) ? TIMER_GENERIC_8_BIT_LIMIT_VALUE : TIMER_GENERIC_16_BIT_LIMIT_VALUE;
+    const uint64_t max_total_counts = (uint64_t) limit_value * TIMER_GENERIC_ACCUMULATOR_LIMIT_VALUE;
+    candidate_t best = {0};
+
+#ifdef UNIT_TESTING
+    search_cost.search_steps = 0;
+    search_cost.divisions = 0;
+#endif
+    parameters->output.prescaler = 0U;
+    parameters->output.ocra = 0U;
+    parameters->output.accumulator = 0U;
+    parameters->output.achieved_frequency = 0U;
+    parameters->output.error_ppm = 0U;
+    if ((0U == parameters->input.target_frequency) || (0U == parameters->input.prescaler_lookup_array.size))
+    {
+        return;
     }
 
-    if (computed_ocra != 0)
+    // Every prescaler is evaluated : the ideal amount of counts per period is rarely an integer, and the closest
+    // integers might not be producible as OCRA * accumulator
+    for (uint8_t i = 0 ; i < parameters->input.prescaler_lookup_array.size ; i++)
     {
-        parameters->output.ocra = (computed_ocra - 1U);
+        const uint16_t prescaler = parameters->input.prescaler_lookup_array.array[i].value;
+        if (0U == prescaler)
+        {
+            continue;
+        }
+
+        const uint64_t cycles_per_count = (uint64_t) prescaler * parameters->input.target_frequency;
+        uint64_t ideal_counts = parameters->input.cpu_frequency / cycles_per_count;
+        const bool exact = (0U == (parameters->input.cpu_frequency % cycles_per_count));
+        if (ideal_counts > max_total_counts)
+        {
+            ideal_counts = max_total_counts;
+        }
+
+        search_direction(parameters, prescaler, limit_value, ideal_counts, false, &best);
+        if (false == exact)
+        {
+            search_direction(parameters, prescaler, limit_value, ideal_counts + 1U, true, &best);
+        }
+
+        // Exact frequency with one interrupt per period cannot be beaten
+        if (best.valid && (0U == best.error) && (1U == best.interrupts))
+        {
+            break;
+        }
     }
-    else
+
+    if (false == best.valid)
     {
-        //TODO : We might be a bit off. In this case, normally we would have to raise the prescaler one step further and recompute ocra value.
-        parameters->output.ocra = computed_ocra;
+        return;
     }
+
+    parameters->output.prescaler = best.prescaler;
+    parameters->output.ocra = (uint16_t) (best.counts - 1U);
+    parameters->output.accumulator = best.interrupts - 1U;
+    parameters->output.achieved_frequency = (uint32_t) ((parameters->input.cpu_frequency + (best.cycles / 2U)) / best.cycles);
+    parameters->output.error_ppm = (uint32_t) (((best.error * 1000000ULL) + (best.cycles * parameters->input.target_frequency / 2U))
+                                             / (best.cycles * parameters->input.target_frequency));
+}
+
+#ifdef UNIT_TESTING
+void timer_generic_get_search_cost(uint32_t * const search_steps, uint32_t * const divisions)
+{
+    *search_steps = search_cost.search_steps;
+    *divisions = search_cost.divisions;
 }
+#endif
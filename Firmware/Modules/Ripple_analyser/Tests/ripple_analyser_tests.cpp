@@ -0,0 +1,252 @@
+/*
+
+------------------
+@<FreeMyCode>
+FreeMyCode version : 1.0 RC alpha
+    Author : bebenlebricolo
+    License : 
+        name : GPLv3
+        url : https://www.gnu.org/licenses/quick-guide-gplv3.html
+    Date : 12/02/2021
+    Project : LabBenchPowerSupply
+    Description : The Lab Bench Power Supply provides a simple design based around an Arduino Nano board to convert AC main voltage into
+ smaller ones, ranging from 0V to 16V, with voltage and current regulations
+<FreeMyCode>@
+------------------
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+
+#include "gtest/gtest.h"
+
+#include <cmath>
+
+#include "ripple_analyser.h"
+
+/* ADC2 is converted once every 9 conversions at 18 kHz : 2 kHz sampling rate. Full-wave rectified 50 Hz mains gives a
+100 Hz ripple */
+#define CONVERSION_RATE_HZ      18000U
+#define CONVERSIONS_PER_SAMPLE  9U
+#define SAMPLE_RATE_HZ          (CONVERSION_RATE_HZ / CONVERSIONS_PER_SAMPLE)
+
+class RippleAnalyserFixture : public ::testing::Test
+{
+public:
+    ripple_analyser_t analyser;
+    ripple_analyser_config_t config;
+
+protected:
+    void SetUp() override
+    {
+        config.conversion_rate_hz = CONVERSION_RATE_HZ;
+        config.max_gap = 4U * CONVERSIONS_PER_SAMPLE;
+        config.block_order = 10U;
+        config.hysteresis = 4U;
+        config.ripple_per_mains_period = 2U;
+    }
+
+    void push(const uint16_t sample, const uint32_t conversions = CONVERSIONS_PER_SAMPLE)
+    {
+        conversion += conversions;
+        ripple_analyser_push(&analyser, sample, conversion);
+    }
+
+    /* Reservoir capacitor is recharged during 20% of each ripple period, then discharged linearly by the load.
+    Signal is sampled at the conversion it is fetched : jitter alternately shortens and lengthens the scan cycle */
+    void push_smoothed_secondary(const double mains_frequency, const double valley, const double peak, const uint32_t samples,
+                                 const int noise = 0, const uint32_t jitter = 0)
+    {
+        const double ripple_period = CONVERSION_RATE_HZ / (2.0 * mains_frequency);
+        for (uint32_t i = 0 ; i < samples ; i++)
+        {
+            const uint32_t conversions = (0U == (sample_index % 2U)) ? CONVERSIONS_PER_SAMPLE - jitter : CONVERSIONS_PER_SAMPLE + jitter;
+            const double phase = std::fmod(conversion + conversions, ripple_period) / ripple_period;
+            double value = (phase < 0.2) ? valley + (peak - valley) * (phase / 0.2)
+                                         : peak - (peak - valley) * ((phase - 0.2) / 0.8);
+            value += (0 == (sample_index % 2U)) ? noise : -noise;
+            push((uint16_t) std::lround(value), conversions);
+            sample_index++;
+        }
+    }
+
+    uint32_t sample_index = 0;
+    uint32_t conversion = 0;
+};
+
+TEST(ripple_analyser_tests, isqrt)
+{
+    ASSERT_EQ(0U, ripple_analyser_isqrt(0U));
+    ASSERT_EQ(1U, ripple_analyser_isqrt(3U));
+    ASSERT_EQ(2U, ripple_analyser_isqrt(4U));
+    ASSERT_EQ(65535U, ripple_analyser_isqrt(UINT32_MAX));
+    for (uint32_t value = 0 ; value < 200000U ; value += 7U)
+    {
+        const uint32_t root = ripple_analyser_isqrt(value);
+        ASSERT_LE(root * root, value);
+        ASSERT_GT((root + 1U) * (root + 1U), value);
+    }
+}
+
+TEST_F(RippleAnalyserFixture, guard_null_and_config)
+{
+    ripple_analyser_report_t report;
+    ASSERT_EQ(RIPPLE_ANALYSER_ERROR_NULL_POINTER, ripple_analyser_init(NULL, &config));
+    ASSERT_EQ(RIPPLE_ANALYSER_ERROR_NULL_POINTER, ripple_analyser_init(&analyser, NULL));
+    config.block_order = RIPPLE_ANALYSER_MAX_BLOCK_ORDER + 1U;
+    ASSERT_EQ(RIPPLE_ANALYSER_ERROR_CONFIG, ripple_analyser_init(&analyser, &config));
+    config.block_order = 0U;
+    ASSERT_EQ(RIPPLE_ANALYSER_ERROR_CONFIG, ripple_analyser_init(&analyser, &config));
+    config.block_order = 4U;
+    config.ripple_per_mains_period = 0U;
+    ASSERT_EQ(RIPPLE_ANALYSER_ERROR_CONFIG, ripple_analyser_init(&analyser, &config));
+    config.ripple_per_mains_period = 2U;
+    config.conversion_rate_hz = 0U;
+    ASSERT_EQ(RIPPLE_ANALYSER_ERROR_CONFIG, ripple_analyser_init(&analyser, &config));
+    config.conversion_rate_hz = CONVERSION_RATE_HZ;
+    ASSERT_EQ(RIPPLE_ANALYSER_ERROR_OK, ripple_analyser_init(&analyser, &config));
+
+    ASSERT_EQ(RIPPLE_ANALYSER_ERROR_NULL_POINTER, ripple_analyser_get_report(NULL, &report));
+    ASSERT_EQ(RIPPLE_ANALYSER_ERROR_NULL_POINTER, ripple_analyser_get_report(&analyser, NULL));
+    ASSERT_EQ(RIPPLE_ANALYSER_ERROR_NOT_READY, ripple_analyser_get_report(&analyser, &report));
+
+    /* Block is latched on its 16th sample */
+    for (uint8_t i = 0 ; i < 15U ; i++)
+    {
+        push(100U);
+    }
+    ASSERT_EQ(RIPPLE_ANALYSER_ERROR_NOT_READY, ripple_analyser_get_report(&analyser, &report));
+    push(100U);
+    ASSERT_EQ(RIPPLE_ANALYSER_ERROR_OK, ripple_analyser_get_report(&analyser, &report));
+    ASSERT_EQ(100U, report.mean);
+    ASSERT_EQ(0U, report.peak_to_peak);
+    ASSERT_EQ(0U, report.rms_q4);
+    ASSERT_EQ(0U, report.frequency_centihz);
+}
+
+TEST_F(RippleAnalyserFixture, sine_ripple_rms)
+{
+    ASSERT_EQ(RIPPLE_ANALYSER_ERROR_OK, ripple_analyser_init(&analyser, &config));
+    /* 40 LSB amplitude : RMS is 40 / sqrt(2) = 28.28 LSB */
+    for (uint32_t i = 0 ; i < 2048U ; i++)
+    {
+        const double value = 600.0 + 40.0 * std::sin(2.0 * M_PI * 100.0 * i / SAMPLE_RATE_HZ);
+        push((uint16_t) std::lround(value));
+    }
+    ripple_analyser_report_t report;
+    ASSERT_EQ(RIPPLE_ANALYSER_ERROR_OK, ripple_analyser_get_report(&analyser, &report));
+    ASSERT_NEAR(600U, report.mean, 1);
+    ASSERT_EQ(560U, report.valley);
+    ASSERT_EQ(80U, report.peak_to_peak);
+    ASSERT_NEAR(40.0 / std::sqrt(2.0) * 16.0, report.rms_q4, 8.0);
+    ASSERT_NEAR(5000U, report.frequency_centihz, 10);
+}
+
+TEST_F(RippleAnalyserFixture, smoothed_secondary_frequency)
+{
+    ASSERT_EQ(RIPPLE_ANALYSER_ERROR_OK, ripple_analyser_init(&analyser, &config));
+
+    /* First block only sets the crossing detection level */
+    push_smoothed_secondary(49.5, 700.0, 760.0, 1024U);
+    ripple_analyser_report_t report;
+    ASSERT_EQ(RIPPLE_ANALYSER_ERROR_OK, ripple_analyser_get_report(&analyser, &report));
+    ASSERT_EQ(0U, report.frequency_centihz);
+
+    push_smoothed_secondary(49.5, 700.0, 760.0, 1024U);
+    ASSERT_EQ(RIPPLE_ANALYSER_ERROR_OK, ripple_analyser_get_report(&analyser, &report));
+    ASSERT_NEAR(4950U, report.frequency_centihz, 10);
+    ASSERT_NEAR(700U, report.valley, 1);
+    ASSERT_NEAR(60U, report.peak_to_peak, 1);
+    ASSERT_NEAR(730U, report.mean, 2);
+
+    /* 3 LSB of alternating noise stays within hysteresis and is not counted as ripple periods */
+    push_smoothed_secondary(60.0, 700.0, 760.0, 2048U, 3);
+    ASSERT_EQ(RIPPLE_ANALYSER_ERROR_OK, ripple_analyser_get_report(&analyser, &report));
+    ASSERT_NEAR(6000U, report.frequency_centihz, 15);
+
+    /* Half-wave rectifier : one ripple period per mains period */
+    config.ripple_per_mains_period = 1U;
+    ASSERT_EQ(RIPPLE_ANALYSER_ERROR_OK, ripple_analyser_init(&analyser, &config));
+    push_smoothed_secondary(25.0, 700.0, 760.0, 2048U);
+    ASSERT_EQ(RIPPLE_ANALYSER_ERROR_OK, ripple_analyser_get_report(&analyser, &report));
+    ASSERT_NEAR(5000U, report.frequency_centihz, 10);
+}
+
+TEST_F(RippleAnalyserFixture, uneven_scan_frequency)
+{
+    /* Scan cycles alternately last 6 and 12 conversions : positions follow the conversion count, not the sample count */
+    ASSERT_EQ(RIPPLE_ANALYSER_ERROR_OK, ripple_analyser_init(&analyser, &config));
+    push_smoothed_secondary(50.0, 700.0, 760.0, 2048U, 0, 3U);
+    ripple_analyser_report_t report;
+    ASSERT_EQ(RIPPLE_ANALYSER_ERROR_OK, ripple_analyser_get_report(&analyser, &report));
+    ASSERT_NEAR(5000U, report.frequency_centihz, 10);
+}
+
+TEST_F(RippleAnalyserFixture, stalled_scan_restarts_block)
+{
+    ASSERT_EQ(RIPPLE_ANALYSER_ERROR_OK, ripple_analyser_init(&analyser, &config));
+    push_smoothed_secondary(50.0, 700.0, 760.0, 1024U + 512U);
+    ASSERT_EQ(1U, analyser.block_id);
+
+    /* Scan stalls for ~28 ms : 2.8 ripple periods are not seen at all */
+    conversion += 56U * CONVERSIONS_PER_SAMPLE;
+    push_smoothed_secondary(50.0, 700.0, 760.0, 1023U);
+    ASSERT_EQ(1U, analyser.block_id);
+    push_smoothed_secondary(50.0, 700.0, 760.0, 1U);
+    ASSERT_EQ(2U, analyser.block_id);
+
+    /* Block only holds samples taken after the stall : missed periods do not bias the estimate */
+    ripple_analyser_report_t report;
+    ASSERT_EQ(RIPPLE_ANALYSER_ERROR_OK, ripple_analyser_get_report(&analyser, &report));
+    ASSERT_NEAR(5000U, report.frequency_centihz, 10);
+    ASSERT_NEAR(700U, report.valley, 1);
+    ASSERT_NEAR(60U, report.peak_to_peak, 1);
+
+    /* Same stall with gap detection disabled : block spans it and periods go missing */
+    config.max_gap = 0U;
+    ASSERT_EQ(RIPPLE_ANALYSER_ERROR_OK, ripple_analyser_init(&analyser, &config));
+    push_smoothed_secondary(50.0, 700.0, 760.0, 1024U + 512U);
+    conversion += 56U * CONVERSIONS_PER_SAMPLE;
+    push_smoothed_secondary(50.0, 700.0, 760.0, 512U);
+    ASSERT_EQ(RIPPLE_ANALYSER_ERROR_OK, ripple_analyser_get_report(&analyser, &report));
+    ASSERT_LT(report.frequency_centihz, 4900U);
+}
+
+TEST_F(RippleAnalyserFixture, derating)
+{
+    ripple_analyser_report_t report = {};
+    report.valley = 700U;
+    ASSERT_EQ(1000U, ripple_analyser_derate(&report, 600U, 100U, 1000U));
+    report.valley = 650U;
+    ASSERT_EQ(500U, ripple_analyser_derate(&report, 600U, 100U, 1000U));
+    report.valley = 600U;
+    ASSERT_EQ(0U, ripple_analyser_derate(&report, 600U, 100U, 1000U));
+    report.valley = 10U;
+    ASSERT_EQ(0U, ripple_analyser_derate(&report, 600U, 100U, 1000U));
+    ASSERT_EQ(0U, ripple_analyser_derate(NULL, 600U, 100U, 1000U));
+
+    /* Ageing capacitor : same load, bigger ripple and lower valley */
+    config.block_order = 10U;
+    ASSERT_EQ(RIPPLE_ANALYSER_ERROR_OK, ripple_analyser_init(&analyser, &config));
+    push_smoothed_secondary(50.0, 640.0, 760.0, 1024U);
+    ASSERT_EQ(RIPPLE_ANALYSER_ERROR_OK, ripple_analyser_get_report(&analyser, &report));
+    ASSERT_EQ(120U, report.peak_to_peak);
+    ASSERT_EQ(400U, ripple_analyser_derate(&report, 600U, 100U, 1000U));
+}
+
+int main(int argc, char **argv)
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,192 @@
+/*
+
+------------------
+@<FreeMyCode>
+FreeMyCode version : 1.0 RC alpha
+    Author : bebenlebricolo
+    License : 
+        name : GPLv3
+        url : https://www.gnu.org/licenses/quick-guide-gplv3.html
+    Date : 12/02/2021
+    Project : LabBenchPowerSupply
+    Description : The Lab Bench Power Supply provides a simple design based around an Arduino Nano board to convert AC main voltage into
+ smaller ones, ranging from 0V to 16V, with voltage and current regulations
+<FreeMyCode>@
+------------------
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+
+#ifndef RIPPLE_ANALYSER_HEADER
+#define RIPPLE_ANALYSER_HEADER
+
+/* Expose this API to C++ code without name mangling */
+#ifdef __cplusplus
+extern "C"
+{
+#endif /* __cplusplus */
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "adc_statistics.h"
+
+/**
+ * Ripple analyser : streaming analysis of the rectified and smoothed transformer secondary voltage.
+ * Samples are accumulated block by block at constant cost, so that ripple_analyser_push() can be called from the ADC
+ * ISR : block statistics are handled by adc_statistics, the analyser only adds the crossings of the previous block
+ * mean. Each complete block is latched and turned into a report (peak to peak ripple, RMS ripple, mains frequency)
+ * from main context.
+ * Samples are positioned with the ADC total conversion count rather than assumed to be evenly spaced : the frequency
+ * estimate follows the actual scan, and a block is restarted when the scan stalls between two samples.
+ * A growing ripple at a given load is the signature of an undersized or ageing reservoir capacitor, and ripple
+ * valley is what eventually makes the regulator drop out.
+*/
+
+/*  ####################################################################################
+    ############################ Data types declaration ################################
+    #################################################################################### */
+
+/* Largest block adc_statistics can accumulate : 2^12 = ADC_STATISTICS_MAX_WINDOW */
+#define RIPPLE_ANALYSER_MAX_BLOCK_ORDER 12U
+
+/* Reports are retried this many times when a block gets latched while being copied */
+#define RIPPLE_ANALYSER_MAX_RETRIES 4U
+
+/**
+ * @brief lists available error types for the ripple analyser
+*/
+typedef enum
+{
+    RIPPLE_ANALYSER_ERROR_OK,           /**< Action was successful                                  */
+    RIPPLE_ANALYSER_ERROR_NULL_POINTER, /**< Given pointer not initialised                          */
+    RIPPLE_ANALYSER_ERROR_CONFIG,       /**< Configuration is out of range                          */
+    RIPPLE_ANALYSER_ERROR_NOT_READY,    /**< No block was completed yet                             */
+    RIPPLE_ANALYSER_ERROR_BUSY,         /**< Blocks kept being latched while reading, try again     */
+} ripple_analyser_error_t;
+
+/**
+ * @brief ripple analyser configuration
+*/
+typedef struct
+{
+    uint32_t conversion_rate_hz;        /**< ADC conversions per second, converts crossing positions to a frequency           */
+    uint16_t max_gap;                   /**< Conversions between two samples above which running block is restarted (0 : off) */
+    uint8_t block_order;                /**< log2 of the number of samples per block (1 to RIPPLE_ANALYSER_MAX_BLOCK_ORDER)   */
+    uint8_t hysteresis;                 /**< Crossing detection hysteresis around previous block mean, in LSB                 */
+    uint8_t ripple_per_mains_period;    /**< Ripple periods per mains period : 2 for a full-wave rectifier, 1 for half-wave   */
+} ripple_analyser_config_t;
+
+/**
+ * @brief crossings detected within a block of samples
+*/
+typedef struct
+{
+    uint16_t crossings;         /**< Rising crossings of the previous block mean                        */
+    uint32_t first_crossing;    /**< Position of the first rising crossing, in conversions from block start */
+    uint32_t last_crossing;     /**< Position of the last rising crossing, in conversions from block start  */
+} ripple_analyser_crossings_t;
+
+/**
+ * @brief ripple analyser object, owned by the caller
+*/
+typedef struct
+{
+    ripple_analyser_config_t config;        /**< Analyser configuration                                             */
+    uint16_t rising_threshold;              /**< Previous block mean + hysteresis                                   */
+    uint16_t falling_threshold;             /**< Previous block mean - hysteresis                                   */
+    bool above;                             /**< Signal was last seen above rising threshold                        */
+    uint32_t last_conversion;               /**< Conversion count of the previous sample                            */
+    uint32_t position;                      /**< Conversions elapsed between block start and the previous sample    */
+    volatile uint8_t block_id;              /**< Incremented once both the statistics and crossings are latched     */
+    adc_statistics_t statistics;            /**< Block statistics (min, max, sum, sum of squares)                   */
+    ripple_analyser_crossings_t running;    /**< Crossings of the block being accumulated                           */
+    ripple_analyser_crossings_t latched;    /**< Crossings of the last complete block                               */
+} ripple_analyser_t;
+
+/**
+ * @brief analysis results of the last complete block
+*/
+typedef struct
+{
+    uint16_t mean;              /**< Mean value, in LSB                                                     */
+    uint16_t valley;            /**< Smallest sample, in LSB                                                */
+    uint16_t peak_to_peak;      /**< Peak to peak ripple, in LSB                                            */
+    uint16_t rms_q4;            /**< RMS value of the ripple (mean removed), in 1/16 LSB                    */
+    uint16_t frequency_centihz; /**< Estimated mains frequency in 1/100 Hz, 0 when less than 2 crossings    */
+} ripple_analyser_report_t;
+
+/*  ####################################################################################
+    ############################ Functions declarations ################################
+    #################################################################################### */
+
+/**
+ * @brief initialises an analyser object and clears its blocks
+ * @param[out] analyser : analyser object
+ * @param[in]  config   : analyser configuration
+ * @return
+ *      RIPPLE_ANALYSER_ERROR_OK            : operation succeeded
+ *      RIPPLE_ANALYSER_ERROR_NULL_POINTER  : given pointer is NULL
+ *      RIPPLE_ANALYSER_ERROR_CONFIG        : block order, conversion rate or ripple_per_mains_period is out of range
+*/
+ripple_analyser_error_t ripple_analyser_init(ripple_analyser_t * const analyser, const ripple_analyser_config_t * const config);
+
+/**
+ * @brief accumulates a new sample, at constant cost (no division). Meant to be called from the ADC ISR :
+ * no checks are performed. When more than config.max_gap conversions elapsed since the previous sample, the scan is
+ * deemed stalled : running block is discarded and crossing detection waits for the signal to go below its level again.
+ * @param[in] analyser   : initialised analyser object
+ * @param[in] sample     : new raw sample
+ * @param[in] conversion : ADC total conversion count when the sample was fetched (@see adc_get_conversion_counters())
+*/
+void ripple_analyser_push(ripple_analyser_t * const analyser, const uint16_t sample, const uint32_t conversion);
+
+/**
+ * @brief computes the report of the last complete block. Uses 64 bits arithmetic : call it from main context only
+ * @param[in]  analyser : analyser object
+ * @param[out] report   : computed report
+ * @return
+ *      RIPPLE_ANALYSER_ERROR_OK            : operation succeeded
+ *      RIPPLE_ANALYSER_ERROR_NULL_POINTER  : given pointer is NULL
+ *      RIPPLE_ANALYSER_ERROR_NOT_READY     : no block was completed yet
+ *      RIPPLE_ANALYSER_ERROR_BUSY          : blocks were latched faster than they could be read
+*/
+ripple_analyser_error_t ripple_analyser_get_report(const ripple_analyser_t * const analyser, ripple_analyser_report_t * const report);
+
+/**
+ * @brief scales an output limit down as ripple valley gets close to the level where the regulator drops out.
+ * Limit is kept as is while valley stays above dropout_level + margin, and linearly reduced down to 0 when
+ * valley reaches dropout_level.
+ * @param[in] report        : ripple report
+ * @param[in] dropout_level : lowest valley (LSB) the regulator can cope with
+ * @param[in] margin        : valley headroom (LSB) above which limit is not reduced
+ * @param[in] limit         : nominal limit
+ * @return derated limit
+*/
+uint16_t ripple_analyser_derate(const ripple_analyser_report_t * const report, const uint16_t dropout_level, const uint16_t margin, const uint16_t limit);
+
+/**
+ * @brief integer square root, rounded down
+ * @param[in] value : input value
+ * @return floor(sqrt(value))
+*/
+uint16_t ripple_analyser_isqrt(const uint32_t value);
+
+/* Expose this API to C++ code without name mangling */
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* RIPPLE_ANALYSER_HEADER */
@@ -0,0 +1,229 @@
+/*
+
+------------------
+@<FreeMyCode>
+FreeMyCode version : 1.0 RC alpha
+    Author : bebenlebricolo
+    License : 
+        name : GPLv3
+        url : https://www.gnu.org/licenses/quick-guide-gplv3.html
+    Date : 12/02/2021
+    Project : LabBenchPowerSupply
+    Description : The Lab Bench Power Supply provides a simple design based around an Arduino Nano board to convert AC main voltage into
+ smaller ones, ranging from 0V to 16V, with voltage and current regulations
+<FreeMyCode>@
+------------------
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+
+#include <stddef.h>
+#include "ripple_analyser.h"
+
+/* Latched blocks are not volatile : keeps the compiler from moving their accesses across the block_id reads */
+static inline void compiler_barrier(void)
+{
+    __asm__ __volatile__("" ::: "memory");
+}
+
+static inline void crossings_reset(ripple_analyser_crossings_t * const crossings)
+{
+    crossings->crossings = 0;
+    crossings->first_crossing = 0;
+    crossings->last_crossing = 0;
+}
+
+ripple_analyser_error_t ripple_analyser_init(ripple_analyser_t * const analyser, const ripple_analyser_config_t * const config)
+{
+    ripple_analyser_error_t ret = RIPPLE_ANALYSER_ERROR_OK;
+    if ((NULL == analyser) || (NULL == config))
+    {
+        ret = RIPPLE_ANALYSER_ERROR_NULL_POINTER;
+    }
+    else if ((0U == config->block_order) || (config->block_order > RIPPLE_ANALYSER_MAX_BLOCK_ORDER)
+          || (0U == config->ripple_per_mains_period) || (0U == config->conversion_rate_hz)
+          || (ADC_STATISTICS_ERROR_OK != adc_statistics_init(&analyser->statistics, (uint16_t)(1U << config->block_order))))
+    {
+        ret = RIPPLE_ANALYSER_ERROR_CONFIG;
+    }
+    else
+    {
+        analyser->config = *config;
+        /* No crossings are counted until a first block mean is known */
+        analyser->rising_threshold = UINT16_MAX;
+        analyser->falling_threshold = 0;
+        analyser->above = false;
+        analyser->last_conversion = 0;
+        analyser->position = 0;
+        analyser->block_id = 0;
+        crossings_reset(&analyser->running);
+        crossings_reset(&analyser->latched);
+    }
+    return ret;
+}
+
+void ripple_analyser_push(ripple_analyser_t * const analyser, const uint16_t sample, const uint32_t conversion)
+{
+    ripple_analyser_crossings_t * const running = &analyser->running;
+    /* Unsigned subtraction handles conversion count wrap around */
+    const uint32_t elapsed = conversion - analyser->last_conversion;
+    analyser->last_conversion = conversion;
+
+    if ((0U != analyser->config.max_gap) && (elapsed > analyser->config.max_gap))
+    {
+        /* Scan stalled : a block spanning the gap would miss crossings. Signal might have moved anywhere meanwhile,
+        so wait for it to go below the level first, like for the first block */
+        adc_statistics_restart(&analyser->statistics);
+        crossings_reset(running);
+        analyser->above = true;
+    }
+    analyser->position = (0U == analyser->statistics.running.count) ? 0U : (analyser->position + elapsed);
+    const uint32_t position = analyser->position;
+    const uint8_t window_id = analyser->statistics.window_id;
+
+    /* Rising crossings only, hysteresis prevents noise from being counted as ripple periods */
+    if (!analyser->above && (sample > analyser->rising_threshold))
+    {
+        analyser->above = true;
+        if (0U == running->crossings)
+        {
+            running->first_crossing = position;
+        }
+        running->last_crossing = position;
+        running->crossings++;
+    }
+    else if (analyser->above && (sample < analyser->falling_threshold))
+    {
+        analyser->above = false;
+    }
+
+    adc_statistics_push(&analyser->statistics, sample);
+    if (window_id != analyser->statistics.window_id)
+    {
+        /* Block length is a power of two : mean is a shift */
+        const uint16_t mean = (uint16_t)(analyser->statistics.latched.sum >> analyser->config.block_order);
+        const uint16_t hysteresis = analyser->config.hysteresis;
+        analyser->rising_threshold = mean + hysteresis;
+        analyser->falling_threshold = (mean > hysteresis) ? (uint16_t)(mean - hysteresis) : 0U;
+        if (0U == analyser->block_id)
+        {
+            /* Signal might currently be above the brand new level : wait for it to go below first, so that the
+            first counted crossing is a real one */
+            analyser->above = true;
+        }
+
+        analyser->latched = *running;
+        compiler_barrier();
+        analyser->block_id++;
+        crossings_reset(running);
+    }
+}
+
+uint16_t ripple_analyser_isqrt(const uint32_t value)
+{
+    /* Digit by digit method, one result bit per iteration */
+    uint32_t remainder = value;
+    uint32_t result = 0;
+    uint32_t bit = (uint32_t) 1U << 30U;
+    while (bit > remainder)
+    {
+        bit >>= 2U;
+    }
+    while (0U != bit)
+    {
+        if (remainder >= result + bit)
+        {
+            remainder -= result + bit;
+            result = (result >> 1U) + bit;
+        }
+        else
+        {
+            result >>= 1U;
+        }
+        bit >>= 2U;
+    }
+    return (uint16_t) result;
+}
+
+ripple_analyser_error_t ripple_analyser_get_report(const ripple_analyser_t * const analyser, ripple_analyser_report_t * const report)
+{
+    ripple_analyser_error_t ret = RIPPLE_ANALYSER_ERROR_OK;
+    adc_statistics_window_t window;
+    ripple_analyser_crossings_t crossings;
+    adc_statistics_summary_t summary;
+    if ((NULL == analyser) || (NULL == report))
+    {
+        ret = RIPPLE_ANALYSER_ERROR_NULL_POINTER;
+    }
+    else
+    {
+        /* Latched block is rewritten by the ISR : copy it again if a new one was latched meanwhile */
+        ret = RIPPLE_ANALYSER_ERROR_BUSY;
+        for (uint8_t i = 0 ; (i < RIPPLE_ANALYSER_MAX_RETRIES) && (RIPPLE_ANALYSER_ERROR_BUSY == ret) ; i++)
+        {
+            const uint8_t block_id = analyser->block_id;
+            compiler_barrier();
+            window = analyser->statistics.latched;
+            crossings = analyser->latched;
+            compiler_barrier();
+            if (block_id == analyser->block_id)
+            {
+                ret = RIPPLE_ANALYSER_ERROR_OK;
+            }
+        }
+        if ((RIPPLE_ANALYSER_ERROR_OK == ret) && (0U == window.count))
+        {
+            ret = RIPPLE_ANALYSER_ERROR_NOT_READY;
+        }
+    }
+
+    if (RIPPLE_ANALYSER_ERROR_OK == ret)
+    {
+        /* Variance is in 1/256 LSB^2 : its square root is in 1/16 LSB */
+        (void) adc_statistics_summarize(&window, &summary);
+        report->mean = (uint16_t)(summary.mean_q8 >> 8U);
+        report->valley = summary.min;
+        report->peak_to_peak = summary.max - summary.min;
+        report->rms_q4 = ripple_analyser_isqrt(summary.variance_q8);
+
+        /* (crossings - 1) ripple periods elapsed between first and last crossing */
+        report->frequency_centihz = 0;
+        if ((crossings.crossings >= 2U) && (crossings.last_crossing > crossings.first_crossing))
+        {
+            const uint64_t periods = (uint64_t)(crossings.crossings - 1U) * analyser->config.conversion_rate_hz * 100U;
+            const uint64_t conversions = (uint64_t)(crossings.last_crossing - crossings.first_crossing) * analyser->config.ripple_per_mains_period;
+            report->frequency_centihz = (uint16_t)((periods + (conversions / 2U)) / conversions);
+        }
+    }
+    return ret;
+}
+
+uint16_t ripple_analyser_derate(const ripple_analyser_report_t * const report, const uint16_t dropout_level, const uint16_t margin, const uint16_t limit)
+{
+    uint16_t derated = limit;
+    if (NULL == report)
+    {
+        derated = 0;
+    }
+    else if (report->valley <= dropout_level)
+    {
+        derated = 0;
+    }
+    else if ((report->valley - dropout_level) < margin)
+    {
+        derated = (uint16_t)(((uint32_t) limit * (report->valley - dropout_level)) / margin);
+    }
+    return derated;
+}
@@ -0,0 +1,282 @@
+/*
+
+------------------
+@<FreeMyCode>
+FreeMyCode version : 1.0 RC alpha
+    Author : bebenlebricolo
+    License : 
+        name : GPLv3
+        url : https://www.gnu.org/licenses/quick-guide-gplv3.html
+    Date : 12/02/2021
+    Project : LabBenchPowerSupply
+    Description : The Lab Bench Power Supply provides a simple design based around an Arduino Nano board to convert AC main voltage into
+ smaller ones, ranging from 0V to 16V, with voltage and current regulations
+<FreeMyCode>@
+------------------
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+
+#include "gtest/gtest.h"
+
+#include <vector>
+
+#include "config.h"
+#include "scheduler.h"
+
+/* Fake clock : tasks make time elapse by their configured run time */
+static uint32_t fake_now = 0;
+static uint32_t run_times[SCHEDULER_MAX_TASKS] = {0};
+static std::vector<uint8_t> runs;
+
+static uint32_t fake_clock(void)
+{
+    return fake_now;
+}
+
+static void run(const uint8_t task)
+{
+    runs.push_back(task);
+    fake_now += run_times[task];
+}
+
+static void task_0(void) { run(0U); }
+static void task_1(void) { run(1U); }
+static void task_2(void) { run(2U); }
+static void task_3(void) { run(3U); }
+
+class SchedulerFixture : public ::testing::Test
+{
+public:
+    void SetUp(void) override
+    {
+        fake_now = 0;
+        runs.clear();
+        for (auto & run_time : run_times)
+        {
+            run_time = 0;
+        }
+    }
+
+    /* Dispatches every ready task, then lets one clock tick elapse */
+    void run_ticks(const uint32_t count)
+    {
+        for (uint32_t i = 0 ; i < count ; i++)
+        {
+            bool idle = false;
+            while (false == idle)
+            {
+                ASSERT_EQ(SCHEDULER_ERROR_OK, scheduler_dispatch(&idle));
+            }
+            fake_now++;
+        }
+    }
+};
+
+TEST(scheduler_tests, test_guard_wrong_parameters)
+{
+    const scheduler_task_t tasks[] =
+    {
+        {task_0, 1U, 0U, 0U, false},
+    };
+    scheduler_task_t wrong_tasks[] =
+    {
+        {nullptr, 1U, 0U, 0U, false},   // No function
+        {task_0, 0U, 0U, 0U, false},    // Can never be released
+    };
+    bool idle = false;
+    scheduler_task_stats_t stats;
+
+    ASSERT_EQ(SCHEDULER_ERROR_NULL_POINTER, scheduler_init(nullptr, 1U, fake_clock, nullptr));
+    ASSERT_EQ(SCHEDULER_ERROR_NULL_POINTER, scheduler_init(tasks, 1U, nullptr, nullptr));
+    ASSERT_EQ(SCHEDULER_ERROR_CONFIG, scheduler_init(tasks, 0U, fake_clock, nullptr));
+    ASSERT_EQ(SCHEDULER_ERROR_CONFIG, scheduler_init(tasks, SCHEDULER_MAX_TASKS + 1U, fake_clock, nullptr));
+    ASSERT_EQ(SCHEDULER_ERROR_CONFIG, scheduler_init(&wrong_tasks[0], 1U, fake_clock, nullptr));
+    ASSERT_EQ(SCHEDULER_ERROR_CONFIG, scheduler_init(&wrong_tasks[1], 1U, fake_clock, nullptr));
+
+    ASSERT_EQ(SCHEDULER_ERROR_UNINITIALISED, scheduler_dispatch(&idle));
+    ASSERT_EQ(SCHEDULER_ERROR_UNINITIALISED, scheduler_is_idle(&idle));
+    ASSERT_EQ(SCHEDULER_ERROR_UNINITIALISED, scheduler_trigger(0U));
+    ASSERT_EQ(SCHEDULER_ERROR_UNINITIALISED, scheduler_get_stats(0U, &stats));
+
+    ASSERT_EQ(SCHEDULER_ERROR_OK, scheduler_init(tasks, 1U, fake_clock, nullptr));
+    ASSERT_EQ(SCHEDULER_ERROR_NULL_POINTER, scheduler_dispatch(nullptr));
+    ASSERT_EQ(SCHEDULER_ERROR_NULL_POINTER, scheduler_is_idle(nullptr));
+    ASSERT_EQ(SCHEDULER_ERROR_NULL_POINTER, scheduler_get_stats(0U, nullptr));
+    ASSERT_EQ(SCHEDULER_ERROR_INVALID_INDEX, scheduler_get_stats(1U, &stats));
+    // Not an event triggered task
+    ASSERT_EQ(SCHEDULER_ERROR_INVALID_INDEX, scheduler_trigger(0U));
+    ASSERT_EQ(SCHEDULER_ERROR_INVALID_INDEX, scheduler_trigger(1U));
+}
+
+TEST_F(SchedulerFixture, test_periods_and_offsets)
+{
+    const scheduler_task_t tasks[] =
+    {
+        {task_0, 2U, 0U, 0U, false},
+        {task_1, 5U, 3U, 0U, false},
+    };
+    ASSERT_EQ(SCHEDULER_ERROR_OK, scheduler_init(tasks, 2U, fake_clock, nullptr));
+
+    // Task 0 runs on ticks 0, 2, 4, 6, 8 and task 1 on ticks 3, 8
+    run_ticks(9U);
+    const std::vector<uint8_t> expected = {0U, 0U, 1U, 0U, 0U, 0U, 1U};
+    ASSERT_EQ(expected, runs);
+
+    scheduler_task_stats_t stats;
+    ASSERT_EQ(SCHEDULER_ERROR_OK, scheduler_get_stats(0U, &stats));
+    ASSERT_EQ(5U, stats.run_count);
+    ASSERT_EQ(0U, stats.deadline_misses);
+    ASSERT_EQ(SCHEDULER_ERROR_OK, scheduler_get_stats(1U, &stats));
+    ASSERT_EQ(2U, stats.run_count);
+}
+
+TEST_F(SchedulerFixture, test_priorities)
+{
+    const scheduler_task_t tasks[] =
+    {
+        {task_0, 10U, 0U, 3U, false},
+        {task_1, 10U, 0U, 1U, false},
+        {task_2, 10U, 0U, 0U, false},
+        {task_3, 10U, 0U, 1U, false},
+    };
+    ASSERT_EQ(SCHEDULER_ERROR_OK, scheduler_init(tasks, 4U, fake_clock, nullptr));
+
+    // Equal priorities run in table order
+    run_ticks(1U);
+    const std::vector<uint8_t> expected = {2U, 1U, 3U, 0U};
+    ASSERT_EQ(expected, runs);
+
+    // A long low priority task is preempted at the next dispatch by newly released urgent ones
+    const scheduler_task_t slow_background[] =
+    {
+        {task_0, 1U, 0U, 0U, false},
+        {task_1, 100U, 0U, 5U, false},
+    };
+    runs.clear();
+    run_times[1U] = 3U;
+    ASSERT_EQ(SCHEDULER_ERROR_OK, scheduler_init(slow_background, 2U, fake_clock, nullptr));
+    bool idle = false;
+    ASSERT_EQ(SCHEDULER_ERROR_OK, scheduler_dispatch(&idle));
+    ASSERT_EQ(SCHEDULER_ERROR_OK, scheduler_dispatch(&idle));
+    ASSERT_EQ(SCHEDULER_ERROR_OK, scheduler_dispatch(&idle));
+    ASSERT_FALSE(idle);
+    const std::vector<uint8_t> expected_slow = {0U, 1U, 0U};
+    ASSERT_EQ(expected_slow, runs);
+
+    // Fast task missed its releases while the slow one was running : it runs once, not once per missed release
+    ASSERT_EQ(SCHEDULER_ERROR_OK, scheduler_dispatch(&idle));
+    ASSERT_TRUE(idle);
+}
+
+TEST_F(SchedulerFixture, test_event_triggered_tasks)
+{
+    const scheduler_task_t tasks[] =
+    {
+        {task_0, 0U, 0U, 1U, true},      // Event only
+        {task_1, 4U, 0U, 0U, true},      // Periodic, or on event
+        {task_2, 4U, 2U, 2U, false},
+    };
+    ASSERT_EQ(SCHEDULER_ERROR_OK, scheduler_init(tasks, 3U, fake_clock, nullptr));
+    ASSERT_EQ(SCHEDULER_ERROR_INVALID_INDEX, scheduler_trigger(2U));
+
+    run_ticks(1U);
+    std::vector<uint8_t> expected = {1U};
+    ASSERT_EQ(expected, runs);
+
+    // Several triggers before dispatch result in a single run
+    ASSERT_EQ(SCHEDULER_ERROR_OK, scheduler_trigger(0U));
+    ASSERT_EQ(SCHEDULER_ERROR_OK, scheduler_trigger(0U));
+    ASSERT_EQ(SCHEDULER_ERROR_OK, scheduler_trigger(1U));
+    run_ticks(2U);
+    expected = {1U, 1U, 0U, 2U};
+    ASSERT_EQ(expected, runs);
+
+    // Event raised once dispatch reported idle is seen before sleeping, and left for dispatch to run
+    bool idle = false;
+    ASSERT_EQ(SCHEDULER_ERROR_OK, scheduler_dispatch(&idle));
+    ASSERT_TRUE(idle);
+    ASSERT_EQ(SCHEDULER_ERROR_OK, scheduler_trigger(0U));
+    ASSERT_EQ(SCHEDULER_ERROR_OK, scheduler_is_idle(&idle));
+    ASSERT_FALSE(idle);
+    ASSERT_EQ(expected, runs);
+    ASSERT_EQ(SCHEDULER_ERROR_OK, scheduler_dispatch(&idle));
+    ASSERT_FALSE(idle);
+    ASSERT_EQ(SCHEDULER_ERROR_OK, scheduler_is_idle(&idle));
+    ASSERT_TRUE(idle);
+    expected = {1U, 1U, 0U, 2U, 0U};
+    ASSERT_EQ(expected, runs);
+
+    // Event runs do not shift periodic releases
+    runs.clear();
+    run_ticks(2U);
+    expected = {1U};
+    ASSERT_EQ(expected, runs);
+}
+
+TEST_F(SchedulerFixture, test_run_time_and_deadline_misses)
+{
+    const scheduler_task_t tasks[] =
+    {
+        {task_0, 10U, 0U, 0U, false},
+        {task_1, 0U, 0U, 1U, true},
+    };
+    ASSERT_EQ(SCHEDULER_ERROR_OK, scheduler_init(tasks, 2U, fake_clock, nullptr));
+
+    // Tasks make the clock elapse by their run time
+    run_times[0U] = 4U;
+    run_ticks(1U);
+    fake_now = 10U;
+    run_times[0U] = 9U;
+    run_ticks(1U);
+
+    scheduler_task_stats_t stats;
+    ASSERT_EQ(SCHEDULER_ERROR_OK, scheduler_get_stats(0U, &stats));
+    ASSERT_EQ(9U, stats.worst_case_run_time);
+    ASSERT_EQ(0U, stats.deadline_misses);
+    ASSERT_EQ(2U, stats.run_count);
+
+    // Overrunning its period is a deadline miss, following releases are realigned on the original schedule
+    fake_now = 20U;
+    run_times[0U] = 25U;
+    run_ticks(1U);
+    ASSERT_EQ(SCHEDULER_ERROR_OK, scheduler_get_stats(0U, &stats));
+    ASSERT_EQ(25U, stats.worst_case_run_time);
+    ASSERT_EQ(1U, stats.deadline_misses);
+    ASSERT_EQ(3U, stats.run_count);
+
+    // Releases missed while overrunning (ticks 30 and 40) are skipped, next runs happen on ticks 50 and 60
+    run_times[0U] = 0U;
+    runs.clear();
+    run_ticks(15U);
+    std::vector<uint8_t> expected = {0U, 0U};
+    ASSERT_EQ(expected, runs);
+    ASSERT_EQ(SCHEDULER_ERROR_OK, scheduler_get_stats(0U, &stats));
+    ASSERT_EQ(1U, stats.deadline_misses);
+
+    // Run time measured with a dedicated clock
+    ASSERT_EQ(SCHEDULER_ERROR_OK, scheduler_init(tasks, 2U, fake_clock, [](void) -> uint32_t { static uint32_t cycles = 0; return cycles += 100U; }));
+    ASSERT_EQ(SCHEDULER_ERROR_OK, scheduler_trigger(1U));
+    run_ticks(1U);
+    ASSERT_EQ(SCHEDULER_ERROR_OK, scheduler_get_stats(1U, &stats));
+    ASSERT_EQ(100U, stats.worst_case_run_time);
+    ASSERT_EQ(1U, stats.run_count);
+}
+
+int main(int argc, char **argv)
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,169 @@
+/*
+
+------------------
+@<FreeMyCode>
+FreeMyCode version : 1.0 RC alpha
+    Author : bebenlebricolo
+    License : 
+        name : GPLv3
+        url : https://www.gnu.org/licenses/quick-guide-gplv3.html
+    Date : 12/02/2021
+    Project : LabBenchPowerSupply
+    Description : The Lab Bench Power Supply provides a simple design based around an Arduino Nano board to convert AC main voltage into
+ smaller ones, ranging from 0V to 16V, with voltage and current regulations
+<FreeMyCode>@
+------------------
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+
+#ifndef SCHEDULER_HEADER
+#define SCHEDULER_HEADER
+
+/* Expose this API to C++ code without name mangling */
+#ifdef __cplusplus
+extern "C"
+{
+#endif /* __cplusplus */
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "config.h"
+
+/**
+ * Cooperative scheduler : tasks are described by a static table (period, offset, priority, event trigger) and run to
+ * completion, one at a time, from scheduler_dispatch(). The highest priority ready task always runs next, so a slow
+ * low priority task only delays fast ones by its own run time. Each task run time is measured, and a deadline miss is
+ * counted whenever a periodic task completes after its next release (in which case missed releases are skipped, not
+ * replayed). When no task is ready, the caller is free to put the CPU to sleep until the next interrupt.
+*/
+
+/*  ####################################################################################
+    ############################ Data types declaration ################################
+    #################################################################################### */
+
+/**
+ * @brief lists available error types for the scheduler
+*/
+typedef enum
+{
+    SCHEDULER_ERROR_OK,             /**< Action was successful                                      */
+    SCHEDULER_ERROR_NULL_POINTER,   /**< Given pointer not initialised                              */
+    SCHEDULER_ERROR_INVALID_INDEX,  /**< Task index is out of bounds or task cannot be triggered    */
+    SCHEDULER_ERROR_CONFIG,         /**< Task table is out of range                                 */
+    SCHEDULER_ERROR_UNINITIALISED,  /**< Scheduler is not initialised                               */
+} scheduler_error_t;
+
+/**
+ * @brief task body, runs to completion
+*/
+typedef void (*scheduler_task_function_t)(void);
+
+/**
+ * @brief time source, returns a free running counter (wrapping around modulo 2^32)
+*/
+typedef uint32_t (*scheduler_clock_t)(void);
+
+/**
+ * @brief static description of a task
+*/
+typedef struct
+{
+    scheduler_task_function_t function; /**< Task body                                                                  */
+    uint32_t period;                    /**< Release period, in clock ticks. 0 for tasks which only run on events       */
+    uint32_t offset;                    /**< First release, in clock ticks after scheduler_init() (spreads tasks load)  */
+    uint8_t priority;                   /**< 0 is the most urgent. Equal priorities run in table order                  */
+    bool event_triggered;               /**< Task can also be released with scheduler_trigger()                         */
+} scheduler_task_t;
+
+/**
+ * @brief run time statistics of a task
+*/
+typedef struct
+{
+    uint32_t worst_case_run_time;       /**< Longest run time, in runtime clock ticks                           */
+    uint16_t deadline_misses;           /**< Periodic runs which completed after next release (saturates)       */
+    uint16_t run_count;                 /**< Number of runs (wraps around)                                      */
+} scheduler_task_stats_t;
+
+/*  ####################################################################################
+    ############################ Functions declarations ################################
+    #################################################################################### */
+
+/**
+ * @brief initialises the scheduler with a task table and clears all statistics. Periodic tasks are first released
+ * 'offset' ticks from now
+ * @param[in] tasks         : task table, shall remain valid while scheduler is used
+ * @param[in] count         : number of tasks in the table (up to SCHEDULER_MAX_TASKS)
+ * @param[in] clock         : time source used for releases and deadlines
+ * @param[in] runtime_clock : finer time source used to measure run times, NULL to use 'clock'
+ * @return
+ *      SCHEDULER_ERROR_OK            : operation succeeded
+ *      SCHEDULER_ERROR_NULL_POINTER  : tasks or clock is NULL
+ *      SCHEDULER_ERROR_CONFIG        : table is empty or too big, or a task has no function or can never be released
+*/
+scheduler_error_t scheduler_init(const scheduler_task_t * const tasks, const uint8_t count, const scheduler_clock_t clock, const scheduler_clock_t runtime_clock);
+
+/**
+ * @brief releases an event triggered task, it will run at next dispatch (according to its priority).
+ * Can be called from an ISR. Several triggers before the task runs result in a single run.
+ * @param[in] task : index of the task in the table
+ * @return
+ *      SCHEDULER_ERROR_OK            : operation succeeded
+ *      SCHEDULER_ERROR_UNINITIALISED : scheduler is not initialised
+ *      SCHEDULER_ERROR_INVALID_INDEX : index is out of bounds or task is not event triggered
+*/
+scheduler_error_t scheduler_trigger(const uint8_t task);
+
+/**
+ * @brief runs the highest priority ready task, if any. To be called from the main loop
+ * @param[out] idle : true when no task was ready (CPU may sleep until next interrupt)
+ * @return
+ *      SCHEDULER_ERROR_OK            : operation succeeded
+ *      SCHEDULER_ERROR_NULL_POINTER  : idle is NULL
+ *      SCHEDULER_ERROR_UNINITIALISED : scheduler is not initialised
+*/
+scheduler_error_t scheduler_dispatch(bool * const idle);
+
+/**
+ * @brief tells whether a task is ready, without running it. Meant to be called with interrupts disabled right before
+ * sleeping : an event raised after scheduler_dispatch() reported idle is not left waiting for the next interrupt
+ * @param[out] idle : true when no task is ready
+ * @return
+ *      SCHEDULER_ERROR_OK            : operation succeeded
+ *      SCHEDULER_ERROR_NULL_POINTER  : idle is NULL
+ *      SCHEDULER_ERROR_UNINITIALISED : scheduler is not initialised
+*/
+scheduler_error_t scheduler_is_idle(bool * const idle);
+
+/**
+ * @brief reads the run time statistics of a task
+ * @param[in]  task  : index of the task in the table
+ * @param[out] stats : task statistics
+ * @return
+ *      SCHEDULER_ERROR_OK            : operation succeeded
+ *      SCHEDULER_ERROR_NULL_POINTER  : stats is NULL
+ *      SCHEDULER_ERROR_UNINITIALISED : scheduler is not initialised
+ *      SCHEDULER_ERROR_INVALID_INDEX : index is out of bounds
+*/
+scheduler_error_t scheduler_get_stats(const uint8_t task, scheduler_task_stats_t * const stats);
+
+/* Expose this API to C++ code without name mangling */
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* SCHEDULER_HEADER */
@@ -0,0 +1,254 @@
+/*
+
+------------------
+@<FreeMyCode>
+FreeMyCode version : 1.0 RC alpha
+    Author : bebenlebricolo
+    License : 
+        name : GPLv3
+        url : https://www.gnu.org/licenses/quick-guide-gplv3.html
+    Date : 12/02/2021
+    Project : LabBenchPowerSupply
+    Description : The Lab Bench Power Supply provides a simple design based around an Arduino Nano board to convert AC main voltage into
+ smaller ones, ranging from 0V to 16V, with voltage and current regulations
+<FreeMyCode>@
+------------------
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+
+#include <stddef.h>
+#include "scheduler.h"
+
+#ifndef SCHEDULER_MAX_TASKS
+    #error "SCHEDULER_MAX_TASKS define is missing, please set the maximum number of scheduled tasks in your config.h"
+#endif
+
+#define NO_TASK 0xFFU
+
+typedef struct
+{
+    uint32_t next_release;          /**< Clock tick of next periodic release                        */
+    volatile bool event_pending;    /**< Set by scheduler_trigger(), possibly from an ISR           */
+    scheduler_task_stats_t stats;
+} scheduler_task_state_t;
+
+static struct
+{
+    const scheduler_task_t * tasks;
+    scheduler_clock_t clock;
+    scheduler_clock_t runtime_clock;
+    scheduler_task_state_t states[SCHEDULER_MAX_TASKS];
+    uint8_t count;
+    bool initialised;
+} scheduler = {0};
+
+/* Free running clocks wrap around : compare through signed difference */
+static inline bool is_reached(const uint32_t now, const uint32_t tick)
+{
+    return ((int32_t)(now - tick)) >= 0;
+}
+
+static inline bool is_task_valid(const scheduler_task_t * const task)
+{
+    return (NULL != task->function) && ((0U != task->period) || task->event_triggered);
+}
+
+static inline bool is_periodic_release_due(const uint8_t index, const uint32_t now)
+{
+    return (0U != scheduler.tasks[index].period) && is_reached(now, scheduler.states[index].next_release);
+}
+
+/* Highest priority ready task, NO_TASK if none */
+static uint8_t select_ready_task(const uint32_t now)
+{
+    uint8_t selected = NO_TASK;
+    for (uint8_t i = 0 ; i < scheduler.count ; i++)
+    {
+        const bool ready = scheduler.states[i].event_pending || is_periodic_release_due(i, now);
+        if (ready && ((NO_TASK == selected) || (scheduler.tasks[i].priority < scheduler.tasks[selected].priority)))
+        {
+            selected = i;
+        }
+    }
+    return selected;
+}
+
+static void update_periodic_release(const uint8_t index)
+{
+    const uint32_t period = scheduler.tasks[index].period;
+    scheduler_task_state_t * const state = &scheduler.states[index];
+    const uint32_t end = scheduler.clock();
+
+    // Task shall complete before being released again
+    state->next_release += period;
+    if (false == is_reached(state->next_release, end))
+    {
+        if (state->stats.deadline_misses < UINT16_MAX)
+        {
+            state->stats.deadline_misses++;
+        }
+        // Skip missed releases instead of replaying them : next run is aligned on the original schedule
+        state->next_release += ((end - state->next_release) / period + 1U) * period;
+    }
+}
+
+scheduler_error_t scheduler_init(const scheduler_task_t * const tasks, const uint8_t count, const scheduler_clock_t clock, const scheduler_clock_t runtime_clock)
+{
+    scheduler_error_t ret = SCHEDULER_ERROR_OK;
+    if ((NULL == tasks) || (NULL == clock))
+    {
+        ret = SCHEDULER_ERROR_NULL_POINTER;
+    }
+    else if ((0U == count) || (count > SCHEDULER_MAX_TASKS))
+    {
+        ret = SCHEDULER_ERROR_CONFIG;
+    }
+    else
+    {
+        for (uint8_t i = 0 ; i < count ; i++)
+        {
+            if (false == is_task_valid(&tasks[i]))
+            {
+                ret = SCHEDULER_ERROR_CONFIG;
+            }
+        }
+    }
+
+    if (SCHEDULER_ERROR_OK == ret)
+    {
+        scheduler.initialised = false;
+        scheduler.tasks = tasks;
+        scheduler.count = count;
+        scheduler.clock = clock;
+        scheduler.runtime_clock = (NULL != runtime_clock) ? runtime_clock : clock;
+
+        const uint32_t now = clock();
+        for (uint8_t i = 0 ; i < count ; i++)
+        {
+            scheduler.states[i].next_release = now + tasks[i].offset;
+            scheduler.states[i].event_pending = false;
+            scheduler.states[i].stats.worst_case_run_time = 0;
+            scheduler.states[i].stats.deadline_misses = 0;
+            scheduler.states[i].stats.run_count = 0;
+        }
+        scheduler.initialised = true;
+    }
+    return ret;
+}
+
+scheduler_error_t scheduler_trigger(const uint8_t task)
+{
+    scheduler_error_t ret = SCHEDULER_ERROR_OK;
+    if (false == scheduler.initialised)
+    {
+        ret = SCHEDULER_ERROR_UNINITIALISED;
+    }
+    else if ((task >= scheduler.count) || (false == scheduler.tasks[task].event_triggered))
+    {
+        ret = SCHEDULER_ERROR_INVALID_INDEX;
+    }
+    else
+    {
+        scheduler.states[task].event_pending = true;
+    }
+    return ret;
+}
+
+scheduler_error_t scheduler_dispatch(bool * const idle)
+{
+    scheduler_error_t ret = SCHEDULER_ERROR_OK;
+    if (NULL == idle)
+    {
+        ret = SCHEDULER_ERROR_NULL_POINTER;
+    }
+    else if (false == scheduler.initialised)
+    {
+        ret = SCHEDULER_ERROR_UNINITIALISED;
+    }
+    else
+    {
+        const uint32_t now = scheduler.clock();
+        const uint8_t selected = select_ready_task(now);
+
+        *idle = (NO_TASK == selected);
+        if (NO_TASK != selected)
+        {
+            scheduler_task_state_t * const state = &scheduler.states[selected];
+            const bool periodic_release = is_periodic_release_due(selected, now);
+
+            // Cleared before running : an event raised while the task runs releases it once more
+            state->event_pending = false;
+
+            const uint32_t start = scheduler.runtime_clock();
+            scheduler.tasks[selected].function();
+            const uint32_t run_time = scheduler.runtime_clock() - start;
+
+            if (run_time > state->stats.worst_case_run_time)
+            {
+                state->stats.worst_case_run_time = run_time;
+            }
+            state->stats.run_count++;
+
+            if (periodic_release)
+            {
+                update_periodic_release(selected);
+            }
+        }
+    }
+    return ret;
+}
+
+scheduler_error_t scheduler_is_idle(bool * const idle)
+{
+    scheduler_error_t ret = SCHEDULER_ERROR_OK;
+    if (NULL == idle)
+    {
+        ret = SCHEDULER_ERROR_NULL_POINTER;
+    }
+    else if (false == scheduler.initialised)
+    {
+        ret = SCHEDULER_ERROR_UNINITIALISED;
+    }
+    else
+    {
+        *idle = (NO_TASK == select_ready_task(scheduler.clock()));
+    }
+    return ret;
+}
+
+scheduler_error_t scheduler_get_stats(const uint8_t task, scheduler_task_stats_t * const stats)
+{
+    scheduler_error_t ret = SCHEDULER_ERROR_OK;
+    if (NULL == stats)
+    {
+        ret = SCHEDULER_ERROR_NULL_POINTER;
+    }
+    else if (false == scheduler.initialised)
+    {
+        ret = SCHEDULER_ERROR_UNINITIALISED;
+    }
+    else if (task >= scheduler.count)
+    {
+        ret = SCHEDULER_ERROR_INVALID_INDEX;
+    }
+    else
+    {
+        stats->worst_case_run_time = scheduler.states[task].stats.worst_case_run_time;
+        stats->deadline_misses = scheduler.states[task].stats.deadline_misses;
+        stats->run_count = scheduler.states[task].stats.run_count;
+    }
+    return ret;
+}
@@ -36,6 +36,8 @@ typedef struct
     timer_16_bit_prescaler_selection_t prescaler;
     uint16_t ocra;
     uint32_t accumulator;
+    uint16_t counter;
+    bool compare_match_a_flag;
     bool initialised;
 } configuration_t;
 
@@ -58,6 +60,12 @@ void timer_16_bit_stub_set_initialised(const bool initialised)
     configuration.initialised = initialised;
 }
 
+void timer_16_bit_stub_set_counter(const uint16_t counter, const bool compare_match_a_flag)
+{
+    configuration.counter = counter;
+    configuration.compare_match_a_flag = compare_match_a_flag;
+}
+
 void timer_16_bit_stub_reset(void)
 {
     memset(&configuration, 0, sizeof(configuration_t));
@@ -377,7 +385,17 @@ timer_error_t timer_16_bit_get_counter_value(uint8_t id, uint16_t * const ticks)
     {
         return TIMER_ERROR_UNKNOWN_TIMER;
     };
-    (void) ticks;
+    *ticks = configuration.counter;
+    return TIMER_ERROR_OK;
+}
+
+timer_error_t timer_16_bit_get_compare_match_a_flag(uint8_t id, bool * const raised)
+{
+    if (!id_is_valid(id))
+    {
+        return TIMER_ERROR_UNKNOWN_TIMER;
+    };
+    *raised = configuration.compare_match_a_flag;
     return TIMER_ERROR_OK;
 }
 
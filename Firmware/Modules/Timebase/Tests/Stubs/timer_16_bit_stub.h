@@ -42,6 +42,7 @@ extern "C"
 void timer_16_bit_stub_set_next_parameters(const timer_16_bit_prescaler_selection_t prescaler, const uint16_t ocra, const uint32_t accumulator);
 void timer_16_bit_stub_set_initialised(const bool initialised);
 void timer_16_bit_stub_reset(void);
+void timer_16_bit_stub_set_counter(const uint16_t counter, const bool compare_match_a_flag);
 #ifdef __cplusplus
 }
 #endif
@@ -42,6 +42,7 @@ extern "C"
 void timer_8_bit_async_stub_set_next_parameters(const timer_8_bit_async_prescaler_selection_t prescaler, const uint8_t ocra, const uint32_t accumulator);
 void timer_8_bit_async_stub_set_initialised(const bool initialised);
 void timer_8_bit_async_stub_reset(void);
+void timer_8_bit_async_stub_set_counter(const uint8_t counter, const bool compare_match_a_flag);
 #ifdef __cplusplus
 }
 #endif
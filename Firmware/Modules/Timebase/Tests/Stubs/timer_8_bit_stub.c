@@ -37,6 +37,8 @@ typedef struct
     timer_8_bit_prescaler_selection_t prescaler;
     uint8_t ocra;
     uint32_t accumulator;
+    uint8_t counter;
+    bool compare_match_a_flag;
     bool initialised;
     timer_8_bit_config_t driver_config;
 } configuration_t;
@@ -60,6 +62,12 @@ void timer_8_bit_stub_set_initialised(const bool initialised)
     configuration.initialised = initialised;
 }
 
+void timer_8_bit_stub_set_counter(const uint8_t counter, const bool compare_match_a_flag)
+{
+    configuration.counter = counter;
+    configuration.compare_match_a_flag = compare_match_a_flag;
+}
+
 void timer_8_bit_stub_reset(void)
 {
     memset(&configuration, 0, sizeof(configuration_t));
@@ -320,21 +328,31 @@ timer_error_t timer_8_bit_set_counter_value(uint8_t id, const uint8_t ticks)
 
 timer_error_t timer_8_bit_get_counter_value(uint8_t id, uint8_t * ticks)
 {
-    (void) ticks;
     if (!id_is_valid(id))
     {
         return TIMER_ERROR_UNKNOWN_TIMER;
     };
+    *ticks = configuration.counter;
+    return TIMER_ERROR_OK;
+}
+
+timer_error_t timer_8_bit_get_compare_match_a_flag(uint8_t id, bool * const raised)
+{
+    if (!id_is_valid(id))
+    {
+        return TIMER_ERROR_UNKNOWN_TIMER;
+    };
+    *raised = configuration.compare_match_a_flag;
     return TIMER_ERROR_OK;
 }
 
 timer_error_t timer_8_bit_set_ocra_register_value(uint8_t id, uint8_t ocra)
 {
-    (void) ocra;
     if (!id_is_valid(id))
     {
         return TIMER_ERROR_UNKNOWN_TIMER;
     };
+    configuration.driver_config.timing_config.ocra_val = ocra;
     return TIMER_ERROR_OK;
 }
 
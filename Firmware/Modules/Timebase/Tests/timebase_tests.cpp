@@ -50,6 +50,7 @@ public:
         timer_8_bit_async_stub_reset();
         timer_16_bit_stub_reset();
 
+        memset(&config, 0, sizeof(timebase_config_t));
         config.cpu_freq = 16'000'000;
         config.timescale = TIMEBASE_TIMESCALE_MILLISECONDS;
         config.timer.type = TIMEBASE_TIMER_16_BIT;
@@ -88,6 +89,7 @@ public:
 TEST(timebase_module_tests, test_compute_timer_parameters)
 {
     timebase_config_t config;
+    memset(&config, 0, sizeof(timebase_config_t));
     config.cpu_freq = 16'000'000;
     config.timescale = TIMEBASE_TIMESCALE_MILLISECONDS;
     config.timer.type = TIMEBASE_TIMER_16_BIT;
@@ -96,19 +98,21 @@ TEST(timebase_module_tests, test_compute_timer_parameters)
     uint16_t prescaler = 0;
     uint16_t ocr_value = 0;
     uint16_t accumulator = 0;
+    int32_t period_error_ppb = 0;
 
     timer_16_bit_stub_set_next_parameters(TIMER16BIT_CLK_PRESCALER_1, 15999U, 0U);
 
-    timebase_error_t err = timebase_compute_timer_parameters(&config, &prescaler, &ocr_value, &accumulator);
+    timebase_error_t err = timebase_compute_timer_parameters(&config, &prescaler, &ocr_value, &accumulator, &period_error_ppb);
     ASSERT_EQ(TIMEBASE_ERROR_OK, err);
     ASSERT_EQ(0U, accumulator);
     ASSERT_EQ(prescaler, 1U);
     ASSERT_EQ(ocr_value, 15999U);
+    ASSERT_EQ(0, period_error_ppb);
 
     config.timer.type = TIMEBASE_TIMER_8_BIT;
     config.timer.index = 0U;
     timer_8_bit_stub_set_next_parameters(TIMER8BIT_CLK_PRESCALER_64, 250, 3U);
-    err = timebase_compute_timer_parameters(&config, &prescaler, &ocr_value, &accumulator);
+    err = timebase_compute_timer_parameters(&config, &prescaler, &ocr_value, &accumulator, &period_error_ppb);
     ASSERT_EQ(TIMEBASE_ERROR_OK, err);
     ASSERT_EQ(3U, accumulator);
     ASSERT_EQ(prescaler, 64U);
@@ -117,11 +121,20 @@ TEST(timebase_module_tests, test_compute_timer_parameters)
     config.timer.type = TIMEBASE_TIMER_8_BIT_ASYNC;
     config.timer.index = 0U;
     timer_8_bit_async_stub_set_next_parameters(TIMER8BIT_ASYNC_CLK_PRESCALER_1024, 127, 4U);
-    err = timebase_compute_timer_parameters(&config, &prescaler, &ocr_value, &accumulator);
+    err = timebase_compute_timer_parameters(&config, &prescaler, &ocr_value, &accumulator, &period_error_ppb);
     ASSERT_EQ(TIMEBASE_ERROR_OK, err);
     ASSERT_EQ(4U, accumulator);
     ASSERT_EQ(prescaler, 1024);
     ASSERT_EQ(ocr_value, 127U);
+
+    // 3 kHz : 83.33 counts per tick with a 64 prescaler, hardware tick is a third of a count short
+    config.timer.type = TIMEBASE_TIMER_8_BIT;
+    config.timescale = TIMEBASE_TIMESCALE_CUSTOM;
+    config.custom_target_freq = 3000U;
+    timer_8_bit_stub_set_next_parameters(TIMER8BIT_CLK_PRESCALER_64, 82U, 0U);
+    err = timebase_compute_timer_parameters(&config, &prescaler, &ocr_value, &accumulator, &period_error_ppb);
+    ASSERT_EQ(TIMEBASE_ERROR_OK, err);
+    ASSERT_EQ(-4000000, period_error_ppb);
 }
 
 TEST(timebase_module_test, test_guard_wrong_parameters)
@@ -132,21 +145,25 @@ TEST(timebase_module_test, test_guard_wrong_parameters)
         uint16_t * null_prescaler = nullptr;
         uint16_t * null_ocr_value = nullptr;
         uint16_t * null_accumulator = nullptr;
-        auto ret = timebase_compute_timer_parameters(&config, null_prescaler, null_ocr_value, null_accumulator);
+        int32_t * null_period_error = nullptr;
+        auto ret = timebase_compute_timer_parameters(&config, null_prescaler, null_ocr_value, null_accumulator, null_period_error);
         ASSERT_EQ(ret, TIMEBASE_ERROR_NULL_POINTER);
         uint16_t prescaler = 0;
         uint16_t accumulator = 0;
         uint16_t ocr_value  = 0;
+        int32_t period_error_ppb = 0;
+        ret = timebase_compute_timer_parameters(&config, &prescaler, &ocr_value, &accumulator, null_period_error);
+        ASSERT_EQ(ret, TIMEBASE_ERROR_NULL_POINTER);
 
         // Forcing a wrong timer type
         config.timer.type = TIMEBASE_TIMER_UNDEFINED;
         config.timescale = TIMEBASE_TIMESCALE_MICROSECONDS;
-        ret = timebase_compute_timer_parameters(&config, &prescaler, &ocr_value, &accumulator);
+        ret = timebase_compute_timer_parameters(&config, &prescaler, &ocr_value, &accumulator, &period_error_ppb);
         ASSERT_EQ(ret, TIMEBASE_ERROR_UNSUPPORTED_TIMER_TYPE);
 
         config.timer.type = TIMEBASE_TIMER_16_BIT;
         config.timescale = TIMEBASE_TIMESCALE_UNDEFINED;
-        ret = timebase_compute_timer_parameters(&config, &prescaler, &ocr_value, &accumulator);
+        ret = timebase_compute_timer_parameters(&config, &prescaler, &ocr_value, &accumulator, &period_error_ppb);
         ASSERT_EQ(ret, TIMEBASE_ERROR_UNSUPPORTED_TIMESCALE);
     }
     {
@@ -179,7 +196,7 @@ TEST(timebase_module_test, test_guard_wrong_parameters)
         ASSERT_EQ(ret, TIMEBASE_ERROR_UNINITIALISED);
     }
     {
-        uint16_t ticks = 0;
+        uint32_t ticks = 0;
         auto ret = timebase_get_tick(0U, nullptr);
         ASSERT_EQ(ret, TIMEBASE_ERROR_NULL_POINTER);
 
@@ -195,8 +212,8 @@ TEST(timebase_module_test, test_guard_wrong_parameters)
         ASSERT_EQ(ret, TIMEBASE_ERROR_NULL_POINTER);
     }
     {
-        uint16_t duration = 0;
-        uint16_t reference = 0;
+        uint32_t duration = 0;
+        uint32_t reference = 0;
 
         auto ret = timebase_get_duration_now(0U,nullptr, nullptr);
         ASSERT_EQ(ret, TIMEBASE_ERROR_NULL_POINTER);
@@ -213,6 +230,7 @@ TEST(timebase_module_test, test_guard_wrong_parameters)
 TEST(timebase_module_tests, test_wrong_index_error_forwarding)
 {
     timebase_config_t config;
+    memset(&config, 0, sizeof(timebase_config_t));
     config.cpu_freq = 16'000'000;
     config.timescale = TIMEBASE_TIMESCALE_MILLISECONDS;
 
@@ -240,6 +258,7 @@ TEST(timebase_module_tests, test_wrong_index_error_forwarding)
 TEST(timebase_module_tests, test_uninitialised_timer_error)
 {
     timebase_config_t config;
+    memset(&config, 0, sizeof(timebase_config_t));
     config.cpu_freq = 16'000'000;
     config.timescale = TIMEBASE_TIMESCALE_MILLISECONDS;
     config.timer.type = TIMEBASE_TIMER_16_BIT;
@@ -281,9 +300,9 @@ TEST_F(TimebaseModuleBasicConfig, test_timer_initialisation)
 
 TEST_F(TimebaseModule8BitInitialised, test_ticks_and_durations)
 {
-    uint16_t tick = 0;
-    uint16_t duration = 0;
-    uint16_t reference = 153U;
+    uint32_t tick = 0;
+    uint32_t duration = 0;
+    uint32_t reference = 153U;
     timebase_internal_config[0U].tick = 1652U;
 
     timebase_error_t err = timebase_get_tick(0U, &tick);
@@ -298,14 +317,503 @@ TEST_F(TimebaseModule8BitInitialised, test_ticks_and_durations)
     ASSERT_EQ(err, TIMEBASE_ERROR_OK);
     ASSERT_EQ(duration, timebase_internal_config[0U].tick - reference);
 
+    // Durations longer than 65.5 seconds
+    timebase_internal_config[0U].tick = 3600000UL;
+    reference = 12563;
+    err = timebase_get_duration_now(0U, &reference, &duration);
+    ASSERT_EQ(err, TIMEBASE_ERROR_OK);
+    ASSERT_EQ(duration, 3600000UL - 12563UL);
+
     // Overflowing case
     timebase_internal_config[0U].tick = 356;
-    reference = 12563;
+    reference = UINT32_MAX - 99UL;
     err = timebase_get_duration_now(0U, &reference, &duration);
     ASSERT_EQ(err, TIMEBASE_ERROR_OK);
-    ASSERT_EQ(duration,((uint32_t) (timebase_internal_config[0U].tick) + USHRT_MAX) - (uint32_t) reference);
+    ASSERT_EQ(duration, 356UL + 100UL);
+}
+
+TEST_F(TimebaseModule8BitInitialised, test_tick_carries_over_16_bits)
+{
+    // No accumulator : each interrupt is a new tick
+    timebase_internal_config[0U].accumulator.programmed = 0;
+    timebase_internal_config[0U].tick = UINT16_MAX;
+    uint32_t reference = 0;
+    ASSERT_EQ(TIMEBASE_ERROR_OK, timebase_get_tick(0U, &reference));
+
+    timebase_interrupt_callback(0U);
+    timebase_interrupt_callback(0U);
+
+    uint32_t tick = 0;
+    uint32_t duration = 0;
+    ASSERT_EQ(TIMEBASE_ERROR_OK, timebase_get_tick(0U, &tick));
+    ASSERT_EQ(UINT16_MAX + 2UL, tick);
+    ASSERT_EQ(TIMEBASE_ERROR_OK, timebase_get_duration(&reference, &tick, &duration));
+    ASSERT_EQ(2U, duration);
+}
+
+
+TEST_F(TimebaseModuleBasicConfig, test_timestamps)
+{
+    uint32_t timestamp = 0;
+    ASSERT_EQ(TIMEBASE_ERROR_INVALID_INDEX, timebase_get_timestamp_us(TIMEBASE_MAX_MODULES, &timestamp));
+    ASSERT_EQ(TIMEBASE_ERROR_NULL_POINTER, timebase_get_timestamp_us(0U, nullptr));
+    timebase_deinit(0U);
+    ASSERT_EQ(TIMEBASE_ERROR_UNINITIALISED, timebase_get_timestamp_us(0U, &timestamp));
+
+    // 16 MHz, prescaler 64 : 4 us per count, compare match every 250 counts (1 ms)
+    timer_8_bit_stub_set_initialised(true);
+    config.timer.type = TIMEBASE_TIMER_8_BIT;
+    timer_8_bit_stub_set_next_parameters(TIMER8BIT_CLK_PRESCALER_64, 249U, 0U);
+    ASSERT_EQ(TIMEBASE_ERROR_OK, timebase_init(0U, &config));
+    timebase_internal_config[0U].tick = 1234U;
+
+    timer_8_bit_stub_set_counter(100U, false);
+    ASSERT_EQ(TIMEBASE_ERROR_OK, timebase_get_timestamp_us(0U, &timestamp));
+    ASSERT_EQ(1234400UL, timestamp);
+
+    timer_8_bit_stub_set_counter(249U, false);
+    ASSERT_EQ(TIMEBASE_ERROR_OK, timebase_get_timestamp_us(0U, &timestamp));
+    ASSERT_EQ(1234996UL, timestamp);
+
+    // Counter wrapped around but ISR did not run yet : timestamp still moves forward
+    timer_8_bit_stub_set_counter(3U, true);
+    ASSERT_EQ(TIMEBASE_ERROR_OK, timebase_get_timestamp_us(0U, &timestamp));
+    ASSERT_EQ(1235012UL, timestamp);
+
+    // Two compare matches per tick
+    timer_8_bit_stub_set_next_parameters(TIMER8BIT_CLK_PRESCALER_64, 124U, 1U);
+    ASSERT_EQ(TIMEBASE_ERROR_OK, timebase_init(0U, &config));
+    timebase_internal_config[0U].tick = 10U;
+    timebase_internal_config[0U].accumulator.running = 1U;
+    timer_8_bit_stub_set_counter(10U, false);
+    ASSERT_EQ(TIMEBASE_ERROR_OK, timebase_get_timestamp_us(0U, &timestamp));
+    ASSERT_EQ(10540UL, timestamp);
+
+    // Pending compare match completes the tick
+    timer_8_bit_stub_set_counter(0U, true);
+    ASSERT_EQ(TIMEBASE_ERROR_OK, timebase_get_timestamp_us(0U, &timestamp));
+    ASSERT_EQ(11000UL, timestamp);
+
+    // 16 bit timer, prescaler 8 : 0.5 us per count, compare match every 2000 counts
+    timer_16_bit_stub_set_initialised(true);
+    config.timer.type = TIMEBASE_TIMER_16_BIT;
+    timer_16_bit_stub_set_next_parameters(TIMER16BIT_CLK_PRESCALER_8, 1999U, 0U);
+    ASSERT_EQ(TIMEBASE_ERROR_OK, timebase_init(1U, &config));
+    timebase_internal_config[1U].tick = 3U;
+    timer_16_bit_stub_set_counter(1999U, false);
+    ASSERT_EQ(TIMEBASE_ERROR_OK, timebase_get_timestamp_us(1U, &timestamp));
+    ASSERT_EQ(3999UL, timestamp);
+
+    // Microsecond timestamps wrap around modulo 2^32 like ticks do
+    timebase_internal_config[1U].tick = 4294968UL;
+    timer_16_bit_stub_set_counter(0U, false);
+    ASSERT_EQ(TIMEBASE_ERROR_OK, timebase_get_timestamp_us(1U, &timestamp));
+    ASSERT_EQ(704UL, timestamp);
+}
+
+TEST_F(TimebaseModuleBasicConfig, test_tickless_mode)
+{
+    // 16 MHz, prescaler 64 : 4 us per count, 250 counts per tick. Compare value goes up to 255 when nothing is due.
+    timebase_deinit(0U);
+    timer_8_bit_stub_set_initialised(true);
+    config.timer.type = TIMEBASE_TIMER_8_BIT;
+    config.tickless = true;
+    timer_8_bit_stub_set_next_parameters(TIMER8BIT_CLK_PRESCALER_64, 249U, 0U);
+    ASSERT_EQ(TIMEBASE_ERROR_OK, timebase_init(0U, &config));
+    ASSERT_EQ(255U, timebase_internal_config[0U].tickless.compare);
+    // Compare margin covers 1024 CPU cycles : 16 counts of 64 cycles
+    ASSERT_EQ(16U, timebase_internal_config[0U].tickless.margin);
+
+    bool tickless = false;
+    ASSERT_EQ(TIMEBASE_ERROR_OK, timebase_is_tickless(0U, &tickless));
+    ASSERT_TRUE(tickless);
+    ASSERT_EQ(TIMEBASE_ERROR_NULL_POINTER, timebase_is_tickless(0U, nullptr));
+    ASSERT_EQ(TIMEBASE_ERROR_INVALID_INDEX, timebase_is_tickless(TIMEBASE_MAX_MODULES, &tickless));
+
+    // Elapsed time is worked out from the counter
+    uint32_t tick = 0;
+    uint32_t timestamp = 0;
+    timer_8_bit_stub_set_counter(100U, false);
+    ASSERT_EQ(TIMEBASE_ERROR_OK, timebase_get_tick(0U, &tick));
+    ASSERT_EQ(0U, tick);
+    ASSERT_EQ(TIMEBASE_ERROR_OK, timebase_get_timestamp_us(0U, &timestamp));
+    ASSERT_EQ(400UL, timestamp);
+
+    // Compare match after 256 counts : one tick, plus 6 counts carried over
+    timer_8_bit_stub_set_counter(0U, false);
+    timebase_interrupt_callback(0U);
+    ASSERT_EQ(1U, timebase_internal_config[0U].tick);
+    ASSERT_EQ(6U, timebase_internal_config[0U].tickless.residual);
+    ASSERT_EQ(255U, timebase_internal_config[0U].tickless.compare);
+    ASSERT_EQ(TIMEBASE_ERROR_OK, timebase_get_timestamp_us(0U, &timestamp));
+    ASSERT_EQ(1024UL, timestamp);
+
+    timer_8_bit_stub_set_counter(244U, false);
+    ASSERT_EQ(TIMEBASE_ERROR_OK, timebase_get_tick(0U, &tick));
+    ASSERT_EQ(2U, tick);
+    ASSERT_EQ(TIMEBASE_ERROR_OK, timebase_get_timestamp_us(0U, &timestamp));
+    ASSERT_EQ(2000UL, timestamp);
+
+    // Pending compare match is accounted for before its ISR runs
+    timer_8_bit_stub_set_counter(3U, true);
+    ASSERT_EQ(TIMEBASE_ERROR_OK, timebase_get_tick(0U, &tick));
+    ASSERT_EQ(2U, tick);
+    ASSERT_EQ(TIMEBASE_ERROR_OK, timebase_get_timestamp_us(0U, &timestamp));
+    ASSERT_EQ(2060UL, timestamp);
+
+    // Deadline set while waiting shortens the compare period so that it ends exactly on the deadline tick
+    timer_8_bit_stub_set_counter(0U, false);
+    timebase_interrupt_callback(0U);
+    ASSERT_EQ(2U, timebase_internal_config[0U].tick);
+    ASSERT_EQ(12U, timebase_internal_config[0U].tickless.residual);
+    ASSERT_EQ(TIMEBASE_ERROR_OK, timebase_set_deadline(0U, 3U));
+    ASSERT_EQ(237U, timebase_internal_config[0U].tickless.compare);
+    timebase_interrupt_callback(0U);
+    ASSERT_EQ(3U, timebase_internal_config[0U].tick);
+    ASSERT_EQ(0U, timebase_internal_config[0U].tickless.residual);
+    ASSERT_EQ(255U, timebase_internal_config[0U].tickless.compare);
+
+    // Deadlines beyond the compare range are left to following interrupts
+    ASSERT_EQ(TIMEBASE_ERROR_OK, timebase_set_deadline(0U, 10U));
+    ASSERT_EQ(255U, timebase_internal_config[0U].tickless.compare);
+
+    // Compare value is never written behind (or right on) the running counter
+    timer_8_bit_stub_set_counter(235U, false);
+    ASSERT_EQ(TIMEBASE_ERROR_OK, timebase_set_deadline(0U, 4U));
+    ASSERT_EQ(251U, timebase_internal_config[0U].tickless.compare);
+
+    // Compare match already happened : ISR programs the next compare value
+    timer_8_bit_stub_set_counter(3U, true);
+    ASSERT_EQ(TIMEBASE_ERROR_OK, timebase_set_deadline(0U, 4U));
+    ASSERT_EQ(251U, timebase_internal_config[0U].tickless.compare);
+    timer_8_bit_stub_set_counter(0U, false);
+    timebase_interrupt_callback(0U);
+    ASSERT_EQ(4U, timebase_internal_config[0U].tick);
+    ASSERT_EQ(2U, timebase_internal_config[0U].tickless.residual);
+
+    ASSERT_EQ(TIMEBASE_ERROR_OK, timebase_cancel_deadline(0U));
+    ASSERT_FALSE(timebase_internal_config[0U].tickless.deadline_armed);
+
+    // Margin follows the prescaler : one count per CPU cycle without any
+    timer_16_bit_stub_set_initialised(true);
+    config.timer.type = TIMEBASE_TIMER_16_BIT;
+    timer_16_bit_stub_set_next_parameters(TIMER16BIT_CLK_PRESCALER_1, 15999U, 0U);
+    ASSERT_EQ(TIMEBASE_ERROR_OK, timebase_init(1U, &config));
+    ASSERT_EQ(1024U, timebase_internal_config[1U].tickless.margin);
+    timebase_deinit(1U);
+    config.timer.type = TIMEBASE_TIMER_8_BIT;
+
+    // Periodic timebases ignore deadlines
+    config.tickless = false;
+    ASSERT_EQ(TIMEBASE_ERROR_OK, timebase_init(0U, &config));
+    ASSERT_EQ(TIMEBASE_ERROR_OK, timebase_set_deadline(0U, 1U));
+    ASSERT_EQ(249U, timebase_internal_config[0U].tickless.compare);
+
+    ASSERT_EQ(TIMEBASE_ERROR_INVALID_INDEX, timebase_set_deadline(TIMEBASE_MAX_MODULES, 1U));
+    ASSERT_EQ(TIMEBASE_ERROR_INVALID_INDEX, timebase_cancel_deadline(TIMEBASE_MAX_MODULES));
+    timebase_deinit(0U);
+    ASSERT_EQ(TIMEBASE_ERROR_UNINITIALISED, timebase_set_deadline(0U, 1U));
+    ASSERT_EQ(TIMEBASE_ERROR_UNINITIALISED, timebase_cancel_deadline(0U));
+}
+
+TEST_F(TimebaseModuleBasicConfig, test_fractional_tick_period)
+{
+    // 3 kHz out of 16 MHz / 64 : 83 + 1/3 counts per tick. Every third tick is one count longer.
+    timebase_deinit(0U);
+    timer_8_bit_stub_set_initialised(true);
+    config.timer.type = TIMEBASE_TIMER_8_BIT;
+    config.timescale = TIMEBASE_TIMESCALE_CUSTOM;
+    config.custom_target_freq = 3000U;
+    timer_8_bit_stub_set_next_parameters(TIMER8BIT_CLK_PRESCALER_64, 82U, 0U);
+    ASSERT_EQ(TIMEBASE_ERROR_OK, timebase_init(0U, &config));
+    ASSERT_EQ(64000U, timebase_internal_config[0U].fraction.step);
+    ASSERT_EQ(192000U, timebase_internal_config[0U].fraction.modulus);
+    ASSERT_EQ(1, timebase_internal_config[0U].fraction.direction);
+
+    timer_8_bit_config_t driver_config;
+    const uint8_t expected_ocra[] = {82U, 82U, 83U, 82U, 82U, 83U, 82U};
+    for (uint8_t i = 0 ; i < sizeof(expected_ocra) ; i++)
+    {
+        timebase_interrupt_callback(0U);
+        timer_8_bit_stub_get_driver_configuration(&driver_config);
+        ASSERT_EQ(expected_ocra[i], driver_config.timing_config.ocra_val);
+    }
+
+    // Exactly one second worth of ticks lasts 250000 counts (each period lasts the compare value it started with + 1)
+    ASSERT_EQ(TIMEBASE_ERROR_OK, timebase_init(0U, &config));
+    uint32_t counts = 0;
+    uint8_t compare = 82U;
+    for (uint16_t i = 0 ; i < 3000U ; i++)
+    {
+        counts += compare + 1U;
+        timebase_interrupt_callback(0U);
+        timer_8_bit_stub_get_driver_configuration(&driver_config);
+        compare = driver_config.timing_config.ocra_val;
+    }
+    // Last correction belongs to the period which just started
+    ASSERT_EQ(250000UL, counts + 1U);
+    ASSERT_EQ(83U, compare);
+
+    // With an accumulator, corrected period is the first one of the tick
+    config.custom_target_freq = 1500U;
+    timer_8_bit_stub_set_next_parameters(TIMER8BIT_CLK_PRESCALER_64, 82U, 1U);
+    ASSERT_EQ(TIMEBASE_ERROR_OK, timebase_init(0U, &config));
+    ASSERT_EQ(96000U, timebase_internal_config[0U].fraction.modulus);
+    const uint8_t expected_accumulated_ocra[] = {82U, 82U, 82U, 83U, 82U};
+    for (uint8_t i = 0 ; i < sizeof(expected_accumulated_ocra) ; i++)
+    {
+        timebase_interrupt_callback(0U);
+        timer_8_bit_stub_get_driver_configuration(&driver_config);
+        ASSERT_EQ(expected_accumulated_ocra[i], driver_config.timing_config.ocra_val);
+    }
+
+    // Shortest correctable period covers 1024 CPU cycles : 100 counts are enough with a 64 prescaler, not with 8
+    config.custom_target_freq = 2503U;
+    timer_8_bit_stub_set_next_parameters(TIMER8BIT_CLK_PRESCALER_64, 99U, 0U);
+    ASSERT_EQ(TIMEBASE_ERROR_OK, timebase_init(0U, &config));
+    ASSERT_EQ(16U, timebase_internal_config[0U].fraction.min_counter_period);
+    ASSERT_EQ(-1, timebase_internal_config[0U].fraction.direction);
+    config.custom_target_freq = 20030U;
+    timer_8_bit_stub_set_next_parameters(TIMER8BIT_CLK_PRESCALER_8, 99U, 0U);
+    ASSERT_EQ(TIMEBASE_ERROR_OK, timebase_init(0U, &config));
+    ASSERT_EQ(128U, timebase_internal_config[0U].fraction.min_counter_period);
+    ASSERT_EQ(0U, timebase_internal_config[0U].fraction.step);
+
+    // Exact configurations and tickless timebases are left untouched
+    config.timescale = TIMEBASE_TIMESCALE_MILLISECONDS;
+    timer_8_bit_stub_set_next_parameters(TIMER8BIT_CLK_PRESCALER_64, 249U, 0U);
+    ASSERT_EQ(TIMEBASE_ERROR_OK, timebase_init(0U, &config));
+    ASSERT_EQ(0U, timebase_internal_config[0U].fraction.step);
+
+    config.timescale = TIMEBASE_TIMESCALE_CUSTOM;
+    config.custom_target_freq = 3000U;
+    config.tickless = true;
+    timer_8_bit_stub_set_next_parameters(TIMER8BIT_CLK_PRESCALER_64, 82U, 0U);
+    ASSERT_EQ(TIMEBASE_ERROR_OK, timebase_init(0U, &config));
+    ASSERT_EQ(0U, timebase_internal_config[0U].fraction.step);
+    timebase_deinit(0U);
+}
+
+TEST_F(TimebaseModuleBasicConfig, test_precomputed_parameters)
+{
+    // Runtime solver would return other values : precomputed ones are used as is
+    timebase_deinit(0U);
+    timer_16_bit_stub_set_initialised(true);
+    timer_16_bit_stub_set_next_parameters(TIMER16BIT_CLK_PRESCALER_1, 15999U, 0U);
+    timebase_timer_parameters_t parameters = {8U, 1999U, 0U};
+    config.parameters = &parameters;
+    ASSERT_EQ(TIMEBASE_ERROR_OK, timebase_init(0U, &config));
+    ASSERT_EQ(2000U, timebase_internal_config[0U].timestamp.counter_period);
+    ASSERT_EQ(0U, timebase_internal_config[0U].accumulator.programmed);
+    ASSERT_EQ(128U, timebase_internal_config[0U].timestamp.us_per_count_q8);
+
+    // Prescaler value which does not exist for selected timer
+    parameters.prescaler = 32U;
+    ASSERT_EQ(TIMEBASE_ERROR_INVALID_PARAMETERS, timebase_init(0U, &config));
+
+    // Compare value does not fit in a 8 bit timer
+    timer_8_bit_stub_set_initialised(true);
+    config.timer.type = TIMEBASE_TIMER_8_BIT;
+    parameters = {64U, 300U, 0U};
+    ASSERT_EQ(TIMEBASE_ERROR_INVALID_PARAMETERS, timebase_init(0U, &config));
+
+    parameters = {64U, 124U, 1U};
+    ASSERT_EQ(TIMEBASE_ERROR_OK, timebase_init(0U, &config));
+    ASSERT_EQ(125U, timebase_internal_config[0U].timestamp.counter_period);
+    ASSERT_EQ(1U, timebase_internal_config[0U].accumulator.programmed);
+    timebase_deinit(0U);
+}
+
+TEST_F(TimebaseModuleBasicConfig, test_derived_timebases)
+{
+    for (uint8_t i = 0 ; i < TIMEBASE_MAX_MODULES ; i++)
+    {
+        timebase_deinit(i);
+    }
+
+    // Derived timebases need an initialised parent
+    timebase_config_t derived_config;
+    memset(&derived_config, 0, sizeof(timebase_config_t));
+    derived_config.timer.type = TIMEBASE_TIMER_DERIVED;
+    derived_config.derived.parent = 0U;
+    derived_config.derived.divider = 10U;
+    ASSERT_EQ(TIMEBASE_ERROR_INVALID_PARENT, timebase_init(1U, &derived_config));
+    derived_config.derived.parent = TIMEBASE_MAX_MODULES;
+    ASSERT_EQ(TIMEBASE_ERROR_INVALID_PARENT, timebase_init(1U, &derived_config));
+    derived_config.derived.parent = 1U;
+    ASSERT_EQ(TIMEBASE_ERROR_INVALID_PARENT, timebase_init(1U, &derived_config));
+
+    // 16 MHz, prescaler 8 : 0.5 us per count, compare match every 200 counts (100 us)
+    timer_8_bit_stub_set_initialised(true);
+    config.timer.type = TIMEBASE_TIMER_8_BIT;
+    config.timescale = TIMEBASE_TIMESCALE_CUSTOM;
+    config.custom_target_freq = 10000U;
+    timer_8_bit_stub_set_next_parameters(TIMER8BIT_CLK_PRESCALER_8, 199U, 0U);
+    ASSERT_EQ(TIMEBASE_ERROR_OK, timebase_init(0U, &config));
+
+    derived_config.derived.parent = 0U;
+    derived_config.derived.divider = 0U;
+    ASSERT_EQ(TIMEBASE_ERROR_INVALID_PARAMETERS, timebase_init(1U, &derived_config));
+
+    // Longest derived tick still counted in 32 bits : counts times count duration needs 64 bits
+    derived_config.derived.divider = 21474836U;
+    ASSERT_EQ(TIMEBASE_ERROR_OK, timebase_init(1U, &derived_config));
+    ASSERT_EQ(4294967200UL, timebase_internal_config[1U].timestamp.counts_per_tick);
+    ASSERT_EQ(2147483600ULL << 16U, timebase_internal_config[1U].timestamp.tick_period_us_q16);
+    derived_config.derived.divider = 21474837U;
+    ASSERT_EQ(TIMEBASE_ERROR_INVALID_PARAMETERS, timebase_init(1U, &derived_config));
+
+    // Milliseconds and seconds out of the 100 us timebase
+    derived_config.derived.divider = 10U;
+    ASSERT_EQ(TIMEBASE_ERROR_OK, timebase_init(1U, &derived_config));
+    derived_config.derived.divider = 10000U;
+    ASSERT_EQ(TIMEBASE_ERROR_OK, timebase_init(2U, &derived_config));
+    ASSERT_EQ(1000ULL << 16U, timebase_internal_config[1U].timestamp.tick_period_us_q16);
+    ASSERT_EQ(1000000ULL << 16U, timebase_internal_config[2U].timestamp.tick_period_us_q16);
+
+    // Derived timebases cannot be divided any further
+    derived_config.derived.parent = 1U;
+    ASSERT_EQ(TIMEBASE_ERROR_INVALID_PARENT, timebase_init(2U, &derived_config));
+    derived_config.derived.parent = 0U;
+    ASSERT_EQ(TIMEBASE_ERROR_OK, timebase_init(2U, &derived_config));
+
+    uint32_t tick = 0;
+    for (uint32_t i = 0 ; i < 9U ; i++)
+    {
+        timebase_interrupt_callback(0U);
+    }
+    ASSERT_EQ(TIMEBASE_ERROR_OK, timebase_get_tick(1U, &tick));
+    ASSERT_EQ(0U, tick);
+    timebase_interrupt_callback(0U);
+    ASSERT_EQ(TIMEBASE_ERROR_OK, timebase_get_tick(1U, &tick));
+    ASSERT_EQ(1U, tick);
+
+    // Derived instances have no interrupt of their own
+    timebase_interrupt_callback(1U);
+    ASSERT_EQ(TIMEBASE_ERROR_OK, timebase_get_tick(1U, &tick));
+    ASSERT_EQ(1U, tick);
+
+    for (uint32_t i = 10U ; i < 10000U ; i++)
+    {
+        timebase_interrupt_callback(0U);
+    }
+    ASSERT_EQ(TIMEBASE_ERROR_OK, timebase_get_tick(0U, &tick));
+    ASSERT_EQ(10000U, tick);
+    ASSERT_EQ(TIMEBASE_ERROR_OK, timebase_get_tick(1U, &tick));
+    ASSERT_EQ(1000U, tick);
+    ASSERT_EQ(TIMEBASE_ERROR_OK, timebase_get_tick(2U, &tick));
+    ASSERT_EQ(1U, tick);
+
+    // 3 parent ticks and 100 counts into the current millisecond
+    for (uint32_t i = 0 ; i < 3U ; i++)
+    {
+        timebase_interrupt_callback(0U);
+    }
+    uint32_t timestamp = 0;
+    timer_8_bit_stub_set_counter(100U, false);
+    ASSERT_EQ(TIMEBASE_ERROR_OK, timebase_get_timestamp_us(1U, &timestamp));
+    ASSERT_EQ(1000350UL, timestamp);
+    ASSERT_EQ(TIMEBASE_ERROR_OK, timebase_get_timestamp_us(2U, &timestamp));
+    ASSERT_EQ(1000350UL, timestamp);
+
+    // Pending parent compare match is accounted for
+    timer_8_bit_stub_set_counter(0U, true);
+    ASSERT_EQ(TIMEBASE_ERROR_OK, timebase_get_timestamp_us(1U, &timestamp));
+    ASSERT_EQ(1000400UL, timestamp);
+
+    // Tickless timebases do not interrupt on each tick
+    timebase_deinit(0U);
+    ASSERT_EQ(TIMEBASE_ERROR_INVALID_PARENT, timebase_get_timestamp_us(1U, &timestamp));
+    config.tickless = true;
+    ASSERT_EQ(TIMEBASE_ERROR_OK, timebase_init(0U, &config));
+    ASSERT_EQ(TIMEBASE_ERROR_INVALID_PARENT, timebase_init(1U, &derived_config));
+
+    for (uint8_t i = 0 ; i < TIMEBASE_MAX_MODULES ; i++)
+    {
+        timebase_deinit(i);
+    }
 }
 
+TEST_F(TimebaseModuleBasicConfig, test_timestamp_long_tick)
+{
+    for (uint8_t i = 0 ; i < TIMEBASE_MAX_MODULES ; i++)
+    {
+        timebase_deinit(i);
+    }
+
+    // 16 MHz, prescaler 8 : 0.5 us per count, 200 counts per parent tick. 20 s derived ticks last 4e7 counts
+    timer_8_bit_stub_set_initialised(true);
+    config.timer.type = TIMEBASE_TIMER_8_BIT;
+    config.timescale = TIMEBASE_TIMESCALE_CUSTOM;
+    config.custom_target_freq = 10000U;
+    timer_8_bit_stub_set_next_parameters(TIMER8BIT_CLK_PRESCALER_8, 199U, 0U);
+    ASSERT_EQ(TIMEBASE_ERROR_OK, timebase_init(0U, &config));
+
+    timebase_config_t derived_config;
+    memset(&derived_config, 0, sizeof(timebase_config_t));
+    derived_config.timer.type = TIMEBASE_TIMER_DERIVED;
+    derived_config.derived.parent = 0U;
+    derived_config.derived.divider = 200000U;
+    ASSERT_EQ(TIMEBASE_ERROR_OK, timebase_init(1U, &derived_config));
+    // A failed re-initialisation in a previous test may have left a stale tick behind
+    timebase_internal_config[1U].tick = 0U;
+
+    // 18 s into the first tick : elapsed counts times count duration (in 1/256 us) no longer fits in 32 bits
+    for (uint32_t i = 0 ; i < 180000U ; i++)
+    {
+        timebase_interrupt_callback(0U);
+    }
+    uint32_t timestamp = 0;
+    timer_8_bit_stub_set_counter(100U, false);
+    ASSERT_EQ(TIMEBASE_ERROR_OK, timebase_get_timestamp_us(1U, &timestamp));
+    ASSERT_EQ(18000050UL, timestamp);
+
+    for (uint8_t i = 0 ; i < TIMEBASE_MAX_MODULES ; i++)
+    {
+        timebase_deinit(i);
+    }
+}
+
+TEST_F(TimebaseModuleBasicConfig, test_timestamp_fractional_tick_period)
+{
+    // 3 kHz out of 16 MHz / 64 : ticks last 333.33 us on average, 332 us for the 83 counts hardware tick
+    timebase_deinit(0U);
+    timer_8_bit_stub_set_initialised(true);
+    config.timer.type = TIMEBASE_TIMER_8_BIT;
+    config.timescale = TIMEBASE_TIMESCALE_CUSTOM;
+    config.custom_target_freq = 3000U;
+    timer_8_bit_stub_set_next_parameters(TIMER8BIT_CLK_PRESCALER_64, 82U, 0U);
+    ASSERT_EQ(TIMEBASE_ERROR_OK, timebase_init(0U, &config));
+    timebase_internal_config[0U].tick = 0U;
+
+    uint32_t timestamp = 0;
+    for (uint32_t i = 0 ; i < 3000U ; i++)
+    {
+        timebase_interrupt_callback(0U);
+    }
+    timer_8_bit_stub_set_counter(0U, false);
+    ASSERT_EQ(TIMEBASE_ERROR_OK, timebase_get_timestamp_us(0U, &timestamp));
+    ASSERT_EQ(1000000UL, timestamp);
+
+    for (uint32_t i = 3000U ; i < 30000U ; i++)
+    {
+        timebase_interrupt_callback(0U);
+    }
+    ASSERT_EQ(TIMEBASE_ERROR_OK, timebase_get_timestamp_us(0U, &timestamp));
+    ASSERT_EQ(10000000UL, timestamp);
+
+    // 83 counts into a lengthened tick : the next tick is reached
+    timer_8_bit_stub_set_counter(83U, false);
+    ASSERT_EQ(TIMEBASE_ERROR_OK, timebase_get_timestamp_us(0U, &timestamp));
+    ASSERT_EQ(10000333UL, timestamp);
+
+    // Tickless timebases keep the whole number of counts
+    config.tickless = true;
+    timer_8_bit_stub_set_next_parameters(TIMER8BIT_CLK_PRESCALER_64, 82U, 0U);
+    ASSERT_EQ(TIMEBASE_ERROR_OK, timebase_init(0U, &config));
+    ASSERT_EQ(332ULL << 16U, timebase_internal_config[0U].timestamp.tick_period_us_q16);
+    timebase_deinit(0U);
+}
 
 int main(int argc, char **argv)
 {
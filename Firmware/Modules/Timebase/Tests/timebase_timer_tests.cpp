@@ -0,0 +1,377 @@
+/*
+
+------------------
+@<FreeMyCode>
+FreeMyCode version : 1.0 RC alpha
+    Author : bebenlebricolo
+    License : 
+        name : GPLv3
+        url : https://www.gnu.org/licenses/quick-guide-gplv3.html
+    Date : 12/02/2021
+    Project : LabBenchPowerSupply
+    Description : The Lab Bench Power Supply provides a simple design based around an Arduino Nano board to convert AC main voltage into
+ smaller ones, ranging from 0V to 16V, with voltage and current regulations
+<FreeMyCode>@
+------------------
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+
+#include "gtest/gtest.h"
+
+#include <vector>
+
+#include "config.h"
+#include "timebase.h"
+#include "timebase_internal.h"
+#include "timebase_timer.h"
+#include "timer_8_bit_stub.h"
+#include "timer_8_bit_async_stub.h"
+#include "timer_16_bit_stub.h"
+
+/* Records which timer fired on which tick */
+struct expiry_record_t
+{
+    uint8_t timer;
+    uint32_t tick;
+};
+
+static std::vector<expiry_record_t> expiries;
+
+static void record_expiry(void * const context)
+{
+    expiries.push_back({*static_cast<uint8_t *>(context), timebase_internal_config[0U].tick});
+}
+
+class TimebaseTimerService : public ::testing::Test
+{
+public:
+    void SetUp(void) override
+    {
+        timer_8_bit_stub_reset();
+        timer_8_bit_async_stub_reset();
+        timer_16_bit_stub_reset();
+        timer_8_bit_stub_set_initialised(true);
+
+        timebase_config_t config;
+        memset(&config, 0, sizeof(timebase_config_t));
+        config.cpu_freq = 16'000'000;
+        config.timescale = TIMEBASE_TIMESCALE_MILLISECONDS;
+        config.timer.type = TIMEBASE_TIMER_8_BIT;
+        config.timer.index = 0U;
+        timer_8_bit_stub_set_next_parameters(TIMER8BIT_CLK_PRESCALER_64, 0U, 0U);
+        ASSERT_EQ(TIMEBASE_ERROR_OK, timebase_init(0U, &config));
+
+        timebase_internal_config[0U].tick = 1000U;
+        ASSERT_EQ(TIMEBASE_ERROR_OK, timebase_timer_init(0U));
+        expiries.clear();
+
+        for (uint8_t i = 0 ; i < TIMEBASE_TIMER_MAX_TIMERS ; i++)
+        {
+            ids[i] = i;
+        }
+        created = 0;
+    }
+
+    void TearDown(void) override
+    {
+        timebase_deinit(0U);
+    }
+
+    /* Advances the tick and processes timers on each tick, as the main loop does */
+    void run_ticks(const uint32_t count)
+    {
+        for (uint32_t i = 0 ; i < count ; i++)
+        {
+            timebase_internal_config[0U].tick++;
+            ASSERT_EQ(TIMEBASE_ERROR_OK, timebase_timer_process());
+        }
+    }
+
+    /* Context of each created timer is its own index */
+    uint8_t create_timer(void)
+    {
+        uint8_t * const context = &ids[created++];
+        EXPECT_EQ(TIMEBASE_ERROR_OK, timebase_timer_create(record_expiry, context, context));
+        return *context;
+    }
+
+    uint8_t ids[TIMEBASE_TIMER_MAX_TIMERS];
+    uint8_t created;
+};
+
+TEST(timebase_timer_tests, test_guard_wrong_parameters)
+{
+    uint8_t timer = 0;
+    bool armed = false;
+
+    ASSERT_EQ(TIMEBASE_ERROR_INVALID_INDEX, timebase_timer_init(TIMEBASE_MAX_MODULES));
+    ASSERT_EQ(TIMEBASE_ERROR_NULL_POINTER, timebase_timer_create(nullptr, nullptr, &timer));
+    ASSERT_EQ(TIMEBASE_ERROR_NULL_POINTER, timebase_timer_create(record_expiry, nullptr, nullptr));
+    ASSERT_EQ(TIMEBASE_ERROR_NULL_POINTER, timebase_timer_is_armed(0U, nullptr));
+    ASSERT_EQ(TIMEBASE_ERROR_INVALID_INDEX, timebase_timer_arm(TIMEBASE_TIMER_MAX_TIMERS, 1U, 0U));
+    ASSERT_EQ(TIMEBASE_ERROR_INVALID_INDEX, timebase_timer_cancel(TIMEBASE_TIMER_MAX_TIMERS));
+    ASSERT_EQ(TIMEBASE_ERROR_INVALID_INDEX, timebase_timer_release(TIMEBASE_TIMER_MAX_TIMERS));
+    ASSERT_EQ(TIMEBASE_ERROR_INVALID_INDEX, timebase_timer_is_armed(TIMEBASE_TIMER_MAX_TIMERS, &armed));
+}
+
+TEST_F(TimebaseTimerService, test_slots_allocation)
+{
+    uint8_t timer = 0;
+    bool armed = true;
+
+    // Slots which were never allocated are rejected
+    ASSERT_EQ(TIMEBASE_ERROR_INVALID_INDEX, timebase_timer_arm(0U, 1U, 0U));
+
+    for (uint8_t i = 0 ; i < TIMEBASE_TIMER_MAX_TIMERS ; i++)
+    {
+        ASSERT_EQ(TIMEBASE_ERROR_OK, timebase_timer_create(record_expiry, &ids[i], &timer));
+        ASSERT_EQ(i, timer);
+        ASSERT_EQ(TIMEBASE_ERROR_OK, timebase_timer_is_armed(timer, &armed));
+        ASSERT_FALSE(armed);
+    }
+    ASSERT_EQ(TIMEBASE_ERROR_NO_FREE_TIMER, timebase_timer_create(record_expiry, nullptr, &timer));
+
+    ASSERT_EQ(TIMEBASE_ERROR_OK, timebase_timer_release(3U));
+    ASSERT_EQ(TIMEBASE_ERROR_INVALID_INDEX, timebase_timer_cancel(3U));
+    ASSERT_EQ(TIMEBASE_ERROR_OK, timebase_timer_create(record_expiry, &ids[3U], &timer));
+    ASSERT_EQ(3U, timer);
+}
+
+TEST_F(TimebaseTimerService, test_one_shot_timer)
+{
+    const uint8_t timer = create_timer();
+    bool armed = false;
+
+    ASSERT_EQ(TIMEBASE_ERROR_OK, timebase_timer_arm(timer, 5U, 0U));
+    ASSERT_EQ(TIMEBASE_ERROR_OK, timebase_timer_is_armed(timer, &armed));
+    ASSERT_TRUE(armed);
+
+    run_ticks(4U);
+    ASSERT_TRUE(expiries.empty());
+
+    run_ticks(1U);
+    ASSERT_EQ(1U, expiries.size());
+    ASSERT_EQ(timer, expiries[0].timer);
+    ASSERT_EQ(1005U, expiries[0].tick);
+    ASSERT_EQ(TIMEBASE_ERROR_OK, timebase_timer_is_armed(timer, &armed));
+    ASSERT_FALSE(armed);
+
+    run_ticks(50U);
+    ASSERT_EQ(1U, expiries.size());
+
+    // Null delay expires on next tick
+    ASSERT_EQ(TIMEBASE_ERROR_OK, timebase_timer_arm(timer, 0U, 0U));
+    ASSERT_EQ(TIMEBASE_ERROR_OK, timebase_timer_process());
+    ASSERT_EQ(1U, expiries.size());
+    run_ticks(1U);
+    ASSERT_EQ(2U, expiries.size());
+}
+
+TEST_F(TimebaseTimerService, test_periodic_and_multiple_rounds_timers)
+{
+    const uint8_t periodic = create_timer();
+    const uint8_t long_one = create_timer();
+    const uint8_t same_bucket = create_timer();
+
+    ASSERT_EQ(TIMEBASE_ERROR_OK, timebase_timer_arm(periodic, 3U, 7U));
+    // Both land in the same bucket, a few wheel rounds apart
+    ASSERT_EQ(TIMEBASE_ERROR_OK, timebase_timer_arm(long_one, 3U + 4U * TIMEBASE_TIMER_WHEEL_SIZE, 0U));
+    ASSERT_EQ(TIMEBASE_ERROR_OK, timebase_timer_arm(same_bucket, 3U + TIMEBASE_TIMER_WHEEL_SIZE, 0U));
+
+    run_ticks(4U * TIMEBASE_TIMER_WHEEL_SIZE + 3U);
+
+    std::vector<uint32_t> periodic_ticks;
+    uint32_t long_one_tick = 0;
+    uint32_t same_bucket_tick = 0;
+    for (auto & record : expiries)
+    {
+        if (record.timer == periodic)
+        {
+            periodic_ticks.push_back(record.tick);
+        }
+        else if (record.timer == long_one)
+        {
+            long_one_tick = record.tick;
+        }
+        else
+        {
+            same_bucket_tick = record.tick;
+        }
+    }
+
+    ASSERT_EQ(1003U + 4U * TIMEBASE_TIMER_WHEEL_SIZE, long_one_tick);
+    ASSERT_EQ(1003U + TIMEBASE_TIMER_WHEEL_SIZE, same_bucket_tick);
+    ASSERT_EQ((4U * TIMEBASE_TIMER_WHEEL_SIZE) / 7U + 1U, periodic_ticks.size());
+    for (size_t i = 0 ; i < periodic_ticks.size() ; i++)
+    {
+        ASSERT_EQ(1003U + 7U * i, periodic_ticks[i]);
+    }
+
+    // Periodic timers as long as the wheel stay in their own bucket
+    expiries.clear();
+    ASSERT_EQ(TIMEBASE_ERROR_OK, timebase_timer_arm(periodic, TIMEBASE_TIMER_WHEEL_SIZE, TIMEBASE_TIMER_WHEEL_SIZE));
+    run_ticks(3U * TIMEBASE_TIMER_WHEEL_SIZE);
+    ASSERT_EQ(3U, expiries.size());
+}
+
+TEST_F(TimebaseTimerService, test_cancel_and_rearm)
+{
+    const uint8_t first = create_timer();
+    const uint8_t second = create_timer();
+    bool armed = true;
+
+    ASSERT_EQ(TIMEBASE_ERROR_OK, timebase_timer_arm(first, 10U, 0U));
+    ASSERT_EQ(TIMEBASE_ERROR_OK, timebase_timer_arm(second, 10U, 2U));
+    run_ticks(5U);
+
+    ASSERT_EQ(TIMEBASE_ERROR_OK, timebase_timer_cancel(second));
+    ASSERT_EQ(TIMEBASE_ERROR_OK, timebase_timer_is_armed(second, &armed));
+    ASSERT_FALSE(armed);
+
+    // Re-arming restarts the delay from now
+    ASSERT_EQ(TIMEBASE_ERROR_OK, timebase_timer_arm(first, 10U, 0U));
+    run_ticks(9U);
+    ASSERT_TRUE(expiries.empty());
+    run_ticks(1U);
+    ASSERT_EQ(1U, expiries.size());
+    ASSERT_EQ(first, expiries[0].timer);
+    ASSERT_EQ(1015U, expiries[0].tick);
+
+    run_ticks(20U);
+    ASSERT_EQ(1U, expiries.size());
+}
+
+TEST_F(TimebaseTimerService, test_late_processing_catches_up)
+{
+    const uint8_t periodic = create_timer();
+    const uint8_t one_shot = create_timer();
+
+    ASSERT_EQ(TIMEBASE_ERROR_OK, timebase_timer_arm(periodic, 4U, 4U));
+    ASSERT_EQ(TIMEBASE_ERROR_OK, timebase_timer_arm(one_shot, 6U, 0U));
+
+    // Main loop was stuck for 20 ticks : expiries are replayed in order, without periodic drift
+    timebase_internal_config[0U].tick += 20U;
+    ASSERT_EQ(TIMEBASE_ERROR_OK, timebase_timer_process());
+
+    const std::vector<uint8_t> expected_timers = {periodic, one_shot, periodic, periodic, periodic, periodic};
+    ASSERT_EQ(expected_timers.size(), expiries.size());
+    for (size_t i = 0 ; i < expiries.size() ; i++)
+    {
+        ASSERT_EQ(expected_timers[i], expiries[i].timer);
+    }
+
+    // Next expiry is still aligned on the original schedule
+    expiries.clear();
+    run_ticks(4U);
+    ASSERT_EQ(1U, expiries.size());
+    ASSERT_EQ(1024U, expiries[0].tick);
+
+    // No timer armed : long idle periods are skipped at once
+    ASSERT_EQ(TIMEBASE_ERROR_OK, timebase_timer_cancel(periodic));
+    timebase_internal_config[0U].tick += 100000UL;
+    ASSERT_EQ(TIMEBASE_ERROR_OK, timebase_timer_process());
+    ASSERT_EQ(TIMEBASE_ERROR_OK, timebase_timer_arm(one_shot, 1U, 0U));
+    run_ticks(1U);
+    ASSERT_EQ(2U, expiries.size());
+}
+
+static uint8_t victim_timer = 0;
+static void cancel_victim(void * const context)
+{
+    (void) context;
+    expiries.push_back({0xFF, timebase_internal_config[0U].tick});
+    timebase_timer_cancel(victim_timer);
+}
+
+TEST_F(TimebaseTimerService, test_callback_cancels_timer_expiring_on_same_tick)
+{
+    uint8_t killer = 0;
+    ASSERT_EQ(TIMEBASE_ERROR_OK, timebase_timer_create(cancel_victim, nullptr, &killer));
+    victim_timer = create_timer();
+
+    // Victim is linked first, so it comes last in the bucket and expires after the killer
+    ASSERT_EQ(TIMEBASE_ERROR_OK, timebase_timer_arm(victim_timer, 3U, 1U));
+    ASSERT_EQ(TIMEBASE_ERROR_OK, timebase_timer_arm(killer, 3U, 0U));
+    run_ticks(10U);
+
+    ASSERT_EQ(1U, expiries.size());
+    ASSERT_EQ(0xFF, expiries[0].timer);
+}
+
+TEST_F(TimebaseTimerService, test_deadline_follows_earliest_timer)
+{
+    // Only tickless timebases record deadlines
+    timebase_internal_config[0U].tickless.enabled = true;
+    const uint8_t slow = create_timer();
+    const uint8_t fast = create_timer();
+
+    ASSERT_EQ(TIMEBASE_ERROR_OK, timebase_timer_arm(slow, 10U, 0U));
+    ASSERT_TRUE(timebase_internal_config[0U].tickless.deadline_armed);
+    ASSERT_EQ(1010U, timebase_internal_config[0U].tickless.deadline);
+
+    ASSERT_EQ(TIMEBASE_ERROR_OK, timebase_timer_arm(fast, 4U, 5U));
+    ASSERT_EQ(1004U, timebase_internal_config[0U].tickless.deadline);
+
+    // Periodic timer moves the deadline to its next expiry
+    run_ticks(4U);
+    ASSERT_EQ(1U, expiries.size());
+    ASSERT_EQ(1009U, timebase_internal_config[0U].tickless.deadline);
+
+    ASSERT_EQ(TIMEBASE_ERROR_OK, timebase_timer_cancel(fast));
+    ASSERT_EQ(1010U, timebase_internal_config[0U].tickless.deadline);
+
+    run_ticks(6U);
+    ASSERT_EQ(2U, expiries.size());
+    ASSERT_FALSE(timebase_internal_config[0U].tickless.deadline_armed);
+}
+
+TEST_F(TimebaseTimerService, test_deadline_cache)
+{
+    // Periodic timebases never get deadlines
+    const uint8_t first = create_timer();
+    const uint8_t second = create_timer();
+    const uint8_t third = create_timer();
+    ASSERT_EQ(TIMEBASE_ERROR_OK, timebase_timer_arm(first, 5U, 0U));
+    ASSERT_FALSE(timebase_internal_config[0U].tickless.deadline_armed);
+    ASSERT_EQ(TIMEBASE_ERROR_OK, timebase_timer_cancel(first));
+
+    timebase_internal_config[0U].tickless.enabled = true;
+    ASSERT_EQ(TIMEBASE_ERROR_OK, timebase_timer_arm(first, 5U, 0U));
+    ASSERT_EQ(TIMEBASE_ERROR_OK, timebase_timer_arm(second, 8U, 0U));
+    ASSERT_EQ(TIMEBASE_ERROR_OK, timebase_timer_arm(third, 12U, 0U));
+    ASSERT_EQ(1005U, timebase_internal_config[0U].tickless.deadline);
+
+    // Later timers come and go without touching the deadline
+    timebase_internal_config[0U].tickless.deadline = 0U;
+    ASSERT_EQ(TIMEBASE_ERROR_OK, timebase_timer_cancel(third));
+    ASSERT_EQ(TIMEBASE_ERROR_OK, timebase_timer_arm(third, 7U, 0U));
+    ASSERT_EQ(TIMEBASE_ERROR_OK, timebase_timer_release(second));
+    ASSERT_EQ(0U, timebase_internal_config[0U].tickless.deadline);
+
+    // Re-arming the earliest timer further away hands the next one over
+    ASSERT_EQ(TIMEBASE_ERROR_OK, timebase_timer_arm(first, 20U, 0U));
+    ASSERT_EQ(1007U, timebase_internal_config[0U].tickless.deadline);
+    ASSERT_EQ(TIMEBASE_ERROR_OK, timebase_timer_release(third));
+    ASSERT_EQ(1020U, timebase_internal_config[0U].tickless.deadline);
+    ASSERT_EQ(TIMEBASE_ERROR_OK, timebase_timer_cancel(first));
+    ASSERT_FALSE(timebase_internal_config[0U].tickless.deadline_armed);
+}
+
+int main(int argc, char **argv)
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -55,6 +55,10 @@ typedef enum
 
     TIMEBASE_ERROR_TIMER_UNINITIALISED,     /**< Underlying timer is not initialised                            */
     TIMEBASE_ERROR_TIMER_ERROR,             /**< Encountered an error while using underlying timer driver       */
+    TIMEBASE_ERROR_NO_FREE_TIMER,           /**< All software timer slots are already in use                    */
+    TIMEBASE_ERROR_INVALID_PARAMETERS,      /**< Precomputed timer parameters do not suit selected timer        */
+    TIMEBASE_ERROR_INVALID_PARENT,          /**< Derived timebase parent is not an initialised periodic
+                                                 timebase driving its own timer                                 */
 } timebase_error_t;
 
 /**
@@ -66,6 +70,8 @@ typedef enum
     TIMEBASE_TIMER_8_BIT,           /**< Uses a regular 8 bit timer                     */
     TIMEBASE_TIMER_16_BIT,          /**< Uses a regular 16 bit timer                    */
     TIMEBASE_TIMER_8_BIT_ASYNC,     /**< Uses an advanced / async capable 8 bit timer   */
+    TIMEBASE_TIMER_DERIVED,         /**< Divides the ticks of another timebase instance,
+                                         no timer of its own                            */
 } timebase_timer_t;
 
 /**
@@ -80,6 +86,18 @@ typedef enum
     TIMEBASE_TIMESCALE_CUSTOM,          /**< Custom timescale, allows to use a custom configuration to handle timebase generation   */
 } timebase_timescale_t;
 
+/**
+ * @brief Timer parameters computed ahead of time, when CPU and target frequencies are known at build time.
+ * Drivers compile-time solvers provide them, e.g. TIMER_8_BIT_STATIC_PRESCALER(), TIMER_8_BIT_STATIC_OCR() and
+ * TIMER_8_BIT_STATIC_ACCUMULATOR() for a regular 8 bit timer.
+*/
+typedef struct
+{
+    uint16_t prescaler;     /**< Prescaler value (1, 8, 64, ...), not the prescaler selection enum of the timer */
+    uint16_t ocr_value;     /**< Output compare value                                                           */
+    uint16_t accumulator;   /**< Compare match interrupts per tick, minus one                                   */
+} timebase_timer_parameters_t;
+
 /**
  * @brief Initialisation structure
 */
@@ -97,6 +115,15 @@ typedef struct
         timebase_timescale_t timescale; /**< Selects what is the resolution of the timer                            */
         uint32_t custom_target_freq;    /**< Custom target frequency                                                */
     };
+    bool tickless;                  /**< Interrupts only fire when the timer counter is about to overflow or on a
+                                         deadline (@see timebase_set_deadline()), instead of on every tick          */
+    timebase_timer_parameters_t const * parameters; /**< Precomputed timer parameters, NULL to compute them at init */
+
+    struct
+    {
+        uint8_t parent;     /**< Timebase instance whose ticks are divided (TIMEBASE_TIMER_DERIVED only)        */
+        uint32_t divider;   /**< Parent ticks per tick (TIMEBASE_TIMER_DERIVED only)                            */
+    } derived;
 } timebase_config_t;
 
 /**
@@ -105,21 +132,30 @@ typedef struct
  * @param[out]  prescaler   : Computed prescaler. Shall be cast to the timer's according prescaler enum.
  *                            E.g : selected timer is a 8bit async timer, then prescaler shall be cast to (timer_8_bit_async_prescaler_selection_t)
  * @param[out]  ocr_value   : Output Compare value used to trigger an interrupt and load the accumulator with it.
+ * @param[out]  accumulator : Compare match interrupts per tick, minus one.
+ * @param[out]  period_error_ppb : Error of the hardware tick period against the target one, in parts per billion
+ *                            (positive when ticks are too long). Periodic timebases compensate it in their ISR, a tick
+ *                            being a timer count longer or shorter from time to time : average tick rate is exact.
  * @return
  *          TIMEBASE_ERROR_OK                       :   operation succeeded
  *          TIMEBASE_ERROR_UNSUPPORTED_TIMER_TYPE   :   targeted timer type does not exist
  *          TIMEBASE_ERROR_UNSUPPORTED_TIMESCALE    :   timescale is not relevant to timebase module
 */
-timebase_error_t timebase_compute_timer_parameters(timebase_config_t const * const config, uint16_t * const prescaler_val, uint16_t * const ocr_value, uint16_t * const accumulator);
+timebase_error_t timebase_compute_timer_parameters(timebase_config_t const * const config, uint16_t * const prescaler_val, uint16_t * const ocr_value, uint16_t * const accumulator, int32_t * const period_error_ppb);
 
 /**
  * @brief Initialises the timebase module using an id and a configuration.
+ * Derived timebases (TIMEBASE_TIMER_DERIVED) do not use a timer : they count the ticks of a periodic parent timebase
+ * from its ISR, so that several timescales (e.g. 100 us, ms and s) share a single hardware timer and interrupt.
+ * Timer, timescale and tickless settings are ignored for them, parent shall be initialised first.
  * @param[in] id     :  index of timebase module to be initialised
  * @param[in] config :  configuration to be used to initialise the targeted timebase module
  * @return
- *          TIMEBASE_ERROR_OK               :   operation succeeded
- *          TIMEBASE_ERROR_NULL_POINTER     :   given parameter is uninitialised
- *          TIMEBASE_ERROR_INVALID_INDEX    :   given module id is out of bounds
+ *          TIMEBASE_ERROR_OK                   :   operation succeeded
+ *          TIMEBASE_ERROR_NULL_POINTER         :   given parameter is uninitialised
+ *          TIMEBASE_ERROR_INVALID_INDEX        :   given module id is out of bounds
+ *          TIMEBASE_ERROR_INVALID_PARAMETERS   :   precomputed timer parameters or derived timebase divider are not usable
+ *          TIMEBASE_ERROR_INVALID_PARENT       :   derived timebase parent is not an initialised periodic timebase
 */
 timebase_error_t timebase_init(const uint8_t id, timebase_config_t const * const config);
 
@@ -135,6 +171,18 @@ timebase_error_t timebase_init(const uint8_t id, timebase_config_t const * const
 */
 timebase_error_t timebase_is_initialised(const uint8_t id, bool * const initialsed);
 
+/**
+ * @brief Checks whether selected timebase instance runs tickless, in which case it relies on deadlines to wake up in
+ * time (@see timebase_set_deadline())
+ * @param[in]   id          :   selected timebase instance index
+ * @param[out]  tickless    :   probes for tickless mode
+ * @return
+ *          TIMEBASE_ERROR_OK               :   operation succeeded
+ *          TIMEBASE_ERROR_NULL_POINTER     :   given parameter is uninitialised
+ *          TIMEBASE_ERROR_INVALID_INDEX    :   given module id is out of bounds
+*/
+timebase_error_t timebase_is_tickless(const uint8_t id, bool * const tickless);
+
 /**
  * @brief Deinitialises targeted timebase module
  * @param[in] id    :   targeted timebase module index
@@ -146,7 +194,10 @@ timebase_error_t timebase_is_initialised(const uint8_t id, bool * const initials
 timebase_error_t timebase_deinit(const uint8_t id);
 
 /**
- * @brief Reads the current tick from underlying timer/accumulator
+ * @brief Reads the current tick from underlying timer/accumulator.
+ * Tick is 32 bits wide and is updated by the timer ISR : it is read without disabling interrupts, read is retried
+ * when an update happened meanwhile so that a torn value is never returned. Tickless timebases add the ticks elapsed
+ * since last interrupt, worked out from the timer counter.
  * @param[in]   id      : index of targeted timebase module
  * @param[out]  tick    : output tick read from underlying timer/accumulator
  * @return
@@ -155,10 +206,11 @@ timebase_error_t timebase_deinit(const uint8_t id);
  *          TIMEBASE_ERROR_INVALID_INDEX    :   given module id is out of bounds
  *          TIMEBASE_ERROR_UNINITIALISED    :   selected module has not been initialised (meaning underlying timer is not configured)
 */
-timebase_error_t timebase_get_tick(const uint8_t id, uint16_t * const tick);
+timebase_error_t timebase_get_tick(const uint8_t id, uint32_t * const tick);
 
 /**
- * @brief Computes a duration using two reference ticks
+ * @brief Computes a duration using two reference ticks. Modular arithmetic makes the result right across a tick
+ * counter wrap around, as long as the actual duration is shorter than 2^32 ticks
  * @param[in]  reference : input reference tick (used as a 'start' time)
  * @param[in]  new_tick  : tick to be compared against the reference
  * @param[out] duration  : calculated duration
@@ -166,7 +218,7 @@ timebase_error_t timebase_get_tick(const uint8_t id, uint16_t * const tick);
  *          TIMEBASE_ERROR_OK               :   operation succeeded
  *          TIMEBASE_ERROR_NULL_POINTER     :   given parameter is uninitialised
 */
-timebase_error_t timebase_get_duration(uint16_t const * const reference, uint16_t const * const new_tick, uint16_t * const duration);
+timebase_error_t timebase_get_duration(uint32_t const * const reference, uint32_t const * const new_tick, uint32_t * const duration);
 
 /**
  * @brief Computes the duration between a reference tick and now (fetched when this function is called)
@@ -179,10 +231,52 @@ timebase_error_t timebase_get_duration(uint16_t const * const reference, uint16_
  *          TIMEBASE_ERROR_INVALID_INDEX    :   given module id is out of bounds
  *          TIMEBASE_ERROR_UNINITIALISED    :   selected module has not been initialised (meaning underlying timer is not configured)
 */
-timebase_error_t timebase_get_duration_now(const uint8_t id, uint16_t const * const reference, uint16_t * const duration);
+timebase_error_t timebase_get_duration_now(const uint8_t id, uint32_t const * const reference, uint32_t * const duration);
+
+/**
+ * @brief Reads a microsecond timestamp, made of the tick count refined with the live timer counter. Tick, accumulator,
+ * counter and pending compare match flag are read without disabling interrupts, and read again whenever the timer ISR
+ * ran meanwhile. A compare match which is still pending (ISR delayed by a critical section) is accounted for.
+ * Timestamps are derived from the timer clock (CPU frequency and prescaler) : they wrap around after 2^32 us (~71.6 min).
+ * Note : interrupts shall not stay disabled for more than one compare match period.
+ * @param[in]   id          : index of targeted timebase module
+ * @param[out]  timestamp   : current time, in microseconds
+ * @return
+ *          TIMEBASE_ERROR_OK               :   operation succeeded
+ *          TIMEBASE_ERROR_NULL_POINTER     :   given parameter is uninitialised
+ *          TIMEBASE_ERROR_INVALID_INDEX    :   given module id is out of bounds
+ *          TIMEBASE_ERROR_UNINITIALISED    :   selected module has not been initialised (meaning underlying timer is not configured)
+ *          TIMEBASE_ERROR_TIMER_ERROR      :   underlying timer counter could not be read
+ *          TIMEBASE_ERROR_INVALID_PARENT   :   parent of a derived timebase has been deinitialised
+*/
+timebase_error_t timebase_get_timestamp_us(const uint8_t id, uint32_t * const timestamp);
+
+/**
+ * @brief Asks for a timer interrupt when the given tick is reached, so that a sleeping CPU wakes up on time.
+ * Only relevant to tickless timebases (no-op otherwise, as ticks already trigger interrupts) : the compare value is
+ * shortened right away if needed. Compare interrupt is masked for a few cycles meanwhile, to be called from main context.
+ * @param[in]   id      : index of targeted timebase module
+ * @param[in]   tick    : tick on which an interrupt is wanted
+ * @return
+ *          TIMEBASE_ERROR_OK               :   operation succeeded
+ *          TIMEBASE_ERROR_INVALID_INDEX    :   given module id is out of bounds
+ *          TIMEBASE_ERROR_UNINITIALISED    :   selected module has not been initialised (meaning underlying timer is not configured)
+*/
+timebase_error_t timebase_set_deadline(const uint8_t id, const uint32_t tick);
+
+/**
+ * @brief Removes the deadline : a tickless timebase lets its timer run up to its maximum compare value again
+ * @param[in]   id      : index of targeted timebase module
+ * @return
+ *          TIMEBASE_ERROR_OK               :   operation succeeded
+ *          TIMEBASE_ERROR_INVALID_INDEX    :   given module id is out of bounds
+ *          TIMEBASE_ERROR_UNINITIALISED    :   selected module has not been initialised (meaning underlying timer is not configured)
+*/
+timebase_error_t timebase_cancel_deadline(const uint8_t id);
 
 /**
- * @brief A callback to be used within the Timer ISR which handles time increment
+ * @brief A callback to be used within the Timer ISR which handles time increment. Timebases derived from this one are
+ * updated as well : they do not need an ISR of their own.
  * @param[in]  id : index of targeted timebase module
 */
 void timebase_interrupt_callback(const uint8_t id);
@@ -46,9 +46,41 @@ typedef struct
     struct
     {
         uint16_t programmed;
-        uint16_t running;
+        volatile uint16_t running;
     } accumulator;
-    uint16_t tick;
+    volatile uint32_t tick;     /**< Incremented by the timer ISR, wraps around after 2^32 ticks (~49.7 days at 1 ms) */
+    struct
+    {
+        uint32_t us_per_count_q8;       /**< Duration of a timer count, in 1/256 us                         */
+        uint32_t counter_period;        /**< Timer counts between two compare match interrupts (OCRA + 1)   */
+        uint32_t counts_per_tick;       /**< Timer counts per tick                                          */
+        uint64_t tick_period_us_q16;    /**< Average duration of a tick, in 1/65536 us                      */
+    } timestamp;
+    struct
+    {
+        uint32_t step;                  /**< Hardware tick period error, in 1/modulus timer counts (Bresenham increment)    */
+        uint32_t modulus;               /**< Prescaler * target frequency : a whole timer count, in the same unit as step   */
+        uint32_t error;                 /**< Accumulated period error, a tick is corrected by a count when it overflows     */
+        int8_t direction;               /**< +1 : corrected ticks last one more count, -1 : one count less, 0 : exact       */
+        volatile bool adjusted;         /**< Compare period being counted is the corrected one                              */
+        uint16_t min_counter_period;    /**< Shortest counter period which can still be shortened by a count                */
+    } fraction;
+    struct
+    {
+        bool enabled;                   /**< Compare value follows next deadline instead of tick period             */
+        volatile bool deadline_armed;   /**< A deadline is set, ISR fires when it is reached                        */
+        uint32_t deadline;              /**< Tick on which an interrupt is wanted                                   */
+        volatile uint32_t residual;     /**< Timer counts elapsed since current tick started, up to last interrupt  */
+        volatile uint16_t compare;      /**< Compare value currently programmed (interrupt fires every compare + 1) */
+        uint16_t max_compare;           /**< Biggest compare value supported by the timer                           */
+        uint16_t margin;                /**< Counts kept between the running counter and a newly written compare    */
+    } tickless;
+    struct
+    {
+        uint8_t parent;             /**< Periodic timebase instance whose ticks are divided (derived timebases only) */
+        uint32_t divider;           /**< Parent ticks per tick                                                       */
+        volatile uint32_t running;  /**< Parent ticks elapsed since current tick started                             */
+    } derived;
     bool initialised;
 } timebase_internal_config_t;
 
@@ -0,0 +1,145 @@
+/*
+
+------------------
+@<FreeMyCode>
+FreeMyCode version : 1.0 RC alpha
+    Author : bebenlebricolo
+    License : 
+        name : GPLv3
+        url : https://www.gnu.org/licenses/quick-guide-gplv3.html
+    Date : 12/02/2021
+    Project : LabBenchPowerSupply
+    Description : The Lab Bench Power Supply provides a simple design based around an Arduino Nano board to convert AC main voltage into
+ smaller ones, ranging from 0V to 16V, with voltage and current regulations
+<FreeMyCode>@
+------------------
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+
+#ifndef TIMEBASE_TIMER_HEADER
+#define TIMEBASE_TIMER_HEADER
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "config.h"
+#include "timebase.h"
+
+/* Number of software timer slots, statically allocated */
+#ifndef TIMEBASE_TIMER_MAX_TIMERS
+    #define TIMEBASE_TIMER_MAX_TIMERS 8U
+#endif
+
+/* Number of buckets of the timer wheel (power of two). Timers expiring less than this many ticks apart never share
+a bucket, so each tick only walks through the few timers which are likely to expire on it */
+#ifndef TIMEBASE_TIMER_WHEEL_SIZE
+    #define TIMEBASE_TIMER_WHEEL_SIZE 16U
+#endif
+
+/**
+ * @brief software timer expiry callback, called from timebase_timer_process() (main loop context)
+ * @param[in]   context : context pointer given when the timer was created
+*/
+typedef void (*timebase_timer_callback_t)(void * const context);
+
+/**
+ * @brief Initialises the software timer service on top of a timebase module : all timers are released and
+ * time starts counting from the current tick of this timebase.
+ * @param[in]   timebase_id : index of an initialised timebase module, which gives the timers resolution
+ * @return
+ *          TIMEBASE_ERROR_OK               :   operation succeeded
+ *          TIMEBASE_ERROR_INVALID_INDEX    :   given module id is out of bounds
+ *          TIMEBASE_ERROR_UNINITIALISED    :   selected timebase module has not been initialised
+*/
+timebase_error_t timebase_timer_init(const uint8_t timebase_id);
+
+/**
+ * @brief Allocates a timer slot. Timer is created disarmed
+ * @param[in]   callback : called on each expiry
+ * @param[in]   context  : passed to the callback (may be NULL)
+ * @param[out]  timer    : index of allocated timer
+ * @return
+ *          TIMEBASE_ERROR_OK               :   operation succeeded
+ *          TIMEBASE_ERROR_NULL_POINTER     :   callback or timer pointers are NULL
+ *          TIMEBASE_ERROR_UNINITIALISED    :   timer service is not initialised
+ *          TIMEBASE_ERROR_NO_FREE_TIMER    :   all TIMEBASE_TIMER_MAX_TIMERS slots are in use
+*/
+timebase_error_t timebase_timer_create(const timebase_timer_callback_t callback, void * const context, uint8_t * const timer);
+
+/**
+ * @brief Cancels a timer and gives its slot back
+ * @param[in]   timer : index of the timer
+ * @return
+ *          TIMEBASE_ERROR_OK               :   operation succeeded
+ *          TIMEBASE_ERROR_INVALID_INDEX    :   timer index is out of bounds or was not allocated
+*/
+timebase_error_t timebase_timer_release(const uint8_t timer);
+
+/**
+ * @brief Arms (or re-arms) a timer, in O(1). Timer expires 'delay' ticks from now, then every 'period' ticks if
+ * period is not 0. Periodic timers are re-armed relatively to their previous expiry, so they do not drift when the
+ * main loop is late.
+ * @param[in]   timer  : index of the timer
+ * @param[in]   delay  : ticks before first expiry (0 is handled as 1 : next tick)
+ * @param[in]   period : ticks between subsequent expiries, 0 for a one-shot timer
+ * @return
+ *          TIMEBASE_ERROR_OK               :   operation succeeded
+ *          TIMEBASE_ERROR_INVALID_INDEX    :   timer index is out of bounds or was not allocated
+*/
+timebase_error_t timebase_timer_arm(const uint8_t timer, const uint32_t delay, const uint32_t period);
+
+/**
+ * @brief Disarms a timer, in O(1). Its callback won't be called anymore, even if it already expired during the
+ * tick being processed
+ * @param[in]   timer : index of the timer
+ * @return
+ *          TIMEBASE_ERROR_OK               :   operation succeeded
+ *          TIMEBASE_ERROR_INVALID_INDEX    :   timer index is out of bounds or was not allocated
+*/
+timebase_error_t timebase_timer_cancel(const uint8_t timer);
+
+/**
+ * @brief Tells whether a timer is armed
+ * @param[in]   timer : index of the timer
+ * @param[out]  armed : true until a one-shot timer expires or a timer is cancelled
+ * @return
+ *          TIMEBASE_ERROR_OK               :   operation succeeded
+ *          TIMEBASE_ERROR_NULL_POINTER     :   armed pointer is NULL
+ *          TIMEBASE_ERROR_INVALID_INDEX    :   timer index is out of bounds or was not allocated
+*/
+timebase_error_t timebase_timer_is_armed(const uint8_t timer, bool * const armed);
+
+/**
+ * @brief Expires timers and runs their callbacks, to be called from the main loop. The timer wheel is advanced by one
+ * bucket per elapsed tick : this costs a single tick read when no tick elapsed since the previous call, and late calls
+ * catch up with all elapsed ticks (in order). Callbacks may arm, cancel or release any timer.
+ * Note : not reentrant, shall not be called from a timer callback
+ * @return
+ *          TIMEBASE_ERROR_OK               :   operation succeeded
+ *          TIMEBASE_ERROR_UNINITIALISED    :   timer service (or its timebase module) is not initialised
+*/
+timebase_error_t timebase_timer_process(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* TIMEBASE_TIMER_HEADER */
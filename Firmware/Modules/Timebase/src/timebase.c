@@ -30,7 +30,6 @@ along with this program.  If not, see <https://www.gnu.org/licenses/>.
 
 #include <stdbool.h>
 #include <stddef.h>
-#include <limits.h>
 
 #include "config.h"
 #include "timebase.h"
@@ -44,6 +43,17 @@ along with this program.  If not, see <https://www.gnu.org/licenses/>.
     #error "TIMEBASE_MAX_MODULES define is missing, please set the maximum number of available timebase modules in your config.h"
 #endif
 
+/* Tickless compare values are kept ahead of the running counter by at least the CPU cycles spent between reading the
+counter and writing the compare value (a 32 bit division and multiplication, roughly 800 cycles on AVR), so that the
+timer never runs past them while they are written (which would delay the interrupt by a whole counter overflow).
+Converted to timer counts at init, as counts last prescaler cycles. */
+#define TICKLESS_COMPARE_MARGIN_CYCLES 1024U
+
+/* Tick period corrections are written from the ISR, shortly after the counter restarted : shortened compare values
+need to stay ahead of it for the interrupt entry, dispatch and correction (a few hundred CPU cycles on AVR).
+Converted to timer counts at init, as counts last prescaler cycles. */
+#define FRACTION_MIN_COUNTER_PERIOD_CYCLES 1024U
+
 timebase_internal_config_t timebase_internal_config[TIMEBASE_MAX_MODULES] = {0};
 
 static inline bool is_index_valid(const uint8_t id)
@@ -61,12 +71,134 @@ static void reset_internal_config(const uint8_t id)
     timebase_internal_config[id].accumulator.programmed = 0;
     timebase_internal_config[id].accumulator.running = 0;
     timebase_internal_config[id].tick = 0;
+    timebase_internal_config[id].timestamp.us_per_count_q8 = 0;
+    timebase_internal_config[id].timestamp.counter_period = 0;
+    timebase_internal_config[id].timestamp.counts_per_tick = 0;
+    timebase_internal_config[id].timestamp.tick_period_us_q16 = 0;
+    timebase_internal_config[id].fraction.step = 0;
+    timebase_internal_config[id].fraction.modulus = 0;
+    timebase_internal_config[id].fraction.error = 0;
+    timebase_internal_config[id].fraction.direction = 0;
+    timebase_internal_config[id].fraction.adjusted = false;
+    timebase_internal_config[id].fraction.min_counter_period = 0;
+    timebase_internal_config[id].tickless.enabled = false;
+    timebase_internal_config[id].tickless.deadline_armed = false;
+    timebase_internal_config[id].tickless.deadline = 0;
+    timebase_internal_config[id].tickless.residual = 0;
+    timebase_internal_config[id].tickless.compare = 0;
+    timebase_internal_config[id].tickless.max_compare = 0;
+    timebase_internal_config[id].tickless.margin = 0;
+    timebase_internal_config[id].derived.parent = 0;
+    timebase_internal_config[id].derived.divider = 0;
+    timebase_internal_config[id].derived.running = 0;
     timebase_internal_config[id].timer = TIMEBASE_TIMER_UNDEFINED;
     timebase_internal_config[id].timer_id = 0;
     timebase_internal_config[id].initialised = false;
 }
 
-static inline timebase_error_t setup_8_bit_timer(const uint8_t timebase_id, uint32_t const * const cpu_freq, uint32_t const * const target_freq)
+/* Timer counts needed for cycles CPU cycles to elapse, rounded up */
+static inline uint16_t cycles_to_counts(const uint32_t cycles, const uint16_t prescaler)
+{
+    if (0U == prescaler)
+    {
+        return (uint16_t) cycles;
+    }
+    return (uint16_t) ((cycles + prescaler - 1U) / prescaler);
+}
+
+/* Compare value actually written to the timer : tickless timebases start with the longest interrupt period */
+static inline uint16_t initial_compare_value(const uint8_t timebase_id, const uint16_t ocr, const uint16_t max_compare)
+{
+    return timebase_internal_config[timebase_id].tickless.enabled ? max_compare : ocr;
+}
+
+/* Returns how much longer (or shorter, when negative) than the target a tick of counts_per_tick timer counts is,
+in 1/(prescaler * target_freq) timer counts. One tick ideally lasts cpu_freq / (prescaler * target_freq) counts. */
+static inline int64_t compute_period_error(const uint32_t cpu_freq, const uint16_t prescaler, const uint32_t target_freq, const uint32_t counts_per_tick)
+{
+    const uint64_t modulus = (uint64_t) prescaler * target_freq;
+    return (int64_t) (((uint64_t) counts_per_tick) * modulus) - (int64_t) cpu_freq;
+}
+
+static void set_fraction_parameters(const uint8_t timebase_id, const uint32_t cpu_freq, const uint16_t prescaler, const uint32_t target_freq)
+{
+    timebase_internal_config_t * const internal = &timebase_internal_config[timebase_id];
+    const uint64_t modulus = (uint64_t) prescaler * target_freq;
+    const int64_t period_error = compute_period_error(cpu_freq, prescaler, target_freq, internal->timestamp.counts_per_tick);
+    const uint64_t step = (uint64_t) ((period_error < 0) ? -period_error : period_error);
+
+    internal->fraction.error = 0;
+    internal->fraction.adjusted = false;
+    internal->fraction.step = 0;
+    internal->fraction.modulus = 0;
+    internal->fraction.direction = 0;
+    internal->fraction.min_counter_period = cycles_to_counts(FRACTION_MIN_COUNTER_PERIOD_CYCLES, prescaler);
+
+    // A tick is corrected by a single timer count at most, which covers solvers output (period error stays within
+    // a count). Tickless timebases count ticks out of the timer counter : they keep the integer tick period.
+    if ((0U == step) || (step >= modulus) || (modulus > UINT32_MAX) || internal->tickless.enabled
+    || ((period_error > 0) && (internal->timestamp.counter_period < internal->fraction.min_counter_period))
+    || ((period_error < 0) && (internal->timestamp.counter_period > internal->tickless.max_compare)))
+    {
+        return;
+    }
+
+    internal->fraction.step = (uint32_t) step;
+    internal->fraction.modulus = (uint32_t) modulus;
+    // Hardware ticks which are too long are shortened by a count from time to time, and conversely
+    internal->fraction.direction = (period_error > 0) ? -1 : 1;
+}
+
+/* Tick duration is the average one : corrected timebases last exactly 1 / target_freq, others last their whole
+number of timer counts. Truncating it to the microsecond would drift (332 us instead of 333.33 us at 3 kHz). */
+static void set_tick_period(const uint8_t timebase_id, const uint32_t cpu_freq, const uint16_t prescaler, const uint32_t target_freq)
+{
+    timebase_internal_config_t * const internal = &timebase_internal_config[timebase_id];
+    internal->timestamp.tick_period_us_q16 = 0;
+
+    if (0U != internal->fraction.step)
+    {
+        // Rounded up, so that whole seconds worth of ticks read whole seconds
+        internal->timestamp.tick_period_us_q16 = ((1000000ULL << 16U) + target_freq - 1U) / target_freq;
+    }
+    else if (0U != cpu_freq)
+    {
+        // Split in quotient and remainder so that the 16 fractional bits never overflow
+        const uint64_t cycles_us = ((uint64_t) internal->timestamp.counts_per_tick) * prescaler * 1000000ULL;
+        const uint64_t quotient = cycles_us / cpu_freq;
+        const uint64_t remainder = cycles_us % cpu_freq;
+        internal->timestamp.tick_period_us_q16 = (quotient << 16U) + ((remainder << 16U) / cpu_freq);
+    }
+}
+
+static void set_counting_parameters(const uint8_t timebase_id, const uint32_t cpu_freq, const uint16_t prescaler, const uint32_t target_freq, const uint32_t counter_period, const uint16_t max_compare)
+{
+    timebase_internal_config_t * const internal = &timebase_internal_config[timebase_id];
+
+    // Computed once here, so that timestamps only need a multiplication and a shift
+    uint32_t us_per_count_q8 = 0;
+    if (0U != cpu_freq)
+    {
+        us_per_count_q8 = (uint32_t) ((((uint64_t) prescaler) * 256000000ULL) / cpu_freq);
+    }
+    const uint16_t programmed = internal->accumulator.programmed;
+    const uint32_t counts_per_tick = ((0U != programmed) ? ((uint32_t) programmed + 1U) : 1U) * counter_period;
+
+    internal->timestamp.us_per_count_q8 = us_per_count_q8;
+    internal->timestamp.counter_period = counter_period;
+    internal->timestamp.counts_per_tick = counts_per_tick;
+
+    internal->tickless.deadline_armed = false;
+    internal->tickless.residual = 0;
+    internal->tickless.max_compare = max_compare;
+    internal->tickless.margin = cycles_to_counts(TICKLESS_COMPARE_MARGIN_CYCLES, prescaler);
+    internal->tickless.compare = initial_compare_value(timebase_id, (uint16_t) (counter_period - 1U), max_compare);
+
+    set_fraction_parameters(timebase_id, cpu_freq, prescaler, target_freq);
+    set_tick_period(timebase_id, cpu_freq, prescaler, target_freq);
+}
+
+static inline timebase_error_t setup_8_bit_timer(const uint8_t timebase_id, uint32_t const * const cpu_freq, uint32_t const * const target_freq, timebase_timer_parameters_t const * const parameters)
 {
     bool initialised = false;
     timer_error_t err = timer_8_bit_is_initialised(timebase_internal_config[timebase_id].timer_id, &initialised);
@@ -83,11 +215,24 @@ static inline timebase_error_t setup_8_bit_timer(const uint8_t timebase_id, uint
     uint8_t ocra = 0;
     timebase_internal_config[timebase_id].accumulator.programmed =  0;
     timer_8_bit_prescaler_selection_t prescaler;
-    timer_8_bit_compute_matching_parameters(cpu_freq,
-                                            target_freq,
-                                            &prescaler,
-                                            &ocra,
-                                            &timebase_internal_config[timebase_id].accumulator.programmed);
+    if (NULL != parameters)
+    {
+        prescaler = timer_8_bit_prescaler_from_value(&parameters->prescaler);
+        if ((TIMER8BIT_CLK_NO_CLOCK == prescaler) || (parameters->ocr_value > UINT8_MAX))
+        {
+            return TIMEBASE_ERROR_INVALID_PARAMETERS;
+        }
+        ocra = (uint8_t) parameters->ocr_value;
+        timebase_internal_config[timebase_id].accumulator.programmed = parameters->accumulator;
+    }
+    else
+    {
+        timer_8_bit_compute_matching_parameters(cpu_freq,
+                                                target_freq,
+                                                &prescaler,
+                                                &ocra,
+                                                &timebase_internal_config[timebase_id].accumulator.programmed);
+    }
 
     timer_error_t ret = timer_8_bit_stop(timebase_internal_config[timebase_id].timer_id);
     timer_8_bit_handle_t handle = {0};
@@ -109,8 +254,9 @@ static inline timebase_error_t setup_8_bit_timer(const uint8_t timebase_id, uint
     config.handle = handle;
     config.timing_config.comp_match_a = TIMER8BIT_CMOD_CLEAR_OCnX;
     config.timing_config.comp_match_b = TIMER8BIT_CMOD_NORMAL;
-    config.timing_config.ocra_val = ocra;
+    config.timing_config.ocra_val = (uint8_t) initial_compare_value(timebase_id, ocra, UINT8_MAX);
     config.timing_config.prescaler = prescaler;
+    config.timing_config.waveform_mode = TIMER8BIT_WG_CTC;
     config.interrupt_config.it_comp_match_a = true;
 
     ret = timer_8_bit_reconfigure(timebase_internal_config[timebase_id].timer_id, &config);
@@ -119,10 +265,11 @@ static inline timebase_error_t setup_8_bit_timer(const uint8_t timebase_id, uint
         return TIMEBASE_ERROR_TIMER_ERROR;
     }
 
+    set_counting_parameters(timebase_id, *cpu_freq, timer_8_bit_prescaler_to_value(prescaler), *target_freq, (uint32_t) ocra + 1U, UINT8_MAX);
     return TIMEBASE_ERROR_OK;
 }
 
-static inline timebase_error_t setup_8_bit_async_timer(const uint8_t timebase_id, uint32_t const * const cpu_freq, uint32_t const * const target_freq)
+static inline timebase_error_t setup_8_bit_async_timer(const uint8_t timebase_id, uint32_t const * const cpu_freq, uint32_t const * const target_freq, timebase_timer_parameters_t const * const parameters)
 {
     bool initialised = false;
     timer_error_t err = timer_8_bit_async_is_initialised(timebase_internal_config[timebase_id].timer_id, &initialised);
@@ -139,11 +286,24 @@ static inline timebase_error_t setup_8_bit_async_timer(const uint8_t timebase_id
     uint8_t ocra = 0;
     timebase_internal_config[timebase_id].accumulator.programmed =  0;
     timer_8_bit_async_prescaler_selection_t prescaler;
-    timer_8_bit_async_compute_matching_parameters(cpu_freq,
-                                                  target_freq,
-                                                  &prescaler,
-                                                  &ocra,
-                                                  &timebase_internal_config[timebase_id].accumulator.programmed);
+    if (NULL != parameters)
+    {
+        prescaler = timer_8_bit_async_prescaler_from_value(&parameters->prescaler);
+        if ((TIMER8BIT_ASYNC_CLK_NO_CLOCK == prescaler) || (parameters->ocr_value > UINT8_MAX))
+        {
+            return TIMEBASE_ERROR_INVALID_PARAMETERS;
+        }
+        ocra = (uint8_t) parameters->ocr_value;
+        timebase_internal_config[timebase_id].accumulator.programmed = parameters->accumulator;
+    }
+    else
+    {
+        timer_8_bit_async_compute_matching_parameters(cpu_freq,
+                                                      target_freq,
+                                                      &prescaler,
+                                                      &ocra,
+                                                      &timebase_internal_config[timebase_id].accumulator.programmed);
+    }
 
     timer_error_t ret = timer_8_bit_async_stop(timebase_internal_config[timebase_id].timer_id);
     timer_8_bit_async_handle_t handle = {0};
@@ -165,8 +325,9 @@ static inline timebase_error_t setup_8_bit_async_timer(const uint8_t timebase_id
     config.handle = handle;
     config.timing_config.comp_match_a = TIMER8BIT_ASYNC_CMOD_CLEAR_OCnX;
     config.timing_config.comp_match_b = TIMER8BIT_ASYNC_CMOD_NORMAL;
-    config.timing_config.ocra_val = ocra;
+    config.timing_config.ocra_val = (uint8_t) initial_compare_value(timebase_id, ocra, UINT8_MAX);
     config.timing_config.prescaler = prescaler;
+    config.timing_config.waveform_mode = TIMER8BIT_ASYNC_WG_CTC;
     config.interrupt_config.it_comp_match_a = true;
 
     ret = timer_8_bit_async_reconfigure(timebase_internal_config[timebase_id].timer_id, &config);
@@ -175,10 +336,11 @@ static inline timebase_error_t setup_8_bit_async_timer(const uint8_t timebase_id
         return TIMEBASE_ERROR_TIMER_ERROR;
     }
 
+    set_counting_parameters(timebase_id, *cpu_freq, timer_8_bit_async_prescaler_to_value(prescaler), *target_freq, (uint32_t) ocra + 1U, UINT8_MAX);
     return TIMEBASE_ERROR_OK;
 }
 
-static inline timebase_error_t setup_16_bit_timer(const uint8_t timebase_id, uint32_t const * const cpu_freq, uint32_t const * const target_freq)
+static inline timebase_error_t setup_16_bit_timer(const uint8_t timebase_id, uint32_t const * const cpu_freq, uint32_t const * const target_freq, timebase_timer_parameters_t const * const parameters)
 {
     bool initialised = false;
     timer_error_t err = timer_16_bit_is_initialised(timebase_internal_config[timebase_id].timer_id, &initialised);
@@ -195,11 +357,24 @@ static inline timebase_error_t setup_16_bit_timer(const uint8_t timebase_id, uin
     uint16_t ocra = 0;
     timebase_internal_config[timebase_id].accumulator.programmed =  0;
     timer_16_bit_prescaler_selection_t prescaler;
-    timer_16_bit_compute_matching_parameters(cpu_freq,
-                                            target_freq,
-                                            &prescaler,
-                                            &ocra,
-                                            &timebase_internal_config[timebase_id].accumulator.programmed);
+    if (NULL != parameters)
+    {
+        prescaler = timer_16_bit_prescaler_from_value(&parameters->prescaler);
+        if (TIMER16BIT_CLK_NO_CLOCK == prescaler)
+        {
+            return TIMEBASE_ERROR_INVALID_PARAMETERS;
+        }
+        ocra = parameters->ocr_value;
+        timebase_internal_config[timebase_id].accumulator.programmed = parameters->accumulator;
+    }
+    else
+    {
+        timer_16_bit_compute_matching_parameters(cpu_freq,
+                                                 target_freq,
+                                                 &prescaler,
+                                                 &ocra,
+                                                 &timebase_internal_config[timebase_id].accumulator.programmed);
+    }
 
     timer_error_t ret = timer_16_bit_stop(timebase_internal_config[timebase_id].timer_id);
     timer_16_bit_handle_t handle = {0};
@@ -221,8 +396,9 @@ static inline timebase_error_t setup_16_bit_timer(const uint8_t timebase_id, uin
     config.handle = handle;
     config.timing_config.comp_match_a = TIMER16BIT_CMOD_CLEAR_OCnX;
     config.timing_config.comp_match_b = TIMER16BIT_CMOD_NORMAL;
-    config.timing_config.ocra_val = ocra;
+    config.timing_config.ocra_val = initial_compare_value(timebase_id, ocra, UINT16_MAX);
     config.timing_config.prescaler = prescaler;
+    config.timing_config.waveform_mode = TIMER16BIT_WG_CTC_OCRA_MAX;
     config.interrupt_config.it_comp_match_a = true;
 
     ret = timer_16_bit_reconfigure(timebase_internal_config[timebase_id].timer_id, &config);
@@ -231,6 +407,52 @@ static inline timebase_error_t setup_16_bit_timer(const uint8_t timebase_id, uin
         return TIMEBASE_ERROR_TIMER_ERROR;
     }
 
+    set_counting_parameters(timebase_id, *cpu_freq, timer_16_bit_prescaler_to_value(prescaler), *target_freq, (uint32_t) ocra + 1U, UINT16_MAX);
+    return TIMEBASE_ERROR_OK;
+}
+
+/* Derived timebases count the ticks of their parent : the latter shall have a timer of its own and interrupt on each
+of its ticks */
+static inline timebase_error_t setup_derived_timebase(const uint8_t timebase_id, timebase_config_t const * const config)
+{
+    const uint8_t parent_id = config->derived.parent;
+    if ((false == is_index_valid(parent_id)) || (timebase_id == parent_id))
+    {
+        return TIMEBASE_ERROR_INVALID_PARENT;
+    }
+
+    timebase_internal_config_t const * const parent = &timebase_internal_config[parent_id];
+    if ((false == parent->initialised) || (TIMEBASE_TIMER_DERIVED == parent->timer) || parent->tickless.enabled)
+    {
+        return TIMEBASE_ERROR_INVALID_PARENT;
+    }
+
+    // Tick duration is still expressed in parent timer counts, for timestamps
+    const uint64_t counts_per_tick = ((uint64_t) parent->timestamp.counts_per_tick) * config->derived.divider;
+    if ((0U == config->derived.divider) || (counts_per_tick > UINT32_MAX))
+    {
+        return TIMEBASE_ERROR_INVALID_PARAMETERS;
+    }
+
+    // Up to 32 bits of counts worth of tick duration, with 16 fractional bits : the product only fits in 64 bits
+    const uint64_t tick_period_us_q16 = parent->timestamp.tick_period_us_q16 * config->derived.divider;
+    if ((tick_period_us_q16 >> 16U) > UINT32_MAX)
+    {
+        return TIMEBASE_ERROR_INVALID_PARAMETERS;
+    }
+
+    timebase_internal_config_t * const internal = &timebase_internal_config[timebase_id];
+    internal->tickless.enabled = false;
+    internal->accumulator.programmed = 0;
+    internal->accumulator.running = 0;
+    internal->fraction.step = 0;
+    internal->timestamp.us_per_count_q8 = parent->timestamp.us_per_count_q8;
+    internal->timestamp.counter_period = parent->timestamp.counts_per_tick;
+    internal->timestamp.counts_per_tick = (uint32_t) counts_per_tick;
+    internal->timestamp.tick_period_us_q16 = tick_period_us_q16;
+    internal->derived.parent = parent_id;
+    internal->derived.divider = config->derived.divider;
+    internal->derived.running = 0;
     return TIMEBASE_ERROR_OK;
 }
 
@@ -257,11 +479,11 @@ static inline timebase_error_t convert_timescale_to_frequency(const timebase_con
     return TIMEBASE_ERROR_OK;
 }
 
-timebase_error_t timebase_compute_timer_parameters(timebase_config_t const * const config, uint16_t * const prescaler_val, uint16_t * const ocr_value, uint16_t * const accumulator)
+timebase_error_t timebase_compute_timer_parameters(timebase_config_t const * const config, uint16_t * const prescaler_val, uint16_t * const ocr_value, uint16_t * const accumulator, int32_t * const period_error_ppb)
 {
     timer_8_bit_prescaler_selection_t prescaler;
     uint32_t target_frequency = 0;
-    if (NULL == config || NULL == prescaler_val || NULL == ocr_value || NULL == accumulator)
+    if (NULL == config || NULL == prescaler_val || NULL == ocr_value || NULL == accumulator || NULL == period_error_ppb)
     {
         return TIMEBASE_ERROR_NULL_POINTER;
     }
@@ -309,6 +531,17 @@ timebase_error_t timebase_compute_timer_parameters(timebase_config_t const * con
         default:
             return TIMEBASE_ERROR_UNSUPPORTED_TIMER_TYPE;
     }
+
+    *period_error_ppb = 0;
+    if (0U != config->cpu_freq)
+    {
+        const uint32_t counts_per_tick = ((uint32_t) *ocr_value + 1U) * ((uint32_t) *accumulator + 1U);
+        const int64_t period_error = compute_period_error(config->cpu_freq, *prescaler_val, target_frequency, counts_per_tick);
+        int64_t ppb = (period_error * 1000000000LL) / (int64_t) config->cpu_freq;
+        // Saturated : such an error means the timer cannot produce the target frequency at all
+        ppb = (ppb > INT32_MAX) ? INT32_MAX : ((ppb < INT32_MIN) ? INT32_MIN : ppb);
+        *period_error_ppb = (int32_t) ppb;
+    }
     return TIMEBASE_ERROR_OK;
 }
 
@@ -328,8 +561,18 @@ timebase_error_t timebase_init(const uint8_t timebase_id, timebase_config_t cons
 
     timebase_internal_config[timebase_id].timer_id = config->timer.index;
     timebase_internal_config[timebase_id].timer = config->timer.type;
+    timebase_internal_config[timebase_id].tickless.enabled = config->tickless;
     uint32_t target_freq = 0;
 
+    if (TIMEBASE_TIMER_DERIVED == config->timer.type)
+    {
+        // Parent ISR starts to update this instance once it is flagged as initialised
+        timebase_internal_config[timebase_id].initialised = false;
+        ret = setup_derived_timebase(timebase_id, config);
+        timebase_internal_config[timebase_id].initialised = (TIMEBASE_ERROR_OK == ret);
+        return ret;
+    }
+
     ret = convert_timescale_to_frequency(config, &target_freq);
     if (TIMEBASE_ERROR_OK != ret)
     {
@@ -340,15 +583,15 @@ timebase_error_t timebase_init(const uint8_t timebase_id, timebase_config_t cons
     switch(config->timer.type)
     {
         case TIMEBASE_TIMER_8_BIT:
-            ret = setup_8_bit_timer(timebase_id, &(config->cpu_freq), &target_freq);
+            ret = setup_8_bit_timer(timebase_id, &(config->cpu_freq), &target_freq, config->parameters);
             break;
 
         case TIMEBASE_TIMER_8_BIT_ASYNC:
-            ret = setup_8_bit_async_timer(timebase_id,  &(config->cpu_freq), &target_freq);
+            ret = setup_8_bit_async_timer(timebase_id,  &(config->cpu_freq), &target_freq, config->parameters);
             break;
 
         case TIMEBASE_TIMER_16_BIT:
-            ret = setup_16_bit_timer(timebase_id, &(config->cpu_freq), &target_freq);
+            ret = setup_16_bit_timer(timebase_id, &(config->cpu_freq), &target_freq, config->parameters);
             break;
 
         default:
@@ -359,13 +602,339 @@ timebase_error_t timebase_init(const uint8_t timebase_id, timebase_config_t cons
     return ret;
 }
 
+static inline uint32_t read_tick(const uint8_t id)
+{
+    // 32 bits tick is read one byte at a time on 8 bits targets, and the timer ISR might update it in between.
+    // Ticks are at least a few hundred CPU cycles apart : two identical consecutive reads are consistent.
+    uint32_t first_read = 0;
+    uint32_t second_read = timebase_internal_config[id].tick;
+    do
+    {
+        first_read = second_read;
+        second_read = timebase_internal_config[id].tick;
+    } while (first_read != second_read);
+    return second_read;
+}
+
+/* Reads the live timer counter and its compare match flag. If the flag is raised, counter has already been reset
+by the compare match (CTC mode) : it is read again so that it is consistent with the flag. */
+static timebase_error_t read_timer_counter(const uint8_t id, uint16_t * const counter, bool * const pending)
+{
+    const uint8_t timer_id = timebase_internal_config[id].timer_id;
+    timer_error_t err = TIMER_ERROR_OK;
+    uint8_t counter_8_bit = 0;
+
+    switch (timebase_internal_config[id].timer)
+    {
+        case TIMEBASE_TIMER_8_BIT:
+            err = timer_8_bit_get_counter_value(timer_id, &counter_8_bit);
+            err = (TIMER_ERROR_OK == err) ? timer_8_bit_get_compare_match_a_flag(timer_id, pending) : err;
+            if ((TIMER_ERROR_OK == err) && *pending)
+            {
+                err = timer_8_bit_get_counter_value(timer_id, &counter_8_bit);
+            }
+            *counter = counter_8_bit;
+            break;
+
+        case TIMEBASE_TIMER_8_BIT_ASYNC:
+            err = timer_8_bit_async_get_counter_value(timer_id, &counter_8_bit);
+            err = (TIMER_ERROR_OK == err) ? timer_8_bit_async_get_compare_match_a_flag(timer_id, pending) : err;
+            if ((TIMER_ERROR_OK == err) && *pending)
+            {
+                err = timer_8_bit_async_get_counter_value(timer_id, &counter_8_bit);
+            }
+            *counter = counter_8_bit;
+            break;
+
+        case TIMEBASE_TIMER_16_BIT:
+            err = timer_16_bit_get_counter_value(timer_id, counter);
+            err = (TIMER_ERROR_OK == err) ? timer_16_bit_get_compare_match_a_flag(timer_id, pending) : err;
+            if ((TIMER_ERROR_OK == err) && *pending)
+            {
+                err = timer_16_bit_get_counter_value(timer_id, counter);
+            }
+            break;
+
+        default:
+            return TIMEBASE_ERROR_UNSUPPORTED_TIMER_TYPE;
+    }
+
+    if (TIMER_ERROR_OK != err)
+    {
+        return TIMEBASE_ERROR_TIMER_ERROR;
+    }
+    return TIMEBASE_ERROR_OK;
+}
+
+static void write_compare(const uint8_t id, const uint16_t compare)
+{
+    const uint8_t timer_id = timebase_internal_config[id].timer_id;
+    switch (timebase_internal_config[id].timer)
+    {
+        case TIMEBASE_TIMER_8_BIT:
+            (void) timer_8_bit_set_ocra_register_value(timer_id, (uint8_t) compare);
+            break;
+
+        case TIMEBASE_TIMER_8_BIT_ASYNC:
+            (void) timer_8_bit_async_set_ocra_register_value(timer_id, (uint8_t) compare);
+            break;
+
+        case TIMEBASE_TIMER_16_BIT:
+            (void) timer_16_bit_set_ocra_register_value(timer_id, &compare);
+            break;
+
+        default:
+            break;
+    }
+}
+
+/* Masks (or unmasks) the compare match interrupt. A compare match happening while masked leaves its flag raised,
+so that the ISR runs as soon as it is unmasked */
+static void set_compare_interrupt(const uint8_t id, const bool enabled)
+{
+    const uint8_t timer_id = timebase_internal_config[id].timer_id;
+    switch (timebase_internal_config[id].timer)
+    {
+        case TIMEBASE_TIMER_8_BIT:
+        {
+            timer_8_bit_interrupt_config_t it_config = {0};
+            (void) timer_8_bit_get_interrupt_config(timer_id, &it_config);
+            it_config.it_comp_match_a = enabled;
+            (void) timer_8_bit_set_interrupt_config(timer_id, &it_config);
+            break;
+        }
+
+        case TIMEBASE_TIMER_8_BIT_ASYNC:
+        {
+            timer_8_bit_async_interrupt_config_t it_config = {0};
+            (void) timer_8_bit_async_get_interrupt_config(timer_id, &it_config);
+            it_config.it_comp_match_a = enabled;
+            (void) timer_8_bit_async_set_interrupt_config(timer_id, &it_config);
+            break;
+        }
+
+        case TIMEBASE_TIMER_16_BIT:
+        {
+            timer_16_bit_interrupt_config_t it_config = {0};
+            (void) timer_16_bit_get_interrupt_config(timer_id, &it_config);
+            it_config.it_comp_match_a = enabled;
+            (void) timer_16_bit_set_interrupt_config(timer_id, &it_config);
+            break;
+        }
+
+        default:
+            break;
+    }
+}
+
+/* Programs the compare value of a tickless timebase so that next interrupt fires on the deadline, or when the timer
+counter reaches its maximum value. Called from the ISR, or from main context with compare interrupt masked, in which
+case the compare value is only ever shortened (ISR takes care of the rest). */
+static void program_tickless_compare(const uint8_t id, const bool shorten_only)
+{
+    timebase_internal_config_t * const internal = &timebase_internal_config[id];
+    uint16_t counter = 0;
+    bool pending = false;
+    if ((TIMEBASE_ERROR_OK != read_timer_counter(id, &counter, &pending)) || pending)
+    {
+        // Compare match already happened : ISR will program next compare value
+        return;
+    }
+
+    const uint32_t max_compare = internal->tickless.max_compare;
+    uint32_t target = max_compare;
+    if (internal->tickless.deadline_armed)
+    {
+        const uint32_t remaining_ticks = internal->tickless.deadline - internal->tick;
+        // Deadlines which are too far away to be reached by this compare period are handled by following ones
+        if (((int32_t) remaining_ticks > 0) && (remaining_ticks <= ((max_compare / internal->timestamp.counts_per_tick) + 1U)))
+        {
+            const uint32_t counts = (remaining_ticks * internal->timestamp.counts_per_tick) - internal->tickless.residual - 1U;
+            if (counts < target)
+            {
+                target = counts;
+            }
+        }
+    }
+
+    const uint32_t earliest = (uint32_t) counter + internal->tickless.margin;
+    if (target < earliest)
+    {
+        target = (earliest < max_compare) ? earliest : max_compare;
+    }
+
+    if ((false == shorten_only) || (target < internal->tickless.compare))
+    {
+        internal->tickless.compare = (uint16_t) target;
+        write_compare(id, (uint16_t) target);
+    }
+}
+
+static void tickless_interrupt(const uint8_t id)
+{
+    timebase_internal_config_t * const internal = &timebase_internal_config[id];
+
+    // Counter was reset by the compare match, after compare + 1 counts
+    uint32_t residual = internal->tickless.residual + (uint32_t) internal->tickless.compare + 1U;
+    if (residual >= internal->timestamp.counts_per_tick)
+    {
+        internal->tick += residual / internal->timestamp.counts_per_tick;
+        residual %= internal->timestamp.counts_per_tick;
+    }
+    internal->tickless.residual = residual;
+
+    program_tickless_compare(id, false);
+}
+
+/* Bresenham-like tick period correction : hardware ticks are off the target period by step / modulus timer counts.
+The error is accumulated on each tick, and when it reaches a whole count the first compare period of the next tick
+is made one count longer (or shorter), so that the average tick rate matches the target exactly. */
+static void fraction_interrupt(const uint8_t id, const bool tick_completed)
+{
+    timebase_internal_config_t * const internal = &timebase_internal_config[id];
+    const uint16_t compare = (uint16_t) (internal->timestamp.counter_period - 1U);
+    bool adjust = false;
+
+    if (tick_completed)
+    {
+        internal->fraction.error += internal->fraction.step;
+        if (internal->fraction.error >= internal->fraction.modulus)
+        {
+            internal->fraction.error -= internal->fraction.modulus;
+            adjust = true;
+        }
+    }
+
+    if (adjust)
+    {
+        write_compare(id, (uint16_t) (compare + internal->fraction.direction));
+    }
+    else if (internal->fraction.adjusted)
+    {
+        write_compare(id, compare);
+    }
+    internal->fraction.adjusted = adjust;
+}
+
+static timebase_error_t read_derived_elapsed_counts(const uint8_t id, uint32_t * const tick, uint32_t * const counts);
+
+/* Reads the tick and the timer counts elapsed since this tick started, consistently with each other. Timer ISR might
+run at any point of this sequence : start over until nothing moved. */
+static timebase_error_t read_elapsed_counts(const uint8_t id, uint32_t * const tick, uint32_t * const counts)
+{
+    timebase_internal_config_t * const internal = &timebase_internal_config[id];
+    if (TIMEBASE_TIMER_DERIVED == internal->timer)
+    {
+        return read_derived_elapsed_counts(id, tick, counts);
+    }
+
+    uint16_t running = 0;
+    uint32_t residual = 0;
+    uint16_t compare = 0;
+    uint16_t counter = 0;
+    bool pending = false;
+
+    do
+    {
+        *tick = read_tick(id);
+        running = internal->accumulator.running;
+        residual = internal->tickless.residual;
+        compare = internal->tickless.compare;
+        timebase_error_t err = read_timer_counter(id, &counter, &pending);
+        if (TIMEBASE_ERROR_OK != err)
+        {
+            return err;
+        }
+    } while ((*tick != read_tick(id))
+          || (running != internal->accumulator.running)
+          || (residual != internal->tickless.residual)
+          || (compare != internal->tickless.compare));
+
+    if (internal->tickless.enabled)
+    {
+        // Counts since last interrupt, plus the compare period which ended if its interrupt is pending
+        *counts = residual + counter + (pending ? ((uint32_t) compare + 1U) : 0U);
+    }
+    else
+    {
+        // Interrupts elapsed since last tick, plus the one which is pending (if any). When the pending one completes
+        // the current tick, counts simply reach the next tick.
+        const uint32_t interrupts = (uint32_t) running + (pending ? 1U : 0U);
+        *counts = interrupts * internal->timestamp.counter_period + counter;
+    }
+    return TIMEBASE_ERROR_OK;
+}
+
+/* Elapsed counts of a derived timebase are made of the parent ticks counted so far, plus the parent timer counts
+elapsed since its own tick started. Both are updated by the same ISR. */
+static timebase_error_t read_derived_elapsed_counts(const uint8_t id, uint32_t * const tick, uint32_t * const counts)
+{
+    timebase_internal_config_t * const internal = &timebase_internal_config[id];
+    const uint8_t parent_id = internal->derived.parent;
+    uint32_t running = 0;
+    uint32_t parent_tick = 0;
+    uint32_t parent_counts = 0;
+
+    if (false == timebase_internal_config[parent_id].initialised)
+    {
+        return TIMEBASE_ERROR_INVALID_PARENT;
+    }
+
+    do
+    {
+        *tick = read_tick(id);
+        running = internal->derived.running;
+        timebase_error_t err = read_elapsed_counts(parent_id, &parent_tick, &parent_counts);
+        if (TIMEBASE_ERROR_OK != err)
+        {
+            return err;
+        }
+    } while ((*tick != read_tick(id)) || (running != internal->derived.running));
+
+    // A pending parent interrupt might complete the parent tick : counts reach the next derived tick at most
+    *counts = (running * internal->timestamp.counter_period) + parent_counts;
+    return TIMEBASE_ERROR_OK;
+}
+
+/* Derived timebases share their parent's interrupt : each parent tick moves their dividers forward. Only a handful of
+instances exist, scanning them all keeps the ISR duration constant. */
+static void update_derived_timebases(const uint8_t parent_id)
+{
+    for (uint8_t i = 0 ; i < TIMEBASE_MAX_MODULES ; i++)
+    {
+        timebase_internal_config_t * const internal = &timebase_internal_config[i];
+        if (internal->initialised && (TIMEBASE_TIMER_DERIVED == internal->timer) && (parent_id == internal->derived.parent))
+        {
+            const uint32_t running = internal->derived.running + 1U;
+            if (running >= internal->derived.divider)
+            {
+                internal->derived.running = 0;
+                internal->tick++;
+            }
+            else
+            {
+                internal->derived.running = running;
+            }
+        }
+    }
+}
+
 void timebase_interrupt_callback(const uint8_t timebase_id)
 {
-    if (false == is_index_valid(timebase_id))
+    // Derived timebases are updated by their parent
+    if ((false == is_index_valid(timebase_id)) || (TIMEBASE_TIMER_DERIVED == timebase_internal_config[timebase_id].timer))
     {
         return;
     }
 
+    if (timebase_internal_config[timebase_id].tickless.enabled)
+    {
+        tickless_interrupt(timebase_id);
+        return;
+    }
+
+    bool tick_completed = true;
+
     // If an accumulator value was set, increment it and when the running accumulator matches the programmed one,
     // This counts as a new tick.
     if (timebase_internal_config[timebase_id].accumulator.programmed != 0)
@@ -373,6 +942,7 @@ void timebase_interrupt_callback(const uint8_t timebase_id)
         if (timebase_internal_config[timebase_id].accumulator.running < timebase_internal_config[timebase_id].accumulator.programmed)
         {
             timebase_internal_config[timebase_id].accumulator.running++;
+            tick_completed = false;
         }
         else
         {
@@ -385,6 +955,16 @@ void timebase_interrupt_callback(const uint8_t timebase_id)
     {
         timebase_internal_config[timebase_id].tick++;
     }
+
+    if (0U != timebase_internal_config[timebase_id].fraction.step)
+    {
+        fraction_interrupt(timebase_id, tick_completed);
+    }
+
+    if (tick_completed)
+    {
+        update_derived_timebases(timebase_id);
+    }
 }
 
 timebase_error_t timebase_deinit(const uint8_t id)
@@ -404,7 +984,7 @@ timebase_error_t timebase_deinit(const uint8_t id)
 }
 
 
-timebase_error_t timebase_get_tick(const uint8_t id, uint16_t * const tick)
+timebase_error_t timebase_get_tick(const uint8_t id, uint32_t * const tick)
 {
     if (false == is_index_valid(id))
     {
@@ -421,35 +1001,80 @@ timebase_error_t timebase_get_tick(const uint8_t id, uint16_t * const tick)
         return TIMEBASE_ERROR_UNINITIALISED;
     }
 
-    *tick = timebase_internal_config[id].tick;
-
+    if (timebase_internal_config[id].tickless.enabled)
+    {
+        uint32_t counts = 0;
+        timebase_error_t err = read_elapsed_counts(id, tick, &counts);
+        if (TIMEBASE_ERROR_OK != err)
+        {
+            return err;
+        }
+        *tick += counts / timebase_internal_config[id].timestamp.counts_per_tick;
+    }
+    else
+    {
+        *tick = read_tick(id);
+    }
     return TIMEBASE_ERROR_OK;
 }
 
-timebase_error_t timebase_get_duration(uint16_t const * const reference, uint16_t const * const new_tick, uint16_t * const duration)
+timebase_error_t timebase_get_timestamp_us(const uint8_t id, uint32_t * const timestamp)
 {
-    if( NULL == reference || NULL == new_tick || NULL == duration)
+    if (false == is_index_valid(id))
+    {
+        return TIMEBASE_ERROR_INVALID_INDEX;
+    }
+
+    if (NULL == timestamp)
     {
         return TIMEBASE_ERROR_NULL_POINTER;
     }
 
-    // Tick counter has overflowed ! As there is no particular event triggered by the overflowing of
-    // any tick variable, we can assume that overflowing happened only once and compute the absolute distance
-    // between the two variables
-    if (*reference > *new_tick)
+    if (false == timebase_internal_config[id].initialised)
     {
-        uint32_t offset_tick = *new_tick + USHRT_MAX;
-        *duration = (offset_tick - (uint32_t) *reference);
+        return TIMEBASE_ERROR_UNINITIALISED;
     }
-    else
+
+    uint32_t tick = 0;
+    uint32_t counts = 0;
+    timebase_error_t err = read_elapsed_counts(id, &tick, &counts);
+    if (TIMEBASE_ERROR_OK != err)
     {
-        *duration = *new_tick - *reference;
+        return err;
     }
 
+    // Whole ticks out of the elapsed counts (pending interrupts, tickless timebases, corrected ticks lasting a count
+    // longer) are accounted for with the average tick duration, so that timestamps never go backwards
+    const uint32_t counts_per_tick = timebase_internal_config[id].timestamp.counts_per_tick;
+    if (counts >= counts_per_tick)
+    {
+        tick += counts / counts_per_tick;
+        counts %= counts_per_tick;
+    }
+    const uint64_t tick_period_us_q16 = timebase_internal_config[id].timestamp.tick_period_us_q16;
+    const uint64_t elapsed_us_q16 = (((uint64_t) counts) * timebase_internal_config[id].timestamp.us_per_count_q8) << 8U;
+
+    // Timestamps wrap around after 2^32 us : the product only needs to be right modulo 2^64
+    *timestamp = (uint32_t) (((((uint64_t) tick) * tick_period_us_q16) + elapsed_us_q16) >> 16U);
+
     return TIMEBASE_ERROR_OK;
 }
 
-timebase_error_t timebase_get_duration_now(const uint8_t id, uint16_t const * const reference, uint16_t * const duration)
+timebase_error_t timebase_get_duration(uint32_t const * const reference, uint32_t const * const new_tick, uint32_t * const duration)
+{
+    if( NULL == reference || NULL == new_tick || NULL == duration)
+    {
+        return TIMEBASE_ERROR_NULL_POINTER;
+    }
+
+    // Unsigned subtraction is performed modulo 2^32 : when the tick counter has wrapped around once since the
+    // reference was taken, this still gives the elapsed number of ticks
+    *duration = *new_tick - *reference;
+
+    return TIMEBASE_ERROR_OK;
+}
+
+timebase_error_t timebase_get_duration_now(const uint8_t id, uint32_t const * const reference, uint32_t * const duration)
 {
     if (false == is_index_valid(id))
     {
@@ -461,7 +1086,7 @@ timebase_error_t timebase_get_duration_now(const uint8_t id, uint16_t const * co
         return TIMEBASE_ERROR_NULL_POINTER;
     }
 
-    uint16_t now = 0;
+    uint32_t now = 0;
     timebase_error_t err = timebase_get_tick(id, &now);
     if (TIMEBASE_ERROR_OK != err)
     {
@@ -486,3 +1111,59 @@ timebase_error_t timebase_is_initialised(const uint8_t id, bool * const initiali
     *initialised = timebase_internal_config[id].initialised;
     return TIMEBASE_ERROR_OK;
 }
+
+timebase_error_t timebase_is_tickless(const uint8_t id, bool * const tickless)
+{
+    if (false == is_index_valid(id))
+    {
+        return TIMEBASE_ERROR_INVALID_INDEX;
+    }
+
+    if (NULL == tickless)
+    {
+        return TIMEBASE_ERROR_NULL_POINTER;
+    }
+
+    *tickless = timebase_internal_config[id].tickless.enabled;
+    return TIMEBASE_ERROR_OK;
+}
+
+timebase_error_t timebase_set_deadline(const uint8_t id, const uint32_t tick)
+{
+    if (false == is_index_valid(id))
+    {
+        return TIMEBASE_ERROR_INVALID_INDEX;
+    }
+
+    if (false == timebase_internal_config[id].initialised)
+    {
+        return TIMEBASE_ERROR_UNINITIALISED;
+    }
+
+    if (timebase_internal_config[id].tickless.enabled)
+    {
+        set_compare_interrupt(id, false);
+        timebase_internal_config[id].tickless.deadline = tick;
+        timebase_internal_config[id].tickless.deadline_armed = true;
+        program_tickless_compare(id, true);
+        set_compare_interrupt(id, true);
+    }
+    return TIMEBASE_ERROR_OK;
+}
+
+timebase_error_t timebase_cancel_deadline(const uint8_t id)
+{
+    if (false == is_index_valid(id))
+    {
+        return TIMEBASE_ERROR_INVALID_INDEX;
+    }
+
+    if (false == timebase_internal_config[id].initialised)
+    {
+        return TIMEBASE_ERROR_UNINITIALISED;
+    }
+
+    // Current compare value is kept : ISR goes back to the longest compare period
+    timebase_internal_config[id].tickless.deadline_armed = false;
+    return TIMEBASE_ERROR_OK;
+}
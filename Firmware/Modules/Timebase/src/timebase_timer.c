@@ -0,0 +1,437 @@
+/*
+
+------------------
+@<FreeMyCode>
+FreeMyCode version : 1.0 RC alpha
+    Author : bebenlebricolo
+    License : 
+        name : GPLv3
+        url : https://www.gnu.org/licenses/quick-guide-gplv3.html
+    Date : 12/02/2021
+    Project : LabBenchPowerSupply
+    Description : The Lab Bench Power Supply provides a simple design based around an Arduino Nano board to convert AC main voltage into
+ smaller ones, ranging from 0V to 16V, with voltage and current regulations
+<FreeMyCode>@
+------------------
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "config.h"
+#include "timebase_timer.h"
+
+#if (TIMEBASE_TIMER_WHEEL_SIZE == 0) || ((TIMEBASE_TIMER_WHEEL_SIZE & (TIMEBASE_TIMER_WHEEL_SIZE - 1U)) != 0)
+    #error "TIMEBASE_TIMER_WHEEL_SIZE shall be a power of two"
+#endif
+
+#if TIMEBASE_TIMER_MAX_TIMERS >= 255U
+    #error "TIMEBASE_TIMER_MAX_TIMERS shall be lower than 255"
+#endif
+
+/* Marks the end of a slot list */
+#define TIMER_SLOT_NONE 0xFFU
+#define WHEEL_MASK ((uint32_t) TIMEBASE_TIMER_WHEEL_SIZE - 1U)
+
+typedef struct
+{
+    timebase_timer_callback_t callback;
+    void * context;
+    uint32_t expiry;        /**< Tick on which the timer expires                                        */
+    uint32_t period;        /**< Re-arming period, 0 for one-shot timers                                */
+    uint8_t next;           /**< Next slot in the same wheel bucket                                     */
+    uint8_t prev;           /**< Previous slot in the same wheel bucket                                 */
+    uint8_t pending_next;   /**< Next slot in the list of timers expired during the processed tick      */
+    bool allocated;
+    bool armed;
+    bool pending;           /**< Expired during the processed tick, callback not called yet             */
+} timer_slot_t;
+
+static struct
+{
+    timer_slot_t slots[TIMEBASE_TIMER_MAX_TIMERS];
+    uint8_t wheel[TIMEBASE_TIMER_WHEEL_SIZE];   /**< Head slot of each bucket, buckets are indexed by expiry tick  */
+    uint32_t current_tick;                      /**< Last processed tick                                           */
+    uint8_t earliest;                           /**< Armed slot handed over as deadline, TIMER_SLOT_NONE if none   */
+    uint8_t armed_count;
+    uint8_t timebase_id;
+    bool initialised;
+} timer_service = {0};
+
+static inline bool is_timer_valid(const uint8_t timer)
+{
+    return (timer < TIMEBASE_TIMER_MAX_TIMERS) && timer_service.slots[timer].allocated;
+}
+
+static void link_slot(const uint8_t timer)
+{
+    timer_slot_t * const slot = &timer_service.slots[timer];
+    uint8_t * const head = &timer_service.wheel[slot->expiry & WHEEL_MASK];
+
+    slot->prev = TIMER_SLOT_NONE;
+    slot->next = *head;
+    if (TIMER_SLOT_NONE != *head)
+    {
+        timer_service.slots[*head].prev = timer;
+    }
+    *head = timer;
+}
+
+static void unlink_slot(const uint8_t timer)
+{
+    timer_slot_t * const slot = &timer_service.slots[timer];
+
+    if (TIMER_SLOT_NONE != slot->prev)
+    {
+        timer_service.slots[slot->prev].next = slot->next;
+    }
+    else
+    {
+        timer_service.wheel[slot->expiry & WHEEL_MASK] = slot->next;
+    }
+
+    if (TIMER_SLOT_NONE != slot->next)
+    {
+        timer_service.slots[slot->next].prev = slot->prev;
+    }
+    slot->next = TIMER_SLOT_NONE;
+    slot->prev = TIMER_SLOT_NONE;
+}
+
+static void disarm_slot(const uint8_t timer)
+{
+    timer_slot_t * const slot = &timer_service.slots[timer];
+    if (slot->armed)
+    {
+        unlink_slot(timer);
+        slot->armed = false;
+        timer_service.armed_count--;
+    }
+    slot->pending = false;
+}
+
+/* Moves timers expiring on the processed tick out of their bucket (periodic ones go back into the wheel) and chains
+them in expiry list, which head is returned */
+static uint8_t collect_expired(void)
+{
+    uint8_t expired_head = TIMER_SLOT_NONE;
+    uint8_t expired_tail = TIMER_SLOT_NONE;
+    uint8_t timer = timer_service.wheel[timer_service.current_tick & WHEEL_MASK];
+
+    while (TIMER_SLOT_NONE != timer)
+    {
+        timer_slot_t * const slot = &timer_service.slots[timer];
+        const uint8_t next = slot->next;
+
+        // Bucket also holds timers expiring one or more wheel rounds later
+        if (slot->expiry == timer_service.current_tick)
+        {
+            unlink_slot(timer);
+            if (0U != slot->period)
+            {
+                // Relative to the previous expiry so that late processing does not make periodic timers drift.
+                // Re-linked slot is pushed in front of its bucket, and is not visited again by this walk
+                slot->expiry += slot->period;
+                link_slot(timer);
+            }
+            else
+            {
+                slot->armed = false;
+                timer_service.armed_count--;
+            }
+
+            slot->pending = true;
+            slot->pending_next = TIMER_SLOT_NONE;
+            if (TIMER_SLOT_NONE == expired_tail)
+            {
+                expired_head = timer;
+            }
+            else
+            {
+                timer_service.slots[expired_tail].pending_next = timer;
+            }
+            expired_tail = timer;
+        }
+        timer = next;
+    }
+    return expired_head;
+}
+
+/* Periodic timebases interrupt on every tick anyway : only tickless ones need the earliest expiry as a deadline */
+static inline bool deadline_needed(void)
+{
+    bool tickless = false;
+    return (TIMEBASE_ERROR_OK == timebase_is_tickless(timer_service.timebase_id, &tickless)) && tickless;
+}
+
+/* Expiries are compared relative to the last processed tick, which keeps tick wrap around harmless */
+static inline bool expires_before(const uint8_t timer, const uint8_t other)
+{
+    return (timer_service.slots[timer].expiry - timer_service.current_tick)
+         < (timer_service.slots[other].expiry - timer_service.current_tick);
+}
+
+static void hand_deadline_over(void)
+{
+    if (TIMER_SLOT_NONE != timer_service.earliest)
+    {
+        (void) timebase_set_deadline(timer_service.timebase_id, timer_service.slots[timer_service.earliest].expiry);
+    }
+    else
+    {
+        (void) timebase_cancel_deadline(timer_service.timebase_id);
+    }
+}
+
+/* Looks for the earliest armed timer among all slots and hands it over to the timebase, so that a tickless timebase
+wakes up in time for it. Only needed when the cached earliest timer is gone or has moved */
+static void rescan_deadline(void)
+{
+    timer_service.earliest = TIMER_SLOT_NONE;
+    for (uint8_t i = 0 ; i < TIMEBASE_TIMER_MAX_TIMERS ; i++)
+    {
+        if (timer_service.slots[i].armed && ((TIMER_SLOT_NONE == timer_service.earliest) || expires_before(i, timer_service.earliest)))
+        {
+            timer_service.earliest = i;
+        }
+    }
+    hand_deadline_over();
+}
+
+/* A newly armed timer only moves the deadline if it expires before the cached earliest one */
+static void deadline_timer_armed(const uint8_t timer)
+{
+    if ((TIMER_SLOT_NONE == timer_service.earliest) || expires_before(timer, timer_service.earliest))
+    {
+        timer_service.earliest = timer;
+        hand_deadline_over();
+    }
+}
+
+/* Disarming any other timer than the earliest one leaves the deadline as is */
+static void deadline_timer_disarmed(const uint8_t timer)
+{
+    if (timer == timer_service.earliest)
+    {
+        rescan_deadline();
+    }
+}
+
+timebase_error_t timebase_timer_init(const uint8_t timebase_id)
+{
+    uint32_t tick = 0;
+    timebase_error_t err = timebase_get_tick(timebase_id, &tick);
+    if (TIMEBASE_ERROR_OK != err)
+    {
+        return err;
+    }
+
+    for (uint8_t i = 0 ; i < TIMEBASE_TIMER_MAX_TIMERS ; i++)
+    {
+        timer_service.slots[i].callback = NULL;
+        timer_service.slots[i].context = NULL;
+        timer_service.slots[i].expiry = 0;
+        timer_service.slots[i].period = 0;
+        timer_service.slots[i].next = TIMER_SLOT_NONE;
+        timer_service.slots[i].prev = TIMER_SLOT_NONE;
+        timer_service.slots[i].pending_next = TIMER_SLOT_NONE;
+        timer_service.slots[i].allocated = false;
+        timer_service.slots[i].armed = false;
+        timer_service.slots[i].pending = false;
+    }
+
+    for (uint8_t i = 0 ; i < TIMEBASE_TIMER_WHEEL_SIZE ; i++)
+    {
+        timer_service.wheel[i] = TIMER_SLOT_NONE;
+    }
+
+    timer_service.current_tick = tick;
+    timer_service.earliest = TIMER_SLOT_NONE;
+    timer_service.armed_count = 0;
+    timer_service.timebase_id = timebase_id;
+    timer_service.initialised = true;
+    return TIMEBASE_ERROR_OK;
+}
+
+timebase_error_t timebase_timer_create(const timebase_timer_callback_t callback, void * const context, uint8_t * const timer)
+{
+    if (NULL == callback || NULL == timer)
+    {
+        return TIMEBASE_ERROR_NULL_POINTER;
+    }
+
+    if (false == timer_service.initialised)
+    {
+        return TIMEBASE_ERROR_UNINITIALISED;
+    }
+
+    for (uint8_t i = 0 ; i < TIMEBASE_TIMER_MAX_TIMERS ; i++)
+    {
+        if (false == timer_service.slots[i].allocated)
+        {
+            timer_service.slots[i].callback = callback;
+            timer_service.slots[i].context = context;
+            timer_service.slots[i].period = 0;
+            timer_service.slots[i].armed = false;
+            timer_service.slots[i].pending = false;
+            timer_service.slots[i].allocated = true;
+            *timer = i;
+            return TIMEBASE_ERROR_OK;
+        }
+    }
+
+    return TIMEBASE_ERROR_NO_FREE_TIMER;
+}
+
+timebase_error_t timebase_timer_release(const uint8_t timer)
+{
+    if (false == is_timer_valid(timer))
+    {
+        return TIMEBASE_ERROR_INVALID_INDEX;
+    }
+
+    disarm_slot(timer);
+    timer_service.slots[timer].allocated = false;
+    timer_service.slots[timer].callback = NULL;
+    timer_service.slots[timer].context = NULL;
+    if (deadline_needed())
+    {
+        deadline_timer_disarmed(timer);
+    }
+    return TIMEBASE_ERROR_OK;
+}
+
+timebase_error_t timebase_timer_arm(const uint8_t timer, const uint32_t delay, const uint32_t period)
+{
+    if (false == is_timer_valid(timer))
+    {
+        return TIMEBASE_ERROR_INVALID_INDEX;
+    }
+
+    // Expiry is relative to the live tick, which is always ahead of (or equal to) the last processed one : timer will
+    // be reached by the wheel even if processing is currently late
+    uint32_t now = 0;
+    timebase_error_t err = timebase_get_tick(timer_service.timebase_id, &now);
+    if (TIMEBASE_ERROR_OK != err)
+    {
+        now = timer_service.current_tick;
+    }
+
+    disarm_slot(timer);
+    timer_slot_t * const slot = &timer_service.slots[timer];
+    slot->expiry = now + ((0U == delay) ? 1U : delay);
+    slot->period = period;
+    slot->armed = true;
+    timer_service.armed_count++;
+    link_slot(timer);
+    if (deadline_needed())
+    {
+        // Re-armed earliest timer might now expire after another one
+        if (timer == timer_service.earliest)
+        {
+            rescan_deadline();
+        }
+        else
+        {
+            deadline_timer_armed(timer);
+        }
+    }
+
+    return TIMEBASE_ERROR_OK;
+}
+
+timebase_error_t timebase_timer_cancel(const uint8_t timer)
+{
+    if (false == is_timer_valid(timer))
+    {
+        return TIMEBASE_ERROR_INVALID_INDEX;
+    }
+
+    disarm_slot(timer);
+    if (deadline_needed())
+    {
+        deadline_timer_disarmed(timer);
+    }
+    return TIMEBASE_ERROR_OK;
+}
+
+timebase_error_t timebase_timer_is_armed(const uint8_t timer, bool * const armed)
+{
+    if (NULL == armed)
+    {
+        return TIMEBASE_ERROR_NULL_POINTER;
+    }
+
+    if (false == is_timer_valid(timer))
+    {
+        return TIMEBASE_ERROR_INVALID_INDEX;
+    }
+
+    *armed = timer_service.slots[timer].armed;
+    return TIMEBASE_ERROR_OK;
+}
+
+timebase_error_t timebase_timer_process(void)
+{
+    if (false == timer_service.initialised)
+    {
+        return TIMEBASE_ERROR_UNINITIALISED;
+    }
+
+    uint32_t now = 0;
+    timebase_error_t err = timebase_get_tick(timer_service.timebase_id, &now);
+    if (TIMEBASE_ERROR_OK != err)
+    {
+        return err;
+    }
+
+    bool expired = false;
+    while (timer_service.current_tick != now)
+    {
+        // Nothing to expire : skip the remaining ticks at once
+        if (0U == timer_service.armed_count)
+        {
+            timer_service.current_tick = now;
+            break;
+        }
+
+        timer_service.current_tick++;
+        uint8_t timer = collect_expired();
+        expired |= (TIMER_SLOT_NONE != timer);
+
+        // Callbacks are called once the bucket is consistent, as they might arm or cancel any timer (even one which
+        // expired on this very tick and whose callback was not called yet)
+        while (TIMER_SLOT_NONE != timer)
+        {
+            timer_slot_t * const slot = &timer_service.slots[timer];
+            const uint8_t next = slot->pending_next;
+            if (slot->pending)
+            {
+                slot->pending = false;
+                slot->callback(slot->context);
+            }
+            timer = next;
+        }
+    }
+
+    // Expired timers are the earliest ones : they were either disarmed or moved to their next period
+    if (expired && deadline_needed())
+    {
+        rescan_deadline();
+    }
+    return TIMEBASE_ERROR_OK;
+}